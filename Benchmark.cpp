@@ -0,0 +1,1518 @@
+/*---------------------------------------------------------*\
+| Benchmark.cpp                                             |
+|                                                           |
+|   Self-contained benchmark scenarios for the --benchmark  |
+|   command line option.  They run on dummy devices and     |
+|   loopback connections, no hardware is needed.            |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "Benchmark.h"
+#include "DDPController.h"
+#include "DeviceUpdatePool.h"
+#include "ENESMBusController.h"
+#include "ENESMBusInterface_i2c_smbus.h"
+#include "i2c_smbus_debug.h"
+#include "LEDStripController.h"
+#include "NetworkProtocol.h"
+#include "NetworkServer.h"
+#include "NetworkSharedMemory.h"
+#include "ResourceManager.h"
+#include "RGBController.h"
+#include "RGBController_DDP.h"
+#include "RGBController_Dummy.h"
+#include "RGBController_E131.h"
+#include "SettingsManager.h"
+
+#ifdef __linux__
+#include "i2c_smbus_linux.h"
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#define BENCHMARK_DUMMY_CONTROLLERS     64
+#define BENCHMARK_IDLE_TIME             std::chrono::seconds(1)
+#define BENCHMARK_FRAME_TIMEOUT         std::chrono::seconds(5)
+#define BENCHMARK_SERVER_HOST           "127.0.0.1"
+#define BENCHMARK_SERVER_PORT           16742
+#define BENCHMARK_SERVER_PORT_ATTEMPTS  16
+#define BENCHMARK_SERVER_CLIENTS        8
+#define BENCHMARK_SERVER_LEDS           100
+#define BENCHMARK_ALLOCATION_LEDS       1000
+#define BENCHMARK_ALLOCATION_WARMUP     16
+#define BENCHMARK_DELTA_LEDS            2000
+#define BENCHMARK_SHM_LEDS              2000
+#define BENCHMARK_DETECTION_RUNS        3
+#define BENCHMARK_SMBUS_ADDRESS         0x77
+#define BENCHMARK_SMBUS_LEDS            10
+#define BENCHMARK_UDP_HOST              "127.0.0.1"
+#define BENCHMARK_UDP_RECEIVE_BUFFER    (4 * 1024 * 1024)
+#define BENCHMARK_UDP_DRAIN_TIME        std::chrono::milliseconds(200)
+#define BENCHMARK_SERIAL_LEDS           300
+#define BENCHMARK_SERIAL_BAUD           1000000
+#define BENCHMARK_SERIAL_READ_RATE      100000      /* Bytes/s, about 1 Mbaud   */
+#define BENCHMARK_SERIAL_INTERVAL       std::chrono::milliseconds(2)
+#define BENCHMARK_SERIAL_IDLE_TIME      std::chrono::milliseconds(500)
+
+/*---------------------------------------------------------*\
+| Allocation count of the counter library from              |
+| scripts/benchmark-allocation-counter.c, NULL unless it    |
+| has been preloaded.  The OpenRGB heap itself is never     |
+| replaced.                                                 |
+\*---------------------------------------------------------*/
+typedef unsigned long long (*BenchmarkAllocationCountFunction)();
+
+static BenchmarkAllocationCountFunction GetAllocationCounter()
+{
+#ifdef __linux__
+    return((BenchmarkAllocationCountFunction)dlsym(RTLD_DEFAULT, "openrgb_benchmark_allocation_count"));
+#else
+    return(NULL);
+#endif
+}
+
+/*---------------------------------------------------------*\
+| CPU time and context switches of the whole process        |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    double                  cpu_seconds;
+    long long               context_switches;   /* -1 if unknown            */
+} BenchmarkUsage;
+
+static BenchmarkUsage GetProcessUsage()
+{
+    BenchmarkUsage usage;
+
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+
+    GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time);
+
+    ULARGE_INTEGER kernel_100ns;
+    ULARGE_INTEGER user_100ns;
+
+    kernel_100ns.LowPart    = kernel_time.dwLowDateTime;
+    kernel_100ns.HighPart   = kernel_time.dwHighDateTime;
+    user_100ns.LowPart      = user_time.dwLowDateTime;
+    user_100ns.HighPart     = user_time.dwHighDateTime;
+
+    usage.cpu_seconds       = (double)(kernel_100ns.QuadPart + user_100ns.QuadPart) / 10000000.0;
+    usage.context_switches  = -1;
+#else
+    struct rusage process_usage;
+
+    getrusage(RUSAGE_SELF, &process_usage);
+
+    usage.cpu_seconds       = process_usage.ru_utime.tv_sec + process_usage.ru_utime.tv_usec / 1000000.0
+                            + process_usage.ru_stime.tv_sec + process_usage.ru_stime.tv_usec / 1000000.0;
+    usage.context_switches  = process_usage.ru_nvcsw + process_usage.ru_nivcsw;
+#endif
+
+    return(usage);
+}
+
+/*---------------------------------------------------------*\
+| Print the CPU use and wakeups of the process while it     |
+| sits idle for BENCHMARK_IDLE_TIME                         |
+\*---------------------------------------------------------*/
+static void PrintIdleUsage(const char* label)
+{
+    BenchmarkUsage                          start_usage = GetProcessUsage();
+    std::chrono::steady_clock::time_point   start_time  = std::chrono::steady_clock::now();
+
+    std::this_thread::sleep_for(BENCHMARK_IDLE_TIME);
+
+    BenchmarkUsage                          end_usage   = GetProcessUsage();
+    double                                  seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::cout << "  " << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << ((end_usage.cpu_seconds - start_usage.cpu_seconds) * 100.0 / seconds) << " % CPU";
+
+    if(start_usage.context_switches >= 0)
+    {
+        std::cout << std::setw(12) << (long long)((end_usage.context_switches - start_usage.context_switches) / seconds) << " wakeups/s";
+    }
+
+    std::cout << std::endl;
+}
+
+/*---------------------------------------------------------*\
+| Print the average, median, 99th percentile and worst of a |
+| set of latency samples                                    |
+\*---------------------------------------------------------*/
+static void PrintLatencies(const char* label, std::vector<double>& samples_us)
+{
+    std::cout << "  " << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1);
+
+    if(samples_us.empty())
+    {
+        std::cout << "          no samples" << std::endl;
+        return;
+    }
+
+    std::sort(samples_us.begin(), samples_us.end());
+
+    double total_us = 0.0;
+
+    for(double sample_us : samples_us)
+    {
+        total_us += sample_us;
+    }
+
+    std::cout << std::setw(10) << (total_us / samples_us.size())              << " us avg"
+              << std::setw(10) << samples_us[samples_us.size() / 2]           << " us p50"
+              << std::setw(10) << samples_us[(samples_us.size() * 99) / 100]  << " us p99"
+              << std::setw(10) << samples_us.back()                           << " us max" << std::endl;
+}
+
+/*---------------------------------------------------------*\
+| Call UpdateLEDs() and wait until the device has sent the  |
+| frame.  Returns the latency in microseconds, or a         |
+| negative value if the frame was not sent in time.         |
+\*---------------------------------------------------------*/
+static double TimeUpdateLEDs(RGBController* controller)
+{
+    unsigned long long                      sent_count  = controller->GetFrameCounters().sent;
+    std::chrono::steady_clock::time_point   start_time  = std::chrono::steady_clock::now();
+
+    controller->UpdateLEDs();
+
+    while(controller->GetFrameCounters().sent == sent_count)
+    {
+        if((std::chrono::steady_clock::now() - start_time) > BENCHMARK_FRAME_TIMEOUT)
+        {
+            return(-1.0);
+        }
+
+        std::this_thread::yield();
+    }
+
+    return(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count());
+}
+
+/*---------------------------------------------------------*\
+| Create a dummy controller with a single Direct mode and   |
+| one linear zone of led_count LEDs                         |
+\*---------------------------------------------------------*/
+static RGBController* CreateBenchmarkController(const std::string& name, unsigned int led_count)
+{
+    RGBController_Dummy* controller = new RGBController_Dummy();
+
+    controller->name                = name;
+    controller->type                = DEVICE_TYPE_LEDSTRIP;
+
+    mode Direct;
+    Direct.name                     = "Direct";
+    Direct.value                    = 0;
+    Direct.flags                    = MODE_FLAG_HAS_PER_LED_COLOR;
+    Direct.color_mode               = MODE_COLORS_PER_LED;
+    controller->modes.push_back(Direct);
+
+    zone benchmark_zone;
+    benchmark_zone.name             = "Benchmark Zone";
+    benchmark_zone.type             = ZONE_TYPE_LINEAR;
+    benchmark_zone.leds_min         = led_count;
+    benchmark_zone.leds_max         = led_count;
+    benchmark_zone.leds_count       = led_count;
+    benchmark_zone.matrix_map       = NULL;
+    controller->zones.push_back(benchmark_zone);
+
+    for(unsigned int led_idx = 0; led_idx < led_count; led_idx++)
+    {
+        led new_led;
+        new_led.name                = "LED " + std::to_string(led_idx + 1);
+        new_led.value               = led_idx;
+        controller->leds.push_back(new_led);
+    }
+
+    controller->SetupColors();
+
+    return(controller);
+}
+
+/*---------------------------------------------------------*\
+| Start an SDK server on the loopback interface, trying a   |
+| few ports in case one is already in use                   |
+\*---------------------------------------------------------*/
+static NetworkServer* StartBenchmarkServer(std::vector<RGBController*>& controllers, bool event_loop)
+{
+    NetworkServer* server = new NetworkServer(controllers);
+
+    server->SetHost(BENCHMARK_SERVER_HOST);
+    server->SetEventLoopEnable(event_loop);
+
+    for(unsigned int attempt = 0; attempt < BENCHMARK_SERVER_PORT_ATTEMPTS; attempt++)
+    {
+        server->SetPort(BENCHMARK_SERVER_PORT + attempt);
+        server->StartServer();
+
+        /*-------------------------------------------------*\
+        | The listen socket is opened on the server thread  |
+        \*-------------------------------------------------*/
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        while(server->GetOnline() && !server->GetListening()
+           && ((std::chrono::steady_clock::now() - start_time) < BENCHMARK_FRAME_TIMEOUT))
+        {
+            std::this_thread::yield();
+        }
+
+        if(server->GetListening())
+        {
+            return(server);
+        }
+
+        server->StopServer();
+    }
+
+    delete server;
+
+    return(NULL);
+}
+
+/*---------------------------------------------------------*\
+| Connect a raw SDK client to the benchmark server          |
+\*---------------------------------------------------------*/
+static bool ConnectBenchmarkClient(net_port& port, NetworkServer* server)
+{
+    std::string port_str = std::to_string(server->GetPort());
+
+    return(port.tcp_client(BENCHMARK_SERVER_HOST, port_str.c_str()) && port.tcp_client_connect());
+}
+
+/*---------------------------------------------------------*\
+| Receive exactly length bytes from a raw SDK client        |
+\*---------------------------------------------------------*/
+static bool ReceiveBenchmarkClient(net_port& port, char* buffer, int length)
+{
+    int received = 0;
+
+    while(received < length)
+    {
+        if(!port.wait_readable((int)std::chrono::duration_cast<std::chrono::milliseconds>(BENCHMARK_FRAME_TIMEOUT).count()))
+        {
+            return(false);
+        }
+
+        int ret = port.tcp_listen(buffer + received, length - received);
+
+        if(ret <= 0)
+        {
+            return(false);
+        }
+
+        received += ret;
+    }
+
+    return(true);
+}
+
+/*---------------------------------------------------------*\
+| Build a complete UPDATELEDS packet, header and color      |
+| description, for the controller at dev_idx                |
+\*---------------------------------------------------------*/
+static std::vector<char> BuildUpdateLEDsPacket(RGBController* controller, unsigned int dev_idx)
+{
+    unsigned char*      description = controller->GetColorDescription();
+    unsigned int        size;
+    NetPacketHeader     header;
+
+    memcpy(&size, description, sizeof(size));
+
+    InitNetPacketHeader(&header, dev_idx, NET_PACKET_ID_RGBCONTROLLER_UPDATELEDS, size);
+
+    std::vector<char>   packet(sizeof(header) + size);
+
+    memcpy(packet.data(), &header, sizeof(header));
+    memcpy(packet.data() + sizeof(header), description, size);
+
+    delete[] description;
+
+    return(packet);
+}
+
+/*---------------------------------------------------------*\
+| Wait until the submitted frame counters of the given      |
+| controllers add up to target.  Returns false on timeout.  |
+\*---------------------------------------------------------*/
+static bool WaitForSubmitted(std::vector<RGBController*>& controllers, unsigned long long target, std::chrono::steady_clock::duration timeout)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    while(true)
+    {
+        unsigned long long submitted = 0;
+
+        for(RGBController* controller : controllers)
+        {
+            submitted += controller->GetFrameCounters().submitted;
+        }
+
+        if(submitted >= target)
+        {
+            return(true);
+        }
+
+        if((std::chrono::steady_clock::now() - start_time) > timeout)
+        {
+            return(false);
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+/*---------------------------------------------------------*\
+| update-threads                                            |
+|   Idle cost and update latency of dummy controllers, on   |
+|   their own device call threads and on the update pool    |
+\*---------------------------------------------------------*/
+static void BenchmarkUpdateThreads(unsigned int frames)
+{
+    std::cout << "Device update threads (" << BENCHMARK_DUMMY_CONTROLLERS << " dummy controllers, " << frames << " frames each):" << std::endl;
+
+    PrintIdleUsage("Idle, no dummy controllers");
+
+    std::vector<RGBController*> controllers;
+
+    for(unsigned int controller_idx = 0; controller_idx < BENCHMARK_DUMMY_CONTROLLERS; controller_idx++)
+    {
+        RGBController_Dummy* controller = new RGBController_Dummy();
+
+        controller->name = "Benchmark Dummy " + std::to_string(controller_idx);
+
+        controllers.push_back(controller);
+    }
+
+    DeviceUpdatePool*   update_pool = ResourceManager::get()->GetDeviceUpdatePool();
+    unsigned int        pass_count  = (update_pool != NULL) ? 2 : 1;
+
+    for(unsigned int pass = 0; pass < pass_count; pass++)
+    {
+        const char* idle_label      = (pass == 0) ? "Idle, own device call threads"     : "Idle, device update pool";
+        const char* latency_label   = (pass == 0) ? "UpdateLEDs, own device call threads" : "UpdateLEDs, device update pool";
+
+        if(pass == 1)
+        {
+            for(RGBController* controller : controllers)
+            {
+                controller->SetUpdateDispatcher(update_pool);
+            }
+        }
+
+        PrintIdleUsage(idle_label);
+
+        std::vector<double> samples_us;
+
+        for(unsigned int frame = 0; frame < frames; frame++)
+        {
+            for(RGBController* controller : controllers)
+            {
+                double latency_us = TimeUpdateLEDs(controller);
+
+                if(latency_us >= 0.0)
+                {
+                    samples_us.push_back(latency_us);
+                }
+            }
+        }
+
+        PrintLatencies(latency_label, samples_us);
+    }
+
+    for(RGBController* controller : controllers)
+    {
+        delete controller;
+    }
+}
+
+/*---------------------------------------------------------*\
+| server                                                    |
+|   Loopback load on the SDK server.  Several raw clients   |
+|   each stream UPDATELEDS packets to their own controller  |
+|   to measure throughput, then a single client sends one   |
+|   packet at a time to measure latency.  Runs once with a  |
+|   thread per client and once with the event loop.         |
+\*---------------------------------------------------------*/
+static void BenchmarkServer(unsigned int frames)
+{
+    std::cout << "SDK server (" << BENCHMARK_SERVER_CLIENTS << " clients, " << BENCHMARK_SERVER_LEDS << " LEDs, " << frames << " frames each):" << std::endl;
+
+    std::vector<RGBController*> controllers;
+
+    for(unsigned int controller_idx = 0; controller_idx < BENCHMARK_SERVER_CLIENTS; controller_idx++)
+    {
+        controllers.push_back(CreateBenchmarkController("Benchmark Dummy " + std::to_string(controller_idx), BENCHMARK_SERVER_LEDS));
+    }
+
+#ifdef __linux__
+    unsigned int mode_count = 2;
+#else
+    unsigned int mode_count = 1;
+#endif
+
+    for(unsigned int mode_idx = 0; mode_idx < mode_count; mode_idx++)
+    {
+        bool            event_loop  = (mode_idx == 1);
+        std::string     mode_name   = event_loop ? "event loop" : "thread per client";
+        NetworkServer*  server      = StartBenchmarkServer(controllers, event_loop);
+
+        if(server == NULL)
+        {
+            std::cout << "  Unable to start server" << std::endl;
+            break;
+        }
+
+        /*-------------------------------------------------*\
+        | Connect all clients before measuring              |
+        \*-------------------------------------------------*/
+        std::vector<net_port*>          ports;
+        std::vector<std::vector<char>>  packets;
+        bool                            connected = true;
+
+        for(unsigned int client_idx = 0; client_idx < BENCHMARK_SERVER_CLIENTS; client_idx++)
+        {
+            net_port* port = new net_port();
+
+            connected = connected && ConnectBenchmarkClient(*port, server);
+
+            ports.push_back(port);
+            packets.push_back(BuildUpdateLEDsPacket(controllers[client_idx], client_idx));
+        }
+
+        while(connected && (server->GetNumClients() < BENCHMARK_SERVER_CLIENTS))
+        {
+            std::this_thread::yield();
+        }
+
+        if(connected)
+        {
+            /*---------------------------------------------*\
+            | Throughput, all clients streaming at once     |
+            \*---------------------------------------------*/
+            unsigned long long submitted_start = 0;
+
+            for(RGBController* controller : controllers)
+            {
+                submitted_start += controller->GetFrameCounters().submitted;
+            }
+
+            std::chrono::steady_clock::time_point   start_time = std::chrono::steady_clock::now();
+            std::vector<std::thread>                client_threads;
+
+            for(unsigned int client_idx = 0; client_idx < BENCHMARK_SERVER_CLIENTS; client_idx++)
+            {
+                client_threads.emplace_back([&ports, &packets, client_idx, frames]()
+                {
+                    for(unsigned int frame = 0; frame < frames; frame++)
+                    {
+                        ports[client_idx]->tcp_client_write(packets[client_idx].data(), (int)packets[client_idx].size());
+                    }
+                });
+            }
+
+            for(std::thread& client_thread : client_threads)
+            {
+                client_thread.join();
+            }
+
+            unsigned long long  total   = (unsigned long long)BENCHMARK_SERVER_CLIENTS * frames;
+            bool                done    = WaitForSubmitted(controllers, submitted_start + total, BENCHMARK_FRAME_TIMEOUT);
+            double              seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+            std::cout << "  " << std::left << std::setw(44) << ("UPDATELEDS throughput, " + mode_name) << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(10) << (total / seconds) << " packets/s" << (done ? "" : " (timed out)") << std::endl;
+
+            /*---------------------------------------------*\
+            | Latency, one packet in flight at a time       |
+            \*---------------------------------------------*/
+            std::vector<RGBController*> latency_controller  = { controllers[0] };
+            std::vector<double>         samples_us;
+
+            for(unsigned int frame = 0; frame < frames; frame++)
+            {
+                unsigned long long                      submitted   = controllers[0]->GetFrameCounters().submitted;
+                std::chrono::steady_clock::time_point   send_time   = std::chrono::steady_clock::now();
+
+                ports[0]->tcp_client_write(packets[0].data(), (int)packets[0].size());
+
+                if(!WaitForSubmitted(latency_controller, submitted + 1, BENCHMARK_FRAME_TIMEOUT))
+                {
+                    break;
+                }
+
+                samples_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - send_time).count());
+            }
+
+            PrintLatencies(("UPDATELEDS latency, " + mode_name).c_str(), samples_us);
+        }
+        else
+        {
+            std::cout << "  Unable to connect clients" << std::endl;
+        }
+
+        for(net_port* port : ports)
+        {
+            port->tcp_close();
+            delete port;
+        }
+
+        server->StopServer();
+        delete server;
+    }
+
+    for(RGBController* controller : controllers)
+    {
+        delete controller;
+    }
+}
+
+/*---------------------------------------------------------*\
+| server-allocations                                        |
+|   Heap allocations per UPDATELEDS packet received by the  |
+|   SDK server for a 1000 LED controller, counted once the  |
+|   connection buffers have warmed up                       |
+\*---------------------------------------------------------*/
+static void BenchmarkServerAllocations(unsigned int frames)
+{
+    std::cout << "SDK server allocations (" << BENCHMARK_ALLOCATION_LEDS << " LEDs, " << frames << " frames):" << std::endl;
+
+    BenchmarkAllocationCountFunction allocation_count = GetAllocationCounter();
+
+    if(allocation_count == NULL)
+    {
+        std::cout << "  Needs the allocation counter, see scripts/benchmark-allocation-counter.c" << std::endl;
+        return;
+    }
+
+    std::vector<RGBController*> controllers = { CreateBenchmarkController("Benchmark Dummy", BENCHMARK_ALLOCATION_LEDS) };
+
+#ifdef __linux__
+    unsigned int mode_count = 2;
+#else
+    unsigned int mode_count = 1;
+#endif
+
+    for(unsigned int mode_idx = 0; mode_idx < mode_count; mode_idx++)
+    {
+        bool            event_loop  = (mode_idx == 1);
+        std::string     mode_name   = event_loop ? "event loop" : "thread per client";
+        NetworkServer*  server      = StartBenchmarkServer(controllers, event_loop);
+
+        if(server == NULL)
+        {
+            std::cout << "  Unable to start server" << std::endl;
+            break;
+        }
+
+        net_port            port;
+        std::vector<char>   packet  = BuildUpdateLEDsPacket(controllers[0], 0);
+
+        if(ConnectBenchmarkClient(port, server))
+        {
+            unsigned long long  submitted   = controllers[0]->GetFrameCounters().submitted;
+            bool                done        = true;
+
+            /*---------------------------------------------*\
+            | Let the connection size its buffers first     |
+            \*---------------------------------------------*/
+            for(unsigned int frame = 0; done && (frame < BENCHMARK_ALLOCATION_WARMUP); frame++)
+            {
+                port.tcp_client_write(packet.data(), (int)packet.size());
+
+                done = WaitForSubmitted(controllers, ++submitted, BENCHMARK_FRAME_TIMEOUT);
+            }
+
+            /*---------------------------------------------*\
+            | Only count between packets being sent and     |
+            | their UpdateLEDs() calls, one at a time       |
+            \*---------------------------------------------*/
+            unsigned long long  allocations = 0;
+            unsigned int        packets     = 0;
+
+            for(; done && (packets < frames); packets++)
+            {
+                unsigned long long start_count = allocation_count();
+
+                port.tcp_client_write(packet.data(), (int)packet.size());
+
+                done = WaitForSubmitted(controllers, ++submitted, BENCHMARK_FRAME_TIMEOUT);
+
+                allocations += allocation_count() - start_count;
+            }
+
+            std::cout << "  " << std::left << std::setw(44) << ("UPDATELEDS allocations, " + mode_name) << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(10) << ((packets > 0) ? ((double)allocations / packets) : 0.0) << " per packet" << (done ? "" : " (timed out)") << std::endl;
+
+            port.tcp_close();
+        }
+        else
+        {
+            std::cout << "  Unable to connect client" << std::endl;
+        }
+
+        server->StopServer();
+        delete server;
+    }
+
+    delete controllers[0];
+}
+
+/*---------------------------------------------------------*\
+| delta                                                     |
+|   Bytes per frame and encode plus apply time of full and  |
+|   delta color updates on a 2000 LED controller, with a    |
+|   growing share of the LEDs changing every frame          |
+\*---------------------------------------------------------*/
+static void BenchmarkDelta(unsigned int frames)
+{
+    std::cout << "Delta color updates (" << BENCHMARK_DELTA_LEDS << " LEDs, " << frames << " frames):" << std::endl;
+
+    RGBController*      source          = CreateBenchmarkController("Benchmark Source", BENCHMARK_DELTA_LEDS);
+    RGBController*      target          = CreateBenchmarkController("Benchmark Target", BENCHMARK_DELTA_LEDS);
+    const unsigned int  changed_counts[]= { 20, 200, BENCHMARK_DELTA_LEDS };
+    std::mt19937        random(6742);
+
+    for(unsigned int changed_count : changed_counts)
+    {
+        for(unsigned int delta = 0; delta < 2; delta++)
+        {
+            std::vector<RGBColor>   reference   = source->colors;
+            unsigned long long      total_bytes = 0;
+            double                  total_us    = 0.0;
+
+            target->colors = source->colors;
+
+            for(unsigned int frame = 0; frame < frames; frame++)
+            {
+                for(unsigned int change_idx = 0; change_idx < changed_count; change_idx++)
+                {
+                    unsigned int led_idx = (changed_count == BENCHMARK_DELTA_LEDS) ? change_idx : (random() % BENCHMARK_DELTA_LEDS);
+
+                    source->colors[led_idx] = (RGBColor)(random() & 0x00FFFFFF);
+                }
+
+                /*-----------------------------------------*\
+                | Time the sender encoding the frame and    |
+                | the receiver applying it                  |
+                \*-----------------------------------------*/
+                std::chrono::steady_clock::time_point   start_time  = std::chrono::steady_clock::now();
+                unsigned char*                          data        = delta ? source->GetColorDeltaDescription(reference) : source->GetColorDescription();
+                unsigned int                            size;
+
+                memcpy(&size, data, sizeof(size));
+
+                if(delta)
+                {
+                    target->SetColorDeltaDescription(data, size);
+                }
+                else
+                {
+                    target->SetColorDescription(data, size);
+                }
+
+                total_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count();
+
+                delete[] data;
+
+                reference    = source->colors;
+                total_bytes += sizeof(NetPacketHeader) + size;
+            }
+
+            std::string label = std::string(delta ? "Delta" : "Full") + ", " + std::to_string(changed_count) + " LEDs changed"
+                              + ((target->colors == source->colors) ? "" : " (MISMATCH)");
+
+            std::cout << "  " << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << ((double)total_bytes / frames) << " B/frame"
+                      << std::setw(10) << (total_us / frames) << " us/frame" << std::endl;
+        }
+    }
+
+    delete source;
+    delete target;
+}
+
+/*---------------------------------------------------------*\
+| shared-memory                                             |
+|   Latency from a local client writing a 2000 LED frame    |
+|   until the server calls UpdateLEDs(), over loopback TCP  |
+|   and over the shared memory color ring                   |
+\*---------------------------------------------------------*/
+static void BenchmarkSharedMemory(unsigned int frames)
+{
+    std::cout << "Shared memory transport (" << BENCHMARK_SHM_LEDS << " LEDs, " << frames << " frames):" << std::endl;
+
+    std::vector<RGBController*> controllers = { CreateBenchmarkController("Benchmark Dummy", BENCHMARK_SHM_LEDS) };
+    NetworkServer*              server      = StartBenchmarkServer(controllers, false);
+    net_port                    port;
+
+    if(server == NULL)
+    {
+        std::cout << "  Unable to start server" << std::endl;
+    }
+    else if(!ConnectBenchmarkClient(port, server))
+    {
+        std::cout << "  Unable to connect client" << std::endl;
+    }
+    else
+    {
+        /*-------------------------------------------------*\
+        | Loopback TCP, one UPDATELEDS packet at a time     |
+        \*-------------------------------------------------*/
+        std::vector<char>   packet      = BuildUpdateLEDsPacket(controllers[0], 0);
+        unsigned long long  submitted   = controllers[0]->GetFrameCounters().submitted;
+        std::vector<double> samples_us;
+
+        for(unsigned int frame = 0; frame < frames; frame++)
+        {
+            std::chrono::steady_clock::time_point send_time = std::chrono::steady_clock::now();
+
+            port.tcp_client_write(packet.data(), (int)packet.size());
+
+            if(!WaitForSubmitted(controllers, ++submitted, BENCHMARK_FRAME_TIMEOUT))
+            {
+                break;
+            }
+
+            samples_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - send_time).count());
+        }
+
+        PrintLatencies("UpdateLEDs latency, loopback TCP", samples_us);
+
+        /*-------------------------------------------------*\
+        | Shared memory ring, one frame at a time           |
+        \*-------------------------------------------------*/
+        server->SetSharedMemoryEnable(true);
+
+        NetPacketHeader request_hdr;
+        NetPacketHeader reply_hdr;
+        char            reply_data[sizeof(unsigned int) + sizeof(unsigned int) + sizeof(unsigned short) + 256];
+        unsigned int    ring_colors = 0;
+        unsigned short  name_len    = 0;
+
+        InitNetPacketHeader(&request_hdr, 0, NET_PACKET_ID_REQUEST_SHARED_MEMORY, 0);
+
+        port.tcp_client_write((char *)&request_hdr, sizeof(request_hdr));
+
+        if(NetworkSharedColorRing::IsSupported()
+        && ReceiveBenchmarkClient(port, (char *)&reply_hdr, sizeof(reply_hdr))
+        && (reply_hdr.pkt_size <= sizeof(reply_data))
+        && ReceiveBenchmarkClient(port, reply_data, reply_hdr.pkt_size))
+        {
+            memcpy(&ring_colors, &reply_data[sizeof(unsigned int)], sizeof(ring_colors));
+            memcpy(&name_len, &reply_data[sizeof(unsigned int) + sizeof(unsigned int)], sizeof(name_len));
+        }
+
+        NetworkSharedColorRing ring;
+
+        if((ring_colors == BENCHMARK_SHM_LEDS)
+        && ring.Open(std::string(&reply_data[sizeof(unsigned int) + sizeof(unsigned int) + sizeof(unsigned short)], name_len), ring_colors))
+        {
+            samples_us.clear();
+
+            for(unsigned int frame = 0; frame < frames; frame++)
+            {
+                std::chrono::steady_clock::time_point send_time = std::chrono::steady_clock::now();
+
+                ring.WriteFrame(controllers[0]->colors.data(), ring_colors);
+
+                if(!WaitForSubmitted(controllers, ++submitted, BENCHMARK_FRAME_TIMEOUT))
+                {
+                    break;
+                }
+
+                samples_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - send_time).count());
+            }
+
+            PrintLatencies("UpdateLEDs latency, shared memory", samples_us);
+
+            ring.Close();
+        }
+        else
+        {
+            std::cout << "  Shared memory is not available on this platform" << std::endl;
+        }
+
+        port.tcp_close();
+    }
+
+    if(server != NULL)
+    {
+        server->StopServer();
+        delete server;
+    }
+
+    delete controllers[0];
+}
+
+/*---------------------------------------------------------*\
+| detection-cache                                           |
+|   Startup detection time with the detection cache, from   |
+|   the start of detection until the devices found last     |
+|   time are available and until all detectors are done,    |
+|   compared to a full detection without a cache.  Frames   |
+|   is the number of runs, at most BENCHMARK_DETECTION_RUNS |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    std::mutex              mutex;
+    std::condition_variable cv;
+    std::vector<int>        phases;
+} BenchmarkDetectionEnds;
+
+static void BenchmarkDetectionEndCallback(void* arg)
+{
+    BenchmarkDetectionEnds* ends = (BenchmarkDetectionEnds*)arg;
+
+    /*-----------------------------------------------------*\
+    | The phase is still DETECTION_PHASE_REMAINING at the   |
+    | end of a cached pass that has a second pass queued    |
+    \*-----------------------------------------------------*/
+    std::lock_guard<std::mutex> lock(ends->mutex);
+
+    ends->phases.push_back(ResourceManager::get()->GetDetectionPhase());
+    ends->cv.notify_all();
+}
+
+static double WaitForDetectionEnd(BenchmarkDetectionEnds& ends, std::size_t count, std::chrono::steady_clock::time_point start_time)
+{
+    std::unique_lock<std::mutex> lock(ends.mutex);
+
+    ends.cv.wait(lock, [&ends, count](){ return(ends.phases.size() >= count); });
+
+    return(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
+}
+
+static void BenchmarkDetectionCache(unsigned int frames)
+{
+    ResourceManager*    resource_manager    = ResourceManager::get();
+    unsigned int        runs                = std::max(1u, std::min(frames, (unsigned int)BENCHMARK_DETECTION_RUNS));
+
+    std::cout << "Detection cache (" << runs << " runs):" << std::endl;
+
+    if(!resource_manager->GetDetectionEnabled())
+    {
+        std::cout << "  Detection is disabled" << std::endl;
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Turn the detection cache on for the benchmark only    |
+    \*-----------------------------------------------------*/
+    SettingsManager*    settings_manager    = resource_manager->GetSettingsManager();
+    json                detector_settings   = settings_manager->GetSettings("Detectors");
+    json                benchmark_settings  = detector_settings;
+
+    benchmark_settings["detection_cache"]   = true;
+
+    settings_manager->SetSettings("Detectors", benchmark_settings);
+
+    BenchmarkDetectionEnds  ends;
+    double                  full_ms         = 0.0;
+    double                  ready_ms        = 0.0;
+    double                  cached_ms       = 0.0;
+    unsigned int            cached_runs     = 0;
+
+    resource_manager->RegisterDetectionEndCallback(BenchmarkDetectionEndCallback, &ends);
+
+    for(unsigned int run = 0; run < runs; run++)
+    {
+        /*-------------------------------------------------*\
+        | Full detection, records a new cache               |
+        \*-------------------------------------------------*/
+        resource_manager->ResetDetectionCache(true);
+
+        {
+            std::lock_guard<std::mutex> lock(ends.mutex);
+            ends.phases.clear();
+        }
+
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        resource_manager->DetectDevices();
+
+        full_ms += WaitForDetectionEnd(ends, 1, start_time);
+
+        resource_manager->WaitForDeviceDetection();
+
+        /*-------------------------------------------------*\
+        | Cached detection, the devices are available after |
+        | the first pass and the remaining detectors run in |
+        | a second one                                      |
+        \*-------------------------------------------------*/
+        resource_manager->ResetDetectionCache(false);
+
+        {
+            std::lock_guard<std::mutex> lock(ends.mutex);
+            ends.phases.clear();
+        }
+
+        start_time = std::chrono::steady_clock::now();
+
+        resource_manager->DetectDevices();
+
+        double  first_ms    = WaitForDetectionEnd(ends, 1, start_time);
+        int     first_phase;
+
+        {
+            std::lock_guard<std::mutex> lock(ends.mutex);
+            first_phase = ends.phases[0];
+        }
+
+        if(first_phase == DETECTION_PHASE_REMAINING)
+        {
+            ready_ms  += first_ms;
+            cached_ms += WaitForDetectionEnd(ends, 2, start_time);
+            cached_runs++;
+        }
+
+        resource_manager->WaitForDeviceDetection();
+    }
+
+    resource_manager->UnregisterDetectionEndCallback(BenchmarkDetectionEndCallback, &ends);
+
+    settings_manager->SetSettings("Detectors", detector_settings);
+
+    std::cout << "  " << std::left << std::setw(44) << "Full detection" << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << (full_ms / runs) << " ms" << std::endl;
+
+    if(cached_runs == 0)
+    {
+        std::cout << "  Cached detection did not run, no detector found any devices" << std::endl;
+        return;
+    }
+
+    std::cout << "  " << std::left << std::setw(44) << "Cached detection, devices available" << std::right
+              << std::setw(10) << (ready_ms / cached_runs) << " ms" << std::endl;
+    std::cout << "  " << std::left << std::setw(44) << "Cached detection, all detectors done" << std::right
+              << std::setw(10) << (cached_ms / cached_runs) << " ms" << std::endl;
+}
+
+/*---------------------------------------------------------*\
+| smbus-batch                                               |
+|   Bus thread hand-offs, transfers and time per frame of   |
+|   an ENE direct color frame written to the simulated      |
+|   SMBus, one register write at a time and as a batch.  On |
+|   Linux also the ioctls per frame of the detected         |
+|   controllers on each i2c-dev bus.                        |
+\*---------------------------------------------------------*/
+static void BenchmarkSMBusBatch(unsigned int frames)
+{
+    std::cout << "SMBus batching (ENE, " << BENCHMARK_SMBUS_LEDS << " LEDs, " << frames << " frames):" << std::endl;
+
+    i2c_smbus_debug                 bus;
+    ENESMBusInterface_i2c_smbus     interface(&bus);
+    unsigned char                   color_buf[BENCHMARK_SMBUS_LEDS * 3];
+
+    bus.AddDevice(BENCHMARK_SMBUS_ADDRESS, I2C_SMBUS_DEBUG_DEVICE_ENE, std::map<unsigned int, u8>());
+
+    for(unsigned int batched = 0; batched < 2; batched++)
+    {
+        unsigned long long                      start_handoffs  = bus.i2c_smbus_get_handoff_count();
+        unsigned long long                      start_xfers     = bus.i2c_smbus_debug_get_xfer_count();
+        std::chrono::steady_clock::time_point   start_time      = std::chrono::steady_clock::now();
+
+        for(unsigned int frame = 0; frame < frames; frame++)
+        {
+            memset(color_buf, frame & 0xFF, sizeof(color_buf));
+
+            /*---------------------------------------------*\
+            | Same writes as ENESMBusController's direct    |
+            | mode frame                                    |
+            \*---------------------------------------------*/
+            if(batched)
+            {
+                interface.BeginBatch();
+            }
+
+            for(unsigned int bytes_sent = 0; bytes_sent < sizeof(color_buf); bytes_sent += interface.GetMaxBlock())
+            {
+                unsigned int bytes_to_send = std::min((unsigned int)interface.GetMaxBlock(), (unsigned int)sizeof(color_buf) - bytes_sent);
+
+                interface.ENERegisterWriteBlock(BENCHMARK_SMBUS_ADDRESS, ENE_REG_COLORS_DIRECT_V2 + bytes_sent, &color_buf[bytes_sent], (unsigned char)bytes_to_send);
+            }
+
+            if(batched)
+            {
+                interface.EndBatch();
+            }
+        }
+
+        double              seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        unsigned long long  handoffs    = bus.i2c_smbus_get_handoff_count() - start_handoffs;
+        unsigned long long  xfers       = bus.i2c_smbus_debug_get_xfer_count() - start_xfers;
+
+        std::cout << "  " << std::left << std::setw(44) << (batched ? "Direct frame, batched" : "Direct frame, one transfer per call") << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << ((double)handoffs / frames) << " hand-offs"
+                  << std::setw(10) << ((double)xfers / frames) << " transfers"
+                  << std::setw(10) << (seconds * 1000000.0 / frames) << " us/frame" << std::endl;
+    }
+
+#ifdef __linux__
+    /*-----------------------------------------------------*\
+    | A frame updates every controller on the bus once, the |
+    | controllers are matched by their "I2C: <bus>"         |
+    | location                                              |
+    \*-----------------------------------------------------*/
+    std::vector<i2c_smbus_interface*>&  busses      = ResourceManager::get()->GetI2CBusses();
+    std::vector<RGBController*>&        controllers = ResourceManager::get()->GetRGBControllers();
+    unsigned int                        bus_count   = 0;
+
+    for(i2c_smbus_interface* bus : busses)
+    {
+        i2c_smbus_linux* linux_bus = dynamic_cast<i2c_smbus_linux*>(bus);
+
+        if(linux_bus == NULL)
+        {
+            continue;
+        }
+
+        std::string                 location = "I2C: " + std::string(bus->device_name);
+        std::vector<RGBController*> bus_controllers;
+
+        for(RGBController* controller : controllers)
+        {
+            if((controller->flags & CONTROLLER_FLAG_LOCAL)
+            && (controller->location.compare(0, location.size(), location) == 0)
+            && ((controller->location.size() == location.size()) || (controller->location[location.size()] == ',')))
+            {
+                bus_controllers.push_back(controller);
+            }
+        }
+
+        if(bus_controllers.empty())
+        {
+            continue;
+        }
+
+        unsigned long long                      start_ioctls    = linux_bus->i2c_smbus_linux_get_ioctl_count();
+        bool                                    done            = true;
+        std::chrono::steady_clock::time_point   start_time      = std::chrono::steady_clock::now();
+
+        for(unsigned int frame = 0; frame < frames; frame++)
+        {
+            for(RGBController* controller : bus_controllers)
+            {
+                if(TimeUpdateLEDs(controller) < 0.0)
+                {
+                    done = false;
+                }
+            }
+        }
+
+        double              seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        unsigned long long  ioctls  = linux_bus->i2c_smbus_linux_get_ioctl_count() - start_ioctls;
+
+        std::cout << "  " << std::left << std::setw(44) << location.substr(0, 44) << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << ((double)ioctls / frames) << " ioctls"
+                  << std::setw(10) << bus_controllers.size() << " devices"
+                  << std::setw(10) << (seconds * 1000000.0 / frames) << " us/frame" << (done ? "" : " (timed out)") << std::endl;
+
+        bus_count++;
+    }
+
+    if(bus_count == 0)
+    {
+        std::cout << "  No detected controllers on Linux i2c-dev busses" << std::endl;
+    }
+#endif
+}
+
+/*---------------------------------------------------------*\
+| Local UDP receiver counting the datagrams and bytes sent  |
+| to a port on the loopback interface                       |
+\*---------------------------------------------------------*/
+class BenchmarkUDPReceiver
+{
+public:
+    BenchmarkUDPReceiver()
+    {
+        sock        = INVALID_SOCKET;
+        running     = false;
+        datagrams   = 0;
+        bytes       = 0;
+    }
+
+    ~BenchmarkUDPReceiver()
+    {
+        Stop();
+    }
+
+    bool Start(unsigned short port)
+    {
+        sockaddr_in address = {};
+
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = inet_addr(BENCHMARK_UDP_HOST);
+        address.sin_port        = htons(port);
+
+        sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+        if(sock == INVALID_SOCKET)
+        {
+            return(false);
+        }
+
+        int receive_buffer = BENCHMARK_UDP_RECEIVE_BUFFER;
+
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char *)&receive_buffer, sizeof(receive_buffer));
+
+        if(bind(sock, (sockaddr *)&address, sizeof(address)) == SOCKET_ERROR)
+        {
+            closesocket(sock);
+            sock = INVALID_SOCKET;
+            return(false);
+        }
+
+        running         = true;
+        receive_thread  = std::thread(&BenchmarkUDPReceiver::ReceiveThreadFunction, this);
+
+        return(true);
+    }
+
+    void Stop()
+    {
+        if(sock == INVALID_SOCKET)
+        {
+            return;
+        }
+
+        running = false;
+        receive_thread.join();
+
+        closesocket(sock);
+        sock = INVALID_SOCKET;
+    }
+
+    std::atomic<unsigned long long> datagrams;
+    std::atomic<unsigned long long> bytes;
+
+private:
+    SOCKET              sock;
+    std::atomic<bool>   running;
+    std::thread         receive_thread;
+
+    void ReceiveThreadFunction()
+    {
+        char buffer[2048];
+
+        while(running)
+        {
+            fd_set  read_set;
+            timeval timeout;
+
+            FD_ZERO(&read_set);
+            FD_SET(sock, &read_set);
+
+            timeout.tv_sec  = 0;
+            timeout.tv_usec = 100000;
+
+            if(select((int)sock + 1, &read_set, NULL, NULL, &timeout) <= 0)
+            {
+                continue;
+            }
+
+            int length = recv(sock, buffer, sizeof(buffer), 0);
+
+            if(length > 0)
+            {
+                datagrams   += 1;
+                bytes       += length;
+            }
+        }
+    }
+};
+
+/*---------------------------------------------------------*\
+| ddp-e131                                                  |
+|   Frames per second, packets and bytes per frame of the   |
+|   DDP and E1.31 controllers sending the same number of    |
+|   pixels to a local UDP receiver                          |
+\*---------------------------------------------------------*/
+static void BenchmarkDDPE131(unsigned int frames)
+{
+    std::cout << "DDP and E1.31 (" << frames << " frames):" << std::endl;
+
+    const unsigned int  pixel_counts[]  = { 170, 480, 2040 };
+    std::mt19937        random(6742);
+
+    for(unsigned int pixel_count : pixel_counts)
+    {
+        for(unsigned int protocol = 0; protocol < 2; protocol++)
+        {
+            bool            ddp         = (protocol == 0);
+            RGBController*  controller;
+            unsigned short  port;
+
+            if(ddp)
+            {
+                DDPDevice device;
+
+                device.name             = "Benchmark DDP";
+                device.ip               = BENCHMARK_UDP_HOST;
+                device.port             = DDP_DEFAULT_PORT;
+                device.num_leds         = pixel_count;
+                device.start_offset     = 0;
+                device.destination_id   = DDP_ID_DISPLAY;
+                device.keepalive_time   = 0;
+                device.type             = ZONE_TYPE_LINEAR;
+                device.matrix_width     = 0;
+                device.matrix_height    = 0;
+
+                controller  = new RGBController_DDP(std::vector<DDPDevice>{ device });
+                port        = (unsigned short)std::stoi(DDP_DEFAULT_PORT);
+            }
+            else
+            {
+                E131Device device;
+
+                device.name             = "Benchmark E1.31";
+                device.ip               = BENCHMARK_UDP_HOST;
+                device.num_leds         = pixel_count;
+                device.start_universe   = 1;
+                device.start_channel    = 1;
+                device.keepalive_time   = 0;
+                device.rgb_order        = E131_RGB_ORDER_RGB;
+                device.type             = ZONE_TYPE_LINEAR;
+                device.matrix_width     = 0;
+                device.matrix_height    = 0;
+                device.universe_size    = 510;
+                device.matrix_order     = E131_MATRIX_ORDER_HORIZONTAL_TOP_LEFT;
+                device.sync_universe    = 0;
+
+                controller  = new RGBController_E131(std::vector<E131Device>{ device });
+                port        = E131_DEFAULT_PORT;
+            }
+
+            std::string             label = std::string(ddp ? "DDP" : "E1.31") + ", " + std::to_string(pixel_count) + " pixels";
+            BenchmarkUDPReceiver    receiver;
+
+            if(!receiver.Start(port))
+            {
+                std::cout << "  " << std::left << std::setw(44) << label << "unable to bind UDP port " << port << std::endl;
+                delete controller;
+                continue;
+            }
+
+            /*---------------------------------------------*\
+            | Send new colors every frame straight from     |
+            | this thread                                   |
+            \*---------------------------------------------*/
+            std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+            for(unsigned int frame = 0; frame < frames; frame++)
+            {
+                for(RGBColor& color : controller->colors)
+                {
+                    color = (RGBColor)(random() & 0x00FFFFFF);
+                }
+
+                controller->DeviceUpdateLEDs();
+            }
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+            std::this_thread::sleep_for(BENCHMARK_UDP_DRAIN_TIME);
+            receiver.Stop();
+
+            std::cout << "  " << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << (frames / seconds) << " frames/s"
+                      << std::setw(8)  << ((double)receiver.datagrams / frames) << " packets"
+                      << std::setw(10) << ((double)receiver.bytes / frames) << " B/frame" << std::endl;
+
+            delete controller;
+        }
+    }
+}
+
+/*---------------------------------------------------------*\
+| serial-strip                                              |
+|   Adalight frames from the serial LED strip writer to a   |
+|   pseudo terminal read at about the speed of a 1 Mbaud    |
+|   UART.  Reports the frames dropped and written late by   |
+|   the writer, the frames that arrived intact, the bytes   |
+|   that were out of sync and the worst SetLEDs() time.     |
+\*---------------------------------------------------------*/
+static void BenchmarkSerialStrip(unsigned int frames)
+{
+    std::cout << "Serial LED strip (Adalight, " << BENCHMARK_SERIAL_LEDS << " LEDs, " << frames << " frames):" << std::endl;
+
+#ifdef __linux__
+    int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if((master_fd < 0) || (grantpt(master_fd) != 0) || (unlockpt(master_fd) != 0))
+    {
+        std::cout << "  Unable to open a pseudo terminal" << std::endl;
+
+        if(master_fd >= 0)
+        {
+            close(master_fd);
+        }
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Read the far side of the pseudo terminal at a fixed   |
+    | rate and check the Adalight framing                   |
+    \*-----------------------------------------------------*/
+    fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+
+    std::atomic<bool>                                   reading(true);
+    std::atomic<std::chrono::steady_clock::rep>         last_read(std::chrono::steady_clock::now().time_since_epoch().count());
+    unsigned long long                                  valid_frames    = 0;
+    unsigned long long                                  sync_bytes      = 0;
+
+    std::thread reader_thread([&]()
+    {
+        std::vector<unsigned char>  stream;
+        unsigned char               buffer[1000];
+
+        while(reading)
+        {
+            ssize_t length = read(master_fd, buffer, sizeof(buffer));
+
+            if(length > 0)
+            {
+                stream.insert(stream.end(), buffer, buffer + length);
+                last_read = std::chrono::steady_clock::now().time_since_epoch().count();
+            }
+
+            while(stream.size() >= 6)
+            {
+                if((stream[0] == 'A') && (stream[1] == 'd') && (stream[2] == 'a') && (stream[5] == (stream[3] ^ stream[4] ^ 0x55)))
+                {
+                    std::size_t frame_size = 6 + ((((std::size_t)stream[3] << 8) | stream[4]) * 3);
+
+                    if(stream.size() < frame_size)
+                    {
+                        break;
+                    }
+
+                    stream.erase(stream.begin(), stream.begin() + frame_size);
+                    valid_frames++;
+                }
+                else
+                {
+                    stream.erase(stream.begin());
+                    sync_bytes++;
+                }
+            }
+
+            std::this_thread::sleep_for(std::chrono::microseconds((sizeof(buffer) * 1000000ULL) / BENCHMARK_SERIAL_READ_RATE));
+        }
+    });
+
+    std::string ledstring = std::string(ptsname(master_fd)) + "," + std::to_string(BENCHMARK_SERIAL_BAUD) + "," + std::to_string(BENCHMARK_SERIAL_LEDS);
+
+    LEDStripController*     controller  = new LEDStripController();
+    std::vector<RGBColor>   colors(BENCHMARK_SERIAL_LEDS);
+    std::vector<double>     samples_us;
+
+    controller->Initialize((char *)ledstring.c_str(), LED_PROTOCOL_ADALIGHT);
+
+    /*-----------------------------------------------------*\
+    | Submit frames faster than the reader can take them    |
+    \*-----------------------------------------------------*/
+    for(unsigned int frame = 0; frame < frames; frame++)
+    {
+        std::fill(colors.begin(), colors.end(), ToRGBColor(frame & 0xFF, 0, 0));
+
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        controller->SetLEDs(colors);
+
+        samples_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count());
+
+        std::this_thread::sleep_for(BENCHMARK_SERIAL_INTERVAL);
+    }
+
+    /*-----------------------------------------------------*\
+    | Wait until the reader has been idle for a while, the  |
+    | writer has then written its last frame                |
+    \*-----------------------------------------------------*/
+    while((std::chrono::steady_clock::now().time_since_epoch().count() - last_read) < std::chrono::steady_clock::duration(BENCHMARK_SERIAL_IDLE_TIME).count())
+    {
+        std::this_thread::sleep_for(BENCHMARK_SERIAL_INTERVAL);
+    }
+
+    unsigned long long sent_frames      = controller->GetSentFrames();
+    unsigned long long dropped_frames   = controller->GetDroppedFrames();
+    unsigned long long late_frames      = controller->GetLateFrames();
+
+    delete controller;
+
+    reading = false;
+    reader_thread.join();
+    close(master_fd);
+
+    std::cout << "  " << std::left << std::setw(44) << "Writer frames" << std::right
+              << std::setw(10) << sent_frames << " sent" << std::setw(10) << dropped_frames << " dropped" << std::setw(10) << late_frames << " late" << std::endl;
+    std::cout << "  " << std::left << std::setw(44) << "Received frames" << std::right
+              << std::setw(10) << valid_frames << " intact" << std::setw(10) << sync_bytes << " bytes out of sync" << std::endl;
+
+    PrintLatencies("SetLEDs() time", samples_us);
+#else
+    std::cout << "  Needs a pseudo terminal, only available on Linux" << std::endl;
+#endif
+}
+
+static const std::vector<BenchmarkScenario> benchmark_scenarios =
+{
+    { "update-threads",     "Idle CPU and UpdateLEDs latency of dummy controllers", BenchmarkUpdateThreads      },
+    { "server",             "UPDATELEDS packets/s and latency of the SDK server",   BenchmarkServer             },
+    { "server-allocations", "Heap allocations per UPDATELEDS packet, 1000 LEDs",    BenchmarkServerAllocations  },
+    { "delta",              "Bytes and time per frame of full and delta updates",   BenchmarkDelta              },
+    { "shared-memory",      "UpdateLEDs latency of shared memory vs loopback TCP",  BenchmarkSharedMemory       },
+    { "detection-cache",    "Startup detection time with and without the cache",    BenchmarkDetectionCache     },
+    { "smbus-batch",        "SMBus hand-offs per frame, batched and unbatched",     BenchmarkSMBusBatch         },
+    { "ddp-e131",           "DDP and E1.31 frames/s to a local UDP receiver",       BenchmarkDDPE131            },
+    { "serial-strip",       "Serial LED strip dropped and late frames over a pty",  BenchmarkSerialStrip        },
+};
+
+const std::vector<BenchmarkScenario>& GetBenchmarkScenarios()
+{
+    return(benchmark_scenarios);
+}
+
+bool RunBenchmarkScenario(const std::string& name, unsigned int frames)
+{
+    for(const BenchmarkScenario& scenario : benchmark_scenarios)
+    {
+        if(name == scenario.name)
+        {
+            /*---------------------------------------------*\
+            | Let detection finish first so that it does    |
+            | not compete with the measurement              |
+            \*---------------------------------------------*/
+            ResourceManager::get()->WaitForDeviceDetection();
+
+            scenario.function(frames);
+
+            return(true);
+        }
+    }
+
+    return(false);
+}
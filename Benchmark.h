@@ -0,0 +1,29 @@
+/*---------------------------------------------------------*\
+| Benchmark.h                                               |
+|                                                           |
+|   Self-contained benchmark scenarios for the --benchmark  |
+|   command line option.  They run on dummy devices and     |
+|   loopback connections, no hardware is needed.            |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+typedef void (*BenchmarkFunction)(unsigned int frames);
+
+typedef struct
+{
+    const char*             name;
+    const char*             description;
+    BenchmarkFunction       function;
+} BenchmarkScenario;
+
+const std::vector<BenchmarkScenario>&   GetBenchmarkScenarios();
+bool                                    RunBenchmarkScenario(const std::string& name, unsigned int frames);
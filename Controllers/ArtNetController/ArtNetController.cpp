@@ -0,0 +1,137 @@
+/*---------------------------------------------------------*\
+| ArtNetController.cpp                                      |
+|                                                           |
+|   Driver for Art-Net nodes                                |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <string.h>
+#include "ArtNetController.h"
+
+static void ArtNetFillHeader(unsigned char* packet, unsigned short opcode)
+{
+    memcpy(packet, "Art-Net", 8);
+
+    packet[8]   = (unsigned char)(opcode & 0xFF);
+    packet[9]   = (unsigned char)(opcode >> 8);
+    packet[10]  = 0;
+    packet[11]  = ARTNET_PROTOCOL_VERSION;
+}
+
+ArtNetController::ArtNetController(std::string ip, std::string port_str)
+{
+    /*-----------------------------------------------------------------*\
+    | Fill in location string with node's IP address and port           |
+    \*-----------------------------------------------------------------*/
+    location        = "IP: " + ip + ":" + port_str;
+    sequence        = 1;
+    universe_count  = 0;
+
+    /*-----------------------------------------------------------------*\
+    | ArtSync packets have no data, Aux1 and Aux2 are zero              |
+    \*-----------------------------------------------------------------*/
+    memset(sync_packet, 0, sizeof(sync_packet));
+    ArtNetFillHeader(sync_packet, ARTNET_OP_SYNC);
+
+    /*-----------------------------------------------------------------*\
+    | Open a UDP client sending to the node's IP and port               |
+    \*-----------------------------------------------------------------*/
+    port.udp_client(ip.c_str(), port_str.c_str());
+}
+
+ArtNetController::~ArtNetController()
+{
+}
+
+std::string ArtNetController::GetLocation()
+{
+    return(location);
+}
+
+void ArtNetController::SetUniverses(const std::vector<unsigned int>& port_addresses, unsigned int length)
+{
+    /*-----------------------------------------------------------------*\
+    | The data length must be even and between 2 and 512                |
+    \*-----------------------------------------------------------------*/
+    length = (length + 1) & ~1u;
+
+    if(length < 2)
+    {
+        length = 2;
+    }
+
+    if(length > ARTNET_DMX_MAX_DATA_LENGTH)
+    {
+        length = ARTNET_DMX_MAX_DATA_LENGTH;
+    }
+
+    universe_count = (unsigned int)port_addresses.size();
+
+    packet_buffer.assign(universe_count * (ARTNET_DMX_HEADER_LENGTH + ARTNET_DMX_MAX_DATA_LENGTH), 0);
+
+    /*-----------------------------------------------------------------*\
+    | The ArtSync packet follows the ArtDmx packets in the batch        |
+    \*-----------------------------------------------------------------*/
+    packet_ptrs.resize(universe_count + 1);
+    packet_lengths.resize(universe_count + 1);
+
+    for(unsigned int universe_idx = 0; universe_idx < universe_count; universe_idx++)
+    {
+        unsigned char* packet = &packet_buffer[universe_idx * (ARTNET_DMX_HEADER_LENGTH + ARTNET_DMX_MAX_DATA_LENGTH)];
+
+        ArtNetFillHeader(packet, ARTNET_OP_DMX);
+
+        packet[12]  = sequence;
+        packet[13]  = 0;
+        packet[14]  = (unsigned char)(port_addresses[universe_idx] & 0xFF);
+        packet[15]  = (unsigned char)((port_addresses[universe_idx] >> 8) & 0x7F);
+        packet[16]  = (unsigned char)(length >> 8);
+        packet[17]  = (unsigned char)(length & 0xFF);
+
+        packet_ptrs[universe_idx]       = (char*)packet;
+        packet_lengths[universe_idx]    = ARTNET_DMX_HEADER_LENGTH + length;
+    }
+
+    packet_ptrs[universe_count]     = (char*)sync_packet;
+    packet_lengths[universe_count]  = ARTNET_SYNC_LENGTH;
+}
+
+std::vector<unsigned char*> ArtNetController::GetUniverseData()
+{
+    std::vector<unsigned char*> universe_data;
+
+    for(unsigned int universe_idx = 0; universe_idx < universe_count; universe_idx++)
+    {
+        universe_data.push_back((unsigned char*)packet_ptrs[universe_idx] + ARTNET_DMX_HEADER_LENGTH);
+    }
+
+    return(universe_data);
+}
+
+void ArtNetController::SendFrame(bool sync)
+{
+    if(packet_ptrs.empty())
+    {
+        return;
+    }
+
+    for(unsigned int universe_idx = 0; universe_idx < universe_count; universe_idx++)
+    {
+        packet_ptrs[universe_idx][12] = (char)sequence;
+    }
+
+    /*-----------------------------------------------------------------*\
+    | Send all universes of the frame to the node in one batch, with    |
+    | an ArtSync at the end so that the node outputs them together      |
+    \*-----------------------------------------------------------------*/
+    port.udp_write_multiple(packet_ptrs.data(), packet_lengths.data(), (int)universe_count + (sync ? 1 : 0));
+
+    /*-----------------------------------------------------------------*\
+    | Sequence numbers run from 1 to 255, 0 disables sequencing         |
+    \*-----------------------------------------------------------------*/
+    sequence = (sequence % 255) + 1;
+}
@@ -0,0 +1,76 @@
+/*---------------------------------------------------------*\
+| ArtNetController.h                                        |
+|                                                           |
+|   Driver for Art-Net nodes                                |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "net_port.h"
+
+#define ARTNET_DEFAULT_PORT         "6454"
+#define ARTNET_PROTOCOL_VERSION     14
+
+/*---------------------------------------------------------*\
+| ArtDmx header                                             |
+|   Byte 0-7:   "Art-Net" and a terminating zero            |
+|   Byte 8-9:   OpCode, little endian                       |
+|   Byte 10-11: protocol version, big endian                |
+|   Byte 12:    sequence number, 1-255 (0 = not used)       |
+|   Byte 13:    physical input port                         |
+|   Byte 14:    SubUni, low byte of the port address        |
+|   Byte 15:    Net, high 7 bits of the port address        |
+|   Byte 16-17: data length, even, big endian               |
+\*---------------------------------------------------------*/
+#define ARTNET_DMX_HEADER_LENGTH    18
+#define ARTNET_DMX_MAX_DATA_LENGTH  512
+#define ARTNET_SYNC_LENGTH          14
+
+enum
+{
+    ARTNET_OP_DMX                   = 0x5000,
+    ARTNET_OP_SYNC                  = 0x5200,
+};
+
+/*---------------------------------------------------------*\
+| A 15-bit port address is made of a 7-bit net, a 4-bit     |
+| subnet and a 4-bit universe                               |
+\*---------------------------------------------------------*/
+#define ARTNET_PORT_ADDRESS(net, subnet, universe)  ((((net) & 0x7F) << 8) | (((subnet) & 0x0F) << 4) | ((universe) & 0x0F))
+
+class ArtNetController
+{
+public:
+    ArtNetController(std::string ip, std::string port);
+    ~ArtNetController();
+
+    std::string                 GetLocation();
+
+    /*-----------------------------------------------------*\
+    | Set up one ArtDmx packet per port address.  The data  |
+    | pointers point at channel 1 of each packet and stay   |
+    | valid until the universes are set up again.           |
+    \*-----------------------------------------------------*/
+    void                        SetUniverses(const std::vector<unsigned int>& port_addresses, unsigned int length);
+    std::vector<unsigned char*> GetUniverseData();
+
+    void                        SendFrame(bool sync);
+
+private:
+    std::string                 location;
+    net_port                    port;
+
+    unsigned int                universe_count;
+    std::vector<unsigned char>  packet_buffer;
+    std::vector<char*>          packet_ptrs;
+    std::vector<int>            packet_lengths;
+    unsigned char               sync_packet[ARTNET_SYNC_LENGTH];
+    unsigned char               sequence;
+};
@@ -0,0 +1,247 @@
+/*---------------------------------------------------------*\
+| ArtNetControllerDetect.cpp                                |
+|                                                           |
+|   Detector for Art-Net devices                            |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <string>
+#include <vector>
+#include "Detector.h"
+#include "RGBController.h"
+#include "RGBController_ArtNet.h"
+#include "SettingsManager.h"
+
+/******************************************************************************************\
+*                                                                                          *
+*   DetectArtNetControllers                                                                *
+*                                                                                          *
+*       Detect devices supported by the Art-Net driver                                     *
+*                                                                                          *
+\******************************************************************************************/
+
+void DetectArtNetControllers()
+{
+    json                artnet_settings;
+
+    std::vector<std::vector<ArtNetDevice>> device_lists;
+    ArtNetDevice dev;
+
+    /*-------------------------------------------------*\
+    | Get Art-Net settings from settings manager        |
+    \*-------------------------------------------------*/
+    artnet_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("ArtNetDevices");
+
+    /*-------------------------------------------------*\
+    | If the Art-Net settings contains devices, process |
+    \*-------------------------------------------------*/
+    if(artnet_settings.contains("devices"))
+    {
+        for(unsigned int device_idx = 0; device_idx < artnet_settings["devices"].size(); device_idx++)
+        {
+            unsigned int net        = 0;
+            unsigned int subnet     = 0;
+            unsigned int universe   = 0;
+
+            /*-------------------------------------------------*\
+            | Clear Art-Net device data                         |
+            \*-------------------------------------------------*/
+            dev.name           = "";
+            dev.ip             = "";
+            dev.port           = ARTNET_DEFAULT_PORT;
+            dev.type           = ZONE_TYPE_LINEAR;
+            dev.num_leds       = 0;
+            dev.rgb_order      = DMX_RGB_ORDER_RGB;
+            dev.matrix_width   = 0;
+            dev.matrix_height  = 0;
+            dev.start_channel  = 1;
+            dev.keepalive_time = 0;
+            dev.universe_size  = 510;
+            dev.sync           = false;
+
+            /*-------------------------------------------------*\
+            | Art-Net data is sent unicast, so a node needs an  |
+            | IP address                                        |
+            \*-------------------------------------------------*/
+            if(!artnet_settings["devices"][device_idx].contains("ip"))
+            {
+                continue;
+            }
+
+            dev.ip = artnet_settings["devices"][device_idx]["ip"];
+
+            if(artnet_settings["devices"][device_idx].contains("name"))
+            {
+                dev.name = artnet_settings["devices"][device_idx]["name"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("port"))
+            {
+                if(artnet_settings["devices"][device_idx]["port"].is_string())
+                {
+                    dev.port = artnet_settings["devices"][device_idx]["port"];
+                }
+                else
+                {
+                    dev.port = std::to_string((unsigned int)artnet_settings["devices"][device_idx]["port"]);
+                }
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("num_leds"))
+            {
+                dev.num_leds = artnet_settings["devices"][device_idx]["num_leds"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("net"))
+            {
+                net = artnet_settings["devices"][device_idx]["net"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("subnet"))
+            {
+                subnet = artnet_settings["devices"][device_idx]["subnet"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("universe"))
+            {
+                universe = artnet_settings["devices"][device_idx]["universe"];
+            }
+
+            dev.start_universe = ARTNET_PORT_ADDRESS(net, subnet, universe);
+
+            if(artnet_settings["devices"][device_idx].contains("start_channel"))
+            {
+                dev.start_channel = artnet_settings["devices"][device_idx]["start_channel"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("universe_size"))
+            {
+                dev.universe_size = artnet_settings["devices"][device_idx]["universe_size"];
+            }
+
+            if(dev.universe_size < 3 || dev.universe_size > ARTNET_DMX_MAX_DATA_LENGTH)
+            {
+                dev.universe_size = 510;
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("keepalive_time"))
+            {
+                dev.keepalive_time = artnet_settings["devices"][device_idx]["keepalive_time"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("sync"))
+            {
+                dev.sync = artnet_settings["devices"][device_idx]["sync"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("matrix_width"))
+            {
+                dev.matrix_width = artnet_settings["devices"][device_idx]["matrix_width"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("matrix_height"))
+            {
+                dev.matrix_height = artnet_settings["devices"][device_idx]["matrix_height"];
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("rgb_order"))
+            {
+                if(artnet_settings["devices"][device_idx]["rgb_order"].is_string())
+                {
+                    std::string rgb_order_val = artnet_settings["devices"][device_idx]["rgb_order"];
+
+                    if(rgb_order_val == "RGB")
+                    {
+                        dev.rgb_order = DMX_RGB_ORDER_RGB;
+                    }
+                    else if(rgb_order_val == "RBG")
+                    {
+                        dev.rgb_order = DMX_RGB_ORDER_RBG;
+                    }
+                    else if(rgb_order_val == "GRB")
+                    {
+                        dev.rgb_order = DMX_RGB_ORDER_GRB;
+                    }
+                    else if(rgb_order_val == "GBR")
+                    {
+                        dev.rgb_order = DMX_RGB_ORDER_GBR;
+                    }
+                    else if(rgb_order_val == "BRG")
+                    {
+                        dev.rgb_order = DMX_RGB_ORDER_BRG;
+                    }
+                    else if(rgb_order_val == "BGR")
+                    {
+                        dev.rgb_order = DMX_RGB_ORDER_BGR;
+                    }
+                }
+                else
+                {
+                    dev.rgb_order = artnet_settings["devices"][device_idx]["rgb_order"];
+                }
+            }
+
+            if(artnet_settings["devices"][device_idx].contains("type"))
+            {
+                if(artnet_settings["devices"][device_idx]["type"].is_string())
+                {
+                    std::string type_val = artnet_settings["devices"][device_idx]["type"];
+
+                    if(type_val == "SINGLE")
+                    {
+                        dev.type = ZONE_TYPE_SINGLE;
+                    }
+                    else if(type_val == "LINEAR")
+                    {
+                        dev.type = ZONE_TYPE_LINEAR;
+                    }
+                    else if(type_val == "MATRIX")
+                    {
+                        dev.type = ZONE_TYPE_MATRIX;
+                    }
+                }
+                else
+                {
+                    dev.type = artnet_settings["devices"][device_idx]["type"];
+                }
+            }
+
+            /*---------------------------------------------------------*\
+            | Devices on the same node share a controller, so that all  |
+            | universes of a node are sent together in one batch        |
+            \*---------------------------------------------------------*/
+            bool device_added_to_existing_list = false;
+
+            for(unsigned int list_idx = 0; list_idx < device_lists.size(); list_idx++)
+            {
+                if(device_lists[list_idx][0].ip == dev.ip && device_lists[list_idx][0].port == dev.port)
+                {
+                    device_lists[list_idx].push_back(dev);
+                    device_added_to_existing_list = true;
+                    break;
+                }
+            }
+
+            if(!device_added_to_existing_list)
+            {
+                std::vector<ArtNetDevice> new_list;
+
+                new_list.push_back(dev);
+
+                device_lists.push_back(new_list);
+            }
+        }
+
+        for(unsigned int list_idx = 0; list_idx < device_lists.size(); list_idx++)
+        {
+            RGBController_ArtNet* rgb_controller;
+            rgb_controller = new RGBController_ArtNet(device_lists[list_idx]);
+            ResourceManager::get()->RegisterRGBController(rgb_controller);
+        }
+    }
+
+}   /* DetectArtNetControllers() */
+
+REGISTER_NETWORK_DETECTOR("Art-Net", DetectArtNetControllers);
@@ -0,0 +1,297 @@
+/*---------------------------------------------------------*\
+| RGBController_ArtNet.cpp                                  |
+|                                                           |
+|   RGBController for Art-Net devices                       |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include "RGBController_ArtNet.h"
+
+using namespace std::chrono_literals;
+
+/**------------------------------------------------------------------*\
+    @name Art-Net Devices
+    @category LEDStrip
+    @type Art-Net
+    @save :x:
+    @direct :white_check_mark:
+    @effects :x:
+    @detectors DetectArtNetControllers
+    @comment Art-Net nodes configured through the ArtNetDevices
+        settings.  Universes are sent unicast to each node.
+\*-------------------------------------------------------------------*/
+
+RGBController_ArtNet::RGBController_ArtNet(std::vector<ArtNetDevice> device_list)
+{
+    devices = device_list;
+
+    name        = "Art-Net Device Group";
+    type        = DEVICE_TYPE_LEDSTRIP;
+    description = "Art-Net Device";
+
+    /*-----------------------------------------*\
+    | If this controller only represents a      |
+    | single device, use the device name for the|
+    | controller name                           |
+    \*-----------------------------------------*/
+    if(devices.size() == 1)
+    {
+        name    = devices[0].name;
+    }
+    else
+    {
+        name += " (" + devices[0].ip + ")";
+    }
+
+    /*-----------------------------------------*\
+    | All devices in a group are on one node    |
+    \*-----------------------------------------*/
+    controller  = new ArtNetController(devices[0].ip, devices[0].port);
+    location    = "Art-Net: " + controller->GetLocation() + ", ";
+
+    /*-----------------------------------------*\
+    | Calculate universe list                   |
+    \*-----------------------------------------*/
+    std::vector<unsigned int>   universe_list;
+    std::vector<DMXUniverseRun> runs;
+    unsigned int                universe_length = 0;
+
+    keepalive_delay = 0ms;
+    sync            = false;
+
+    for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
+    {
+        unsigned int universe_size      = devices[device_idx].universe_size;
+        unsigned int total_universes    = ((devices[device_idx].num_leds * 3) + devices[device_idx].start_channel + universe_size - 2) / universe_size;
+
+        for(unsigned int univ_idx = 0; univ_idx < total_universes; univ_idx++)
+        {
+            unsigned int universe = devices[device_idx].start_universe + univ_idx;
+
+            if(std::find(universe_list.begin(), universe_list.end(), universe) == universe_list.end())
+            {
+                universe_list.push_back(universe);
+            }
+        }
+
+        DMXUniverseRun run;
+
+        run.num_leds        = devices[device_idx].num_leds;
+        run.start_universe  = devices[device_idx].start_universe;
+        run.start_channel   = devices[device_idx].start_channel;
+        run.universe_size   = universe_size;
+        run.rgb_order       = devices[device_idx].rgb_order;
+
+        runs.push_back(run);
+
+        universe_length = std::max(universe_length, universe_size);
+
+        /*-----------------------------------------*\
+        | Update keepalive delay                    |
+        \*-----------------------------------------*/
+        if(devices[device_idx].keepalive_time > 0)
+        {
+            if(keepalive_delay.count() == 0 || keepalive_delay.count() > devices[device_idx].keepalive_time)
+            {
+                keepalive_delay = std::chrono::milliseconds(devices[device_idx].keepalive_time);
+            }
+        }
+
+        if(devices[device_idx].sync)
+        {
+            sync = true;
+        }
+    }
+
+    /*-----------------------------------------*\
+    | Append "Universe" and make plural if there|
+    | are multiple universes in use, universes  |
+    | are shown as net:subnet:universe          |
+    \*-----------------------------------------*/
+    location   += "Universe";
+
+    if(universe_list.size() > 1)
+    {
+        location += "s ";
+    }
+    else
+    {
+        location += " ";
+    }
+
+    for(unsigned int univ_list_idx = 0; univ_list_idx < universe_list.size(); univ_list_idx++)
+    {
+        location += std::to_string((universe_list[univ_list_idx] >> 8) & 0x7F) + ":"
+                  + std::to_string((universe_list[univ_list_idx] >> 4) & 0x0F) + ":"
+                  + std::to_string(universe_list[univ_list_idx] & 0x0F);
+
+        if(univ_list_idx < (universe_list.size() - 1))
+        {
+            location += ", ";
+        }
+    }
+
+    /*-----------------------------------------*\
+    | Set up modes                              |
+    \*-----------------------------------------*/
+    mode Direct;
+    Direct.name       = "Direct";
+    Direct.value      = 0;
+    Direct.flags      = MODE_FLAG_HAS_PER_LED_COLOR;
+    Direct.color_mode = MODE_COLORS_PER_LED;
+    modes.push_back(Direct);
+
+    SetupZones();
+
+    /*-----------------------------------------*\
+    | Colors are packed straight into the       |
+    | ArtDmx packets                            |
+    \*-----------------------------------------*/
+    controller->SetUniverses(universe_list, universe_length);
+
+    universe_data = controller->GetUniverseData();
+
+    universe_map.Setup(runs, universe_list);
+
+    if(keepalive_delay.count() > 0)
+    {
+        keepalive_thread_run = 1;
+        keepalive_thread = new std::thread(&RGBController_ArtNet::KeepaliveThreadFunction, this);
+    }
+    else
+    {
+        keepalive_thread_run = 0;
+        keepalive_thread = nullptr;
+    }
+}
+
+RGBController_ArtNet::~RGBController_ArtNet()
+{
+    if(keepalive_thread != nullptr)
+    {
+        keepalive_thread_run = 0;
+        keepalive_thread->join();
+        delete keepalive_thread;
+    }
+
+    /*---------------------------------------------------------*\
+    | Delete the matrix map                                     |
+    \*---------------------------------------------------------*/
+    for(unsigned int zone_index = 0; zone_index < zones.size(); zone_index++)
+    {
+        if(zones[zone_index].matrix_map != NULL)
+        {
+            if(zones[zone_index].matrix_map->map != NULL)
+            {
+                delete[] zones[zone_index].matrix_map->map;
+            }
+
+            delete zones[zone_index].matrix_map;
+        }
+    }
+
+    delete controller;
+}
+
+void RGBController_ArtNet::SetupZones()
+{
+    /*-----------------------------------------*\
+    | Add Zones                                 |
+    \*-----------------------------------------*/
+    for(std::size_t zone_idx = 0; zone_idx < devices.size(); zone_idx++)
+    {
+        zone led_zone;
+        led_zone.name           = devices[zone_idx].name;
+        led_zone.type           = devices[zone_idx].type;
+        led_zone.leds_min       = devices[zone_idx].num_leds;
+        led_zone.leds_max       = devices[zone_idx].num_leds;
+        led_zone.leds_count     = devices[zone_idx].num_leds;
+        led_zone.matrix_map     = NULL;
+
+        /*-----------------------------------------*\
+        | Matrix zones are laid out row by row      |
+        \*-----------------------------------------*/
+        if(devices[zone_idx].type == ZONE_TYPE_MATRIX)
+        {
+            unsigned int map_size = devices[zone_idx].matrix_width * devices[zone_idx].matrix_height;
+
+            led_zone.matrix_map         = new matrix_map_type;
+            led_zone.matrix_map->width  = devices[zone_idx].matrix_width;
+            led_zone.matrix_map->height = devices[zone_idx].matrix_height;
+            led_zone.matrix_map->map    = new unsigned int[map_size];
+
+            for(unsigned int map_idx = 0; map_idx < map_size; map_idx++)
+            {
+                led_zone.matrix_map->map[map_idx] = (map_idx < devices[zone_idx].num_leds) ? map_idx : 0xFFFFFFFF;
+            }
+        }
+
+        zones.push_back(led_zone);
+    }
+
+    /*-----------------------------------------*\
+    | Add LEDs                                  |
+    \*-----------------------------------------*/
+    for(std::size_t zone_idx = 0; zone_idx < zones.size(); zone_idx++)
+    {
+        for(std::size_t led_idx = 0; led_idx < zones[zone_idx].leds_count; led_idx++)
+        {
+            led new_led;
+
+            new_led.name = zones[zone_idx].name + " LED ";
+            new_led.name.append(std::to_string(led_idx));
+
+            leds.push_back(new_led);
+        }
+    }
+
+    SetupColors();
+}
+
+void RGBController_ArtNet::ResizeZone(int /*zone*/, int /*new_size*/)
+{
+    /*---------------------------------------------------------*\
+    | This device does not support resizing zones               |
+    \*---------------------------------------------------------*/
+}
+
+void RGBController_ArtNet::DeviceUpdateLEDs()
+{
+    last_update_time = std::chrono::steady_clock::now();
+
+    universe_map.Pack(colors.data(), universe_data.data());
+
+    controller->SendFrame(sync);
+}
+
+void RGBController_ArtNet::UpdateZoneLEDs(int /*zone*/)
+{
+    DeviceUpdateLEDs();
+}
+
+void RGBController_ArtNet::UpdateSingleLED(int /*led*/)
+{
+    DeviceUpdateLEDs();
+}
+
+void RGBController_ArtNet::DeviceUpdateMode()
+{
+
+}
+
+void RGBController_ArtNet::KeepaliveThreadFunction()
+{
+    while(keepalive_thread_run.load())
+    {
+        if((std::chrono::steady_clock::now() - last_update_time) > ( keepalive_delay * 0.95f ) )
+        {
+            UpdateLEDs();
+        }
+        std::this_thread::sleep_for(keepalive_delay / 2);
+    }
+}
@@ -0,0 +1,66 @@
+/*---------------------------------------------------------*\
+| RGBController_ArtNet.h                                    |
+|                                                           |
+|   RGBController for Art-Net devices                       |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "RGBController.h"
+#include "ArtNetController.h"
+#include "DMXUniverseMap.h"
+
+struct ArtNetDevice
+{
+    std::string name;
+    std::string ip;
+    std::string port;
+    unsigned int num_leds;
+    unsigned int start_universe;
+    unsigned int start_channel;
+    unsigned int universe_size;
+    unsigned int rgb_order;
+    unsigned int keepalive_time;
+    bool sync;
+    zone_type type;
+    unsigned int matrix_width;
+    unsigned int matrix_height;
+};
+
+class RGBController_ArtNet : public RGBController
+{
+public:
+    RGBController_ArtNet(std::vector<ArtNetDevice> device_list);
+    ~RGBController_ArtNet();
+
+    void        SetupZones();
+
+    void        ResizeZone(int zone, int new_size);
+
+    void        DeviceUpdateLEDs();
+    void        UpdateZoneLEDs(int zone);
+    void        UpdateSingleLED(int led);
+
+    void        DeviceUpdateMode();
+
+    void        KeepaliveThreadFunction();
+
+private:
+    std::vector<ArtNetDevice>                           devices;
+    ArtNetController*                                   controller;
+    DMXUniverseMap                                      universe_map;
+    std::vector<unsigned char*>                         universe_data;
+    bool                                                sync;
+    std::thread *                                       keepalive_thread;
+    std::atomic<bool>                                   keepalive_thread_run;
+    std::chrono::milliseconds                           keepalive_delay;
+    std::chrono::time_point<std::chrono::steady_clock>  last_update_time;
+};
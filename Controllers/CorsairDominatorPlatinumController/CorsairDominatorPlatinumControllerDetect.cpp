@@ -63,7 +63,7 @@ json corsair_dominator_models =
 
 bool TestForCorsairDominatorPlatinumController(i2c_smbus_interface *bus, unsigned char address)
 {
-    int res = bus->i2c_smbus_write_quick(address, I2C_SMBUS_WRITE);
+    int res = bus->i2c_smbus_probe_address(address, I2C_SMBUS_QUICK);
 
     LOG_DEBUG("[%s] Trying address %02X", CORSAIR_DOMINATOR_PLATINUM_NAME, address);
 
@@ -28,7 +28,7 @@ bool TestForCorsairVengeanceController(i2c_smbus_interface* bus, unsigned char a
 {
     bool pass = false;
 
-    int res = bus->i2c_smbus_write_quick(address, I2C_SMBUS_WRITE);
+    int res = bus->i2c_smbus_probe_address(address, I2C_SMBUS_QUICK);
 
     if (res >= 0)
     {
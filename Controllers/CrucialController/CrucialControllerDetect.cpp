@@ -90,7 +90,7 @@ bool TestForCrucialController(i2c_smbus_interface* bus, unsigned char address)
 {
     bool pass = false;
 
-    int res = bus->i2c_smbus_write_quick(address, I2C_SMBUS_WRITE);
+    int res = bus->i2c_smbus_probe_address(address, I2C_SMBUS_QUICK);
 
     if (res >= 0)
     {
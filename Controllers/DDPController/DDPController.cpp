@@ -0,0 +1,116 @@
+/*---------------------------------------------------------*\
+| DDPController.cpp                                         |
+|                                                           |
+|   Driver for Distributed Display Protocol (DDP) devices   |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <string.h>
+#include "DDPController.h"
+
+DDPController::DDPController(std::string ip, std::string port_str)
+{
+    /*-----------------------------------------------------------------*\
+    | Fill in location string with device's IP address and port         |
+    \*-----------------------------------------------------------------*/
+    location    = "IP: " + ip + ":" + port_str;
+    sequence    = 1;
+
+    /*-----------------------------------------------------------------*\
+    | Open a UDP client sending to the device's IP and port             |
+    \*-----------------------------------------------------------------*/
+    port.udp_client(ip.c_str(), port_str.c_str());
+}
+
+DDPController::~DDPController()
+{
+}
+
+std::string DDPController::GetLocation()
+{
+    return(location);
+}
+
+/*---------------------------------------------------------*\
+| Split the ranges into packets of up to 480 pixels and     |
+| fill in the packet headers, which only change in the      |
+| sequence number afterwards.  The last packet of a frame   |
+| carries the push flag, so that the receiver latches the   |
+| whole frame at once.                                      |
+\*---------------------------------------------------------*/
+void DDPController::SetRanges(const std::vector<DDPRange>& ranges)
+{
+    packet_ranges.clear();
+
+    for(std::size_t range_idx = 0; range_idx < ranges.size(); range_idx++)
+    {
+        for(unsigned int offset = 0; offset < ranges[range_idx].length; offset += DDP_MAX_DATA_LENGTH)
+        {
+            DDPRange packet_range;
+
+            packet_range.destination_id = ranges[range_idx].destination_id;
+            packet_range.data_offset    = ranges[range_idx].data_offset + offset;
+            packet_range.channel_offset = ranges[range_idx].channel_offset + offset;
+            packet_range.length         = std::min(ranges[range_idx].length - offset, (unsigned int)DDP_MAX_DATA_LENGTH);
+
+            packet_ranges.push_back(packet_range);
+        }
+    }
+
+    packet_buffer.assign(packet_ranges.size() * (DDP_HEADER_LENGTH + DDP_MAX_DATA_LENGTH), 0);
+    packet_ptrs.resize(packet_ranges.size());
+    packet_lengths.resize(packet_ranges.size());
+
+    for(std::size_t packet_idx = 0; packet_idx < packet_ranges.size(); packet_idx++)
+    {
+        unsigned char*  packet = &packet_buffer[packet_idx * (DDP_HEADER_LENGTH + DDP_MAX_DATA_LENGTH)];
+        DDPRange&       range  = packet_ranges[packet_idx];
+
+        packet[0] = DDP_FLAG_VERSION_1;
+        packet[1] = sequence;
+        packet[2] = DDP_TYPE_RGB_8BIT;
+        packet[3] = range.destination_id;
+        packet[4] = (unsigned char)(range.data_offset >> 24);
+        packet[5] = (unsigned char)(range.data_offset >> 16);
+        packet[6] = (unsigned char)(range.data_offset >> 8);
+        packet[7] = (unsigned char)(range.data_offset);
+        packet[8] = (unsigned char)(range.length >> 8);
+        packet[9] = (unsigned char)(range.length);
+
+        if(packet_idx == (packet_ranges.size() - 1))
+        {
+            packet[0] |= DDP_FLAG_PUSH;
+        }
+
+        packet_ptrs[packet_idx]     = (char*)packet;
+        packet_lengths[packet_idx]  = DDP_HEADER_LENGTH + range.length;
+    }
+}
+
+void DDPController::SendFrame(const unsigned char* channel_data)
+{
+    /*-----------------------------------------------------------------*\
+    | Copy the channel data into the packets and send them all at once  |
+    \*-----------------------------------------------------------------*/
+    for(std::size_t packet_idx = 0; packet_idx < packet_ranges.size(); packet_idx++)
+    {
+        unsigned char*  packet = (unsigned char*)packet_ptrs[packet_idx];
+        DDPRange&       range  = packet_ranges[packet_idx];
+
+        packet[1] = sequence;
+
+        memcpy(&packet[DDP_HEADER_LENGTH], &channel_data[range.channel_offset], range.length);
+    }
+
+    port.udp_write_multiple(packet_ptrs.data(), packet_lengths.data(), (int)packet_ptrs.size());
+
+    /*-----------------------------------------------------------------*\
+    | Sequence numbers run from 1 to 15, 0 means no sequence number     |
+    \*-----------------------------------------------------------------*/
+    sequence = (sequence % 15) + 1;
+}
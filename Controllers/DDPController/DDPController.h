@@ -0,0 +1,90 @@
+/*---------------------------------------------------------*\
+| DDPController.h                                           |
+|                                                           |
+|   Driver for Distributed Display Protocol (DDP) devices   |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "net_port.h"
+
+#define DDP_DEFAULT_PORT            "4048"
+
+/*---------------------------------------------------------*\
+| DDP header                                                |
+|   Byte 0: flags, version 1 in the top two bits            |
+|   Byte 1: sequence number, 1-15 (0 = not used)            |
+|   Byte 2: data type                                       |
+|   Byte 3: destination ID                                  |
+|   Byte 4-7: data offset in bytes, big endian              |
+|   Byte 8-9: data length in bytes, big endian              |
+\*---------------------------------------------------------*/
+#define DDP_HEADER_LENGTH           10
+
+/*---------------------------------------------------------*\
+| 480 RGB pixels per packet keeps a packet within a 1500    |
+| byte Ethernet MTU                                         |
+\*---------------------------------------------------------*/
+#define DDP_MAX_DATA_LENGTH         1440
+
+enum
+{
+    DDP_FLAG_PUSH                   = 0x01,
+    DDP_FLAG_QUERY                  = 0x02,
+    DDP_FLAG_REPLY                  = 0x04,
+    DDP_FLAG_STORAGE                = 0x08,
+    DDP_FLAG_TIMECODE               = 0x10,
+    DDP_FLAG_VERSION_1              = 0x40,
+};
+
+enum
+{
+    DDP_TYPE_RGB_8BIT               = 0x0B,     /* RGB, 8 bits per channel  */
+};
+
+enum
+{
+    DDP_ID_DISPLAY                  = 0x01,     /* Default output device    */
+    DDP_ID_ALL                      = 0xFF,     /* All output devices       */
+};
+
+/*---------------------------------------------------------*\
+| A run of channel data sent to one destination ID,         |
+| starting at a byte offset in the destination's buffer     |
+\*---------------------------------------------------------*/
+struct DDPRange
+{
+    unsigned char   destination_id;
+    unsigned int    data_offset;
+    unsigned int    channel_offset;
+    unsigned int    length;
+};
+
+class DDPController
+{
+public:
+    DDPController(std::string ip, std::string port);
+    ~DDPController();
+
+    std::string GetLocation();
+
+    void        SetRanges(const std::vector<DDPRange>& ranges);
+    void        SendFrame(const unsigned char* channel_data);
+
+private:
+    std::string                 location;
+    net_port                    port;
+
+    std::vector<DDPRange>       packet_ranges;
+    std::vector<unsigned char>  packet_buffer;
+    std::vector<char*>          packet_ptrs;
+    std::vector<int>            packet_lengths;
+    unsigned char               sequence;
+};
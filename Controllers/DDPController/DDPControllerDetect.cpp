@@ -0,0 +1,184 @@
+/*---------------------------------------------------------*\
+| DDPControllerDetect.cpp                                   |
+|                                                           |
+|   Detector for Distributed Display Protocol (DDP) devices |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <string>
+#include <vector>
+#include "Detector.h"
+#include "RGBController.h"
+#include "RGBController_DDP.h"
+#include "SettingsManager.h"
+
+/******************************************************************************************\
+*                                                                                          *
+*   DetectDDPControllers                                                                   *
+*                                                                                          *
+*       Detect devices supported by the DDP driver                                         *
+*                                                                                          *
+\******************************************************************************************/
+
+void DetectDDPControllers()
+{
+    json                ddp_settings;
+
+    std::vector<std::vector<DDPDevice>> device_lists;
+    DDPDevice dev;
+
+    /*-------------------------------------------------*\
+    | Get DDP settings from settings manager            |
+    \*-------------------------------------------------*/
+    ddp_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("DDPDevices");
+
+    /*-------------------------------------------------*\
+    | If the DDP settings contains devices, process     |
+    \*-------------------------------------------------*/
+    if(ddp_settings.contains("devices"))
+    {
+        for(unsigned int device_idx = 0; device_idx < ddp_settings["devices"].size(); device_idx++)
+        {
+            /*-------------------------------------------------*\
+            | Clear DDP device data                             |
+            \*-------------------------------------------------*/
+            dev.name           = "";
+            dev.ip             = "";
+            dev.port           = DDP_DEFAULT_PORT;
+            dev.type           = ZONE_TYPE_LINEAR;
+            dev.num_leds       = 0;
+            dev.destination_id = DDP_ID_DISPLAY;
+            dev.matrix_width   = 0;
+            dev.matrix_height  = 0;
+            dev.keepalive_time = 0;
+
+            if(!ddp_settings["devices"][device_idx].contains("ip"))
+            {
+                continue;
+            }
+
+            dev.ip = ddp_settings["devices"][device_idx]["ip"];
+
+            if(ddp_settings["devices"][device_idx].contains("name"))
+            {
+                dev.name = ddp_settings["devices"][device_idx]["name"];
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("port"))
+            {
+                if(ddp_settings["devices"][device_idx]["port"].is_string())
+                {
+                    dev.port = ddp_settings["devices"][device_idx]["port"];
+                }
+                else
+                {
+                    dev.port = std::to_string((unsigned int)ddp_settings["devices"][device_idx]["port"]);
+                }
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("num_leds"))
+            {
+                dev.num_leds = ddp_settings["devices"][device_idx]["num_leds"];
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("destination_id"))
+            {
+                dev.destination_id = ddp_settings["devices"][device_idx]["destination_id"];
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("keepalive_time"))
+            {
+                dev.keepalive_time = ddp_settings["devices"][device_idx]["keepalive_time"];
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("matrix_width"))
+            {
+                dev.matrix_width = ddp_settings["devices"][device_idx]["matrix_width"];
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("matrix_height"))
+            {
+                dev.matrix_height = ddp_settings["devices"][device_idx]["matrix_height"];
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("type"))
+            {
+                if(ddp_settings["devices"][device_idx]["type"].is_string())
+                {
+                    std::string type_val = ddp_settings["devices"][device_idx]["type"];
+
+                    if(type_val == "SINGLE")
+                    {
+                        dev.type = ZONE_TYPE_SINGLE;
+                    }
+                    else if(type_val == "LINEAR")
+                    {
+                        dev.type = ZONE_TYPE_LINEAR;
+                    }
+                    else if(type_val == "MATRIX")
+                    {
+                        dev.type = ZONE_TYPE_MATRIX;
+                    }
+                }
+                else
+                {
+                    dev.type = ddp_settings["devices"][device_idx]["type"];
+                }
+            }
+
+            /*---------------------------------------------------------*\
+            | Devices sending to the same receiver share a controller,  |
+            | so that a frame goes out together and latches with one    |
+            | push.  Without a start offset, a device follows the       |
+            | previous device of its receiver.                          |
+            \*---------------------------------------------------------*/
+            std::vector<DDPDevice>* device_list = NULL;
+
+            for(unsigned int list_idx = 0; list_idx < device_lists.size(); list_idx++)
+            {
+                if(device_lists[list_idx][0].ip == dev.ip && device_lists[list_idx][0].port == dev.port)
+                {
+                    device_list = &device_lists[list_idx];
+                    break;
+                }
+            }
+
+            dev.start_offset = 0;
+
+            if(device_list != NULL)
+            {
+                dev.start_offset = device_list->back().start_offset + device_list->back().num_leds;
+            }
+
+            if(ddp_settings["devices"][device_idx].contains("start_offset"))
+            {
+                dev.start_offset = ddp_settings["devices"][device_idx]["start_offset"];
+            }
+
+            if(device_list != NULL)
+            {
+                device_list->push_back(dev);
+            }
+            else
+            {
+                std::vector<DDPDevice> new_list;
+
+                new_list.push_back(dev);
+
+                device_lists.push_back(new_list);
+            }
+        }
+
+        for(unsigned int list_idx = 0; list_idx < device_lists.size(); list_idx++)
+        {
+            RGBController_DDP* rgb_controller;
+            rgb_controller = new RGBController_DDP(device_lists[list_idx]);
+            ResourceManager::get()->RegisterRGBController(rgb_controller);
+        }
+    }
+
+}   /* DetectDDPControllers() */
+
+REGISTER_NETWORK_DETECTOR("DDP", DetectDDPControllers);
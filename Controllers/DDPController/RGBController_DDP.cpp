@@ -0,0 +1,258 @@
+/*---------------------------------------------------------*\
+| RGBController_DDP.cpp                                     |
+|                                                           |
+|   RGBController for Distributed Display Protocol (DDP)    |
+|   devices                                                 |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include "RGBController_DDP.h"
+
+using namespace std::chrono_literals;
+
+/**------------------------------------------------------------------*\
+    @name DDP Devices
+    @category LEDStrip
+    @type DDP
+    @save :x:
+    @direct :white_check_mark:
+    @effects :x:
+    @detectors DetectDDPControllers
+    @comment Distributed Display Protocol receivers such as WLED,
+        configured through the DDPDevices settings.
+\*-------------------------------------------------------------------*/
+
+RGBController_DDP::RGBController_DDP(std::vector<DDPDevice> device_list)
+{
+    devices = device_list;
+
+    name        = "DDP Device Group";
+    type        = DEVICE_TYPE_LEDSTRIP;
+    description = "Distributed Display Protocol Device";
+
+    /*-----------------------------------------*\
+    | If this controller only represents a      |
+    | single device, use the device name for the|
+    | controller name                           |
+    \*-----------------------------------------*/
+    if(devices.size() == 1)
+    {
+        name    = devices[0].name;
+    }
+    else
+    {
+        name += " (" + devices[0].ip + ")";
+    }
+
+    /*-----------------------------------------*\
+    | All devices in a group share a receiver   |
+    \*-----------------------------------------*/
+    controller  = new DDPController(devices[0].ip, devices[0].port);
+    location    = "DDP: " + controller->GetLocation();
+
+    /*-----------------------------------------*\
+    | Set up modes                              |
+    \*-----------------------------------------*/
+    mode Direct;
+    Direct.name       = "Direct";
+    Direct.value      = 0;
+    Direct.flags      = MODE_FLAG_HAS_PER_LED_COLOR;
+    Direct.color_mode = MODE_COLORS_PER_LED;
+    modes.push_back(Direct);
+
+    keepalive_delay = 0ms;
+
+    SetupZones();
+
+    /*-----------------------------------------*\
+    | Each device is one range of the channel   |
+    | buffer, sent to its offset in the         |
+    | receiver's pixel buffer                   |
+    \*-----------------------------------------*/
+    std::vector<DDPRange>   ranges;
+    unsigned int            channel_offset = 0;
+
+    for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
+    {
+        /*-----------------------------------------*\
+        | Update keepalive delay                    |
+        \*-----------------------------------------*/
+        if(devices[device_idx].keepalive_time > 0)
+        {
+            if(keepalive_delay.count() == 0 || keepalive_delay.count() > devices[device_idx].keepalive_time)
+            {
+                keepalive_delay = std::chrono::milliseconds(devices[device_idx].keepalive_time);
+            }
+        }
+
+        DDPRange range;
+
+        range.destination_id    = devices[device_idx].destination_id;
+        range.data_offset       = devices[device_idx].start_offset * 3;
+        range.channel_offset    = channel_offset;
+        range.length            = devices[device_idx].num_leds * 3;
+
+        ranges.push_back(range);
+
+        channel_offset += range.length;
+    }
+
+    channel_data.assign(channel_offset, 0);
+
+    controller->SetRanges(ranges);
+
+    if(keepalive_delay.count() > 0)
+    {
+        keepalive_thread_run = 1;
+        keepalive_thread = new std::thread(&RGBController_DDP::KeepaliveThreadFunction, this);
+    }
+    else
+    {
+        keepalive_thread_run = 0;
+        keepalive_thread = nullptr;
+    }
+}
+
+RGBController_DDP::~RGBController_DDP()
+{
+    if(keepalive_thread != nullptr)
+    {
+        keepalive_thread_run = 0;
+        keepalive_thread->join();
+        delete keepalive_thread;
+    }
+
+    /*---------------------------------------------------------*\
+    | Delete the matrix map                                     |
+    \*---------------------------------------------------------*/
+    for(unsigned int zone_index = 0; zone_index < zones.size(); zone_index++)
+    {
+        if(zones[zone_index].matrix_map != NULL)
+        {
+            if(zones[zone_index].matrix_map->map != NULL)
+            {
+                delete[] zones[zone_index].matrix_map->map;
+            }
+
+            delete zones[zone_index].matrix_map;
+        }
+    }
+
+    delete controller;
+}
+
+void RGBController_DDP::SetupZones()
+{
+    /*-----------------------------------------*\
+    | Add Zones                                 |
+    \*-----------------------------------------*/
+    for(std::size_t zone_idx = 0; zone_idx < devices.size(); zone_idx++)
+    {
+        zone led_zone;
+        led_zone.name           = devices[zone_idx].name;
+        led_zone.type           = devices[zone_idx].type;
+        led_zone.leds_min       = devices[zone_idx].num_leds;
+        led_zone.leds_max       = devices[zone_idx].num_leds;
+        led_zone.leds_count     = devices[zone_idx].num_leds;
+        led_zone.matrix_map     = NULL;
+
+        /*-----------------------------------------*\
+        | Matrix zones are laid out row by row      |
+        \*-----------------------------------------*/
+        if(devices[zone_idx].type == ZONE_TYPE_MATRIX)
+        {
+            unsigned int map_size = devices[zone_idx].matrix_width * devices[zone_idx].matrix_height;
+
+            led_zone.matrix_map         = new matrix_map_type;
+            led_zone.matrix_map->width  = devices[zone_idx].matrix_width;
+            led_zone.matrix_map->height = devices[zone_idx].matrix_height;
+            led_zone.matrix_map->map    = new unsigned int[map_size];
+
+            for(unsigned int map_idx = 0; map_idx < map_size; map_idx++)
+            {
+                led_zone.matrix_map->map[map_idx] = (map_idx < devices[zone_idx].num_leds) ? map_idx : 0xFFFFFFFF;
+            }
+        }
+
+        zones.push_back(led_zone);
+    }
+
+    /*-----------------------------------------*\
+    | Add LEDs                                  |
+    \*-----------------------------------------*/
+    for(std::size_t zone_idx = 0; zone_idx < zones.size(); zone_idx++)
+    {
+        for(std::size_t led_idx = 0; led_idx < zones[zone_idx].leds_count; led_idx++)
+        {
+            led new_led;
+
+            new_led.name = zones[zone_idx].name + " LED ";
+            new_led.name.append(std::to_string(led_idx));
+
+            leds.push_back(new_led);
+        }
+    }
+
+    SetupColors();
+}
+
+void RGBController_DDP::ResizeZone(int /*zone*/, int /*new_size*/)
+{
+    /*---------------------------------------------------------*\
+    | This device does not support resizing zones               |
+    \*---------------------------------------------------------*/
+}
+
+void RGBController_DDP::DeviceUpdateLEDs()
+{
+    last_update_time = std::chrono::steady_clock::now();
+
+    /*-----------------------------------------*\
+    | Pack the colors into the channel buffer,  |
+    | all devices' channels are consecutive     |
+    \*-----------------------------------------*/
+    unsigned char* channel_ptr = channel_data.data();
+
+    for(std::size_t color_idx = 0; color_idx < colors.size(); color_idx++)
+    {
+        RGBColor color = colors[color_idx];
+
+        channel_ptr[0] = RGBGetRValue(color);
+        channel_ptr[1] = RGBGetGValue(color);
+        channel_ptr[2] = RGBGetBValue(color);
+        channel_ptr   += 3;
+    }
+
+    controller->SendFrame(channel_data.data());
+}
+
+void RGBController_DDP::UpdateZoneLEDs(int /*zone*/)
+{
+    DeviceUpdateLEDs();
+}
+
+void RGBController_DDP::UpdateSingleLED(int /*led*/)
+{
+    DeviceUpdateLEDs();
+}
+
+void RGBController_DDP::DeviceUpdateMode()
+{
+
+}
+
+void RGBController_DDP::KeepaliveThreadFunction()
+{
+    while(keepalive_thread_run.load())
+    {
+        if((std::chrono::steady_clock::now() - last_update_time) > ( keepalive_delay * 0.95f ) )
+        {
+            UpdateLEDs();
+        }
+        std::this_thread::sleep_for(keepalive_delay / 2);
+    }
+}
@@ -0,0 +1,61 @@
+/*---------------------------------------------------------*\
+| RGBController_DDP.h                                       |
+|                                                           |
+|   RGBController for Distributed Display Protocol (DDP)    |
+|   devices                                                 |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "RGBController.h"
+#include "DDPController.h"
+
+struct DDPDevice
+{
+    std::string name;
+    std::string ip;
+    std::string port;
+    unsigned int num_leds;
+    unsigned int start_offset;
+    unsigned char destination_id;
+    unsigned int keepalive_time;
+    zone_type type;
+    unsigned int matrix_width;
+    unsigned int matrix_height;
+};
+
+class RGBController_DDP : public RGBController
+{
+public:
+    RGBController_DDP(std::vector<DDPDevice> device_list);
+    ~RGBController_DDP();
+
+    void        SetupZones();
+
+    void        ResizeZone(int zone, int new_size);
+
+    void        DeviceUpdateLEDs();
+    void        UpdateZoneLEDs(int zone);
+    void        UpdateSingleLED(int led);
+
+    void        DeviceUpdateMode();
+
+    void        KeepaliveThreadFunction();
+
+private:
+    std::vector<DDPDevice>                              devices;
+    DDPController*                                      controller;
+    std::vector<unsigned char>                          channel_data;
+    std::thread *                                       keepalive_thread;
+    std::atomic<bool>                                   keepalive_thread_run;
+    std::chrono::milliseconds                           keepalive_delay;
+    std::chrono::time_point<std::chrono::steady_clock>  last_update_time;
+};
@@ -0,0 +1,156 @@
+/*---------------------------------------------------------*\
+| DMXUniverseMap.cpp                                        |
+|                                                           |
+|   Packs RGB colors into DMX universes for the network     |
+|   DMX protocols (E1.31, Art-Net)                          |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <map>
+#include "DMXUniverseMap.h"
+
+void DMXUniverseMap::Setup(const std::vector<DMXUniverseRun>& runs, const std::vector<unsigned int>& universes)
+{
+    std::map<unsigned int, unsigned int> universe_indices;
+
+    for(std::size_t universe_idx = 0; universe_idx < universes.size(); universe_idx++)
+    {
+        universe_indices[universes[universe_idx]] = (unsigned int)universe_idx;
+    }
+
+    unsigned int color_count = 0;
+
+    run_maps.clear();
+
+    for(std::size_t run_idx = 0; run_idx < runs.size(); run_idx++)
+    {
+        DMXUniverseRunMap   run_map;
+        unsigned int        universe_size   = runs[run_idx].universe_size;
+        unsigned int        total_channels  = runs[run_idx].num_leds * 3;
+        unsigned int        universe        = runs[run_idx].start_universe;
+        unsigned int        channel         = runs[run_idx].start_channel;
+        unsigned int        offset          = 0;
+
+        run_map.color_start = color_count;
+
+        /*-----------------------------------------*\
+        | Bit positions of the output channels in   |
+        | an RGBColor, which is stored as 0xBBGGRR  |
+        \*-----------------------------------------*/
+        switch(runs[run_idx].rgb_order)
+        {
+            case DMX_RGB_ORDER_RBG:
+                run_map.shift[0] = 0;  run_map.shift[1] = 16; run_map.shift[2] = 8;
+                break;
+            case DMX_RGB_ORDER_GRB:
+                run_map.shift[0] = 8;  run_map.shift[1] = 0;  run_map.shift[2] = 16;
+                break;
+            case DMX_RGB_ORDER_GBR:
+                run_map.shift[0] = 8;  run_map.shift[1] = 16; run_map.shift[2] = 0;
+                break;
+            case DMX_RGB_ORDER_BRG:
+                run_map.shift[0] = 16; run_map.shift[1] = 0;  run_map.shift[2] = 8;
+                break;
+            case DMX_RGB_ORDER_BGR:
+                run_map.shift[0] = 16; run_map.shift[1] = 8;  run_map.shift[2] = 0;
+                break;
+            default:
+                run_map.shift[0] = 0;  run_map.shift[1] = 8;  run_map.shift[2] = 16;
+                break;
+        }
+
+        /*-----------------------------------------*\
+        | Walk the universes the run covers, a      |
+        | universe without a buffer ends the run    |
+        \*-----------------------------------------*/
+        while(offset < total_channels)
+        {
+            std::map<unsigned int, unsigned int>::iterator universe_it = universe_indices.find(universe);
+
+            if(universe_it == universe_indices.end())
+            {
+                break;
+            }
+
+            if(channel >= 1 && channel <= universe_size)
+            {
+                DMXUniverseSegment segment;
+
+                segment.universe_idx    = universe_it->second;
+                segment.channel         = channel - 1;
+                segment.offset          = offset;
+                segment.length          = std::min(universe_size - channel + 1, total_channels - offset);
+
+                run_map.segments.push_back(segment);
+
+                offset += segment.length;
+            }
+
+            universe++;
+            channel = 1;
+        }
+
+        run_maps.push_back(run_map);
+
+        color_count += runs[run_idx].num_leds;
+    }
+}
+
+void DMXUniverseMap::Pack(const RGBColor* colors, unsigned char* const* universe_data) const
+{
+    for(std::size_t run_idx = 0; run_idx < run_maps.size(); run_idx++)
+    {
+        const DMXUniverseRunMap&    run_map = run_maps[run_idx];
+        const RGBColor*             run_colors = &colors[run_map.color_start];
+
+        for(std::size_t segment_idx = 0; segment_idx < run_map.segments.size(); segment_idx++)
+        {
+            const DMXUniverseSegment&   segment = run_map.segments[segment_idx];
+            unsigned char*              data    = universe_data[segment.universe_idx] + segment.channel;
+            unsigned int                channel = segment.offset;
+            unsigned int                end     = segment.offset + segment.length;
+
+            /*-------------------------------------*\
+            | A universe boundary can split an LED, |
+            | write its remaining channels first    |
+            \*-------------------------------------*/
+            while((channel < end) && ((channel % 3) != 0))
+            {
+                *data++ = (unsigned char)(run_colors[channel / 3] >> run_map.shift[channel % 3]);
+                channel++;
+            }
+
+            /*-------------------------------------*\
+            | Whole LEDs                            |
+            \*-------------------------------------*/
+            const RGBColor* color   = &run_colors[channel / 3];
+            unsigned int    shift_0 = run_map.shift[0];
+            unsigned int    shift_1 = run_map.shift[1];
+            unsigned int    shift_2 = run_map.shift[2];
+
+            for(; (channel + 3) <= end; channel += 3)
+            {
+                data[0] = (unsigned char)(*color >> shift_0);
+                data[1] = (unsigned char)(*color >> shift_1);
+                data[2] = (unsigned char)(*color >> shift_2);
+                data   += 3;
+                color++;
+            }
+
+            /*-------------------------------------*\
+            | The first channels of an LED that     |
+            | continues in the next universe        |
+            \*-------------------------------------*/
+            while(channel < end)
+            {
+                *data++ = (unsigned char)(run_colors[channel / 3] >> run_map.shift[channel % 3]);
+                channel++;
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*---------------------------------------------------------*\
+| DMXUniverseMap.h                                          |
+|                                                           |
+|   Packs RGB colors into DMX universes for the network     |
+|   DMX protocols (E1.31, Art-Net)                          |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <vector>
+#include "RGBController.h"
+
+/*---------------------------------------------------------*\
+| Channel orders, in the order of the E1.31 rgb_order       |
+| setting                                                   |
+\*---------------------------------------------------------*/
+enum
+{
+    DMX_RGB_ORDER_RGB,
+    DMX_RGB_ORDER_RBG,
+    DMX_RGB_ORDER_GRB,
+    DMX_RGB_ORDER_GBR,
+    DMX_RGB_ORDER_BRG,
+    DMX_RGB_ORDER_BGR
+};
+
+/*---------------------------------------------------------*\
+| A strip of LEDs starting at a channel (1-based) of a      |
+| universe, continuing at channel 1 of the next universes   |
+\*---------------------------------------------------------*/
+struct DMXUniverseRun
+{
+    unsigned int num_leds;
+    unsigned int start_universe;
+    unsigned int start_channel;
+    unsigned int universe_size;
+    unsigned int rgb_order;
+};
+
+/*---------------------------------------------------------*\
+| Channels offset to offset + length of a run, which go to  |
+| one universe starting at a channel (0-based)              |
+\*---------------------------------------------------------*/
+struct DMXUniverseSegment
+{
+    unsigned int universe_idx;
+    unsigned int channel;
+    unsigned int offset;
+    unsigned int length;
+};
+
+struct DMXUniverseRunMap
+{
+    unsigned int                    color_start;
+    unsigned int                    shift[3];
+    std::vector<DMXUniverseSegment> segments;
+};
+
+class DMXUniverseMap
+{
+public:
+    /*-----------------------------------------------------*\
+    | Universes are given as the list of universe numbers   |
+    | the caller has buffers for, runs take their colors    |
+    | one after the other                                   |
+    \*-----------------------------------------------------*/
+    void            Setup(const std::vector<DMXUniverseRun>& runs, const std::vector<unsigned int>& universes);
+
+    /*-----------------------------------------------------*\
+    | Write the colors straight into the universe buffers,  |
+    | universe_data[i] points at channel 1 of universe i    |
+    \*-----------------------------------------------------*/
+    void            Pack(const RGBColor* colors, unsigned char* const* universe_data) const;
+
+private:
+    std::vector<DMXUniverseRunMap>  run_maps;
+};
@@ -49,7 +49,7 @@ void DetectE131Controllers()
             dev.ip             = "";
             dev.type           = ZONE_TYPE_SINGLE;
             dev.num_leds       = 0;
-            dev.rgb_order      = E131_RGB_ORDER_RBG;
+            dev.rgb_order      = E131_RGB_ORDER_RGB;
             dev.matrix_order   = E131_MATRIX_ORDER_HORIZONTAL_TOP_LEFT;
             dev.matrix_width   = 0;
             dev.matrix_height  = 0;
@@ -57,6 +57,7 @@ void DetectE131Controllers()
             dev.start_universe = 1;
             dev.keepalive_time = 0;
             dev.universe_size  = 512;
+            dev.sync_universe  = 0;
 
             if(e131_settings["devices"][device_idx].contains("name"))
             {
@@ -185,6 +186,11 @@ void DetectE131Controllers()
                 dev.universe_size = e131_settings["devices"][device_idx]["universe_size"];
             }
 
+            if(e131_settings["devices"][device_idx].contains("sync_universe"))
+            {
+                dev.sync_universe = e131_settings["devices"][device_idx]["sync_universe"];
+            }
+
             if(e131_settings["devices"][device_idx].contains("type"))
             {
                 if(e131_settings["devices"][device_idx]["type"].is_string())
@@ -284,4 +290,4 @@ void DetectE131Controllers()
 
 }   /* DetectE131Controllers() */
 
-REGISTER_DETECTOR("E1.31", DetectE131Controllers);
+REGISTER_NETWORK_DETECTOR("E1.31", DetectE131Controllers);
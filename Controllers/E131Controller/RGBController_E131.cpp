@@ -11,8 +11,15 @@
 
 #include <e131.h>
 #include <math.h>
+#include <string.h>
 #include "RGBController_E131.h"
 
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#endif
+
 using namespace std::chrono_literals;
 
 /**------------------------------------------------------------------*\
@@ -296,6 +303,8 @@ RGBController_E131::RGBController_E131(std::vector<E131Device> device_list)
         }
     }
 
+    SetupUniverseMap();
+
     if(keepalive_delay.count() > 0)
     {
         keepalive_thread_run = 1;
@@ -378,68 +387,141 @@ void RGBController_E131::ResizeZone(int /*zone*/, int /*new_size*/)
     \*---------------------------------------------------------*/
 }
 
-void RGBController_E131::DeviceUpdateLEDs()
+/*---------------------------------------------------------*\
+| Precompute where each device's channels go, so that a     |
+| frame is packed straight into the universe packets        |
+\*---------------------------------------------------------*/
+void RGBController_E131::SetupUniverseMap()
 {
-    int color_idx = 0;
-
-    last_update_time = std::chrono::steady_clock::now();
+    std::vector<DMXUniverseRun> runs;
 
     for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
     {
-        float universe_size = (float)devices[device_idx].universe_size;
-        unsigned int total_universes = (unsigned int)ceil( ( ( devices[device_idx].num_leds * 3 ) + devices[device_idx].start_channel ) / universe_size );
-        unsigned int channel_idx = devices[device_idx].start_channel;
-        unsigned int led_idx = 0;
-        unsigned int rgb_idx = 0;
-        bool         done = false;
+        DMXUniverseRun run;
 
-        for (unsigned int univ_idx = 0; univ_idx < total_universes; univ_idx++)
-        {
-            unsigned int universe = devices[device_idx].start_universe + univ_idx;
+        run.num_leds        = devices[device_idx].num_leds;
+        run.start_universe  = devices[device_idx].start_universe;
+        run.start_channel   = devices[device_idx].start_channel;
+        run.universe_size   = devices[device_idx].universe_size;
+        run.rgb_order       = devices[device_idx].rgb_order;
 
-            for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
-            {
-                if(!done && (universes[packet_idx] == universe))
-                {
-                    while(!done && (channel_idx <= universe_size))
-                    {
-                        switch(rgb_idx)
-                        {
-                            case 0:
-                                packets[packet_idx].dmp.prop_val[channel_idx] = RGBGetRValue( colors[color_idx] );
-                                rgb_idx = 1;
-                                break;
-                            case 1:
-                                packets[packet_idx].dmp.prop_val[channel_idx] = RGBGetGValue( colors[color_idx] );
-                                rgb_idx = 2;
-                                break;
-                            case 2:
-                                packets[packet_idx].dmp.prop_val[channel_idx] = RGBGetBValue( colors[color_idx] );
-                                rgb_idx = 0;
-                                led_idx++;
-                                color_idx++;
-                                break;
-                        }
+        runs.push_back(run);
+    }
 
-                        if(led_idx >= devices[device_idx].num_leds)
-                        {
-                            done = true;
-                        }
+    universe_map.Setup(runs, universes);
 
-                        channel_idx++;
-                    }
-                }
-            }
+    universe_data.resize(packets.size());
+
+    for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+    {
+        universe_data[packet_idx] = &packets[packet_idx].dmp.prop_val[1];
+    }
+
+    /*-----------------------------------------*\
+    | Universe synchronization, the first       |
+    | device that sets a sync universe sets it  |
+    | for the whole group                       |
+    \*-----------------------------------------*/
+    sync_universe = 0;
+
+    for(std::size_t device_idx = 0; device_idx < devices.size() && !packets.empty(); device_idx++)
+    {
+        if(devices[device_idx].sync_universe != 0)
+        {
+            sync_universe = devices[device_idx].sync_universe;
+            break;
+        }
+    }
 
-            channel_idx = 1;
+    if(sync_universe != 0)
+    {
+        /*-----------------------------------------*\
+        | Data packets name the sync universe in    |
+        | the framing layer field libe131 calls     |
+        | reserved, receivers then hold the data    |
+        | until the sync packet arrives             |
+        \*-----------------------------------------*/
+        for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+        {
+            packets[packet_idx].frame.reserved = htons((uint16_t)sync_universe);
+        }
+
+        /*-----------------------------------------*\
+        | Synchronization packet: the root layer of |
+        | the data packets with the extended root   |
+        | vector, followed by an 11 byte framing    |
+        | layer                                     |
+        \*-----------------------------------------*/
+        memset(sync_packet, 0, sizeof(sync_packet));
+        memcpy(sync_packet, packets[0].raw, 38);
+
+        uint16_t root_flength   = htons(0x7000 | (sizeof(sync_packet) - 16));
+        uint32_t root_vector    = htonl(0x00000008);
+        uint16_t frame_flength  = htons(0x7000 | (sizeof(sync_packet) - 38));
+        uint32_t frame_vector   = htonl(0x00000001);
+        uint16_t sync_address   = htons((uint16_t)sync_universe);
+
+        memcpy(&sync_packet[16], &root_flength,  sizeof(root_flength));
+        memcpy(&sync_packet[18], &root_vector,   sizeof(root_vector));
+        memcpy(&sync_packet[38], &frame_flength, sizeof(frame_flength));
+        memcpy(&sync_packet[40], &frame_vector,  sizeof(frame_vector));
+        memcpy(&sync_packet[45], &sync_address,  sizeof(sync_address));
+
+        if(devices[0].ip != "")
+        {
+            e131_unicast_dest(&sync_dest_addr, devices[0].ip.c_str(), E131_DEFAULT_PORT);
+        }
+        else
+        {
+            e131_multicast_dest(&sync_dest_addr, (uint16_t)sync_universe, E131_DEFAULT_PORT);
         }
     }
 
+    /*-----------------------------------------*\
+    | Buffers and destinations for sending all  |
+    | universe packets of a frame at once       |
+    \*-----------------------------------------*/
+    send_buffers.resize(packets.size());
+    send_lengths.resize(packets.size());
+    send_dests.resize(packets.size());
+
+    for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+    {
+        send_buffers[packet_idx]    = (char *)packets[packet_idx].raw;
+        send_lengths[packet_idx]    = (int)(sizeof(packets[packet_idx].raw) - sizeof(packets[packet_idx].dmp.prop_val) + ntohs(packets[packet_idx].dmp.prop_val_cnt));
+        send_dests[packet_idx]      = (const sockaddr *)&dest_addrs[packet_idx];
+    }
+}
+
+void RGBController_E131::DeviceUpdateLEDs()
+{
+    last_update_time = std::chrono::steady_clock::now();
+
+    universe_map.Pack(colors.data(), universe_data.data());
+
+    SendPackets();
+
     for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
     {
-        e131_send(sockfd, &packets[packet_idx], &dest_addrs[packet_idx]);
         packets[packet_idx].frame.seq_number++;
     }
+
+    if(sync_universe != 0)
+    {
+        SendSyncPacket();
+    }
+}
+
+void RGBController_E131::SendPackets()
+{
+    net_port::udp_write_multiple(sockfd, send_dests.data(), sizeof(e131_addr_t), send_buffers.data(), send_lengths.data(), (int)send_buffers.size());
+}
+
+void RGBController_E131::SendSyncPacket()
+{
+    sendto(sockfd, (const char *)sync_packet, sizeof(sync_packet), 0, (const struct sockaddr *)&sync_dest_addr, sizeof(sync_dest_addr));
+
+    sync_packet[44]++;
 }
 
 void RGBController_E131::UpdateZoneLEDs(int /*zone*/)
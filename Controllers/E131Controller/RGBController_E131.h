@@ -15,17 +15,19 @@
 #include <thread>
 #include <e131.h>
 #include "RGBController.h"
+#include "DMXUniverseMap.h"
+#include "net_port.h"
 
 typedef unsigned int e131_rgb_order;
 
 enum
 {
-    E131_RGB_ORDER_RGB,
-    E131_RGB_ORDER_RBG,
-    E131_RGB_ORDER_GRB,
-    E131_RGB_ORDER_GBR,
-    E131_RGB_ORDER_BRG,
-    E131_RGB_ORDER_BGR
+    E131_RGB_ORDER_RGB = DMX_RGB_ORDER_RGB,
+    E131_RGB_ORDER_RBG = DMX_RGB_ORDER_RBG,
+    E131_RGB_ORDER_GRB = DMX_RGB_ORDER_GRB,
+    E131_RGB_ORDER_GBR = DMX_RGB_ORDER_GBR,
+    E131_RGB_ORDER_BRG = DMX_RGB_ORDER_BRG,
+    E131_RGB_ORDER_BGR = DMX_RGB_ORDER_BGR
 };
 
 enum
@@ -56,6 +58,7 @@ struct E131Device
     unsigned int matrix_height;
     unsigned int universe_size;
     e131_matrix_order matrix_order;
+    unsigned int sync_universe;
 };
 
 class RGBController_E131 : public RGBController
@@ -77,6 +80,10 @@ public:
     void        KeepaliveThreadFunction();
 
 private:
+    void        SetupUniverseMap();
+    void        SendPackets();
+    void        SendSyncPacket();
+
 	std::vector<E131Device> 	devices;
     std::vector<e131_packet_t> 	packets;
 	std::vector<e131_addr_t> 	dest_addrs;
@@ -86,4 +93,15 @@ private:
     std::atomic<bool>           keepalive_thread_run;
     std::chrono::milliseconds                           keepalive_delay;
     std::chrono::time_point<std::chrono::steady_clock>  last_update_time;
+
+    DMXUniverseMap              universe_map;
+    std::vector<unsigned char*> universe_data;
+
+    unsigned int                sync_universe;
+    unsigned char               sync_packet[49];
+    e131_addr_t                 sync_dest_addr;
+
+    std::vector<char *>             send_buffers;
+    std::vector<int>                send_lengths;
+    std::vector<const sockaddr *>   send_dests;
 };
@@ -364,6 +364,12 @@ void ENESMBusController::SetAllColorsDirect(RGBColor* colors)
         color_buf[i + 2] = RGBGetGValue(colors[i / 3]);
     }
 
+    /*-----------------------------------------------------*\
+    | Queue the whole frame so that it is sent to the bus   |
+    | in one batch                                          |
+    \*-----------------------------------------------------*/
+    interface->BeginBatch();
+
     while(bytes_sent < (led_count * 3))
     {
         int bytes_to_send = (led_count * 3) - bytes_sent;
@@ -378,6 +384,8 @@ void ENESMBusController::SetAllColorsDirect(RGBColor* colors)
         bytes_sent += bytes_to_send;
     }
 
+    interface->EndBatch();
+
     delete[] color_buf;
 }
 
@@ -393,6 +401,12 @@ void ENESMBusController::SetAllColorsEffect(RGBColor* colors)
         color_buf[i + 2] = RGBGetGValue(colors[i / 3]);
     }
 
+    /*-----------------------------------------------------*\
+    | Queue the whole frame so that it is sent to the bus   |
+    | in one batch                                          |
+    \*-----------------------------------------------------*/
+    interface->BeginBatch();
+
     while(bytes_sent < (led_count * 3))
     {
         int bytes_to_send = (led_count * 3) - bytes_sent;
@@ -409,14 +423,20 @@ void ENESMBusController::SetAllColorsEffect(RGBColor* colors)
 
     ENERegisterWrite(ENE_REG_APPLY, ENE_APPLY_VAL);
 
+    interface->EndBatch();
+
     delete[] color_buf;
 }
 
 
 void ENESMBusController::SetDirect(unsigned char direct)
 {
+    interface->BeginBatch();
+
     ENERegisterWrite(ENE_REG_DIRECT, direct);
     ENERegisterWrite(ENE_REG_APPLY, ENE_APPLY_VAL);
+
+    interface->EndBatch();
 }
 
 void ENESMBusController::SetLEDColorDirect(unsigned int led, unsigned char red, unsigned char green, unsigned char blue)
@@ -437,10 +457,14 @@ void ENESMBusController::SetLEDColorEffect(unsigned int led, unsigned char red,
 
 void ENESMBusController::SetMode(unsigned char mode, unsigned char speed, unsigned char direction)
 {
+    interface->BeginBatch();
+
     ENERegisterWrite(ENE_REG_MODE,      mode);
     ENERegisterWrite(ENE_REG_SPEED,     speed);
     ENERegisterWrite(ENE_REG_DIRECTION, direction);
     ENERegisterWrite(ENE_REG_APPLY,     ENE_APPLY_VAL);
+
+    interface->EndBatch();
 }
 
 bool ENESMBusController::SupportsMode14()
@@ -38,4 +38,12 @@ public:
     virtual unsigned char       ENERegisterRead(ene_dev_id dev, ene_register reg) = 0;
     virtual void                ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val) = 0;
     virtual void                ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz) = 0;
+
+    /*-----------------------------------------*\
+    | Register writes between BeginBatch and    |
+    | EndBatch may be queued and sent together. |
+    | Interfaces without batching write at once |
+    \*-----------------------------------------*/
+    virtual void                BeginBatch() {}
+    virtual void                EndBatch() {}
 };
@@ -13,7 +13,8 @@
 
 ENESMBusInterface_i2c_smbus::ENESMBusInterface_i2c_smbus(i2c_smbus_interface* bus)
 {
-    this->bus = bus;
+    this->bus       = bus;
+    this->batching  = false;
 }
 
 ENESMBusInterface_i2c_smbus::~ENESMBusInterface_i2c_smbus()
@@ -39,6 +40,13 @@ int ENESMBusInterface_i2c_smbus::GetMaxBlock()
 
 unsigned char ENESMBusInterface_i2c_smbus::ENERegisterRead(ene_dev_id dev, ene_register reg)
 {
+    //Send queued writes first so the read sees them
+    if(batching)
+    {
+        bus->i2c_smbus_xfer_batch_call(batch);
+        batch.clear();
+    }
+
     //Write ENE register
     bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
 
@@ -48,6 +56,13 @@ unsigned char ENESMBusInterface_i2c_smbus::ENERegisterRead(ene_dev_id dev, ene_r
 
 void ENESMBusInterface_i2c_smbus::ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val)
 {
+    if(batching)
+    {
+        batch.write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
+        batch.write_byte_data(dev, 0x01, val);
+        return;
+    }
+
     //Write ENE register
     bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
 
@@ -57,9 +72,31 @@ void ENESMBusInterface_i2c_smbus::ENERegisterWrite(ene_dev_id dev, ene_register
 
 void ENESMBusInterface_i2c_smbus::ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz)
 {
+    if(batching)
+    {
+        batch.write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
+        batch.write_block_data(dev, 0x03, sz, data);
+        return;
+    }
+
     //Write ENE register
     bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
 
     //Write ENE block data
     bus->i2c_smbus_write_block_data(dev, 0x03, sz, data);
 }
+
+void ENESMBusInterface_i2c_smbus::BeginBatch()
+{
+    batch.clear();
+    batching = true;
+}
+
+void ENESMBusInterface_i2c_smbus::EndBatch()
+{
+    batching = false;
+
+    //Send all queued register writes in one bus transaction batch
+    bus->i2c_smbus_xfer_batch_call(batch);
+    batch.clear();
+}
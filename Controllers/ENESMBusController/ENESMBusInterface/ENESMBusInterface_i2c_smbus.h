@@ -26,7 +26,11 @@ public:
     unsigned char       ENERegisterRead(ene_dev_id dev, ene_register reg);
     void                ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val);
     void                ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz);
+    void                BeginBatch();
+    void                EndBatch();
 
 private:
     i2c_smbus_interface *   bus;
+    bool                    batching;
+    i2c_smbus_batch         batch;
 };
@@ -50,4 +50,4 @@ void DetectElgatoKeyLightControllers()
 
 }   /* DetectElgatoKeyLightControllers() */
 
-REGISTER_DETECTOR("ElgatoKeyLight", DetectElgatoKeyLightControllers);
+REGISTER_NETWORK_DETECTOR("ElgatoKeyLight", DetectElgatoKeyLightControllers);
@@ -35,7 +35,7 @@ bool TestForGigabyteRGBFusionController(i2c_smbus_interface* bus, unsigned char
 {
     bool pass = false;
 
-    int res = bus->i2c_smbus_write_quick(address, I2C_SMBUS_WRITE);
+    int res = bus->i2c_smbus_probe_address(address, I2C_SMBUS_QUICK);
 
     if (res >= 0)
     {
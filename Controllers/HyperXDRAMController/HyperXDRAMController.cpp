@@ -30,6 +30,8 @@ HyperXDRAMController::HyperXDRAMController(i2c_smbus_interface* bus, hyperx_dev_
     }
 
     mode = HYPERX_MODE_DIRECT;
+
+    batching = false;
 }
 
 HyperXDRAMController::~HyperXDRAMController()
@@ -73,28 +75,46 @@ unsigned int HyperXDRAMController::GetMode()
     return(mode);
 }
 
+/*---------------------------------------------------------*\
+| Register writes between BeginBatch and EndBatch are       |
+| queued and sent to the bus with a single hand-off         |
+\*---------------------------------------------------------*/
+void HyperXDRAMController::BeginBatch()
+{
+    batch.clear();
+    batching = true;
+}
+
+void HyperXDRAMController::EndBatch()
+{
+    batching = false;
+
+    bus->i2c_smbus_xfer_batch_call(batch);
+    batch.clear();
+}
+
 void HyperXDRAMController::SendApply()
 {
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x02);
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x03);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x02);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x03);
 }
 
 void HyperXDRAMController::SetEffectColor(unsigned char red, unsigned char green, unsigned char blue)
 {
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x01);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x01);
 
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_EFFECT_RED,        red  );
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_EFFECT_GREEN,      green);
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_EFFECT_BLUE,       blue );
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_EFFECT_BRIGHTNESS, 0x64 );
+    HyperXRegisterWrite(HYPERX_REG_EFFECT_RED,        red  );
+    HyperXRegisterWrite(HYPERX_REG_EFFECT_GREEN,      green);
+    HyperXRegisterWrite(HYPERX_REG_EFFECT_BLUE,       blue );
+    HyperXRegisterWrite(HYPERX_REG_EFFECT_BRIGHTNESS, 0x64 );
 
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x02);
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x03);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x02);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x03);
 }
 
 void HyperXDRAMController::SetAllColors(unsigned char red, unsigned char green, unsigned char blue)
 {
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x01);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x01);
 
     /*-----------------------------------------------------*\
     | Loop through all slots and only set those which are   |
@@ -115,21 +135,21 @@ void HyperXDRAMController::SetAllColors(unsigned char red, unsigned char green,
 
             if(mode == HYPERX_MODE_DIRECT)
             {
-                bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_MODE_INDEPENDENT, HYPERX_MODE3_DIRECT);
+                HyperXRegisterWrite(HYPERX_REG_MODE_INDEPENDENT, HYPERX_MODE3_DIRECT);
             }
 
             for(int led = 0; led < 5; led++)
             {
-                bus->i2c_smbus_write_byte_data(dev, red_base    + (3 * led), red  );
-                bus->i2c_smbus_write_byte_data(dev, green_base  + (3 * led), green);
-                bus->i2c_smbus_write_byte_data(dev, blue_base   + (3 * led), blue );
-                bus->i2c_smbus_write_byte_data(dev, bright_base + (3 * led), 0x64 );
+                HyperXRegisterWrite(red_base    + (3 * led), red  );
+                HyperXRegisterWrite(green_base  + (3 * led), green);
+                HyperXRegisterWrite(blue_base   + (3 * led), blue );
+                HyperXRegisterWrite(bright_base + (3 * led), 0x64 );
             }
         }
     }
 
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x02);
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x03);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x02);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x03);
 }
 
 void HyperXDRAMController::SetLEDColor(unsigned int led, unsigned char red, unsigned char green, unsigned char blue)
@@ -178,12 +198,12 @@ void HyperXDRAMController::SetLEDColor(unsigned int slot, unsigned int led, unsi
     unsigned char blue_base   = base + 0x02;
     unsigned char bright_base = base + 0x10;
 
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x01);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x01);
 
-    bus->i2c_smbus_write_byte_data(dev, red_base    + (3 * led), red  );
-    bus->i2c_smbus_write_byte_data(dev, green_base  + (3 * led), green);
-    bus->i2c_smbus_write_byte_data(dev, blue_base   + (3 * led), blue );
-    bus->i2c_smbus_write_byte_data(dev, bright_base + (3 * led), 0x64 );
+    HyperXRegisterWrite(red_base    + (3 * led), red  );
+    HyperXRegisterWrite(green_base  + (3 * led), green);
+    HyperXRegisterWrite(blue_base   + (3 * led), blue );
+    HyperXRegisterWrite(bright_base + (3 * led), 0x64 );
 }
 
 void HyperXDRAMController::SetMode(unsigned char new_mode, bool random, unsigned short new_speed)
@@ -191,7 +211,7 @@ void HyperXDRAMController::SetMode(unsigned char new_mode, bool random, unsigned
     mode  = new_mode;
     speed = new_speed;
 
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x01);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x01);
 
     /*-----------------------------------------------------*\
     | Determine which mode register to use.                 |
@@ -212,68 +232,80 @@ void HyperXDRAMController::SetMode(unsigned char new_mode, bool random, unsigned
     switch (mode)
     {
     case HYPERX_MODE_DIRECT:
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_MODE_INDEPENDENT, HYPERX_MODE3_DIRECT);
+        HyperXRegisterWrite(HYPERX_REG_MODE_INDEPENDENT, HYPERX_MODE3_DIRECT);
         break;
 
     case HYPERX_MODE_STATIC:
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_MODE_CUSTOM, HYPERX_MODE2_STATIC);
+        HyperXRegisterWrite(HYPERX_REG_MODE_CUSTOM, HYPERX_MODE2_STATIC);
         break;
 
     case HYPERX_MODE_RAINBOW:
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_MODE_RANDOM, HYPERX_MODE1_RAINBOW);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_TIMER_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_TIMER_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_MODE_RANDOM, HYPERX_MODE1_RAINBOW);
+        HyperXRegisterWrite(HYPERX_REG_TIMER_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_TIMER_LSB, speed & 0xFF);
         break;
 
     case HYPERX_MODE_COMET:
-        bus->i2c_smbus_write_byte_data(dev, mode_reg, HYPERX_MODE2_COMET);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_TIMER_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_TIMER_LSB, speed & 0xFF);
+        HyperXRegisterWrite(mode_reg, HYPERX_MODE2_COMET);
+        HyperXRegisterWrite(HYPERX_REG_TIMER_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_TIMER_LSB, speed & 0xFF);
         break;
 
     case HYPERX_MODE_HEARTBEAT:
-        bus->i2c_smbus_write_byte_data(dev, mode_reg, HYPERX_MODE2_HEARTBEAT);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_OFF_TIME_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_OFF_TIME_LSB, speed & 0xFF);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_ON_TIME_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_ON_TIME_LSB, speed & 0xFF);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_DELAY_TIME_MSB, 0x03);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_DELAY_TIME_LSB, 0xE8);
+        HyperXRegisterWrite(mode_reg, HYPERX_MODE2_HEARTBEAT);
+        HyperXRegisterWrite(HYPERX_REG_OFF_TIME_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_OFF_TIME_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_ON_TIME_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_ON_TIME_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_DELAY_TIME_MSB, 0x03);
+        HyperXRegisterWrite(HYPERX_REG_DELAY_TIME_LSB, 0xE8);
         break;
 
     case HYPERX_MODE_CYCLE:
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_MODE_RANDOM, HYPERX_MODE1_CYCLE);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_ON_TIME_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_ON_TIME_LSB, speed & 0xFF);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_CHANGE_TIME_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_CHANGE_TIME_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_MODE_RANDOM, HYPERX_MODE1_CYCLE);
+        HyperXRegisterWrite(HYPERX_REG_ON_TIME_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_ON_TIME_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_CHANGE_TIME_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_CHANGE_TIME_LSB, speed & 0xFF);
         break;
 
     case HYPERX_MODE_BREATHING:
-        bus->i2c_smbus_write_byte_data(dev, mode_reg, HYPERX_MODE2_BREATHING);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_FADE_IN_TIME_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_FADE_IN_TIME_LSB, speed & 0xFF);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_FADE_OUT_TIME_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_FADE_OUT_TIME_LSB, speed & 0xFF);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_OFF_TIME_MSB, 0x00);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_OFF_TIME_LSB, 0x00);
+        HyperXRegisterWrite(mode_reg, HYPERX_MODE2_BREATHING);
+        HyperXRegisterWrite(HYPERX_REG_FADE_IN_TIME_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_FADE_IN_TIME_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_FADE_OUT_TIME_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_FADE_OUT_TIME_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_OFF_TIME_MSB, 0x00);
+        HyperXRegisterWrite(HYPERX_REG_OFF_TIME_LSB, 0x00);
         break;
 
     case HYPERX_MODE_BOUNCE:
-        bus->i2c_smbus_write_byte_data(dev, mode_reg, HYPERX_MODE2_BOUNCE);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_TIMER_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_TIMER_LSB, speed & 0xFF);
+        HyperXRegisterWrite(mode_reg, HYPERX_MODE2_BOUNCE);
+        HyperXRegisterWrite(HYPERX_REG_TIMER_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_TIMER_LSB, speed & 0xFF);
         break;
 
     case HYPERX_MODE_BLINK:
-        bus->i2c_smbus_write_byte_data(dev, mode_reg, HYPERX_MODE2_BLINK);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_OFF_TIME_MSB, speed >> 8);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_OFF_TIME_LSB, speed & 0xFF);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_ON_TIME_MSB, 0x07);
-        bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_ON_TIME_LSB, 0xD4);
+        HyperXRegisterWrite(mode_reg, HYPERX_MODE2_BLINK);
+        HyperXRegisterWrite(HYPERX_REG_OFF_TIME_MSB, speed >> 8);
+        HyperXRegisterWrite(HYPERX_REG_OFF_TIME_LSB, speed & 0xFF);
+        HyperXRegisterWrite(HYPERX_REG_ON_TIME_MSB, 0x07);
+        HyperXRegisterWrite(HYPERX_REG_ON_TIME_LSB, 0xD4);
         break;
     }
 
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x02);
-    bus->i2c_smbus_write_byte_data(dev, HYPERX_REG_APPLY, 0x03);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x02);
+    HyperXRegisterWrite(HYPERX_REG_APPLY, 0x03);
+}
+
+void HyperXDRAMController::HyperXRegisterWrite(unsigned char reg, unsigned char val)
+{
+    if(batching)
+    {
+        batch.write_byte_data(dev, reg, val);
+    }
+    else
+    {
+        bus->i2c_smbus_write_byte_data(dev, reg, val);
+    }
 }
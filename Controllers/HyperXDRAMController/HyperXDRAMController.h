@@ -214,6 +214,9 @@ public:
     unsigned int    GetSlotCount();
     unsigned int    GetMode();
 
+    void            BeginBatch();
+    void            EndBatch();
+
     void            SendApply();
 
     void            SetMode(unsigned char new_mode, bool random, unsigned short new_speed);
@@ -230,4 +233,8 @@ private:
     hyperx_dev_id           dev;
     unsigned int            mode;
     unsigned short          speed;
+    bool                    batching;
+    i2c_smbus_batch         batch;
+
+    void                    HyperXRegisterWrite(unsigned char reg, unsigned char val);
 };
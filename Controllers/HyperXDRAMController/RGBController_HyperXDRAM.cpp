@@ -190,6 +190,8 @@ void RGBController_HyperXDRAM::DeviceUpdateLEDs()
 {
     if(controller->GetMode() == HYPERX_MODE_DIRECT)
     {
+        controller->BeginBatch();
+
         for(unsigned int led_idx = 0; led_idx < (unsigned int)colors.size(); led_idx++ )
         {
             RGBColor      color = colors[led_idx];
@@ -200,6 +202,8 @@ void RGBController_HyperXDRAM::DeviceUpdateLEDs()
             controller->SetLEDColor(led_idx, red, grn, blu);
         }
         controller->SendApply();
+
+        controller->EndBatch();
     }
     else
     {
@@ -215,6 +219,8 @@ void RGBController_HyperXDRAM::UpdateZoneLEDs(int zone)
 {
     if(controller->GetMode() == HYPERX_MODE_DIRECT)
     {
+        controller->BeginBatch();
+
         for(std::size_t led_idx = 0; led_idx < zones[zone].leds_count; led_idx++ )
         {
             unsigned int  led   = zones[zone].leds[led_idx].value;
@@ -226,6 +232,8 @@ void RGBController_HyperXDRAM::UpdateZoneLEDs(int zone)
             controller->SetLEDColor(led, red, grn, blu);
         }
         controller->SendApply();
+
+        controller->EndBatch();
     }
     else
     {
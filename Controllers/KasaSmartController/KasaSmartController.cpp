@@ -25,25 +25,30 @@ KasaSmartController::KasaSmartController(std::string ipAddress, std::string name
     \*------------------------------------------------*/
     location = "IP: " + ipAddress;
 
+    is_initialized = false;
+
+    /*--------------------------------------------------------*\
+    | Set light state commands only differ in hue, saturation  |
+    | and brightness, compile them once                        |
+    \*--------------------------------------------------------*/
+    light_state_template.compile(KASA_SMART_LIGHT_SET_LIGHT_STATE_COMMAND_FORMAT);
+    ledstrip_state_template.compile(KASA_SMART_LEDSTRIP_SET_LIGHT_STATE_COMMAND_FORMAT);
+
     /*---------------------------------------------------------*\
-    | Create a TCP client sending to the device's IP, port 9999 |
+    | Open a TCP session to the device's IP, port 9999.  It is  |
+    | kept open and reopened by the transport when it drops.    |
+    | The bulb serves one command at a time, keep the next one  |
+    | queued behind it.                                         |
     \*---------------------------------------------------------*/
-    port.tcp_client(ipAddress.c_str(), "9999");
+    transport.set_max_in_flight(KASA_SMART_MAX_IN_FLIGHT);
+    transport.open_tcp(ipAddress.c_str(), "9999", SMART_LIGHT_FRAMING_LENGTH_PREFIX, KASA_SMART_MAX_CONNECTION_ATTEMPTS);
 }
 
 bool KasaSmartController::Initialize()
 {
     is_initialized = false;
-    retry_count = 0;
 
-    /*--------------*\
-    | Try to connect |
-    \*--------------*/
-    while(!port.connected && !port.tcp_client_connect() && retry_count < KASA_SMART_MAX_CONNECTION_ATTEMPTS)
-    {
-        ++retry_count;
-    }
-    if(!port.connected)
+    if(!transport.is_connected())
     {
         /*----------------*\
         | Couldn't connect |
@@ -53,8 +58,7 @@ bool KasaSmartController::Initialize()
 
     const std::string system_info_query(KASA_SMART_SYSTEM_INFO_QUERY);
     std::string system_info_json;
-    bool command_sent = KasaSmartController::SendCommand(system_info_query, system_info_json);
-    port.tcp_close();
+    bool command_sent = KasaSmartController::RequestCommand(system_info_query, system_info_json);
     if(!command_sent || system_info_json.empty())
     {
         /*---------------------------------------*\
@@ -147,10 +151,7 @@ bool KasaSmartController::Initialize()
 
 KasaSmartController::~KasaSmartController()
 {
-    if(port.connected)
-    {
-        port.tcp_close();
-    }
+    transport.close();
 }
 
 std::string KasaSmartController::GetLocation()
@@ -183,6 +184,11 @@ int KasaSmartController::GetKasaType()
     return(kasa_type);
 }
 
+smart_light_stats KasaSmartController::GetLatencyStats()
+{
+    return(transport.get_stats());
+}
+
 void KasaSmartController::SetColor(unsigned char red, unsigned char green, unsigned char blue, int device_type)
 {
     if(!is_initialized)
@@ -208,16 +214,6 @@ void KasaSmartController::SetColor(unsigned char red, unsigned char green, unsig
     unsigned int normalized_saturation = hsv.saturation * 100 / 255;
     unsigned int normalized_value      = hsv.value * 100 / 255;
 
-
-    /*-------------------*\
-    | Open TCP connection |
-    \*-------------------*/
-    if(!port.connected && !port.tcp_client_connect() && ++retry_count >= KASA_SMART_MAX_CONNECTION_ATTEMPTS)
-    {
-        is_initialized = false;
-        return;
-    }
-
     /*----------------------------*\
     | Hack to handle/emulate black |
     \*----------------------------*/
@@ -227,35 +223,31 @@ void KasaSmartController::SetColor(unsigned char red, unsigned char green, unsig
         return;
     }
 
-    /*------------------------------*\
-    | Format set light state command |
-    \*------------------------------*/
-    std::string set_lightstate_command_format;
+    /*---------------------------------------*\
+    | Patch the values into the light state   |
+    | command template                        |
+    \*---------------------------------------*/
+    smart_light_template* set_lightstate_command;
     if(device_type == DEVICE_TYPE_LIGHT)
     {
-        set_lightstate_command_format = KASA_SMART_LIGHT_SET_LIGHT_STATE_COMMAND_FORMAT;
+        set_lightstate_command = &light_state_template;
     }
     else if(device_type == DEVICE_TYPE_LEDSTRIP)
     {
-        set_lightstate_command_format = KASA_SMART_LEDSTRIP_SET_LIGHT_STATE_COMMAND_FORMAT;
+        set_lightstate_command = &ledstrip_state_template;
     }
-    int size = std::snprintf(nullptr, 0, set_lightstate_command_format.c_str(), normalized_hue, normalized_saturation, normalized_value) + 1;
-    if(size <= 0)
+    else
     {
-        port.tcp_close();
         return;
     }
-    char* buf = new char[size];
-    std::snprintf(buf, size, set_lightstate_command_format.c_str(), normalized_hue, normalized_saturation, normalized_value);
-    std::string set_lightstate_command(buf, buf + size - 1);
-    delete[] buf;
+    set_lightstate_command->set_field(0, normalized_hue);
+    set_lightstate_command->set_field(1, normalized_saturation);
+    set_lightstate_command->set_field(2, normalized_value);
 
     /*-----------------------------*\
     | Send command, ignore response |
     \*-----------------------------*/
-    std::string response;
-    KasaSmartController::SendCommand(set_lightstate_command, response);
-    port.tcp_close();
+    KasaSmartController::SendCommand(set_lightstate_command->data(), set_lightstate_command->length());
 }
 
 void KasaSmartController::SetEffect(std::string effect)
@@ -265,18 +257,7 @@ void KasaSmartController::SetEffect(std::string effect)
         return;
     }
 
-    /*-------------------*\
-    | Open TCP connection |
-    \*-------------------*/
-    if(!port.connected && !port.tcp_client_connect() && ++retry_count >= KASA_SMART_MAX_CONNECTION_ATTEMPTS)
-    {
-        is_initialized = false;
-        return;
-    }
-
-    std::string response;
-    KasaSmartController::SendCommand(effect, response);
-    port.tcp_close();
+    KasaSmartController::SendCommand(effect.c_str(), (int)effect.length());
 }
 
 void KasaSmartController::TurnOff(int device_type)
@@ -296,76 +277,45 @@ void KasaSmartController::TurnOff(int device_type)
         turn_off_command = KASA_SMART_LEDSTRIP_OFF_COMMAND;
     }
 
-    if(!port.connected && !port.tcp_client_connect() && ++retry_count >= KASA_SMART_MAX_CONNECTION_ATTEMPTS)
-    {
-        is_initialized = false;
-        return;
-    }
-    std::string response;
-    KasaSmartController::SendCommand(turn_off_command, response);
-    port.tcp_close();
+    KasaSmartController::SendCommand(turn_off_command.c_str(), (int)turn_off_command.length());
 }
 
-bool KasaSmartController::SendCommand(std::string command, std::string &response)
+bool KasaSmartController::SendCommand(const char* command, int length)
 {
-    const unsigned char* encrypted_payload = KasaSmartController::Encrypt(command);
-    port.tcp_client_write((char*)encrypted_payload, (int)(command.length() + sizeof(unsigned long)));
-    delete[] encrypted_payload;
-
-    unsigned char* receive_buffer = new unsigned char[KASA_SMART_RECEIVE_BUFFER_SIZE];
-    int response_length = port.tcp_listen((char*)receive_buffer, KASA_SMART_RECEIVE_BUFFER_SIZE);
-    if(response_length > KASA_SMART_RECEIVE_BUFFER_SIZE || response_length <= 0) {
-        /*-------------------------------------------------------------*\
-        | Small fail safes to prevent decrypting bad or empty responses |
-        \*-------------------------------------------------------------*/
-        return false;
-    }
-
-    unsigned long received_length = response_length;
-    unsigned long response_full_length = 0;
-    if(response_length > 0)
-    {
-        response_full_length = ntohl(*(uint32_t*)receive_buffer);
-    }
+    /*----------------------------------------------------------*\
+    | Responses are only counted by the transport, don't wait    |
+    \*----------------------------------------------------------*/
+    KasaSmartController::Encrypt(command, length);
+    return transport.send((const char*)command_buffer.data(), (int)command_buffer.size());
+}
 
-    if(response_full_length > KASA_SMART_RECEIVE_BUFFER_SIZE) {
-        return false;
-    }
+bool KasaSmartController::RequestCommand(const std::string command, std::string &response)
+{
+    KasaSmartController::Encrypt(command.data(), (int)command.length());
 
-    /*--------------------------*\
-    | Fetch entirety of response |
-    \*--------------------------*/
-    while(received_length < response_full_length)
+    std::string encrypted_response;
+    if(!transport.request((const char*)command_buffer.data(), (int)command_buffer.size(), encrypted_response))
     {
-        received_length += port.tcp_listen((char*)receive_buffer + received_length, KASA_SMART_RECEIVE_BUFFER_SIZE - received_length);
+        return false;
     }
 
-    if(received_length > 0)
-    {
-        /*------------------------------------------------*\
-        | Decrypt payload data preceeding the payload size |
-        \*------------------------------------------------*/
-        KasaSmartController::Decrypt(receive_buffer + sizeof(uint32_t), received_length - sizeof(uint32_t), response);
-    }
-    delete[] receive_buffer;
+    /*------------------------------------------------------------*\
+    | The transport strips the payload size preceeding the payload |
+    \*------------------------------------------------------------*/
+    KasaSmartController::Decrypt((const unsigned char*)encrypted_response.data(), (int)encrypted_response.length(), response);
     return true;
 }
 
-unsigned char* KasaSmartController::Encrypt(const std::string request)
+void KasaSmartController::Encrypt(const char* request, int length)
 {
     /*----------------------------------------------------------------*\
     | "Encrypted" payload consists of size as a uint32 + XOR'd payload |
     \*----------------------------------------------------------------*/
-    uint32_t size          = htonl((uint32_t)request.length());
-    int payload_size       = (int)(request.length() + sizeof(size));
-    unsigned char* payload = new unsigned char[payload_size];
-    memcpy(payload, &size, sizeof(size));
-    unsigned char* request_data = new unsigned char[request.length()];
-    memcpy(request_data, request.data(), request.length());
-    KasaSmartController::XorPayload(request_data, (int)request.length());
-    memcpy(payload + sizeof(size), request_data, request.length());
-    delete[] request_data;
-    return payload;
+    uint32_t size = htonl((uint32_t)length);
+    command_buffer.resize(length + sizeof(size));
+    memcpy(command_buffer.data(), &size, sizeof(size));
+    memcpy(command_buffer.data() + sizeof(size), request, length);
+    KasaSmartController::XorPayload(command_buffer.data() + sizeof(size), length);
 }
 
 std::string KasaSmartController::Decrypt(const unsigned char* encrypted, int length, std::string &response)
@@ -15,7 +15,7 @@
 #include <thread>
 #include <vector>
 #include "RGBController.h"
-#include "net_port.h"
+#include "smart_light_transport.h"
 
 enum
 {
@@ -32,8 +32,8 @@ enum
 };
 
 #define KASA_SMART_INITIALIZATION_VECTOR 0xAB
-#define KASA_SMART_RECEIVE_BUFFER_SIZE 4096
 #define KASA_SMART_MAX_CONNECTION_ATTEMPTS 3
+#define KASA_SMART_MAX_IN_FLIGHT 2
 
 /*-------------------------*\
 | Kasa Smart Light Commands |
@@ -66,18 +66,23 @@ public:
     void SetEffect(std::string effect);
     void TurnOff(int device_type);
 
+    smart_light_stats GetLatencyStats();
+
 private:
-    net_port port;
+    smart_light_transport transport;
+    smart_light_template light_state_template;
+    smart_light_template ledstrip_state_template;
+    std::vector<unsigned char> command_buffer;
     std::string name;
     bool is_initialized;
-    unsigned int retry_count;
     std::string firmware_version;
     std::string module_name;
     std::string device_id;
     std::string location;
     int kasa_type;
-    bool SendCommand(std::string command, std::string &response);
-    static unsigned char* Encrypt(const std::string request);
+    bool SendCommand(const char* command, int length);
+    bool RequestCommand(const std::string command, std::string &response);
+    void Encrypt(const char* request, int length);
     static std::string Decrypt(const unsigned char*, int length, std::string &response);
     static void XorPayload(unsigned char* encrypted, int length);
     static void XorEncryptedPayload(unsigned char* encrypted, int length);
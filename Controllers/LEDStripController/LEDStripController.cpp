@@ -13,16 +13,45 @@
 #include <iostream>
 #include <string>
 #include "LEDStripController.h"
+#include "LogManager.h"
 #include "ResourceManager.h"
 
 LEDStripController::LEDStripController()
 {
-
+    serialport          = NULL;
+    udpport             = NULL;
+    i2cport             = NULL;
+
+    frame_pending       = false;
+    frame_pending_late  = false;
+    writer_busy         = false;
+    writer_thread       = NULL;
+    writer_thread_run   = false;
+
+    sent_frames         = 0;
+    dropped_frames      = 0;
+    late_frames         = 0;
 }
 
 
 LEDStripController::~LEDStripController()
 {
+    if(writer_thread != NULL)
+    {
+        {
+            std::lock_guard<std::mutex> lock(frame_mutex);
+            writer_thread_run = false;
+        }
+
+        frame_cv.notify_one();
+        writer_thread->join();
+        delete writer_thread;
+
+        LOG_DEBUG("[LEDStripController] %s: %llu frames sent, %llu dropped, %llu late", port_name.c_str(), sent_frames.load(), dropped_frames.load(), late_frames.load());
+    }
+
+    delete serialport;
+    delete udpport;
 }
 
 void LEDStripController::Initialize(char* ledstring, led_protocol proto)
@@ -126,6 +155,13 @@ void LEDStripController::InitializeSerial(char* portname, int baud)
     serialport = new serial_port(port_name.c_str(), baud_rate);
     udpport = NULL;
     i2cport = NULL;
+
+    /*-----------------------------------------------------*\
+    | Serial writes happen on a writer thread so that the   |
+    | update thread does not wait for the port to drain     |
+    \*-----------------------------------------------------*/
+    writer_thread_run = true;
+    writer_thread = new std::thread(&LEDStripController::WriterThreadFunction, this);
 }
 
 void LEDStripController::InitializeUDP(char * clientname, char * port)
@@ -163,7 +199,7 @@ char* LEDStripController::GetLEDString()
     return(led_string);
 }
 
-void LEDStripController::SetLEDs(std::vector<RGBColor> colors)
+void LEDStripController::SetLEDs(const std::vector<RGBColor>& colors)
 {
     switch(protocol)
     {
@@ -185,10 +221,56 @@ void LEDStripController::SetLEDs(std::vector<RGBColor> colors)
     }
 }
 
-void LEDStripController::SetLEDsKeyboardVisualizer(std::vector<RGBColor> colors)
+void LEDStripController::SetLEDsKeyboardVisualizer(const std::vector<RGBColor>& colors)
+{
+    /*-------------------------------------------------------------*\
+    | Send the packet                                               |
+    \*-------------------------------------------------------------*/
+    if (serialport != NULL)
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex);
+
+        EncodeKeyboardVisualizer(colors, pending_buf);
+        SubmitFrame();
+    }
+    else if (udpport != NULL)
+    {
+        EncodeKeyboardVisualizer(colors, write_buf);
+
+        udpport->udp_write((char *)write_buf.data(), (int)write_buf.size());
+    }
+}
+
+void LEDStripController::SetLEDsAdalight(const std::vector<RGBColor>& colors)
 {
-    unsigned char *serial_buf;
+    /*-------------------------------------------------------------*\
+    | Send the packet                                               |
+    \*-------------------------------------------------------------*/
+    if (serialport != NULL)
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex);
 
+        EncodeAdalight(colors, pending_buf);
+        SubmitFrame();
+    }
+}
+
+void LEDStripController::SetLEDsTPM2(const std::vector<RGBColor>& colors)
+{
+    /*-------------------------------------------------------------*\
+    | Send the packet                                               |
+    \*-------------------------------------------------------------*/
+    if (serialport != NULL)
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex);
+
+        EncodeTPM2(colors, pending_buf);
+        SubmitFrame();
+    }
+}
+
+void LEDStripController::EncodeKeyboardVisualizer(const std::vector<RGBColor>& colors, std::vector<unsigned char>& frame_buf)
+{
     /*-------------------------------------------------------------*\
     | Keyboard Visualizer Arduino Protocol                          |
     |                                                               |
@@ -202,7 +284,9 @@ void LEDStripController::SetLEDsKeyboardVisualizer(std::vector<RGBColor> colors)
     unsigned int payload_size   = (unsigned int)(colors.size() * 3);
     unsigned int packet_size    = payload_size + 3;
 
-    serial_buf = new unsigned char[packet_size];
+    frame_buf.resize(packet_size);
+
+    unsigned char* serial_buf   = frame_buf.data();
 
     /*-------------------------------------------------------------*\
     | Set up header                                                 |
@@ -210,8 +294,10 @@ void LEDStripController::SetLEDsKeyboardVisualizer(std::vector<RGBColor> colors)
     serial_buf[0x00]            = 0xAA;
 
     /*-------------------------------------------------------------*\
-    | Copy in color data in RGB order                               |
+    | Copy in color data in RGB order and calculate the checksum    |
     \*-------------------------------------------------------------*/
+    unsigned short sum          = serial_buf[0x00];
+
     for(unsigned int color_idx = 0; color_idx < colors.size(); color_idx++)
     {
         unsigned int color_offset = color_idx * 3;
@@ -219,43 +305,19 @@ void LEDStripController::SetLEDsKeyboardVisualizer(std::vector<RGBColor> colors)
         serial_buf[0x01 + color_offset]     = RGBGetRValue(colors[color_idx]);
         serial_buf[0x02 + color_offset]     = RGBGetGValue(colors[color_idx]);
         serial_buf[0x03 + color_offset]     = RGBGetBValue(colors[color_idx]);
-    }
 
-    /*-------------------------------------------------------------*\
-    | Calculate the checksum                                        |
-    \*-------------------------------------------------------------*/
-    unsigned short sum          = 0;
-
-    for(unsigned int i = 0; i < (payload_size + 1); i++)
-    {
-        sum += serial_buf[i];
+        sum += serial_buf[0x01 + color_offset] + serial_buf[0x02 + color_offset] + serial_buf[0x03 + color_offset];
     }
 
     /*-------------------------------------------------------------*\
     | Fill in the checksum bytes                                    |
     \*-------------------------------------------------------------*/
-    serial_buf[(num_leds * 3) + 1] = sum >> 8;
-    serial_buf[(num_leds * 3) + 2] = sum & 0x00FF;
-
-    /*-------------------------------------------------------------*\
-    | Send the packet                                               |
-    \*-------------------------------------------------------------*/
-    if (serialport != NULL)
-    {
-        serialport->serial_write((char *)serial_buf, packet_size);
-    }
-    else if (udpport != NULL)
-    {
-        udpport->udp_write((char *)serial_buf, packet_size);
-    }
-
-    delete[] serial_buf;
+    serial_buf[payload_size + 1] = sum >> 8;
+    serial_buf[payload_size + 2] = sum & 0x00FF;
 }
 
-void LEDStripController::SetLEDsAdalight(std::vector<RGBColor> colors)
+void LEDStripController::EncodeAdalight(const std::vector<RGBColor>& colors, std::vector<unsigned char>& frame_buf)
 {
-    unsigned char *serial_buf;
-
     /*-------------------------------------------------------------*\
     | Adalight Protocol                                             |
     |                                                               |
@@ -273,7 +335,9 @@ void LEDStripController::SetLEDsAdalight(std::vector<RGBColor> colors)
     unsigned int payload_size   = (led_count * 3);
     unsigned int packet_size    = payload_size + 6;
 
-    serial_buf = new unsigned char[packet_size];
+    frame_buf.resize(packet_size);
+
+    unsigned char* serial_buf   = frame_buf.data();
 
     /*-------------------------------------------------------------*\
     | Set up header                                                 |
@@ -296,22 +360,10 @@ void LEDStripController::SetLEDsAdalight(std::vector<RGBColor> colors)
         serial_buf[0x07 + color_offset]     = RGBGetGValue(colors[color_idx]);
         serial_buf[0x08 + color_offset]     = RGBGetBValue(colors[color_idx]);
     }
-
-    /*-------------------------------------------------------------*\
-    | Send the packet                                               |
-    \*-------------------------------------------------------------*/
-    if (serialport != NULL)
-    {
-        serialport->serial_write((char *)serial_buf, packet_size);
-    }
-
-    delete[] serial_buf;
 }
 
-void LEDStripController::SetLEDsTPM2(std::vector<RGBColor> colors)
+void LEDStripController::EncodeTPM2(const std::vector<RGBColor>& colors, std::vector<unsigned char>& frame_buf)
 {
-    unsigned char *serial_buf;
-
     /*-------------------------------------------------------------*\
     | TPM2 Protocol                                                 |
     |                                                               |
@@ -327,7 +379,9 @@ void LEDStripController::SetLEDsTPM2(std::vector<RGBColor> colors)
     unsigned int payload_size   = (unsigned int)(colors.size() * 3);
     unsigned int packet_size    = payload_size + 5;
 
-    serial_buf = new unsigned char[packet_size];
+    frame_buf.resize(packet_size);
+
+    unsigned char* serial_buf   = frame_buf.data();
 
     /*-------------------------------------------------------------*\
     | Set up header and end byte                                    |
@@ -349,19 +403,114 @@ void LEDStripController::SetLEDsTPM2(std::vector<RGBColor> colors)
         serial_buf[0x05 + color_offset]     = RGBGetGValue(colors[color_idx]);
         serial_buf[0x06 + color_offset]     = RGBGetBValue(colors[color_idx]);
     }
+}
 
-    /*-------------------------------------------------------------*\
-    | Send the packet                                               |
-    \*-------------------------------------------------------------*/
-    if (serialport != NULL)
+/*---------------------------------------------------------*\
+| Hand the frame in pending_buf to the writer thread, with  |
+| frame_mutex held.  Only the latest frame is kept: a frame |
+| still pending when the next one arrives is dropped, and a |
+| frame submitted while the writer is busy with an earlier  |
+| one is counted as late when it is written.                |
+\*---------------------------------------------------------*/
+void LEDStripController::SubmitFrame()
+{
+    if(frame_pending)
+    {
+        dropped_frames++;
+    }
+
+    frame_pending       = true;
+    frame_pending_late  = writer_busy;
+
+    frame_cv.notify_one();
+}
+
+void LEDStripController::WriterThreadFunction()
+{
+    std::unique_lock<std::mutex> lock(frame_mutex);
+
+    while(writer_thread_run.load())
+    {
+        frame_cv.wait(lock, [this]{ return(frame_pending || !writer_thread_run.load()); });
+
+        if(!writer_thread_run.load())
+        {
+            break;
+        }
+
+        /*-----------------------------------------------------*\
+        | Take the pending frame, the buffer it replaces is     |
+        | encoded into next                                     |
+        \*-----------------------------------------------------*/
+        pending_buf.swap(write_buf);
+
+        if(frame_pending_late)
+        {
+            late_frames++;
+        }
+
+        frame_pending   = false;
+        writer_busy     = true;
+
+        lock.unlock();
+
+        if(WriteFrame(write_buf))
+        {
+            sent_frames++;
+        }
+
+        lock.lock();
+
+        writer_busy     = false;
+    }
+}
+
+bool LEDStripController::WriteFrame(std::vector<unsigned char>& frame_buf)
+{
+    int offset = 0;
+    int length = (int)frame_buf.size();
+
+    /*-----------------------------------------------------*\
+    | A frame is always written completely so that the      |
+    | strip does not lose sync, waiting for room in the     |
+    | output buffer as needed                               |
+    \*-----------------------------------------------------*/
+    while(offset < length && writer_thread_run.load())
     {
-        serialport->serial_write((char *)serial_buf, packet_size);
+        int byteswritten = serialport->serial_write_nonblocking((char *)&frame_buf[offset], length - offset);
+
+        if(byteswritten < 0)
+        {
+            return(false);
+        }
+
+        if(byteswritten == 0)
+        {
+            serialport->serial_wait_writable(100);
+        }
+
+        offset += byteswritten;
     }
 
-    delete[] serial_buf;
+    return(offset == length);
+}
+
+unsigned long long LEDStripController::GetSentFrames()
+{
+    return(sent_frames.load());
+}
+
+unsigned long long LEDStripController::GetDroppedFrames()
+{
+    return(dropped_frames.load());
+}
+
+unsigned long long LEDStripController::GetLateFrames()
+{
+    return(late_frames.load());
 }
 
-void LEDStripController::SetLEDsBasicI2C(std::vector<RGBColor> colors)
+void LEDStripController::SetLEDsBasicI2C(const std::vector<RGBColor>& colors)
 {
     unsigned char serial_buf[30];
 
@@ -11,6 +11,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include "RGBController.h"
 #include "i2c_smbus.h"
@@ -61,12 +65,16 @@ public:
     char*       GetLEDString();
     std::string GetLocation();
 
-    void        SetLEDs(std::vector<RGBColor> colors);
+    void        SetLEDs(const std::vector<RGBColor>& colors);
 
-    void        SetLEDsKeyboardVisualizer(std::vector<RGBColor> colors);
-    void        SetLEDsAdalight(std::vector<RGBColor> colors);
-    void        SetLEDsTPM2(std::vector<RGBColor> colors);
-    void        SetLEDsBasicI2C(std::vector<RGBColor> colors);
+    void        SetLEDsKeyboardVisualizer(const std::vector<RGBColor>& colors);
+    void        SetLEDsAdalight(const std::vector<RGBColor>& colors);
+    void        SetLEDsTPM2(const std::vector<RGBColor>& colors);
+    void        SetLEDsBasicI2C(const std::vector<RGBColor>& colors);
+
+    unsigned long long  GetSentFrames();
+    unsigned long long  GetDroppedFrames();
+    unsigned long long  GetLateFrames();
 
     int num_leds;
 
@@ -81,4 +89,32 @@ private:
     i2c_smbus_interface *i2cport;
     unsigned char i2c_addr;
     led_protocol protocol;
+
+    /*-----------------------------------------------------*\
+    | Frames are encoded into pending_buf and written to    |
+    | serial ports from write_buf by the writer thread.     |
+    | The buffers are swapped, not reallocated, so the      |
+    | headers only need to be written once per size.        |
+    \*-----------------------------------------------------*/
+    void        EncodeKeyboardVisualizer(const std::vector<RGBColor>& colors, std::vector<unsigned char>& frame_buf);
+    void        EncodeAdalight(const std::vector<RGBColor>& colors, std::vector<unsigned char>& frame_buf);
+    void        EncodeTPM2(const std::vector<RGBColor>& colors, std::vector<unsigned char>& frame_buf);
+
+    void        SubmitFrame();
+    void        WriterThreadFunction();
+    bool        WriteFrame(std::vector<unsigned char>& frame_buf);
+
+    std::vector<unsigned char>          pending_buf;
+    std::vector<unsigned char>          write_buf;
+    std::mutex                          frame_mutex;
+    std::condition_variable             frame_cv;
+    bool                                frame_pending;
+    bool                                frame_pending_late;
+    bool                                writer_busy;
+    std::thread*                        writer_thread;
+    std::atomic<bool>                   writer_thread_run;
+
+    std::atomic<unsigned long long>     sent_frames;
+    std::atomic<unsigned long long>     dropped_frames;
+    std::atomic<unsigned long long>     late_frames;
 };
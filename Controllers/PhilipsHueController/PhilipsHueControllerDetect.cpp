@@ -178,6 +178,8 @@ void DetectPhilipsHueControllers()
                     | Loop through all available groups and check to    |
                     | see if any are Entertainment groups               |
                     \*-------------------------------------------------*/
+                    RGBController_PhilipsHueEntertainment* first_entertainment_controller = NULL;
+
                     for(unsigned int group_idx = 0; group_idx < groups.size(); group_idx++)
                     {
                         if(groups[group_idx].getType() == "Entertainment")
@@ -185,25 +187,25 @@ void DetectPhilipsHueControllers()
                             PhilipsHueEntertainmentController*     controller     = new PhilipsHueEntertainmentController(bridge, groups[group_idx]);
                             RGBController_PhilipsHueEntertainment* rgb_controller = new RGBController_PhilipsHueEntertainment(controller);
 
+                            if(first_entertainment_controller == NULL)
+                            {
+                                first_entertainment_controller = rgb_controller;
+                            }
+
                             ResourceManager::get()->RegisterRGBController(rgb_controller);
                         }
                     }
 
                     /*-------------------------------------------------*\
-                    | Loop through RGB Controllers to find the first    |
-                    | Entertainment group and Set it to "Connect",      |
-                    | as only one Stream can be open at a time.         |
+                    | Set the first Entertainment group to "Connect",   |
+                    | as only one Stream can be open at a time.  The    |
+                    | controller list is not searched because with      |
+                    | parallel detection the controllers are not added  |
+                    | to it until all detectors have finished.          |
                     \*-------------------------------------------------*/
-                    if(auto_connect)
+                    if(auto_connect && first_entertainment_controller != NULL)
                     {
-                        for(unsigned int controller_idx = 0; controller_idx < ResourceManager::get()->GetRGBControllers().size(); controller_idx++)
-                        {
-                            if(ResourceManager::get()->GetRGBControllers()[controller_idx]->description == "Philips Hue Entertainment Mode Device")
-                            {
-                                ResourceManager::get()->GetRGBControllers()[controller_idx]->SetMode(0);
-                                break;
-                            }
-                        }
+                        first_entertainment_controller->SetMode(0);
                     }
                 }
             }
@@ -241,4 +243,4 @@ void DetectPhilipsHueControllers()
     }
 }   /* DetectPhilipsHueControllers() */
 
-REGISTER_DETECTOR("Philips Hue", DetectPhilipsHueControllers);
+REGISTER_NETWORK_DETECTOR("Philips Hue", DetectPhilipsHueControllers);
@@ -30,15 +30,17 @@ PhilipsWizController::PhilipsWizController(std::string ip, bool use_cool, bool u
     white_strategy = selected_white_strategy;
 
     /*-----------------------------------------------------------------*\
-    | Open a UDP client sending to the device's IP, port 38899          |
+    | Compile the setPilot commands, only their values change           |
     \*-----------------------------------------------------------------*/
-    port.udp_client(ip.c_str(), "38899");
+    color_command.compile(PHILIPSWIZ_SET_PILOT_COLOR_COMMAND_FORMAT);
+    scene_command.compile(PHILIPSWIZ_SET_PILOT_SCENE_COMMAND_FORMAT);
 
     /*-----------------------------------------------------------------*\
-    | Start a thread to handle responses received from the Wiz device   |
+    | Open a UDP client sending to the device's IP, port 38899.  The    |
+    | transport's thread handles responses received from the device     |
     \*-----------------------------------------------------------------*/
-    ReceiveThreadRun = 1;
-    ReceiveThread = new std::thread(&PhilipsWizController::ReceiveThreadFunction, this);
+    transport.set_response_callback([this](const char* data, int length){ return HandleResponse(data, length); });
+    transport.open_udp(ip.c_str(), "38899");
 
     /*-----------------------------------------------------------------*\
     | Request the system config (name, firmware version, MAC address)   |
@@ -48,9 +50,7 @@ PhilipsWizController::PhilipsWizController(std::string ip, bool use_cool, bool u
 
 PhilipsWizController::~PhilipsWizController()
 {
-    ReceiveThreadRun = 0;
-    ReceiveThread->join();
-    delete ReceiveThread;
+    transport.close();
 }
 
 std::string PhilipsWizController::GetLocation()
@@ -83,9 +83,13 @@ std::string PhilipsWizController::GetUniqueID()
     return(module_mac);
 }
 
+smart_light_stats PhilipsWizController::GetLatencyStats()
+{
+    return(transport.get_stats());
+}
+
 void PhilipsWizController::SetColor(unsigned char red, unsigned char green, unsigned char blue, unsigned char brightness)
 {
-    json command;
     unsigned char white;
 
     /*-----------------------------------------------------------------*\
@@ -112,24 +116,8 @@ void PhilipsWizController::SetColor(unsigned char red, unsigned char green, unsi
         white      = 0;
     }
 
-    if(use_cool_white)
-    {
-        command["params"]["c"] = white;
-    }
-    else
-    {
-        command["params"]["c"] = 0;
-    }
-
-    if(use_warm_white)
-    {
-        command["params"]["w"] = white;
-    }
-    else
-    {
-        command["params"]["w"] = 0;
-    }
-
+    color_command.set_field(1, use_cool_white ? white : 0);
+    color_command.set_field(6, use_warm_white ? white : 0);
 
     /*-----------------------------------------------------------------*\
     | Fill in the setPilot command with RGB and brightness information. |
@@ -137,126 +125,92 @@ void PhilipsWizController::SetColor(unsigned char red, unsigned char green, unsi
     | set the state to off.  Otherwise, set it to on. As we're also     |
     | running direct the bulb needs to be set back to max brightness.   |
     \*-----------------------------------------------------------------*/
-    command["method"]            = "setPilot";
-    command["params"]["r"]       = red;
-    command["params"]["g"]       = green;
-    command["params"]["b"]       = blue;
-    command["params"]["dimming"] = brightness;
-    command["params"]["state"]   = !((red == 0) && (green == 0) && (blue == 0) && (white == 0));
+    color_command.set_field(0, blue);
+    color_command.set_field(2, brightness);
+    color_command.set_field(3, green);
+    color_command.set_field(4, red);
+    color_command.set_field(5, ((red == 0) && (green == 0) && (blue == 0) && (white == 0)) ? "false" : "true");
 
     /*-----------------------------------------------------------------*\
-    | Convert the JSON object to a string and write it                  |
+    | Write the command, its response is handled asynchronously         |
     \*-----------------------------------------------------------------*/
-    std::string command_str     = command.dump();
-
-    port.udp_write((char *)command_str.c_str(), (int)command_str.length() + 1);
+    transport.send(color_command.data(), color_command.length() + 1);
 }
 
 void PhilipsWizController::SetScene(int scene, unsigned char brightness)
 {
-    json command;
-
     /*------------------------------------------------------------*\
     | Fill in the setPilot command with Scene information.         |
     \*------------------------------------------------------------*/
-    command["method"] = "setPilot";
-    command["params"]["sceneId"] = scene;
-    command["params"]["dimming"] = brightness;
+    scene_command.set_field(0, brightness);
+    scene_command.set_field(1, (unsigned int)scene);
 
     /*------------------------------------------------------------*\
-    | Convert the JSON object to a string and write it             |
+    | Write the command, its response is handled asynchronously    |
     \*------------------------------------------------------------*/
-    std::string command_str = command.dump();
-
-    port.udp_write((char*)command_str.c_str(), (int)command_str.length() + 1);
+    transport.send(scene_command.data(), scene_command.length() + 1);
 }
 
-void PhilipsWizController::ReceiveThreadFunction()
+bool PhilipsWizController::HandleResponse(const char* data, int /*length*/)
 {
-    char recv_buf[1025];
+    /*-----------------------------------------------------------------*\
+    | Convert null-terminated response to JSON                          |
+    \*-----------------------------------------------------------------*/
+    json response = json::parse(data, nullptr, false);
 
-    while(ReceiveThreadRun.load())
+    if(response.is_discarded())
     {
-        /*-----------------------------------------------------------------*\
-        | Receive up to 1024 bytes from the device with a 1s timeout        |
-        \*-----------------------------------------------------------------*/
-        int size = port.udp_listen_timeout(recv_buf, 1024, 1, 0);
+        return(true);
+    }
 
-        if(size > 0)
+    /*-----------------------------------------------------------------*\
+    | Check if the response contains the method name                    |
+    \*-----------------------------------------------------------------*/
+    if(response.contains("method"))
+    {
+        /*-------------------------------------------------------------*\
+        | Handle responses for getSystemConfig method                   |
+        | This method's response should contain a result object         |
+        | containing fwVersion, moduleName, and mac, among others.      |
+        \*-------------------------------------------------------------*/
+        if(response["method"] == "getSystemConfig")
         {
-            /*-----------------------------------------------------------------*\
-            | Responses are not null-terminated, so add termination             |
-            \*-----------------------------------------------------------------*/
-            recv_buf[size] = '\0';
-
-            /*-----------------------------------------------------------------*\
-            | Convert null-terminated response to JSON                          |
-            \*-----------------------------------------------------------------*/
-            json response = json::parse(recv_buf);
-
-            /*-----------------------------------------------------------------*\
-            | Check if the response contains the method name                    |
-            \*-----------------------------------------------------------------*/
-            if(response.contains("method"))
+            if(response.contains("result"))
             {
-                /*-------------------------------------------------------------*\
-                | Handle responses for getSystemConfig method                   |
-                | This method's response should contain a result object         |
-                | containing fwVersion, moduleName, and mac, among others.      |
-                \*-------------------------------------------------------------*/
-                if(response["method"] == "getSystemConfig")
-                {
-                    if(response.contains("result"))
-                    {
-                        json result = response["result"];
+                json result = response["result"];
 
-                        if(result.contains("fwVersion"))
-                        {
-                            firmware_version = result["fwVersion"];
-                        }
+                if(result.contains("fwVersion"))
+                {
+                    firmware_version = result["fwVersion"];
+                }
 
-                        if(result.contains("moduleName"))
-                        {
-                            module_name = result["moduleName"];
-                        }
+                if(result.contains("moduleName"))
+                {
+                    module_name = result["moduleName"];
+                }
 
-                        if(result.contains("mac"))
-                        {
-                            module_mac = result["mac"];
-                        }
-                    }
+                if(result.contains("mac"))
+                {
+                    module_mac = result["mac"];
                 }
             }
         }
     }
-}
-
-void PhilipsWizController::RequestSystemConfig()
-{
-    json command;
 
     /*-----------------------------------------------------------------*\
-    | Fill in the getSystemConfig command                               |
+    | Every datagram from the bulb answers a command                    |
     \*-----------------------------------------------------------------*/
-    command["method"]           = "getSystemConfig";
-
-    /*-----------------------------------------------------------------*\
-    | Convert the JSON object to a string and write it                  |
-    \*-----------------------------------------------------------------*/
-    std::string command_str     = command.dump();
-
-    port.udp_write((char *)command_str.c_str(), (int)command_str.length() + 1);
+    return(true);
+}
 
+void PhilipsWizController::RequestSystemConfig()
+{
     /*-----------------------------------------------------------------*\
-    | Wait up to 1s to give it time to receive and process response     |
+    | Write the getSystemConfig command and wait up to 1s for the       |
+    | response, which is processed by HandleResponse                    |
     \*-----------------------------------------------------------------*/
-    for(unsigned int wait_count = 0; wait_count < 100; wait_count++)
-    {
-        if(firmware_version != "")
-        {
-            return;
-        }
+    const char command_str[] = PHILIPSWIZ_GET_SYSTEM_CONFIG_COMMAND;
+    std::string response;
 
-        std::this_thread::sleep_for(10ms);
-    }
+    transport.request(command_str, (int)sizeof(command_str), response);
 }
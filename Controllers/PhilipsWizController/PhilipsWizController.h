@@ -15,11 +15,18 @@
 #include <thread>
 #include <vector>
 #include "RGBController.h"
-#include "net_port.h"
+#include "smart_light_transport.h"
 
 #define PHILIPSWIZ_BRIGHTNESS_MAX   100
 #define PHILIPSWIZ_BRIGHTNESS_MIN   10
 
+/*---------------------------------------------------------*\
+| setPilot commands, fields are filled in per update        |
+\*---------------------------------------------------------*/
+const char PHILIPSWIZ_SET_PILOT_COLOR_COMMAND_FORMAT[] = "{\"method\":\"setPilot\",\"params\":{\"b\":%u,\"c\":%u,\"dimming\":%u,\"g\":%u,\"r\":%u,\"state\":%s,\"w\":%u}}";
+const char PHILIPSWIZ_SET_PILOT_SCENE_COMMAND_FORMAT[] = "{\"method\":\"setPilot\",\"params\":{\"dimming\":%u,\"sceneId\":%u}}";
+#define PHILIPSWIZ_GET_SYSTEM_CONFIG_COMMAND "{\"method\":\"getSystemConfig\"}"
+
 enum
 {
     PHILLIPSWIZ_MODE_STATIC        = 0,
@@ -74,21 +81,23 @@ public:
 
     void SetScene(int scene, unsigned char brightness);
 
-    void ReceiveThreadFunction();
+    bool HandleResponse(const char* data, int length);
     void RequestSystemConfig();
 
+    smart_light_stats GetLatencyStats();
+
 private:
-    std::string         firmware_version;
-    std::string         module_name;
-    std::string         module_mac;
-    std::string         location;
-    net_port            port;
-    std::thread*        ReceiveThread;
-    std::atomic<bool>   ReceiveThreadRun;
+    std::string             firmware_version;
+    std::string             module_name;
+    std::string             module_mac;
+    std::string             location;
+    smart_light_transport   transport;
+    smart_light_template    color_command;
+    smart_light_template    scene_command;
 
-    bool                use_cool_white;
-    bool                use_warm_white;
-    std::string         white_strategy;
+    bool                    use_cool_white;
+    bool                    use_warm_white;
+    std::string             white_strategy;
 
     void SendSetPilot();
 };
@@ -70,4 +70,4 @@ void DetectPhilipsWizControllers()
 
 }   /* DetectPhilipsWizControllers() */
 
-REGISTER_DETECTOR("Philips Wiz", DetectPhilipsWizControllers);
+REGISTER_NETWORK_DETECTOR("Philips Wiz", DetectPhilipsWizControllers);
@@ -24,9 +24,16 @@ YeelightController::YeelightController(std::string ip, std::string host_ip, bool
     this->host_ip = host_ip;
 
     /*-----------------------------------------------------------------*\
-    | Open a TCP client sending to the device's IP, port 38899          |
+    | Compile the color flow command, only its values change            |
     \*-----------------------------------------------------------------*/
-    port.tcp_client(ip.c_str(), "55443");
+    color_command.compile(YEELIGHT_START_CF_COMMAND_FORMAT);
+
+    /*-----------------------------------------------------------------*\
+    | Open a TCP session to the device's IP, port 55443.  It is kept    |
+    | open and reopened by the transport when it drops.                 |
+    \*-----------------------------------------------------------------*/
+    transport.set_response_callback([this](const char* data, int length){ return HandleResponse(data, length); });
+    transport.open_tcp(ip.c_str(), "55443", SMART_LIGHT_FRAMING_LINE, 1);
 
     SetPower();
 
@@ -84,6 +91,7 @@ YeelightController::YeelightController(std::string ip, std::string host_ip, bool
 
 YeelightController::~YeelightController()
 {
+    transport.close();
 }
 
 std::string YeelightController::GetLocation()
@@ -116,6 +124,20 @@ bool YeelightController::GetMusicMode()
     return(music_mode);
 }
 
+smart_light_stats YeelightController::GetLatencyStats()
+{
+    return(transport.get_stats());
+}
+
+bool YeelightController::HandleResponse(const char* data, int /*length*/)
+{
+    /*-----------------------------------------------------------------*\
+    | Command results carry the command id, property change             |
+    | notifications ("method":"props") do not                           |
+    \*-----------------------------------------------------------------*/
+    return(strstr(data, "\"id\"") != NULL);
+}
+
 void YeelightController::SetMusicMode()
 {
     json command;
@@ -156,9 +178,7 @@ void YeelightController::SetMusicMode()
     \*-----------------------------------------------------------------*/
     std::string command_str     = command.dump().append("\r\n");
 
-    port.tcp_client_connect();
-    port.tcp_client_write((char *)command_str.c_str(), (int)command_str.length() + 1);
-    port.tcp_close();
+    transport.send(command_str.c_str(), (int)command_str.length());
 }
 
 void YeelightController::SetPower()
@@ -182,15 +202,11 @@ void YeelightController::SetPower()
     \*-----------------------------------------------------------------*/
     std::string command_str     = command.dump().append("\r\n");
 
-    port.tcp_client_connect();
-    port.tcp_client_write((char *)command_str.c_str(), (int)command_str.length() + 1);
-    port.tcp_close();
+    transport.send(command_str.c_str(), (int)command_str.length());
 }
 
 void YeelightController::SetColor(unsigned char red, unsigned char green, unsigned char blue)
 {
-    json command;
-
     /*-----------------------------------------------------------------*\
     | Yeelight doesn't seem to support proper RGB, it just uses RGB to  |
     | calculate hue and saturation.  It doesn't affect brightness.  To  |
@@ -222,30 +238,15 @@ void YeelightController::SetColor(unsigned char red, unsigned char green, unsign
     | set_cf option provides both RGB and brightness in one command, it |
     | allows better RGB control than the set_rgb function.              |
     \*-----------------------------------------------------------------*/
-    std::string cf = "50,1," + std::to_string(rgb) +"," + std::to_string((int)bright);
-
-    /*-----------------------------------------------------------------*\
-    | Fill in the set_cf command with the color flow string.            |
-    \*-----------------------------------------------------------------*/
-    command["id"]               = 1;
-    command["method"]           = "start_cf";
-    command["params"][0]        = 1;
-    command["params"][1]        = 1;
-    command["params"][2]        = cf;
-
-    /*-----------------------------------------------------------------*\
-    | Convert the JSON object to a string and write it                  |
-    \*-----------------------------------------------------------------*/
-    std::string command_str     = command.dump().append("\r\n");
+    color_command.set_field(0, rgb);
+    color_command.set_field(1, (unsigned int)bright);
 
     if(music_mode)
     {
-        send(*music_mode_sock, (char *)command_str.c_str(), (int)command_str.length(), 0);
+        send(*music_mode_sock, color_command.data(), color_command.length(), 0);
     }
     else
     {
-        port.tcp_client_connect();
-        port.tcp_client_write((char *)command_str.c_str(), (int)command_str.length() + 1);
-        port.tcp_close();
+        transport.send(color_command.data(), color_command.length());
     }
 }
@@ -16,6 +16,12 @@
 #include <vector>
 #include "RGBController.h"
 #include "net_port.h"
+#include "smart_light_transport.h"
+
+/*---------------------------------------------------------*\
+| Single frame color flow, fields are RGB and brightness    |
+\*---------------------------------------------------------*/
+const char YEELIGHT_START_CF_COMMAND_FORMAT[] = "{\"id\":1,\"method\":\"start_cf\",\"params\":[1,1,\"50,1,%u,%u\"]}\r\n";
 
 class YeelightController
 {
@@ -35,10 +41,15 @@ public:
     void SetPower();
     void SetColor(unsigned char red, unsigned char green, unsigned char blue);
 
+    bool HandleResponse(const char* data, int length);
+
+    smart_light_stats GetLatencyStats();
+
 private:
-    std::string         location;
-    std::string         host_ip;
-    net_port            port;
+    std::string             location;
+    std::string             host_ip;
+    smart_light_transport   transport;
+    smart_light_template    color_command;
     bool                music_mode;
     unsigned int        music_mode_port;
     net_port            music_mode_server;
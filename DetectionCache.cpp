@@ -0,0 +1,242 @@
+/*---------------------------------------------------------*\
+| DetectionCache.cpp                                        |
+|                                                           |
+|   Persistent record of which detectors found devices,     |
+|   keyed by a fingerprint of the system's hardware         |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include "DetectionCache.h"
+#include "LogManager.h"
+
+using json = nlohmann::json;
+
+DetectionCache::DetectionCache()
+{
+    Clear();
+}
+
+DetectionCache::~DetectionCache()
+{
+
+}
+
+/*---------------------------------------------------------*\
+| Load the cache file.  A missing, unreadable or corrupt    |
+| file, or one written by a different cache version, leaves |
+| the cache invalid so that it never matches.               |
+\*---------------------------------------------------------*/
+void DetectionCache::Load(const filesystem::path& filename)
+{
+    Clear();
+
+    this->filename = filename;
+
+    if(!filesystem::exists(filename))
+    {
+        LOG_DEBUG("[DetectionCache] No detection cache found");
+        return;
+    }
+
+    std::ifstream cache_file(filename, std::ios::in | std::ios::binary);
+
+    if(!cache_file)
+    {
+        return;
+    }
+
+    try
+    {
+        json cache_data;
+
+        cache_file >> cache_data;
+
+        if(!cache_data.contains("version") || cache_data["version"] != DETECTION_CACHE_VERSION)
+        {
+            LOG_INFO("[DetectionCache] Ignoring detection cache from a different version");
+            return;
+        }
+
+        fingerprint         = cache_data["fingerprint"];
+        detection_time_ms   = cache_data["detection_time_ms"];
+
+        for(json& detector : cache_data["detectors"])
+        {
+            DetectionCacheEntry entry;
+
+            entry.name          = detector["name"];
+            entry.controllers   = detector["controllers"];
+            entry.time_ms       = detector["time_ms"];
+            entry.locations     = detector["locations"].get<std::vector<std::string>>();
+
+            entries.push_back(entry);
+            detector_names.insert(entry.name);
+        }
+
+        if(cache_data.contains("quiet_i2c_busses"))
+        {
+            quiet_busses = cache_data["quiet_i2c_busses"].get<std::set<std::string>>();
+        }
+
+        valid = true;
+    }
+    catch(const std::exception& e)
+    {
+        LOG_ERROR("[DetectionCache] JSON parsing failed: %s", e.what());
+
+        Clear();
+
+        this->filename = filename;
+    }
+}
+
+bool DetectionCache::Save()
+{
+    if(!valid || filename.empty())
+    {
+        return(false);
+    }
+
+    json cache_data;
+
+    cache_data["version"]           = DETECTION_CACHE_VERSION;
+    cache_data["fingerprint"]       = fingerprint;
+    cache_data["detection_time_ms"] = detection_time_ms;
+    cache_data["detectors"]         = json::array();
+
+    for(std::size_t entry_idx = 0; entry_idx < entries.size(); entry_idx++)
+    {
+        json detector;
+
+        detector["name"]        = entries[entry_idx].name;
+        detector["controllers"] = entries[entry_idx].controllers;
+        detector["time_ms"]     = entries[entry_idx].time_ms;
+        detector["locations"]   = entries[entry_idx].locations;
+
+        cache_data["detectors"].push_back(detector);
+    }
+
+    cache_data["quiet_i2c_busses"]  = quiet_busses;
+
+    std::ofstream cache_file(filename, std::ios::out | std::ios::binary);
+
+    if(!cache_file)
+    {
+        LOG_ERROR("[DetectionCache] Cannot open detection cache for writing");
+        return(false);
+    }
+
+    try
+    {
+        cache_file << cache_data.dump(4);
+    }
+    catch(const std::exception& e)
+    {
+        LOG_ERROR("[DetectionCache] Cannot write to file: %s", e.what());
+        return(false);
+    }
+
+    return(true);
+}
+
+void DetectionCache::Clear()
+{
+    valid               = false;
+    detection_time_ms   = 0.0;
+
+    filename.clear();
+    fingerprint.clear();
+    entries.clear();
+    detector_names.clear();
+    quiet_busses.clear();
+}
+
+/*---------------------------------------------------------*\
+| A cache only matches if it was loaded successfully, lists |
+| at least one detector and has the same fingerprint        |
+\*---------------------------------------------------------*/
+bool DetectionCache::Matches(const std::string& fingerprint)
+{
+    return(valid && !entries.empty() && (this->fingerprint == fingerprint));
+}
+
+bool DetectionCache::ContainsDetector(const std::string& name)
+{
+    return(detector_names.find(name) != detector_names.end());
+}
+
+unsigned int DetectionCache::GetNumDetectors()
+{
+    return((unsigned int)entries.size());
+}
+
+double DetectionCache::GetDetectionTime()
+{
+    return(detection_time_ms);
+}
+
+void DetectionCache::SetEntries(const std::string& fingerprint, double detection_time_ms, const std::vector<DetectionCacheEntry>& entries)
+{
+    this->valid             = true;
+    this->fingerprint       = fingerprint;
+    this->detection_time_ms = detection_time_ms;
+    this->entries           = entries;
+
+    detector_names.clear();
+
+    for(std::size_t entry_idx = 0; entry_idx < entries.size(); entry_idx++)
+    {
+        detector_names.insert(entries[entry_idx].name);
+    }
+}
+
+/*---------------------------------------------------------*\
+| A quiet bus did not answer a single transfer during the   |
+| last complete detection                                   |
+\*---------------------------------------------------------*/
+bool DetectionCache::IsBusQuiet(const std::string& bus)
+{
+    return(valid && (quiet_busses.find(bus) != quiet_busses.end()));
+}
+
+void DetectionCache::SetQuietBusses(const std::set<std::string>& quiet_busses)
+{
+    this->quiet_busses = quiet_busses;
+}
+
+/*---------------------------------------------------------*\
+| Hash the hardware description items with 64-bit FNV-1a.   |
+| The items are sorted first so that enumeration order does |
+| not change the fingerprint.                               |
+\*---------------------------------------------------------*/
+std::string DetectionCache::ComputeFingerprint(std::vector<std::string> items)
+{
+    unsigned long long hash = 0xCBF29CE484222325ULL;
+
+    std::sort(items.begin(), items.end());
+
+    for(std::size_t item_idx = 0; item_idx < items.size(); item_idx++)
+    {
+        for(std::size_t char_idx = 0; char_idx <= items[item_idx].size(); char_idx++)
+        {
+            /*---------------------------------------------*\
+            | Include the terminating null as a separator   |
+            \*---------------------------------------------*/
+            hash ^= (unsigned char)items[item_idx].c_str()[char_idx];
+            hash *= 0x100000001B3ULL;
+        }
+    }
+
+    char fingerprint_str[17];
+
+    snprintf(fingerprint_str, sizeof(fingerprint_str), "%016llX", hash);
+
+    return(fingerprint_str);
+}
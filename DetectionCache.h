@@ -0,0 +1,64 @@
+/*---------------------------------------------------------*\
+| DetectionCache.h                                          |
+|                                                           |
+|   Persistent record of which detectors found devices,     |
+|   keyed by a fingerprint of the system's hardware         |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+#include "filesystem.h"
+
+/*---------------------------------------------------------*\
+| Increment when the cache file layout or the fingerprint   |
+| contents change, older cache files are then ignored       |
+\*---------------------------------------------------------*/
+#define DETECTION_CACHE_VERSION     1
+
+typedef struct
+{
+    std::string                 name;
+    unsigned int                controllers;
+    double                      time_ms;
+    std::vector<std::string>    locations;
+} DetectionCacheEntry;
+
+class DetectionCache
+{
+public:
+    DetectionCache();
+    ~DetectionCache();
+
+    void                        Load(const filesystem::path& filename);
+    bool                        Save();
+    void                        Clear();
+
+    bool                        Matches(const std::string& fingerprint);
+    bool                        ContainsDetector(const std::string& name);
+    unsigned int                GetNumDetectors();
+    double                      GetDetectionTime();
+
+    void                        SetEntries(const std::string& fingerprint, double detection_time_ms, const std::vector<DetectionCacheEntry>& entries);
+
+    bool                        IsBusQuiet(const std::string& bus);
+    void                        SetQuietBusses(const std::set<std::string>& quiet_busses);
+
+    static std::string          ComputeFingerprint(std::vector<std::string> items);
+
+private:
+    filesystem::path                    filename;
+    bool                                valid;
+    std::string                         fingerprint;
+    double                              detection_time_ms;
+    std::vector<DetectionCacheEntry>    entries;
+    std::set<std::string>               detector_names;
+    std::set<std::string>               quiet_busses;
+};
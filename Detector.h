@@ -12,6 +12,7 @@
 #include "DeviceDetector.h"
 
 #define REGISTER_DETECTOR(name, func)                                                   static DeviceDetector           device_detector_obj_##func(name, func)
+#define REGISTER_NETWORK_DETECTOR(name, func)                                           static NetworkDeviceDetector    device_detector_obj_##func(name, func)
 #define REGISTER_I2C_DETECTOR(name, func)                                               static I2CDeviceDetector        device_detector_obj_##func(name, func)
 #define REGISTER_I2C_DIMM_DETECTOR(name, func, jedec_id, dimm_type)                     static I2CDIMMDeviceDetector    device_detector_obj_##func(name, func, jedec_id, dimm_type)
 #define REGISTER_I2C_PCI_DETECTOR(name, func, ven, dev, subven, subdev, addr)           static I2CPCIDeviceDetector     device_detector_obj_##ven##dev##subven##subdev##addr##func(name, func, ven, dev, subven, subdev, addr)
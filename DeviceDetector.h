@@ -24,6 +24,15 @@ public:
 	}
 };
 
+class NetworkDeviceDetector
+{
+public:
+    NetworkDeviceDetector(std::string name, DeviceDetectorFunction detector)
+	{
+        ResourceManager::get()->RegisterNetworkDeviceDetector(name, detector);
+	}
+};
+
 class I2CDeviceDetector
 {
 public:
@@ -0,0 +1,475 @@
+/*---------------------------------------------------------*\
+| DeviceUpdatePool.cpp                                      |
+|                                                           |
+|   Shared worker pool that runs RGBController device       |
+|   updates, serialized per device and per physical bus     |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <string.h>
+#include "DeviceUpdatePool.h"
+#include "LogManager.h"
+
+DeviceUpdatePool::DeviceUpdatePool(unsigned int thread_count, unsigned int network_thread_count, unsigned int max_queue_depth)
+{
+    this->max_queue_depth   = max_queue_depth;
+    this->queue_depth       = 0;
+
+    if(thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    if(network_thread_count == 0)
+    {
+        network_thread_count = 1;
+    }
+
+    lane_thread_count[DEVICE_UPDATE_LANE_LOCAL]     = thread_count;
+    lane_thread_count[DEVICE_UPDATE_LANE_NETWORK]   = network_thread_count;
+
+    workers_running = true;
+
+    for(unsigned int lane = 0; lane < DEVICE_UPDATE_LANE_COUNT; lane++)
+    {
+        for(unsigned int worker_idx = 0; worker_idx < lane_thread_count[lane]; worker_idx++)
+        {
+            workers.push_back(new std::thread(&DeviceUpdatePool::WorkerThreadFunction, this, lane));
+        }
+    }
+
+    LOG_INFO("[DeviceUpdatePool] Started %d local and %d network worker threads, max queue depth %d", thread_count, network_thread_count, max_queue_depth);
+}
+
+DeviceUpdatePool::~DeviceUpdatePool()
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        workers_running = false;
+    }
+
+    for(unsigned int lane = 0; lane < DEVICE_UPDATE_LANE_COUNT; lane++)
+    {
+        work_cv[lane].notify_all();
+    }
+
+    for(std::thread* worker : workers)
+    {
+        worker->join();
+        delete worker;
+    }
+
+    workers.clear();
+}
+
+/*---------------------------------------------------------*\
+| Devices that share a physical bus must not be accessed    |
+| concurrently.  I2C controllers report their location as   |
+| "<bus location>, address 0xNN", so strip the address to   |
+| group all devices on one SMBus.  Other locations, such as |
+| HID paths, already identify a single bus.                 |
+\*---------------------------------------------------------*/
+std::string DeviceUpdatePool::GetBusKey(RGBController* controller)
+{
+    std::string location = controller->GetLocation();
+
+    if(location.empty())
+    {
+        char controller_ptr[32];
+        snprintf(controller_ptr, sizeof(controller_ptr), "%p", (void*)controller);
+        return(controller_ptr);
+    }
+
+    std::size_t address_pos = location.find(", address");
+
+    if(address_pos != std::string::npos)
+    {
+        location.erase(address_pos);
+    }
+
+    return(location);
+}
+
+/*---------------------------------------------------------*\
+| Devices on local busses report their location with one    |
+| of these prefixes.  Anything else, such as an IP address, |
+| may block on the network and goes to the network lane.    |
+\*---------------------------------------------------------*/
+unsigned int DeviceUpdatePool::GetLane(RGBController* controller)
+{
+    static const char* local_prefixes[] =
+    {
+        "HID: ",
+        "USB: ",
+        "I2C: ",
+        "COM: ",
+        "SCSI: ",
+        "NVMe: ",
+    };
+
+    std::string location = controller->GetLocation();
+
+    for(const char* prefix : local_prefixes)
+    {
+        if(location.compare(0, strlen(prefix), prefix) == 0)
+        {
+            return(DEVICE_UPDATE_LANE_LOCAL);
+        }
+    }
+
+    return(DEVICE_UPDATE_LANE_NETWORK);
+}
+
+void DeviceUpdatePool::AddController(RGBController* controller)
+{
+    std::string  bus_key = GetBusKey(controller);
+    unsigned int lane    = GetLane(controller);
+
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    if(controllers.find(controller) != controllers.end())
+    {
+        return;
+    }
+
+    std::map<std::string, BusQueue>::iterator bus_it = busses.find(bus_key);
+
+    if(bus_it == busses.end())
+    {
+        bus_it = busses.insert(std::make_pair(bus_key, BusQueue())).first;
+
+        bus_it->second.lane     = lane;
+        bus_it->second.active   = false;
+    }
+
+    BusQueue& bus = bus_it->second;
+
+    ControllerEntry entry;
+
+    entry.bus               = &bus;
+    entry.queued            = false;
+    entry.running           = false;
+    entry.deferred          = false;
+    entry.stats.jobs        = 0;
+    entry.stats.dropped     = 0;
+    entry.stats.total_us    = 0;
+    entry.stats.max_us      = 0;
+
+    controllers[controller] = entry;
+}
+
+void DeviceUpdatePool::RemoveController(RGBController* controller)
+{
+    std::unique_lock<std::mutex> lock(pool_mutex);
+
+    std::map<RGBController*, ControllerEntry>::iterator it = controllers.find(controller);
+
+    if(it == controllers.end())
+    {
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Wait for a running job on this controller to finish   |
+    \*-----------------------------------------------------*/
+    idle_cv.wait(lock, [&it]{ return(!it->second.running); });
+
+    /*-----------------------------------------------------*\
+    | Drop any job still queued for this controller.  An    |
+    | empty bus left in the ready list is skipped by the    |
+    | workers.                                              |
+    \*-----------------------------------------------------*/
+    if(it->second.queued)
+    {
+        std::deque<RGBController*>& pending = it->second.bus->pending;
+
+        for(std::deque<RGBController*>::iterator pending_it = pending.begin(); pending_it != pending.end(); pending_it++)
+        {
+            if(*pending_it == controller)
+            {
+                pending.erase(pending_it);
+                break;
+            }
+        }
+
+        queue_depth--;
+    }
+
+    if(it->second.deferred)
+    {
+        deferred.erase(std::make_pair(it->second.due_time, controller));
+    }
+
+    DeviceUpdateStats&          stats   = it->second.stats;
+    RGBControllerFrameCounters  frames  = controller->GetFrameCounters();
+
+    if(stats.jobs > 0)
+    {
+        LOG_DEBUG("[DeviceUpdatePool] %s: %llu jobs, %llu dropped, average latency %llu us, max latency %llu us",
+                  controller->GetName().c_str(), stats.jobs, stats.dropped, stats.total_us / stats.jobs, stats.max_us);
+        LOG_DEBUG("[DeviceUpdatePool] %s: %llu frames submitted, %llu coalesced, %llu sent",
+                  controller->GetName().c_str(), frames.submitted, frames.coalesced, frames.sent);
+    }
+
+    controllers.erase(it);
+}
+
+bool DeviceUpdatePool::ScheduleController(RGBController* controller)
+{
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    std::map<RGBController*, ControllerEntry>::iterator it = controllers.find(controller);
+
+    if(it == controllers.end())
+    {
+        return(false);
+    }
+
+    ControllerEntry& entry = it->second;
+
+    /*-----------------------------------------------------*\
+    | A queued job runs all pending call flags, so further  |
+    | requests coalesce into it                             |
+    \*-----------------------------------------------------*/
+    if(entry.queued)
+    {
+        return(true);
+    }
+
+    if(queue_depth >= max_queue_depth)
+    {
+        if(entry.stats.dropped == 0)
+        {
+            LOG_WARNING("[DeviceUpdatePool] Queue full, dropping update for %s", controller->GetName().c_str());
+        }
+
+        entry.stats.dropped++;
+        return(false);
+    }
+
+    /*-----------------------------------------------------*\
+    | Run a deferred controller now, it defers itself again |
+    | if its frame is still not due                         |
+    \*-----------------------------------------------------*/
+    if(entry.deferred)
+    {
+        deferred.erase(std::make_pair(entry.due_time, controller));
+        entry.deferred = false;
+    }
+
+    QueueController(controller, entry);
+
+    return(true);
+}
+
+bool DeviceUpdatePool::ScheduleControllerAt(RGBController* controller, std::chrono::steady_clock::time_point due_time)
+{
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    std::map<RGBController*, ControllerEntry>::iterator it = controllers.find(controller);
+
+    if(it == controllers.end())
+    {
+        return(false);
+    }
+
+    ControllerEntry& entry = it->second;
+
+    if(entry.queued)
+    {
+        return(true);
+    }
+
+    if(entry.deferred)
+    {
+        deferred.erase(std::make_pair(entry.due_time, controller));
+    }
+
+    entry.deferred = true;
+    entry.due_time = due_time;
+
+    deferred.insert(std::make_pair(due_time, controller));
+
+    /*-----------------------------------------------------*\
+    | Wake a worker so it waits for the new due time        |
+    \*-----------------------------------------------------*/
+    work_cv[entry.bus->lane].notify_one();
+
+    return(true);
+}
+
+void DeviceUpdatePool::QueueController(RGBController* controller, ControllerEntry& entry)
+{
+    /*-----------------------------------------------------*\
+    | Called with pool_mutex held                           |
+    \*-----------------------------------------------------*/
+    entry.queued        = true;
+    entry.queued_time   = std::chrono::steady_clock::now();
+    queue_depth++;
+
+    entry.bus->pending.push_back(controller);
+
+    /*-----------------------------------------------------*\
+    | Only one worker at a time may own a bus.  If the bus  |
+    | is already owned it is requeued when that job ends.   |
+    \*-----------------------------------------------------*/
+    if(!entry.bus->active)
+    {
+        entry.bus->active = true;
+        ready_busses[entry.bus->lane].push_back(entry.bus);
+        work_cv[entry.bus->lane].notify_one();
+    }
+}
+
+void DeviceUpdatePool::QueueDueControllers()
+{
+    /*-----------------------------------------------------*\
+    | Called with pool_mutex held.  A deferred frame was    |
+    | already accepted, so it is queued even if the queue   |
+    | is full.                                              |
+    \*-----------------------------------------------------*/
+    time_point now = std::chrono::steady_clock::now();
+
+    while(!deferred.empty() && (deferred.begin()->first <= now))
+    {
+        RGBController*   controller = deferred.begin()->second;
+        ControllerEntry& entry      = controllers[controller];
+
+        deferred.erase(deferred.begin());
+        entry.deferred = false;
+
+        QueueController(controller, entry);
+    }
+}
+
+unsigned int DeviceUpdatePool::GetThreadCount()
+{
+    return((unsigned int)workers.size());
+}
+
+unsigned int DeviceUpdatePool::GetThreadCount(unsigned int lane)
+{
+    if(lane >= DEVICE_UPDATE_LANE_COUNT)
+    {
+        return(0);
+    }
+
+    return(lane_thread_count[lane]);
+}
+
+unsigned int DeviceUpdatePool::GetMaxQueueDepth()
+{
+    return(max_queue_depth);
+}
+
+unsigned int DeviceUpdatePool::GetQueueDepth()
+{
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    return(queue_depth);
+}
+
+bool DeviceUpdatePool::GetControllerStats(RGBController* controller, DeviceUpdateStats* stats)
+{
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    std::map<RGBController*, ControllerEntry>::iterator it = controllers.find(controller);
+
+    if(it == controllers.end())
+    {
+        return(false);
+    }
+
+    *stats = it->second.stats;
+
+    return(true);
+}
+
+void DeviceUpdatePool::WorkerThreadFunction(unsigned int lane)
+{
+    std::unique_lock<std::mutex> lock(pool_mutex);
+
+    while(workers_running.load())
+    {
+        QueueDueControllers();
+
+        if(ready_busses[lane].empty() && workers_running.load())
+        {
+            if(deferred.empty())
+            {
+                work_cv[lane].wait(lock);
+            }
+            else
+            {
+                work_cv[lane].wait_until(lock, deferred.begin()->first);
+            }
+
+            continue;
+        }
+
+        if(!workers_running.load())
+        {
+            break;
+        }
+
+        BusQueue* bus = ready_busses[lane].front();
+        ready_busses[lane].pop_front();
+
+        if(bus->pending.empty())
+        {
+            bus->active = false;
+            continue;
+        }
+
+        RGBController*   controller = bus->pending.front();
+        ControllerEntry& entry      = controllers[controller];
+        time_point       start_time = entry.queued_time;
+
+        bus->pending.pop_front();
+        queue_depth--;
+
+        entry.queued  = false;
+        entry.running = true;
+
+        /*-------------------------------------------------*\
+        | Run the device update without holding the pool    |
+        | lock so other busses are serviced in parallel     |
+        \*-------------------------------------------------*/
+        lock.unlock();
+
+        controller->RunPendingUpdates();
+
+        lock.lock();
+
+        unsigned long long latency_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        entry.running = false;
+        entry.stats.jobs++;
+        entry.stats.total_us += latency_us;
+
+        if(latency_us > entry.stats.max_us)
+        {
+            entry.stats.max_us = latency_us;
+        }
+
+        /*-------------------------------------------------*\
+        | Hand the bus back to the ready list if more jobs  |
+        | were queued on it while this one was running      |
+        \*-------------------------------------------------*/
+        if(bus->pending.empty())
+        {
+            bus->active = false;
+        }
+        else
+        {
+            ready_busses[lane].push_back(bus);
+            work_cv[lane].notify_one();
+        }
+
+        idle_cv.notify_all();
+    }
+}
@@ -0,0 +1,117 @@
+/*---------------------------------------------------------*\
+| DeviceUpdatePool.h                                        |
+|                                                           |
+|   Shared worker pool that runs RGBController device       |
+|   updates, serialized per device and per physical bus     |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RGBController.h"
+
+/*---------------------------------------------------------*\
+| Worker lanes                                              |
+|   Network devices can block for a long time on a single   |
+|   update, so they run on their own workers and can never  |
+|   hold up devices on local busses                         |
+\*---------------------------------------------------------*/
+enum
+{
+    DEVICE_UPDATE_LANE_LOCAL            = 0,    /* HID, USB, I2C, serial    */
+    DEVICE_UPDATE_LANE_NETWORK          = 1,    /* Everything else          */
+    DEVICE_UPDATE_LANE_COUNT            = 2,
+};
+
+/*---------------------------------------------------------*\
+| Per-device job statistics                                 |
+|   Latency is measured from the time a job is queued until |
+|   the device update functions return                      |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    unsigned long long      jobs;           /* Jobs completed           */
+    unsigned long long      dropped;        /* Jobs rejected, queue full*/
+    unsigned long long      total_us;       /* Sum of job latencies     */
+    unsigned long long      max_us;         /* Worst job latency        */
+} DeviceUpdateStats;
+
+class DeviceUpdatePool : public RGBControllerUpdateDispatcher
+{
+public:
+    DeviceUpdatePool(unsigned int thread_count, unsigned int network_thread_count, unsigned int max_queue_depth);
+    ~DeviceUpdatePool();
+
+    void                    AddController(RGBController* controller) override;
+    void                    RemoveController(RGBController* controller) override;
+    bool                    ScheduleController(RGBController* controller) override;
+    bool                    ScheduleControllerAt(RGBController* controller, std::chrono::steady_clock::time_point due_time) override;
+
+    unsigned int            GetThreadCount();
+    unsigned int            GetThreadCount(unsigned int lane);
+    unsigned int            GetMaxQueueDepth();
+    unsigned int            GetQueueDepth();
+    bool                    GetControllerStats(RGBController* controller, DeviceUpdateStats* stats);
+
+    static std::string      GetBusKey(RGBController* controller);
+    static unsigned int     GetLane(RGBController* controller);
+
+private:
+    typedef std::chrono::steady_clock::time_point   time_point;
+
+    struct BusQueue
+    {
+        std::deque<RGBController*>  pending;
+        unsigned int                lane;
+        bool                        active;
+    };
+
+    struct ControllerEntry
+    {
+        BusQueue*                   bus;
+        bool                        queued;
+        bool                        running;
+        bool                        deferred;
+        time_point                  due_time;
+        time_point                  queued_time;
+        DeviceUpdateStats           stats;
+    };
+
+    void                    QueueController(RGBController* controller, ControllerEntry& entry);
+    void                    QueueDueControllers();
+    void                    WorkerThreadFunction(unsigned int lane);
+
+    std::vector<std::thread*>                       workers;
+    unsigned int                                    lane_thread_count[DEVICE_UPDATE_LANE_COUNT];
+    std::atomic<bool>                               workers_running;
+    unsigned int                                    max_queue_depth;
+    unsigned int                                    queue_depth;
+
+    std::mutex                                      pool_mutex;
+    std::condition_variable                         work_cv[DEVICE_UPDATE_LANE_COUNT];
+    std::condition_variable                         idle_cv;
+
+    std::map<RGBController*, ControllerEntry>       controllers;
+    std::map<std::string, BusQueue>                 busses;
+    std::deque<BusQueue*>                           ready_busses[DEVICE_UPDATE_LANE_COUNT];
+
+    /*---------------------------------------------------------*\
+    | Deferred controllers ordered by due time.  Workers wait   |
+    | for the earliest one instead of sleeping in a job.        |
+    \*---------------------------------------------------------*/
+    std::set<std::pair<time_point, RGBController*>> deferred;
+};
@@ -0,0 +1,310 @@
+/*---------------------------------------------------------*\
+| HIDHotplugMonitor.cpp                                     |
+|                                                           |
+|   Watches udev netlink events for hidraw devices being    |
+|   added or removed                                        |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstring>
+#include "HIDHotplugMonitor.h"
+#include "LogManager.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/*---------------------------------------------------------*\
+| Netlink multicast groups of NETLINK_KOBJECT_UEVENT.  The  |
+| kernel group carries the raw events, the udev group the   |
+| same events once udev has processed its rules.  Both are  |
+| watched so that hotplug also works without udev, while    |
+| the udev event restarts the settle time when it arrives.  |
+\*---------------------------------------------------------*/
+#define UEVENT_GROUP_KERNEL         1
+#define UEVENT_GROUP_UDEV           2
+
+#define UDEV_MONITOR_MAGIC          0xFEEDCAFE
+#define UEVENT_BUFFER_SIZE          8192
+#define POLL_INTERVAL_MS            250
+
+/*---------------------------------------------------------*\
+| Header of the messages udev sends to the udev group       |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    char                        prefix[8];
+    unsigned int                magic;
+    unsigned int                header_size;
+    unsigned int                properties_off;
+    unsigned int                properties_len;
+} udev_monitor_netlink_header;
+
+HIDHotplugMonitor::HIDHotplugMonitor(HIDHotplugCallback callback)
+{
+    this->callback  = callback;
+    netlink_fd      = -1;
+    running         = false;
+    monitor_thread  = NULL;
+}
+
+HIDHotplugMonitor::~HIDHotplugMonitor()
+{
+    Stop();
+}
+
+bool HIDHotplugMonitor::IsSupported()
+{
+#ifdef __linux__
+    return(true);
+#else
+    return(false);
+#endif
+}
+
+bool HIDHotplugMonitor::Start()
+{
+#ifdef __linux__
+    if(monitor_thread != NULL)
+    {
+        return(true);
+    }
+
+    netlink_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+
+    if(netlink_fd < 0)
+    {
+        LOG_ERROR("[HIDHotplugMonitor] Failed to open netlink socket: %s", strerror(errno));
+        return(false);
+    }
+
+    struct sockaddr_nl netlink_addr;
+
+    memset(&netlink_addr, 0, sizeof(netlink_addr));
+
+    netlink_addr.nl_family  = AF_NETLINK;
+    netlink_addr.nl_groups  = UEVENT_GROUP_KERNEL | UEVENT_GROUP_UDEV;
+
+    /*-----------------------------------------------------*\
+    | Ask for the sender credentials so that only events    |
+    | sent by root, the kernel or udev, are accepted        |
+    \*-----------------------------------------------------*/
+    int pass_cred = 1;
+
+    setsockopt(netlink_fd, SOL_SOCKET, SO_PASSCRED, &pass_cred, sizeof(pass_cred));
+
+    if(bind(netlink_fd, (struct sockaddr *)&netlink_addr, sizeof(netlink_addr)) != 0)
+    {
+        LOG_ERROR("[HIDHotplugMonitor] Failed to bind netlink socket: %s", strerror(errno));
+        close(netlink_fd);
+        netlink_fd = -1;
+        return(false);
+    }
+
+    running         = true;
+    monitor_thread  = new std::thread(&HIDHotplugMonitor::MonitorThreadFunction, this);
+
+    LOG_INFO("[HIDHotplugMonitor] Watching for hidraw devices");
+
+    return(true);
+#else
+    return(false);
+#endif
+}
+
+void HIDHotplugMonitor::Stop()
+{
+    running = false;
+
+    if(monitor_thread != NULL)
+    {
+        monitor_thread->join();
+        delete monitor_thread;
+        monitor_thread = NULL;
+    }
+
+#ifdef __linux__
+    if(netlink_fd >= 0)
+    {
+        close(netlink_fd);
+        netlink_fd = -1;
+    }
+#endif
+}
+
+void HIDHotplugMonitor::MonitorThreadFunction()
+{
+#ifdef __linux__
+    std::set<std::string>                   changed_paths;
+    std::chrono::steady_clock::time_point   settle_time;
+    char                                    buffer[UEVENT_BUFFER_SIZE];
+    char                                    control[CMSG_SPACE(sizeof(struct ucred))];
+
+    while(running.load())
+    {
+        int timeout_ms = POLL_INTERVAL_MS;
+
+        if(!changed_paths.empty())
+        {
+            long long settle_ms = std::chrono::duration_cast<std::chrono::milliseconds>(settle_time - std::chrono::steady_clock::now()).count();
+
+            if(settle_ms < timeout_ms)
+            {
+                timeout_ms = (settle_ms > 0) ? (int)settle_ms : 0;
+            }
+        }
+
+        struct pollfd netlink_pollfd;
+
+        netlink_pollfd.fd       = netlink_fd;
+        netlink_pollfd.events   = POLLIN;
+        netlink_pollfd.revents  = 0;
+
+        if(poll(&netlink_pollfd, 1, timeout_ms) > 0 && (netlink_pollfd.revents & POLLIN))
+        {
+            struct iovec    iov;
+            struct msghdr   msg;
+
+            iov.iov_base        = buffer;
+            iov.iov_len         = sizeof(buffer) - 1;
+
+            memset(&msg, 0, sizeof(msg));
+
+            msg.msg_iov         = &iov;
+            msg.msg_iovlen      = 1;
+            msg.msg_control     = control;
+            msg.msg_controllen  = sizeof(control);
+
+            int length = (int)recvmsg(netlink_fd, &msg, 0);
+
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+
+            if(length > 0
+            && cmsg != NULL
+            && cmsg->cmsg_type == SCM_CREDENTIALS
+            && ((struct ucred *)CMSG_DATA(cmsg))->uid == 0)
+            {
+                std::string path;
+
+                buffer[length] = '\0';
+
+                if(ParseEvent(buffer, length, path))
+                {
+                    LOG_DEBUG("[HIDHotplugMonitor] %s changed", path.c_str());
+
+                    changed_paths.insert(path);
+                    settle_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(HID_HOTPLUG_SETTLE_MS);
+                }
+            }
+        }
+
+        /*-------------------------------------------------*\
+        | Report the changes once no hidraw event arrived   |
+        | for the settle time                               |
+        \*-------------------------------------------------*/
+        if(!changed_paths.empty() && std::chrono::steady_clock::now() >= settle_time)
+        {
+            callback(changed_paths);
+            changed_paths.clear();
+        }
+    }
+#endif
+}
+
+/*---------------------------------------------------------*\
+| Parse a kernel or udev uevent.  Returns true and the      |
+| device node path for hidraw add and remove events.        |
+\*---------------------------------------------------------*/
+bool HIDHotplugMonitor::ParseEvent(const char* buffer, int length, std::string& path)
+{
+#ifdef __linux__
+    const char* properties;
+    int         properties_len;
+
+    if(length >= (int)sizeof(udev_monitor_netlink_header) && memcmp(buffer, "libudev", 8) == 0)
+    {
+        const udev_monitor_netlink_header* header = (const udev_monitor_netlink_header *)buffer;
+
+        if(ntohl(header->magic) != UDEV_MONITOR_MAGIC
+        || header->properties_off > (unsigned int)length
+        || header->properties_len > (unsigned int)length - header->properties_off)
+        {
+            return(false);
+        }
+
+        properties      = buffer + header->properties_off;
+        properties_len  = (int)header->properties_len;
+    }
+    else
+    {
+        /*-------------------------------------------------*\
+        | Kernel events start with "action@devpath"         |
+        \*-------------------------------------------------*/
+        int header_len = (int)strnlen(buffer, length) + 1;
+
+        if(header_len >= length || strchr(buffer, '@') == NULL)
+        {
+            return(false);
+        }
+
+        properties      = buffer + header_len;
+        properties_len  = length - header_len;
+    }
+
+    bool        hidraw  = false;
+    bool        action  = false;
+    std::string devname;
+
+    for(int offset = 0; offset < properties_len; )
+    {
+        const char* property     = properties + offset;
+        int         property_len = (int)strnlen(property, properties_len - offset);
+
+        if(strncmp(property, "SUBSYSTEM=", 10) == 0)
+        {
+            hidraw = (strcmp(property + 10, "hidraw") == 0);
+        }
+        else if(strncmp(property, "ACTION=", 7) == 0)
+        {
+            action = (strcmp(property + 7, "add") == 0) || (strcmp(property + 7, "remove") == 0);
+        }
+        else if(strncmp(property, "DEVNAME=", 8) == 0)
+        {
+            devname = property + 8;
+        }
+
+        offset += property_len + 1;
+    }
+
+    if(!hidraw || !action || devname.empty())
+    {
+        return(false);
+    }
+
+    /*-----------------------------------------------------*\
+    | The kernel reports the node name relative to /dev     |
+    \*-----------------------------------------------------*/
+    if(devname[0] != '/')
+    {
+        devname = "/dev/" + devname;
+    }
+
+    path = devname;
+
+    return(true);
+#else
+    (void)buffer;
+    (void)length;
+    (void)path;
+    return(false);
+#endif
+}
@@ -0,0 +1,55 @@
+/*---------------------------------------------------------*\
+| HIDHotplugMonitor.h                                       |
+|                                                           |
+|   Watches udev netlink events for hidraw devices being    |
+|   added or removed                                        |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+
+/*---------------------------------------------------------*\
+| Time to wait after the last hidraw event before reporting |
+| the changes.  A device usually adds or removes several    |
+| interfaces at once, and udev needs some time to apply the |
+| device permissions after the kernel event.                |
+\*---------------------------------------------------------*/
+#define HID_HOTPLUG_SETTLE_MS       500
+
+/*---------------------------------------------------------*\
+| Called from the monitor thread with the /dev/hidrawN      |
+| paths of all interfaces added or removed since the last   |
+| call                                                      |
+\*---------------------------------------------------------*/
+typedef std::function<void(const std::set<std::string>&)> HIDHotplugCallback;
+
+class HIDHotplugMonitor
+{
+public:
+    HIDHotplugMonitor(HIDHotplugCallback callback);
+    ~HIDHotplugMonitor();
+
+    static bool     IsSupported();
+
+    bool            Start();
+    void            Stop();
+
+private:
+    HIDHotplugCallback  callback;
+    int                 netlink_fd;
+    std::atomic<bool>   running;
+    std::thread*        monitor_thread;
+
+    void                MonitorThreadFunction();
+    bool                ParseEvent(const char* buffer, int length, std::string& path);
+};
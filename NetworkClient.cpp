@@ -12,6 +12,7 @@
 #include <cstring>
 #include "NetworkClient.h"
 #include "RGBController_Network.h"
+#include "NetworkSharedMemory.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -37,6 +38,8 @@ NetworkClient::NetworkClient(std::vector<RGBController *>& control) : controller
     server_connected        = false;
     server_controller_count = 0;
     change_in_progress      = false;
+    shared_memory_enabled   = false;
+    color_updates_enabled   = false;
 
     ListenThread            = NULL;
     ConnectionThread        = NULL;
@@ -138,6 +141,16 @@ void NetworkClient::SetPort(unsigned short new_port)
     }
 }
 
+void NetworkClient::SetSharedMemoryEnable(bool enable)
+{
+    shared_memory_enabled = enable;
+}
+
+void NetworkClient::SetColorUpdatesEnable(bool enable)
+{
+    color_updates_enabled = enable;
+}
+
 void NetworkClient::StartClient()
 {
     /*---------------------------------------------------------*\
@@ -372,6 +385,42 @@ void NetworkClient::ConnectionThreadFunction()
 
             ControllerListMutex.unlock();
 
+            /*---------------------------------------------------------*\
+            | If the server runs on this machine, ask for a shared      |
+            | memory color ring per controller.  Controllers keep using |
+            | the socket until the reply arrives or if it is refused.   |
+            \*---------------------------------------------------------*/
+            if(shared_memory_enabled
+            && (GetProtocolVersion() >= 8)
+            && NetworkSharedColorRing::IsSupported()
+            && ((port_ip == "127.0.0.1") || (port_ip == "localhost") || (port_ip == "::1")))
+            {
+                for(unsigned int controller_idx = 0; controller_idx < server_controller_count; controller_idx++)
+                {
+                    SendRequest_SharedMemory(controller_idx);
+                }
+            }
+
+            /*---------------------------------------------------------*\
+            | Ask the server to push mode and zone changes made by      |
+            | other clients so the local copies stay in sync.  Color    |
+            | changes can arrive at the effect frame rate and are only  |
+            | requested if enabled.                                     |
+            \*---------------------------------------------------------*/
+            if(GetProtocolVersion() >= 9)
+            {
+                unsigned int update_subscription = RGBCONTROLLER_UPDATE_REASON_UPDATEMODE
+                                                 | RGBCONTROLLER_UPDATE_REASON_RESIZEZONE
+                                                 | RGBCONTROLLER_UPDATE_REASON_SEGMENTS;
+
+                if(color_updates_enabled)
+                {
+                    update_subscription |= RGBCONTROLLER_UPDATE_REASON_UPDATELEDS;
+                }
+
+                SendRequest_ControllerUpdates(update_subscription);
+            }
+
             server_initialized = true;
 
             /*---------------------------------------------------------*\
@@ -517,6 +566,14 @@ void NetworkClient::ListenThreadFunction()
             case NET_PACKET_ID_DEVICE_LIST_UPDATED:
                 ProcessRequest_DeviceListChanged();
                 break;
+
+            case NET_PACKET_ID_REQUEST_SHARED_MEMORY:
+                ProcessReply_SharedMemory(header.pkt_size, data, header.pkt_dev_idx);
+                break;
+
+            case NET_PACKET_ID_CONTROLLER_UPDATED:
+                ProcessRequest_ControllerUpdated(header.pkt_size, data, header.pkt_dev_idx);
+                break;
         }
 
         delete[] data;
@@ -572,6 +629,63 @@ void NetworkClient::WaitOnControllerData()
     return;
 }
 
+/*---------------------------------------------------------*\
+| Flush the colors of every remote controller.  Servers     |
+| supporting protocol 6 or higher receive all controllers   |
+| in a single UpdateAllLEDs packet so that the devices are  |
+| updated together.  Older servers fall back to one         |
+| UpdateLEDs packet per controller.                         |
+\*---------------------------------------------------------*/
+void NetworkClient::UpdateAllLEDs()
+{
+    ControllerListMutex.lock();
+
+    if(GetProtocolVersion() < 6)
+    {
+        for(std::size_t controller_idx = 0; controller_idx < server_controllers.size(); controller_idx++)
+        {
+            server_controllers[controller_idx]->UpdateLEDs();
+        }
+
+        ControllerListMutex.unlock();
+        return;
+    }
+
+    unsigned int        data_size       = 0;
+    unsigned short      num_controllers = (unsigned short)server_controllers.size();
+    std::vector<unsigned char> data_buf(sizeof(data_size) + sizeof(num_controllers));
+
+    for(unsigned short controller_idx = 0; controller_idx < num_controllers; controller_idx++)
+    {
+        RGBController_Network * controller  = (RGBController_Network *)server_controllers[controller_idx];
+        unsigned int            dev_idx     = controller->GetDeviceIndex();
+        unsigned char *         color_data  = controller->GetColorDescription();
+        unsigned int            color_size;
+
+        memcpy(&color_size, &color_data[0], sizeof(unsigned int));
+
+        std::size_t data_ptr = data_buf.size();
+
+        data_buf.resize(data_ptr + sizeof(dev_idx) + color_size);
+
+        memcpy(&data_buf[data_ptr], &dev_idx, sizeof(dev_idx));
+        memcpy(&data_buf[data_ptr + sizeof(dev_idx)], color_data, color_size);
+
+        delete[] color_data;
+
+        controller->SetDeltaReference();
+    }
+
+    ControllerListMutex.unlock();
+
+    data_size = (unsigned int)data_buf.size();
+
+    memcpy(&data_buf[0], &data_size, sizeof(data_size));
+    memcpy(&data_buf[sizeof(data_size)], &num_controllers, sizeof(num_controllers));
+
+    SendRequest_RGBController_UpdateAllLEDs(data_buf.data(), data_size);
+}
+
 void NetworkClient::ProcessReply_ControllerCount(unsigned int data_size, char * data)
 {
     if(data_size == sizeof(unsigned int))
@@ -638,6 +752,141 @@ void NetworkClient::ProcessReply_ProtocolVersion(unsigned int data_size, char *
     }
 }
 
+void NetworkClient::ProcessReply_SharedMemory(unsigned int data_size, char * data, unsigned int dev_idx)
+{
+    const unsigned int header_size = sizeof(unsigned int) + sizeof(unsigned int) + sizeof(unsigned short);
+
+    unsigned int    num_colors;
+    unsigned short  name_len;
+
+    if(data_size < header_size)
+    {
+        return;
+    }
+
+    memcpy(&num_colors, &data[sizeof(unsigned int)], sizeof(num_colors));
+    memcpy(&name_len, &data[sizeof(unsigned int) + sizeof(num_colors)], sizeof(name_len));
+
+    /*---------------------------------------------------------*\
+    | An empty name means the server refused the request        |
+    \*---------------------------------------------------------*/
+    if((name_len == 0) || (num_colors == 0) || ((data_size - header_size) < name_len))
+    {
+        return;
+    }
+
+    std::string ring_name(&data[header_size], name_len);
+
+    ControllerListMutex.lock();
+
+    if(dev_idx < server_controllers.size())
+    {
+        NetworkSharedColorRing * ring = new NetworkSharedColorRing();
+
+        if(ring->Open(ring_name, num_colors))
+        {
+            ((RGBController_Network *)server_controllers[dev_idx])->SetSharedColorRing(ring);
+        }
+        else
+        {
+            delete ring;
+        }
+    }
+
+    ControllerListMutex.unlock();
+}
+
+void NetworkClient::ProcessRequest_ControllerUpdated(unsigned int data_size, char * data, unsigned int dev_idx)
+{
+    unsigned int data_ptr = 0;
+    unsigned int event_size;
+    unsigned int update_reason;
+
+    if(data_size < (sizeof(event_size) + sizeof(update_reason)))
+    {
+        return;
+    }
+
+    memcpy(&event_size, &data[data_ptr], sizeof(event_size));
+    data_ptr += sizeof(event_size);
+
+    memcpy(&update_reason, &data[data_ptr], sizeof(update_reason));
+    data_ptr += sizeof(update_reason);
+
+    if(event_size != data_size)
+    {
+        return;
+    }
+
+    ControllerListMutex.lock();
+
+    if(dev_idx >= server_controllers.size())
+    {
+        ControllerListMutex.unlock();
+        return;
+    }
+
+    RGBController * controller = server_controllers[dev_idx];
+
+    /*---------------------------------------------------------*\
+    | Apply the active mode, then the colors.  Each description |
+    | starts with its own size.                                 |
+    \*---------------------------------------------------------*/
+    if(update_reason & RGBCONTROLLER_UPDATE_REASON_UPDATEMODE)
+    {
+        unsigned int    mode_size;
+        int             mode_idx;
+
+        if((data_size - data_ptr) < (sizeof(mode_size) + sizeof(mode_idx)))
+        {
+            ControllerListMutex.unlock();
+            return;
+        }
+
+        memcpy(&mode_size, &data[data_ptr], sizeof(mode_size));
+        memcpy(&mode_idx, &data[data_ptr + sizeof(mode_size)], sizeof(mode_idx));
+
+        if((mode_size > (data_size - data_ptr)) || (mode_size < (sizeof(mode_size) + sizeof(mode_idx))))
+        {
+            ControllerListMutex.unlock();
+            return;
+        }
+
+        if((mode_idx >= 0) && ((std::size_t)mode_idx < controller->modes.size()))
+        {
+            controller->SetModeDescription((unsigned char *)&data[data_ptr], GetProtocolVersion());
+        }
+
+        data_ptr += mode_size;
+    }
+
+    if(update_reason & RGBCONTROLLER_UPDATE_REASON_UPDATELEDS)
+    {
+        controller->SetColorDescription((const unsigned char *)&data[data_ptr], data_size - data_ptr);
+
+        /*-----------------------------------------------------*\
+        | The server now holds these colors, so the next delta  |
+        | must be computed against them                         |
+        \*-----------------------------------------------------*/
+        ((RGBController_Network *)controller)->SetDeltaReference();
+    }
+
+    /*---------------------------------------------------------*\
+    | Signal while the list lock keeps the controller alive     |
+    \*---------------------------------------------------------*/
+    controller->SignalUpdate();
+
+    ControllerListMutex.unlock();
+
+    /*---------------------------------------------------------*\
+    | Zone layout changed, fetch the controller data again      |
+    \*---------------------------------------------------------*/
+    if(update_reason & (RGBCONTROLLER_UPDATE_REASON_RESIZEZONE | RGBCONTROLLER_UPDATE_REASON_SEGMENTS))
+    {
+        SendRequest_ControllerData(dev_idx);
+    }
+}
+
 void NetworkClient::ProcessRequest_DeviceListChanged()
 {
     change_in_progress = true;
@@ -762,6 +1011,29 @@ void NetworkClient::SendRequest_ProtocolVersion()
     send_in_progress.unlock();
 }
 
+void NetworkClient::SendRequest_ControllerUpdates(unsigned int update_subscription)
+{
+    NetPacketHeader request_hdr;
+
+    InitNetPacketHeader(&request_hdr, 0, NET_PACKET_ID_REQUEST_CONTROLLER_UPDATES, sizeof(update_subscription));
+
+    send_in_progress.lock();
+    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+    send(client_sock, (char *)&update_subscription, sizeof(update_subscription), MSG_NOSIGNAL);
+    send_in_progress.unlock();
+}
+
+void NetworkClient::SendRequest_SharedMemory(unsigned int dev_idx)
+{
+    NetPacketHeader request_hdr;
+
+    InitNetPacketHeader(&request_hdr, dev_idx, NET_PACKET_ID_REQUEST_SHARED_MEMORY, 0);
+
+    send_in_progress.lock();
+    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+    send_in_progress.unlock();
+}
+
 void NetworkClient::SendRequest_RGBController_ClearSegments(unsigned int dev_idx, int zone)
 {
     if(change_in_progress)
@@ -867,6 +1139,44 @@ void NetworkClient::SendRequest_RGBController_UpdateSingleLED(unsigned int dev_i
     send_in_progress.unlock();
 }
 
+void NetworkClient::SendRequest_RGBController_UpdateLEDsDelta(unsigned int dev_idx, unsigned char * data, unsigned int size)
+{
+    if(change_in_progress)
+    {
+        return;
+    }
+
+    NetPacketHeader request_hdr;
+
+    InitNetPacketHeader(&request_hdr, dev_idx, NET_PACKET_ID_RGBCONTROLLER_UPDATELEDSDELTA, size);
+
+    send_in_progress.lock();
+    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+    send(client_sock, (char *)data, size, MSG_NOSIGNAL);
+    send_in_progress.unlock();
+}
+
+void NetworkClient::SendRequest_RGBController_UpdateAllLEDs(unsigned char * data, unsigned int size)
+{
+    if(change_in_progress)
+    {
+        return;
+    }
+
+    /*---------------------------------------------------------*\
+    | Send the header and all color descriptions in a single    |
+    | send() so the server receives the whole frame at once     |
+    \*---------------------------------------------------------*/
+    std::vector<char> request_buf(sizeof(NetPacketHeader) + size);
+
+    InitNetPacketHeader((NetPacketHeader *)request_buf.data(), 0, NET_PACKET_ID_RGBCONTROLLER_UPDATEALLLEDS, size);
+    memcpy(&request_buf[sizeof(NetPacketHeader)], data, size);
+
+    send_in_progress.lock();
+    send(client_sock, request_buf.data(), (int)request_buf.size(), MSG_NOSIGNAL);
+    send_in_progress.unlock();
+}
+
 void NetworkClient::SendRequest_RGBController_SetCustomMode(unsigned int dev_idx)
 {
     if(change_in_progress)
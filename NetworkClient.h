@@ -40,6 +40,8 @@ public:
     void            SetIP(std::string new_ip);
     void            SetName(std::string new_name);
     void            SetPort(unsigned short new_port);
+    void            SetSharedMemoryEnable(bool enable);
+    void            SetColorUpdatesEnable(bool enable);
 
     void            StartClient();
     void            StopClient();
@@ -49,17 +51,23 @@ public:
 
     void            WaitOnControllerData();
 
+    void            UpdateAllLEDs();
+
     void        ProcessReply_ControllerCount(unsigned int data_size, char * data);
     void        ProcessReply_ControllerData(unsigned int data_size, char * data, unsigned int dev_idx);
     void        ProcessReply_ProtocolVersion(unsigned int data_size, char * data);
+    void        ProcessReply_SharedMemory(unsigned int data_size, char * data, unsigned int dev_idx);
 
     void        ProcessRequest_DeviceListChanged();
+    void        ProcessRequest_ControllerUpdated(unsigned int data_size, char * data, unsigned int dev_idx);
 
     void        SendData_ClientString();
 
     void        SendRequest_ControllerCount();
     void        SendRequest_ControllerData(unsigned int dev_idx);
     void        SendRequest_ProtocolVersion();
+    void        SendRequest_SharedMemory(unsigned int dev_idx);
+    void        SendRequest_ControllerUpdates(unsigned int update_subscription);
 
     void        SendRequest_RGBController_ClearSegments(unsigned int dev_idx, int zone);
     void        SendRequest_RGBController_AddSegment(unsigned int dev_idx, unsigned char * data, unsigned int size);
@@ -68,6 +76,8 @@ public:
     void        SendRequest_RGBController_UpdateLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size);
     void        SendRequest_RGBController_UpdateZoneLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size);
     void        SendRequest_RGBController_UpdateSingleLED(unsigned int dev_idx, unsigned char * data, unsigned int size);
+    void        SendRequest_RGBController_UpdateAllLEDs(unsigned char * data, unsigned int size);
+    void        SendRequest_RGBController_UpdateLEDsDelta(unsigned int dev_idx, unsigned char * data, unsigned int size);
 
     void        SendRequest_RGBController_SetCustomMode(unsigned int dev_idx);
 
@@ -105,6 +115,8 @@ private:
     unsigned int    server_protocol_version;
     bool            server_protocol_version_received;
     bool            change_in_progress;
+    bool            shared_memory_enabled;
+    bool            color_updates_enabled;
     std::mutex      send_in_progress;
 
     std::mutex      connection_mutex;
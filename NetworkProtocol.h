@@ -21,8 +21,12 @@
 |   4:      Add segments field to zones, network plugins (Release 0.9)  |
 |   5:      Zone flags, controller flags, resizable effects-only zones  |
                 (Release 1.0)                                           |
+|   6:      Batched multi-device UpdateLEDs                             |
+|   7:      Delta-encoded UpdateLEDs                                    |
+|   8:      Shared memory color transport for local clients             |
+|   9:      Controller update notifications                             |
 \*---------------------------------------------------------------------*/
-#define OPENRGB_SDK_PROTOCOL_VERSION    5
+#define OPENRGB_SDK_PROTOCOL_VERSION    9
 
 /*-----------------------------------------------------*\
 | Default Interface to bind to.                         |
@@ -61,7 +65,11 @@ enum
 
     NET_PACKET_ID_SET_CLIENT_NAME               = 50,   /* Send client name string to server                    */
 
+    NET_PACKET_ID_REQUEST_SHARED_MEMORY         = 60,   /* Request shared memory color ring for a controller    */
+
     NET_PACKET_ID_DEVICE_LIST_UPDATED           = 100,  /* Indicate to clients that device list has updated     */
+    NET_PACKET_ID_REQUEST_CONTROLLER_UPDATES    = 101,  /* Subscribe to controller update notifications         */
+    NET_PACKET_ID_CONTROLLER_UPDATED            = 102,  /* Indicate to clients that a controller has updated    */
 
     NET_PACKET_ID_REQUEST_PROFILE_LIST          = 150,  /* Request profile list                                 */
     NET_PACKET_ID_REQUEST_SAVE_PROFILE          = 151,  /* Save current configuration in a new profile          */
@@ -81,6 +89,8 @@ enum
     NET_PACKET_ID_RGBCONTROLLER_UPDATELEDS      = 1050, /* RGBController::UpdateLEDs()                          */
     NET_PACKET_ID_RGBCONTROLLER_UPDATEZONELEDS  = 1051, /* RGBController::UpdateZoneLEDs()                      */
     NET_PACKET_ID_RGBCONTROLLER_UPDATESINGLELED = 1052, /* RGBController::UpdateSingleLED()                     */
+    NET_PACKET_ID_RGBCONTROLLER_UPDATEALLLEDS   = 1053, /* RGBController::UpdateLEDs() on multiple controllers  */
+    NET_PACKET_ID_RGBCONTROLLER_UPDATELEDSDELTA = 1054, /* RGBController::UpdateLEDs() with changed LEDs only   */
 
     NET_PACKET_ID_RGBCONTROLLER_SETCUSTOMMODE   = 1100, /* RGBController::SetCustomMode()                       */
     NET_PACKET_ID_RGBCONTROLLER_UPDATEMODE      = 1101, /* RGBController::UpdateMode()                          */
@@ -15,6 +15,9 @@
 
 #ifndef WIN32
 #include <sys/ioctl.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 #include <netinet/tcp.h>
 #include <sys/types.h>
 #include <arpa/inet.h>
@@ -24,9 +27,32 @@
 #include <memory.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <iostream>
+#include <map>
+
+const int yes = 1;
+
+/*---------------------------------------------------------*\
+| Lets the header and data of a packet leave in one segment |
+\*---------------------------------------------------------*/
+#ifndef MSG_MORE
+#define MSG_MORE 0
+#endif
+
+/*---------------------------------------------------------*\
+| Client whose packet is being processed on this thread.    |
+| Controller updates caused by a client are not echoed back |
+| to it.                                                    |
+\*---------------------------------------------------------*/
+static thread_local NetworkClientInfo * update_source_client = nullptr;
+
+static void ControllerUpdateReasonCallback(void * this_ptr, RGBController * controller, unsigned int update_reason)
+{
+    NetworkServer * this_obj = (NetworkServer *)this_ptr;
 
-const char yes = 1;
+    this_obj->ControllerUpdated(controller, update_reason);
+}
 
 #ifdef WIN32
 #include <Windows.h>
@@ -43,10 +69,29 @@ NetworkClientInfo::NetworkClientInfo()
     client_sock             = INVALID_SOCKET;
     client_listen_thread    = nullptr;
     client_protocol_version = 0;
+    recv_len                = 0;
+    recv_resync             = false;
+    send_nonblocking        = false;
+    send_failed             = false;
+    send_pos                = 0;
+    update_subscription     = 0;
+    notify_refs             = 0;
 }
 
 NetworkClientInfo::~NetworkClientInfo()
 {
+    /*---------------------------------------------------------*\
+    | Stop the shared memory flush threads before unmapping     |
+    \*---------------------------------------------------------*/
+    for(std::size_t ring_idx = 0; ring_idx < shared_rings.size(); ring_idx++)
+    {
+        shared_rings[ring_idx]->Stop();
+        shared_ring_threads[ring_idx]->join();
+
+        delete shared_ring_threads[ring_idx];
+        delete shared_rings[ring_idx];
+    }
+
     if(client_sock != INVALID_SOCKET)
     {
         LOG_INFO("[NetworkServer] Closing server connection: %s", client_ip.c_str());
@@ -62,7 +107,17 @@ NetworkServer::NetworkServer(std::vector<RGBController *>& control) : controller
     port_num                    = OPENRGB_SDK_PORT;
     server_online               = false;
     server_listening            = false;
+    event_loop_enabled          = false;
     legacy_workaround_enabled   = false;
+    shared_memory_enabled       = false;
+    shared_memory_mode          = OPENRGB_SHM_DEFAULT_MODE;
+    EventLoopThread             = nullptr;
+    event_loop_fd               = -1;
+    UpdateNotifyThread          = nullptr;
+    update_notify_running       = false;
+    description_cache_hits      = 0;
+    description_cache_misses    = 0;
+    socket_count                = 0;
 
     for(int i = 0; i < MAXSOCK; i++)
     {
@@ -70,6 +125,7 @@ NetworkServer::NetworkServer(std::vector<RGBController *>& control) : controller
     }
 
     profile_manager  = nullptr;
+    controllers_mutex = nullptr;
 }
 
 NetworkServer::~NetworkServer()
@@ -94,14 +150,52 @@ void NetworkServer::ClientInfoChanged()
 
 void NetworkServer::DeviceListChanged()
 {
+    /*---------------------------------------------------------*\
+    | Attach update callbacks to any new controllers            |
+    \*---------------------------------------------------------*/
+    if(server_online)
+    {
+        RegisterControllerCallbacks();
+    }
+
+    /*---------------------------------------------------------*\
+    | Drop pending updates of controllers that are no longer in |
+    | the list, they may be deleted once it has changed.  The   |
+    | owner holds the controllers mutex while calling this.     |
+    \*---------------------------------------------------------*/
+    {
+        std::lock_guard<std::mutex> pending_lock(UpdatePendingMutex);
+
+        for(NetworkClientInfo * subscriber : UpdateSubscribers)
+        {
+            std::map<RGBController *, unsigned int>::iterator update_it = subscriber->pending_updates.begin();
+
+            while(update_it != subscriber->pending_updates.end())
+            {
+                if(std::find(controllers.begin(), controllers.end(), update_it->first) == controllers.end())
+                {
+                    update_it = subscriber->pending_updates.erase(update_it);
+                }
+                else
+                {
+                    update_it++;
+                }
+            }
+        }
+    }
+
     /*---------------------------------------------------------*\
     | Indicate to the clients that the controller list has      |
     | changed                                                   |
     \*---------------------------------------------------------*/
+    ServerClientsMutex.lock();
+
     for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
     {
-        SendRequest_DeviceListChanged(ServerClients[client_idx]->client_sock);
+        SendRequest_DeviceListChanged(ServerClients[client_idx]);
     }
+
+    ServerClientsMutex.unlock();
 }
 
 void NetworkServer::ServerListeningChanged()
@@ -144,6 +238,12 @@ unsigned int NetworkServer::GetNumClients()
     return (unsigned int)ServerClients.size();
 }
 
+void NetworkServer::GetDescriptionCacheStats(unsigned long long * hits, unsigned long long * misses)
+{
+    *hits   = description_cache_hits.load();
+    *misses = description_cache_misses.load();
+}
+
 const char * NetworkServer::GetClientString(unsigned int client_num)
 {
     const char * result;
@@ -216,6 +316,14 @@ void NetworkServer::RegisterServerListeningChangeCallback(NetServerCallback new_
     ServerListeningChangeCallbackArgs.push_back(new_callback_arg);
 }
 
+void NetworkServer::SetControllersMutex(std::mutex * mutex)
+{
+    if(server_online == false)
+    {
+        controllers_mutex = mutex;
+    }
+}
+
 void NetworkServer::SetHost(std::string new_host)
 {
     if(server_online == false)
@@ -224,11 +332,42 @@ void NetworkServer::SetHost(std::string new_host)
     }
 }
 
+void NetworkServer::SetEventLoopEnable(bool enable)
+{
+#ifdef __linux__
+    if(server_online == false)
+    {
+        event_loop_enabled = enable;
+    }
+#else
+    if(enable)
+    {
+        LOG_WARNING("[NetworkServer] Event loop server mode is only supported on Linux, using one thread per client");
+    }
+#endif
+}
+
 void NetworkServer::SetLegacyWorkaroundEnable(bool enable)
 {
     legacy_workaround_enabled = enable;
 }
 
+void NetworkServer::SetSharedMemoryEnable(bool enable)
+{
+    if(enable && !NetworkSharedColorRing::IsSupported())
+    {
+        LOG_WARNING("[NetworkServer] Shared memory color transport is only supported on Linux");
+        return;
+    }
+
+    shared_memory_enabled = enable;
+}
+
+void NetworkServer::SetSharedMemoryMode(unsigned int mode)
+{
+    shared_memory_mode = mode & 0666;
+}
+
 void NetworkServer::SetPort(unsigned short new_port)
 {
     if(server_online == false)
@@ -329,7 +468,7 @@ void NetworkServer::StartServer()
         /*---------------------------------------------------------*\
         | Set socket options - no delay                             |
         \*---------------------------------------------------------*/
-        setsockopt(server_sock[socket_count], IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        setsockopt(server_sock[socket_count], IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
 
         socket_count += 1;
     }
@@ -337,6 +476,24 @@ void NetworkServer::StartServer()
     freeaddrinfo(result);
     server_online = true;
 
+    /*---------------------------------------------------------*\
+    | Start the controller update notification thread           |
+    \*---------------------------------------------------------*/
+    RegisterControllerCallbacks();
+
+    update_notify_running   = true;
+    UpdateNotifyThread      = new std::thread(&NetworkServer::UpdateNotifyThreadFunction, this);
+
+    /*---------------------------------------------------------*\
+    | In event loop mode a single thread accepts and services   |
+    | all clients                                               |
+    \*---------------------------------------------------------*/
+    if(event_loop_enabled)
+    {
+        EventLoopThread = new std::thread(&NetworkServer::EventLoopThreadFunction, this);
+        return;
+    }
+
     /*---------------------------------------------------------*\
     | Start the connection thread                               |
     \*---------------------------------------------------------*/
@@ -352,6 +509,41 @@ void NetworkServer::StopServer()
     int curr_socket;
     server_online = false;
 
+    /*---------------------------------------------------------*\
+    | Wait for the event loop to exit before closing sockets    |
+    \*---------------------------------------------------------*/
+    if(EventLoopThread)
+    {
+        EventLoopThread->join();
+        delete EventLoopThread;
+        EventLoopThread = nullptr;
+    }
+
+    /*---------------------------------------------------------*\
+    | Stop update notifications before deleting the clients     |
+    \*---------------------------------------------------------*/
+    if(UpdateNotifyThread)
+    {
+        {
+            std::lock_guard<std::mutex> pending_lock(UpdatePendingMutex);
+            update_notify_running = false;
+        }
+        UpdatePendingCV.notify_all();
+
+        UpdateNotifyThread->join();
+        delete UpdateNotifyThread;
+        UpdateNotifyThread = nullptr;
+
+        UnregisterControllerCallbacks();
+    }
+
+    {
+        std::lock_guard<std::mutex> subscribers_lock(UpdateSubscribersMutex);
+        std::lock_guard<std::mutex> pending_lock(UpdatePendingMutex);
+
+        UpdateSubscribers.clear();
+    }
+
     ServerClientsMutex.lock();
 
     for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
@@ -380,6 +572,12 @@ void NetworkServer::StopServer()
 
     socket_count = 0;
 
+    if(description_cache_hits.load() + description_cache_misses.load() > 0)
+    {
+        LOG_DEBUG("[NetworkServer] Controller data requests: %llu served from cache, %llu rebuilt",
+                  description_cache_hits.load(), description_cache_misses.load());
+    }
+
     /*---------------------------------------------------------*\
     | Client info has changed, call the callbacks               |
     \*---------------------------------------------------------*/
@@ -432,35 +630,7 @@ void NetworkServer::ConnectionThreadFunction(int socket_idx)
             return;
         }
 
-        /*---------------------------------------------------------*\
-        | Get the new client socket and store it in the clients     |
-        | vector                                                    |
-        \*---------------------------------------------------------*/
-        u_long arg = 0;
-        ioctlsocket(client_info->client_sock, FIONBIO, &arg);
-        setsockopt(client_info->client_sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
-
-        /*---------------------------------------------------------*\
-        | Discover the remote hosts IP                              |
-        \*---------------------------------------------------------*/
-        struct sockaddr_storage tmp_addr;
-        char ipstr[INET6_ADDRSTRLEN];
-        socklen_t len;
-        len = sizeof(tmp_addr);
-        getpeername(client_info->client_sock, (struct sockaddr*)&tmp_addr, &len);
-
-        if(tmp_addr.ss_family == AF_INET)
-        {
-            struct sockaddr_in *s_4 = (struct sockaddr_in *)&tmp_addr;
-            inet_ntop(AF_INET, &s_4->sin_addr, ipstr, sizeof(ipstr));
-            client_info->client_ip = ipstr;
-        }
-        else
-        {
-            struct sockaddr_in6 *s_6 = (struct sockaddr_in6 *)&tmp_addr;
-            inet_ntop(AF_INET6, &s_6->sin6_addr, ipstr, sizeof(ipstr));
-            client_info->client_ip = ipstr;
-        }
+        SetupClientConnection(client_info);
 
         /*---------------------------------------------------------*\
         | We need to lock before the thread could possibly finish   |
@@ -488,6 +658,38 @@ void NetworkServer::ConnectionThreadFunction(int socket_idx)
     ServerListeningChanged();
 }
 
+void NetworkServer::SetupClientConnection(NetworkClientInfo * client_info)
+{
+    /*---------------------------------------------------------*\
+    | Put the new client socket in blocking mode with no delay  |
+    \*---------------------------------------------------------*/
+    u_long arg = 0;
+    ioctlsocket(client_info->client_sock, FIONBIO, &arg);
+    setsockopt(client_info->client_sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
+
+    /*---------------------------------------------------------*\
+    | Discover the remote hosts IP                              |
+    \*---------------------------------------------------------*/
+    struct sockaddr_storage tmp_addr;
+    char ipstr[INET6_ADDRSTRLEN];
+    socklen_t len;
+    len = sizeof(tmp_addr);
+    getpeername(client_info->client_sock, (struct sockaddr*)&tmp_addr, &len);
+
+    if(tmp_addr.ss_family == AF_INET)
+    {
+        struct sockaddr_in *s_4 = (struct sockaddr_in *)&tmp_addr;
+        inet_ntop(AF_INET, &s_4->sin_addr, ipstr, sizeof(ipstr));
+        client_info->client_ip = ipstr;
+    }
+    else
+    {
+        struct sockaddr_in6 *s_6 = (struct sockaddr_in6 *)&tmp_addr;
+        inet_ntop(AF_INET6, &s_6->sin6_addr, ipstr, sizeof(ipstr));
+        client_info->client_ip = ipstr;
+    }
+}
+
 int NetworkServer::accept_select(int sockfd)
 {
     fd_set              set;
@@ -562,13 +764,14 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
         NetPacketHeader header;
         int             bytes_read  = 0;
         char *          data        = NULL;
+        unsigned int    magic_idx   = 0;
 
-        for(unsigned int i = 0; i < 4; i++)
+        while(magic_idx < 4)
         {
             /*---------------------------------------------------------*\
             | Read byte of magic                                        |
             \*---------------------------------------------------------*/
-            bytes_read = recv_select(client_sock, &header.pkt_magic[i], 1, 0);
+            bytes_read = recv_select(client_sock, &header.pkt_magic[magic_idx], 1, 0);
 
             if(bytes_read <= 0)
             {
@@ -579,13 +782,35 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
             /*---------------------------------------------------------*\
             | Test characters of magic "ORGB"                           |
             \*---------------------------------------------------------*/
-            if(header.pkt_magic[i] != openrgb_sdk_magic[i])
+            if(header.pkt_magic[magic_idx] == openrgb_sdk_magic[magic_idx])
             {
-                LOG_ERROR("[NetworkServer] Invalid magic received");
+                magic_idx++;
                 continue;
             }
+
+            /*---------------------------------------------------------*\
+            | Skip bytes until the magic is found again, logging once   |
+            | per resync.  A mismatched byte may start the next magic.  |
+            \*---------------------------------------------------------*/
+            if(!client_info->recv_resync)
+            {
+                LOG_ERROR("[NetworkServer] Invalid magic received from %s, resynchronizing", client_info->client_ip.c_str());
+                client_info->recv_resync = true;
+            }
+
+            if(header.pkt_magic[magic_idx] == openrgb_sdk_magic[0])
+            {
+                header.pkt_magic[0] = openrgb_sdk_magic[0];
+                magic_idx           = 1;
+            }
+            else
+            {
+                magic_idx           = 0;
+            }
         }
 
+        client_info->recv_resync = false;
+
         /*---------------------------------------------------------*\
         | If we get to this point, the magic is correct.  Read the  |
         | rest of the header                                        |
@@ -613,7 +838,16 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
         bytes_read = 0;
         if(header.pkt_size > 0)
         {
-            data = new char[header.pkt_size];
+            /*---------------------------------------------------------*\
+            | Reuse the per-connection buffer, it only grows when a     |
+            | larger packet than any before is received                 |
+            \*---------------------------------------------------------*/
+            if(client_info->recv_buf.size() < header.pkt_size)
+            {
+                client_info->recv_buf.resize(header.pkt_size);
+            }
+
+            data = client_info->recv_buf.data();
 
             do
             {
@@ -632,475 +866,1563 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
         }
 
         /*---------------------------------------------------------*\
-        | Entire request received, select functionality based on    |
-        | request ID                                                |
+        | Entire request received, process it                       |
         \*---------------------------------------------------------*/
-        switch(header.pkt_id)
+        if(!ProcessPacket(client_info, header, data))
         {
-            case NET_PACKET_ID_REQUEST_CONTROLLER_COUNT:
-                SendReply_ControllerCount(client_sock);
-                break;
+            goto listen_done;
+        }
+    }
 
-            case NET_PACKET_ID_REQUEST_CONTROLLER_DATA:
-                {
-                    unsigned int protocol_version = 0;
+listen_done:
 
-                    if(header.pkt_size == sizeof(unsigned int))
-                    {
-                        memcpy(&protocol_version, data, sizeof(unsigned int));
-                    }
+    RemoveUpdateSubscriber(client_info);
 
-                    SendReply_ControllerData(client_sock, header.pkt_dev_idx, protocol_version);
-                }
-                break;
+    ServerClientsMutex.lock();
 
-            case NET_PACKET_ID_REQUEST_PROTOCOL_VERSION:
-                SendReply_ProtocolVersion(client_sock);
-                ProcessRequest_ClientProtocolVersion(client_sock, header.pkt_size, data);
-                break;
+    for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
+    {
+        if(ServerClients[this_idx] == client_info)
+        {
+            delete client_info;
+            ServerClients.erase(ServerClients.begin() + this_idx);
+            break;
+        }
+    }
 
-            case NET_PACKET_ID_SET_CLIENT_NAME:
-                if(data == NULL)
-                {
-                    break;
-                }
+    client_info = nullptr;
 
-                ProcessRequest_ClientString(client_sock, header.pkt_size, data);
-                break;
+    ServerClientsMutex.unlock();
 
-            case NET_PACKET_ID_RGBCONTROLLER_RESIZEZONE:
-                if(data == NULL)
-                {
-                    break;
-                }
+    /*---------------------------------------------------------*\
+    | Client info has changed, call the callbacks               |
+    \*---------------------------------------------------------*/
+    ClientInfoChanged();
+}
 
-                if((header.pkt_dev_idx < controllers.size()) && (header.pkt_size == (2 * sizeof(int))))
-                {
-                    int zone;
-                    int new_size;
+void NetworkServer::EventLoopThreadFunction()
+{
+#ifdef __linux__
+    /*---------------------------------------------------------*\
+    | This thread accepts clients on all server sockets and     |
+    | handles messages from all clients using epoll             |
+    \*---------------------------------------------------------*/
+    LOG_INFO("[NetworkServer] Network event loop started on port %hu", GetPort());
 
-                    memcpy(&zone, data, sizeof(int));
-                    memcpy(&new_size, data + sizeof(int), sizeof(int));
+    const int                           max_events = 64;
+    struct epoll_event                  events[max_events];
+    std::map<SOCKET, NetworkClientInfo*> event_clients;
 
-                    controllers[header.pkt_dev_idx]->ResizeZone(zone, new_size);
-                    profile_manager->SaveProfile("sizes", true);
-                }
-                break;
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
 
-            case NET_PACKET_ID_RGBCONTROLLER_UPDATELEDS:
-                if(data == NULL)
-                {
-                    break;
-                }
+    if(epoll_fd < 0)
+    {
+        LOG_ERROR("[NetworkServer] Failed to create epoll instance, error code: %d", errno);
+        server_online = false;
+        return;
+    }
 
-                /*---------------------------------------------------------*\
-                | Verify the color description size (first 4 bytes of data) |
-                | matches the packet size in the header                     |
-                |                                                           |
-                | If protocol version is 4 or below and the legacy SDK      |
-                | compatibility workaround is enabled, ignore this check.   |
-                | This allows backwards compatibility with old versions of  |
-                | SDK applications that didn't properly implement the size  |
-                | field.                                                    |
-                \*---------------------------------------------------------*/
-                if((header.pkt_size == *((unsigned int*)data))
-                || ((client_info->client_protocol_version <= 4)
-                 && (legacy_workaround_enabled)))
-                {
-                    if(header.pkt_dev_idx < controllers.size())
-                    {
-                        controllers[header.pkt_dev_idx]->SetColorDescription((unsigned char *)data);
-                        controllers[header.pkt_dev_idx]->UpdateLEDs();
-                    }
-                }
-                else
-                {
-                    LOG_ERROR("[NetworkServer] UpdateLEDs packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, *((unsigned int*)data));
-                    goto listen_done;
-                }
-                break;
+    for(int curr_socket = 0; curr_socket < socket_count; curr_socket++)
+    {
+        if(listen(server_sock[curr_socket], 10) < 0)
+        {
+            LOG_ERROR("[NetworkServer] Failed to listen on server socket, error code: %d", errno);
+            continue;
+        }
 
-            case NET_PACKET_ID_RGBCONTROLLER_UPDATEZONELEDS:
-                if(data == NULL)
-                {
-                    break;
-                }
+        u_long arg = 1;
+        ioctlsocket(server_sock[curr_socket], FIONBIO, &arg);
 
-                /*---------------------------------------------------------*\
-                | Verify the color description size (first 4 bytes of data) |
-                | matches the packet size in the header                     |
-                |                                                           |
-                | If protocol version is 4 or below and the legacy SDK      |
-                | compatibility workaround is enabled, ignore this check.   |
-                | This allows backwards compatibility with old versions of  |
-                | SDK applications that didn't properly implement the size  |
-                | field.                                                    |
-                \*---------------------------------------------------------*/
-                if((header.pkt_size == *((unsigned int*)data))
-                || ((client_info->client_protocol_version <= 4)
-                 && (legacy_workaround_enabled)))
-                {
-                    if(header.pkt_dev_idx < controllers.size())
-                    {
-                        int zone;
+        struct epoll_event event;
+        event.events    = EPOLLIN;
+        event.data.fd   = (int)server_sock[curr_socket];
 
-                        memcpy(&zone, &data[sizeof(unsigned int)], sizeof(int));
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, (int)server_sock[curr_socket], &event);
+    }
 
-                        controllers[header.pkt_dev_idx]->SetZoneColorDescription((unsigned char *)data);
-                        controllers[header.pkt_dev_idx]->UpdateZoneLEDs(zone);
-                    }
-                }
-                else
-                {
-                    LOG_ERROR("[NetworkServer] UpdateZoneLEDs packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, *((unsigned int*)data));
-                    goto listen_done;
-                }
-                break;
+    event_loop_fd = epoll_fd;
+
+    server_listening = true;
+    ServerListeningChanged();
+
+    while(server_online == true)
+    {
+        /*---------------------------------------------------------*\
+        | Wake up at least once per second to check server_online   |
+        \*---------------------------------------------------------*/
+        int num_events = epoll_wait(epoll_fd, events, max_events, 1000);
+
+        if(num_events < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            LOG_ERROR("[NetworkServer] epoll_wait failed, error code: %d", errno);
+            break;
+        }
+
+        for(int event_idx = 0; event_idx < num_events; event_idx++)
+        {
+            SOCKET event_sock   = events[event_idx].data.fd;
+            bool   is_listener  = false;
 
-            case NET_PACKET_ID_RGBCONTROLLER_UPDATESINGLELED:
-                if(data == NULL)
+            for(int curr_socket = 0; curr_socket < socket_count; curr_socket++)
+            {
+                if(server_sock[curr_socket] == event_sock)
                 {
+                    is_listener = true;
                     break;
                 }
+            }
 
-                /*---------------------------------------------------------*\
-                | Verify the single LED color description size (8 bytes)    |
-                | matches the packet size in the header                     |
-                \*---------------------------------------------------------*/
-                if(header.pkt_size == (sizeof(int) + sizeof(RGBColor)))
+            /*---------------------------------------------------------*\
+            | Accept all pending connections on a listening socket      |
+            \*---------------------------------------------------------*/
+            if(is_listener)
+            {
+                while(1)
                 {
-                    if(header.pkt_dev_idx < controllers.size())
+                    SOCKET new_sock = accept((int)event_sock, NULL, NULL);
+
+                    if(new_sock == INVALID_SOCKET)
                     {
-                        int led;
+                        break;
+                    }
 
-                        memcpy(&led, data, sizeof(int));
+                    NetworkClientInfo * client_info = new NetworkClientInfo();
 
-                        controllers[header.pkt_dev_idx]->SetSingleLEDColorDescription((unsigned char *)data);
-                        controllers[header.pkt_dev_idx]->UpdateSingleLED(led);
-                    }
-                }
-                else
+                    client_info->client_sock = new_sock;
+
+                    SetupClientConnection(client_info);
+
+                    /*---------------------------------------------------------*\
+                    | Replies are queued instead of blocking the event loop     |
+                    \*---------------------------------------------------------*/
+                    u_long arg = 1;
+                    ioctlsocket(new_sock, FIONBIO, &arg);
+
+                    client_info->send_nonblocking = true;
+
+                    struct epoll_event event;
+                    event.events    = EPOLLIN | EPOLLRDHUP;
+                    event.data.fd   = (int)new_sock;
+
+                    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, (int)new_sock, &event);
+
+                    event_clients[new_sock] = client_info;
+
+                    ServerClientsMutex.lock();
+                    ServerClients.push_back(client_info);
+                    ServerClientsMutex.unlock();
+
+                    /*---------------------------------------------------------*\
+                    | Client info has changed, call the callbacks               |
+                    \*---------------------------------------------------------*/
+                    ClientInfoChanged();
+                }
+
+                continue;
+            }
+
+            std::map<SOCKET, NetworkClientInfo*>::iterator client_it = event_clients.find(event_sock);
+
+            if(client_it == event_clients.end())
+            {
+                continue;
+            }
+
+            NetworkClientInfo * client_info = client_it->second;
+            bool                client_ok   = true;
+
+            if(events[event_idx].events & EPOLLOUT)
+            {
+                client_ok = EventLoopFlush(client_info);
+            }
+
+            if(client_ok && (events[event_idx].events & ~EPOLLOUT))
+            {
+                client_ok = EventLoopReceive(client_info);
+            }
+
+            if(client_ok)
+            {
+                continue;
+            }
+
+            /*---------------------------------------------------------*\
+            | Client disconnected or sent an invalid packet, remove it  |
+            \*---------------------------------------------------------*/
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, (int)event_sock, NULL);
+            event_clients.erase(client_it);
+
+            RemoveUpdateSubscriber(client_info);
+
+            ServerClientsMutex.lock();
+
+            for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
+            {
+                if(ServerClients[this_idx] == client_info)
                 {
-                    LOG_ERROR("[NetworkServer] UpdateSingleLED packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, (sizeof(int) + sizeof(RGBColor)));
-                    goto listen_done;
+                    delete client_info;
+                    ServerClients.erase(ServerClients.begin() + this_idx);
+                    break;
+                }
+            }
+
+            ServerClientsMutex.unlock();
+
+            /*---------------------------------------------------------*\
+            | Client info has changed, call the callbacks               |
+            \*---------------------------------------------------------*/
+            ClientInfoChanged();
+        }
+    }
+
+    event_loop_fd = -1;
+    close(epoll_fd);
+
+    LOG_INFO("[NetworkServer] Network event loop closed");
+    server_online = false;
+    server_listening = false;
+    ServerListeningChanged();
+#endif
+}
+
+bool NetworkServer::EventLoopReceive(NetworkClientInfo * client_info)
+{
+#ifdef __linux__
+    /*---------------------------------------------------------*\
+    | Read everything currently available on the socket without |
+    | blocking                                                  |
+    \*---------------------------------------------------------*/
+    while(1)
+    {
+        if(client_info->recv_buf.size() - client_info->recv_len < 4096)
+        {
+            client_info->recv_buf.resize(client_info->recv_len + 65536);
+        }
+
+        std::size_t space = client_info->recv_buf.size() - client_info->recv_len;
+        ssize_t     bytes = recv(client_info->client_sock, &client_info->recv_buf[client_info->recv_len], space, MSG_DONTWAIT);
+
+        if(bytes == 0)
+        {
+            LOG_INFO("[NetworkServer] Client %s disconnected", client_info->client_ip.c_str());
+            return(false);
+        }
+        else if(bytes < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            if((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                break;
+            }
+
+            LOG_ERROR("[NetworkServer] recv failed, error code: %d", errno);
+            return(false);
+        }
+
+        client_info->recv_len += bytes;
+
+        if((std::size_t)bytes < space)
+        {
+            break;
+        }
+    }
+
+    /*---------------------------------------------------------*\
+    | Process every complete packet in the buffer               |
+    \*---------------------------------------------------------*/
+    std::size_t parse_pos = 0;
+
+    while(client_info->recv_len - parse_pos >= sizeof(NetPacketHeader))
+    {
+        char * packet = &client_info->recv_buf[parse_pos];
+
+        /*---------------------------------------------------------*\
+        | Skip bytes until the magic "ORGB" is found, logging once  |
+        | per resync                                                |
+        \*---------------------------------------------------------*/
+        if(memcmp(packet, openrgb_sdk_magic, sizeof(openrgb_sdk_magic)) != 0)
+        {
+            if(!client_info->recv_resync)
+            {
+                LOG_ERROR("[NetworkServer] Invalid magic received from %s, resynchronizing", client_info->client_ip.c_str());
+                client_info->recv_resync = true;
+            }
+
+            parse_pos++;
+            continue;
+        }
+
+        client_info->recv_resync = false;
+
+        NetPacketHeader header;
+
+        memcpy(&header, packet, sizeof(NetPacketHeader));
+
+        if(client_info->recv_len - parse_pos - sizeof(NetPacketHeader) < header.pkt_size)
+        {
+            break;
+        }
+
+        char * data = NULL;
+
+        if(header.pkt_size > 0)
+        {
+            data = packet + sizeof(NetPacketHeader);
+        }
+
+        parse_pos += sizeof(NetPacketHeader) + header.pkt_size;
+
+        if(!ProcessPacket(client_info, header, data))
+        {
+            return(false);
+        }
+    }
+
+    /*---------------------------------------------------------*\
+    | Keep the incomplete remainder at the start of the buffer  |
+    \*---------------------------------------------------------*/
+    if(parse_pos > 0)
+    {
+        memmove(&client_info->recv_buf[0], &client_info->recv_buf[parse_pos], client_info->recv_len - parse_pos);
+        client_info->recv_len -= parse_pos;
+    }
+
+    return(true);
+#else
+    return(false);
+#endif
+}
+
+bool NetworkServer::EventLoopFlush(NetworkClientInfo * client_info)
+{
+#ifdef __linux__
+    /*---------------------------------------------------------*\
+    | The socket is writable again, write out the queued output |
+    \*---------------------------------------------------------*/
+    std::lock_guard<std::mutex> send_lock(client_info->send_mutex);
+
+    if(client_info->send_failed)
+    {
+        return(false);
+    }
+
+    while(client_info->send_pos < client_info->send_buf.size())
+    {
+        ssize_t bytes = send(client_info->client_sock, &client_info->send_buf[client_info->send_pos], client_info->send_buf.size() - client_info->send_pos, MSG_NOSIGNAL);
+
+        if(bytes < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            if((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                /*-------------------------------------------------*\
+                | Drop the part already written once it is most of  |
+                | the queue so a slow reader does not grow it       |
+                \*-------------------------------------------------*/
+                if(client_info->send_pos > (client_info->send_buf.size() / 2))
+                {
+                    client_info->send_buf.erase(client_info->send_buf.begin(), client_info->send_buf.begin() + client_info->send_pos);
+                    client_info->send_pos = 0;
                 }
+
+                return(true);
+            }
+
+            LOG_ERROR("[NetworkServer] send failed, error code: %d", errno);
+            client_info->send_failed = true;
+            return(false);
+        }
+
+        client_info->send_pos += bytes;
+    }
+
+    client_info->send_buf.clear();
+    client_info->send_pos = 0;
+
+    /*---------------------------------------------------------*\
+    | Queue is empty, stop waiting for the socket to be         |
+    | writable                                                  |
+    \*---------------------------------------------------------*/
+    struct epoll_event event;
+    event.events    = EPOLLIN | EPOLLRDHUP;
+    event.data.fd   = (int)client_info->client_sock;
+
+    epoll_ctl(event_loop_fd, EPOLL_CTL_MOD, (int)client_info->client_sock, &event);
+
+    return(true);
+#else
+    return(false);
+#endif
+}
+
+bool NetworkServer::ProcessPacket(NetworkClientInfo * client_info, NetPacketHeader & header, char * data)
+{
+    /*---------------------------------------------------------*\
+    | Controller updates made while handling the packet are not |
+    | echoed back to the client that sent it                    |
+    \*---------------------------------------------------------*/
+    update_source_client = client_info;
+
+    bool result = DispatchPacket(client_info, header, data);
+
+    update_source_client = nullptr;
+
+    return(result);
+}
+
+bool NetworkServer::DispatchPacket(NetworkClientInfo * client_info, NetPacketHeader & header, char * data)
+{
+    /*---------------------------------------------------------*\
+    | Entire request received, select functionality based on    |
+    | request ID                                                |
+    \*---------------------------------------------------------*/
+    switch(header.pkt_id)
+    {
+        case NET_PACKET_ID_REQUEST_CONTROLLER_COUNT:
+            SendReply_ControllerCount(client_info);
+            break;
+
+        case NET_PACKET_ID_REQUEST_CONTROLLER_DATA:
+            {
+                unsigned int protocol_version = 0;
+
+                if(header.pkt_size == sizeof(unsigned int))
+                {
+                    memcpy(&protocol_version, data, sizeof(unsigned int));
+                }
+
+                /*---------------------------------------------*\
+                | Never describe a controller in a newer format |
+                | than the one negotiated with this client      |
+                \*---------------------------------------------*/
+                protocol_version = std::min(protocol_version, (unsigned int)OPENRGB_SDK_PROTOCOL_VERSION);
+
+                if(client_info->client_protocol_version != 0)
+                {
+                    protocol_version = std::min(protocol_version, client_info->client_protocol_version);
+                }
+
+                SendReply_ControllerData(client_info, header.pkt_dev_idx, protocol_version);
+            }
+            break;
+
+        case NET_PACKET_ID_REQUEST_PROTOCOL_VERSION:
+            SendReply_ProtocolVersion(client_info);
+            ProcessRequest_ClientProtocolVersion(client_info->client_sock, header.pkt_size, data);
+            break;
+
+        case NET_PACKET_ID_SET_CLIENT_NAME:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            ProcessRequest_ClientString(client_info->client_sock, header.pkt_size, data);
+            break;
+
+        case NET_PACKET_ID_REQUEST_CONTROLLER_UPDATES:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            ProcessRequest_ControllerUpdates(client_info, header.pkt_size, data);
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_RESIZEZONE:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            if((header.pkt_dev_idx < controllers.size()) && (header.pkt_size == (2 * sizeof(int))))
+            {
+                int zone;
+                int new_size;
+
+                memcpy(&zone, data, sizeof(int));
+                memcpy(&new_size, data + sizeof(int), sizeof(int));
+
+                controllers[header.pkt_dev_idx]->ResizeZone(zone, new_size);
+                controllers[header.pkt_dev_idx]->SignalUpdateReason(RGBCONTROLLER_UPDATE_REASON_RESIZEZONE);
+                profile_manager->SaveProfile("sizes", true);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_UPDATELEDS:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            /*---------------------------------------------------------*\
+            | Verify the color description size (first 4 bytes of data) |
+            | matches the packet size in the header                     |
+            |                                                           |
+            | If protocol version is 4 or below and the legacy SDK      |
+            | compatibility workaround is enabled, ignore this check.   |
+            | This allows backwards compatibility with old versions of  |
+            | SDK applications that didn't properly implement the size  |
+            | field.                                                    |
+            \*---------------------------------------------------------*/
+            if((header.pkt_size == *((unsigned int*)data))
+            || ((client_info->client_protocol_version <= 4)
+             && (legacy_workaround_enabled)))
+            {
+                if(header.pkt_dev_idx < controllers.size())
+                {
+                    controllers[header.pkt_dev_idx]->SetColorDescription((const unsigned char *)data, header.pkt_size);
+                    controllers[header.pkt_dev_idx]->UpdateLEDs();
+                }
+            }
+            else
+            {
+                LOG_ERROR("[NetworkServer] UpdateLEDs packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, *((unsigned int*)data));
+                return(false);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_UPDATEZONELEDS:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            /*---------------------------------------------------------*\
+            | Verify the color description size (first 4 bytes of data) |
+            | matches the packet size in the header                     |
+            |                                                           |
+            | If protocol version is 4 or below and the legacy SDK      |
+            | compatibility workaround is enabled, ignore this check.   |
+            | This allows backwards compatibility with old versions of  |
+            | SDK applications that didn't properly implement the size  |
+            | field.                                                    |
+            \*---------------------------------------------------------*/
+            if((header.pkt_size == *((unsigned int*)data))
+            || ((client_info->client_protocol_version <= 4)
+             && (legacy_workaround_enabled)))
+            {
+                if(header.pkt_dev_idx < controllers.size())
+                {
+                    int zone;
+
+                    memcpy(&zone, &data[sizeof(unsigned int)], sizeof(int));
+
+                    controllers[header.pkt_dev_idx]->SetZoneColorDescription((unsigned char *)data);
+                    controllers[header.pkt_dev_idx]->UpdateZoneLEDs(zone);
+                }
+            }
+            else
+            {
+                LOG_ERROR("[NetworkServer] UpdateZoneLEDs packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, *((unsigned int*)data));
+                return(false);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_UPDATESINGLELED:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            /*---------------------------------------------------------*\
+            | Verify the single LED color description size (8 bytes)    |
+            | matches the packet size in the header                     |
+            \*---------------------------------------------------------*/
+            if(header.pkt_size == (sizeof(int) + sizeof(RGBColor)))
+            {
+                if(header.pkt_dev_idx < controllers.size())
+                {
+                    int led;
+
+                    memcpy(&led, data, sizeof(int));
+
+                    controllers[header.pkt_dev_idx]->SetSingleLEDColorDescription((unsigned char *)data);
+                    controllers[header.pkt_dev_idx]->UpdateSingleLED(led);
+                }
+            }
+            else
+            {
+                LOG_ERROR("[NetworkServer] UpdateSingleLED packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, (sizeof(int) + sizeof(RGBColor)));
+                return(false);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_UPDATELEDSDELTA:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            /*---------------------------------------------------------*\
+            | Verify the delta description size (first 4 bytes of data) |
+            | matches the packet size in the header                     |
+            \*---------------------------------------------------------*/
+            if(header.pkt_size == *((unsigned int*)data))
+            {
+                if(header.pkt_dev_idx < controllers.size())
+                {
+                    if(controllers[header.pkt_dev_idx]->SetColorDeltaDescription((const unsigned char *)data, header.pkt_size))
+                    {
+                        controllers[header.pkt_dev_idx]->UpdateLEDs();
+                    }
+                    else
+                    {
+                        LOG_WARNING("[NetworkServer] UpdateLEDsDelta packet does not match controller %d, ignoring", header.pkt_dev_idx);
+                    }
+                }
+            }
+            else
+            {
+                LOG_ERROR("[NetworkServer] UpdateLEDsDelta packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, *((unsigned int*)data));
+                return(false);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_UPDATEALLLEDS:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            if(!ProcessRequest_RGBController_UpdateAllLEDs(header.pkt_size, data))
+            {
+                return(false);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_SETCUSTOMMODE:
+            if(header.pkt_dev_idx < controllers.size())
+            {
+                controllers[header.pkt_dev_idx]->SetCustomMode();
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_UPDATEMODE:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            /*---------------------------------------------------------*\
+            | Verify the mode description size (first 4 bytes of data)  |
+            | matches the packet size in the header                     |
+            |                                                           |
+            | If protocol version is 4 or below and the legacy SDK      |
+            | compatibility workaround is enabled, ignore this check.   |
+            | This allows backwards compatibility with old versions of  |
+            | SDK applications that didn't properly implement the size  |
+            | field.                                                    |
+            \*---------------------------------------------------------*/
+            if((header.pkt_size == *((unsigned int*)data))
+            || ((client_info->client_protocol_version <= 4)
+             && (legacy_workaround_enabled)))
+            {
+                if(header.pkt_dev_idx < controllers.size())
+                {
+                    controllers[header.pkt_dev_idx]->SetModeDescription((unsigned char *)data, client_info->client_protocol_version);
+                    controllers[header.pkt_dev_idx]->UpdateMode();
+                }
+            }
+            else
+            {
+                LOG_ERROR("[NetworkServer] UpdateMode packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, *((unsigned int*)data));
+                return(false);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_SAVEMODE:
+            if(data == NULL)
+            {
                 break;
+            }
 
-            case NET_PACKET_ID_RGBCONTROLLER_SETCUSTOMMODE:
+            /*---------------------------------------------------------*\
+            | Verify the mode description size (first 4 bytes of data)  |
+            | matches the packet size in the header                     |
+            |                                                           |
+            | If protocol version is 4 or below and the legacy SDK      |
+            | compatibility workaround is enabled, ignore this check.   |
+            | This allows backwards compatibility with old versions of  |
+            | SDK applications that didn't properly implement the size  |
+            | field.                                                    |
+            \*---------------------------------------------------------*/
+            if((header.pkt_size == *((unsigned int*)data))
+            || ((client_info->client_protocol_version <= 4)
+             && (legacy_workaround_enabled)))
+            {
                 if(header.pkt_dev_idx < controllers.size())
                 {
-                    controllers[header.pkt_dev_idx]->SetCustomMode();
+                    controllers[header.pkt_dev_idx]->SetModeDescription((unsigned char *)data, client_info->client_protocol_version);
+                    controllers[header.pkt_dev_idx]->SaveMode();
                 }
+            }
+            break;
+
+        case NET_PACKET_ID_REQUEST_SHARED_MEMORY:
+            SendReply_SharedMemory(client_info, header.pkt_dev_idx);
+            break;
+
+        case NET_PACKET_ID_REQUEST_PROFILE_LIST:
+            SendReply_ProfileList(client_info);
+            break;
+
+        case NET_PACKET_ID_REQUEST_SAVE_PROFILE:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            if(profile_manager)
+            {
+                std::string profile_name;
+                profile_name.assign(data, header.pkt_size);
+
+                profile_manager->SaveProfile(profile_name);
+            }
+
+            break;
+
+        case NET_PACKET_ID_REQUEST_LOAD_PROFILE:
+            if(data == NULL)
+            {
+                break;
+            }
+
+            if(profile_manager)
+            {
+                std::string profile_name;
+                profile_name.assign(data, header.pkt_size);
+
+                profile_manager->LoadProfile(profile_name);
+            }
+
+            for(RGBController* controller : controllers)
+            {
+                controller->UpdateLEDs();
+            }
+
+            break;
+
+        case NET_PACKET_ID_REQUEST_DELETE_PROFILE:
+            if(data == NULL)
+            {
                 break;
+            }
+
+            if(profile_manager)
+            {
+                std::string profile_name;
+                profile_name.assign(data, header.pkt_size);
+
+                profile_manager->DeleteProfile(profile_name);
+            }
 
-            case NET_PACKET_ID_RGBCONTROLLER_UPDATEMODE:
-                if(data == NULL)
+            break;
+
+        case NET_PACKET_ID_REQUEST_PLUGIN_LIST:
+            SendReply_PluginList(client_info);
+            break;
+
+        case NET_PACKET_ID_PLUGIN_SPECIFIC:
+            {
+                unsigned int plugin_pkt_type = *((unsigned int*)(data));
+                unsigned int plugin_pkt_size = header.pkt_size - (sizeof(unsigned int));
+                unsigned char* plugin_data = (unsigned char*)(data + sizeof(unsigned int));
+
+                if(header.pkt_dev_idx < plugins.size())
                 {
-                    break;
+                    NetworkPlugin plugin = plugins[header.pkt_dev_idx];
+                    unsigned char* output = plugin.callback(plugin.callback_arg, plugin_pkt_type, plugin_data, &plugin_pkt_size);
+                    if(output != nullptr)
+                    {
+                        SendReply_PluginSpecific(client_info, plugin_pkt_type, output, plugin_pkt_size);
+                    }
                 }
+                break;
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_CLEARSEGMENTS:
+            if(data == NULL)
+            {
+                break;
+            }
 
+            if((header.pkt_dev_idx < controllers.size()) && (header.pkt_size == sizeof(int)))
+            {
+                int zone;
+
+                memcpy(&zone, data, sizeof(int));
+
+                controllers[header.pkt_dev_idx]->ClearSegments(zone);
+                profile_manager->SaveProfile("sizes", true);
+            }
+            break;
+
+        case NET_PACKET_ID_RGBCONTROLLER_ADDSEGMENT:
+            {
                 /*---------------------------------------------------------*\
-                | Verify the mode description size (first 4 bytes of data)  |
-                | matches the packet size in the header                     |
-                |                                                           |
-                | If protocol version is 4 or below and the legacy SDK      |
-                | compatibility workaround is enabled, ignore this check.   |
-                | This allows backwards compatibility with old versions of  |
-                | SDK applications that didn't properly implement the size  |
-                | field.                                                    |
+                | Verify the segment description size (first 4 bytes of     |
+                | data) matches the packet size in the header               |
                 \*---------------------------------------------------------*/
-                if((header.pkt_size == *((unsigned int*)data))
-                || ((client_info->client_protocol_version <= 4)
-                 && (legacy_workaround_enabled)))
+                if(header.pkt_size == *((unsigned int*)data))
                 {
                     if(header.pkt_dev_idx < controllers.size())
                     {
-                        controllers[header.pkt_dev_idx]->SetModeDescription((unsigned char *)data, client_info->client_protocol_version);
-                        controllers[header.pkt_dev_idx]->UpdateMode();
+                        controllers[header.pkt_dev_idx]->SetSegmentDescription((unsigned char *)data);
+                        profile_manager->SaveProfile("sizes", true);
                     }
                 }
-                else
-                {
-                    LOG_ERROR("[NetworkServer] UpdateMode packet has invalid size. Packet size: %d, Data size: %d", header.pkt_size, *((unsigned int*)data));
-                    goto listen_done;
-                }
+            }
+            break;
+    }
+
+    return(true);
+}
+
+void NetworkServer::ProcessRequest_ClientProtocolVersion(SOCKET client_sock, unsigned int data_size, char * data)
+{
+    unsigned int protocol_version = 0;
+
+    if(data_size == sizeof(unsigned int) && (data != NULL))
+    {
+        memcpy(&protocol_version, data, sizeof(unsigned int));
+    }
+
+    if(protocol_version > OPENRGB_SDK_PROTOCOL_VERSION)
+    {
+        protocol_version = OPENRGB_SDK_PROTOCOL_VERSION;
+    }
+
+    ServerClientsMutex.lock();
+    for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
+    {
+        if(ServerClients[this_idx]->client_sock == client_sock)
+        {
+            ServerClients[this_idx]->client_protocol_version = protocol_version;
+            break;
+        }
+    }
+    ServerClientsMutex.unlock();
+
+    /*---------------------------------------------------------*\
+    | Client info has changed, call the callbacks               |
+    \*---------------------------------------------------------*/
+    ClientInfoChanged();
+}
+
+void NetworkServer::ProcessRequest_ClientString(SOCKET client_sock, unsigned int data_size, char * data)
+{
+    ServerClientsMutex.lock();
+    for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
+    {
+        if(ServerClients[this_idx]->client_sock == client_sock)
+        {
+            ServerClients[this_idx]->client_string.assign(data, data_size);
+            break;
+        }
+    }
+    ServerClientsMutex.unlock();
+
+    /*---------------------------------------------------------*\
+    | Client info has changed, call the callbacks               |
+    \*---------------------------------------------------------*/
+    ClientInfoChanged();
+}
+
+/*---------------------------------------------------------*\
+| UpdateAllLEDs carries the color descriptions of several   |
+| controllers in one packet:                                |
+|                                                           |
+|   unsigned int    data_size                               |
+|   unsigned short  num_controllers                         |
+|   num_controllers * {                                     |
+|       unsigned int    dev_idx                             |
+|       Color Description (data_size, num_colors, colors)   |
+|   }                                                       |
+|                                                           |
+| The whole packet is validated before any controller is    |
+| touched.  All colors are then applied before the first    |
+| UpdateLEDs() call so that every device receives its frame |
+| in the same pass.                                         |
+\*---------------------------------------------------------*/
+bool NetworkServer::ProcessRequest_RGBController_UpdateAllLEDs(unsigned int data_size, char * data)
+{
+    const unsigned int header_size  = sizeof(unsigned int) + sizeof(unsigned short);
+    const unsigned int entry_size   = sizeof(unsigned int) + sizeof(unsigned int) + sizeof(unsigned short);
+
+    unsigned int    packet_data_size;
+    unsigned short  num_controllers;
+
+    if(data_size < header_size)
+    {
+        LOG_ERROR("[NetworkServer] UpdateAllLEDs packet is too small. Packet size: %d", data_size);
+        return(false);
+    }
+
+    memcpy(&packet_data_size, &data[0], sizeof(packet_data_size));
+    memcpy(&num_controllers, &data[sizeof(unsigned int)], sizeof(num_controllers));
+
+    if(packet_data_size != data_size)
+    {
+        LOG_ERROR("[NetworkServer] UpdateAllLEDs packet has invalid size. Packet size: %d, Data size: %d", data_size, packet_data_size);
+        return(false);
+    }
+
+    /*---------------------------------------------------------*\
+    | Walk the packet once to validate every entry and record   |
+    | where each color description starts                       |
+    \*---------------------------------------------------------*/
+    std::vector<unsigned int>   entry_dev_idx(num_controllers);
+    std::vector<unsigned int>   entry_offset(num_controllers);
+    std::vector<unsigned int>   entry_size_list(num_controllers);
+    unsigned int                data_ptr = header_size;
+
+    for(unsigned int entry_idx = 0; entry_idx < num_controllers; entry_idx++)
+    {
+        unsigned int    color_size;
+        unsigned short  num_colors;
+
+        if((data_size - data_ptr) < entry_size)
+        {
+            LOG_ERROR("[NetworkServer] UpdateAllLEDs packet is truncated at entry %d", entry_idx);
+            return(false);
+        }
+
+        memcpy(&entry_dev_idx[entry_idx], &data[data_ptr], sizeof(unsigned int));
+        data_ptr += sizeof(unsigned int);
+
+        memcpy(&color_size, &data[data_ptr], sizeof(unsigned int));
+        memcpy(&num_colors, &data[data_ptr + sizeof(unsigned int)], sizeof(unsigned short));
+
+        if((color_size > (data_size - data_ptr))
+        || (color_size != (sizeof(unsigned int) + sizeof(unsigned short) + (num_colors * sizeof(RGBColor)))))
+        {
+            LOG_ERROR("[NetworkServer] UpdateAllLEDs entry %d has invalid size. Data size: %d", entry_idx, color_size);
+            return(false);
+        }
+
+        entry_offset[entry_idx]    = data_ptr;
+        entry_size_list[entry_idx] = color_size;
+        data_ptr += color_size;
+    }
+
+    if(data_ptr != data_size)
+    {
+        LOG_ERROR("[NetworkServer] UpdateAllLEDs packet has %d trailing bytes", data_size - data_ptr);
+        return(false);
+    }
+
+    /*---------------------------------------------------------*\
+    | Apply all color buffers, then trigger the updates         |
+    \*---------------------------------------------------------*/
+    for(unsigned int entry_idx = 0; entry_idx < num_controllers; entry_idx++)
+    {
+        if(entry_dev_idx[entry_idx] < controllers.size())
+        {
+            controllers[entry_dev_idx[entry_idx]]->SetColorDescription((const unsigned char *)&data[entry_offset[entry_idx]], entry_size_list[entry_idx]);
+        }
+    }
+
+    for(unsigned int entry_idx = 0; entry_idx < num_controllers; entry_idx++)
+    {
+        if(entry_dev_idx[entry_idx] < controllers.size())
+        {
+            controllers[entry_dev_idx[entry_idx]]->UpdateLEDs();
+        }
+    }
+
+    return(true);
+}
+
+void NetworkServer::ProcessRequest_ControllerUpdates(NetworkClientInfo * client_info, unsigned int data_size, char * data)
+{
+    unsigned int update_subscription;
+
+    if(data_size != sizeof(update_subscription))
+    {
+        return;
+    }
+
+    memcpy(&update_subscription, data, sizeof(update_subscription));
+
+    std::lock_guard<std::mutex> subscribers_lock(UpdateSubscribersMutex);
+    std::lock_guard<std::mutex> pending_lock(UpdatePendingMutex);
+
+    std::vector<NetworkClientInfo *>::iterator subscriber_it = std::find(UpdateSubscribers.begin(), UpdateSubscribers.end(), client_info);
+
+    client_info->update_subscription = update_subscription;
+
+    if(update_subscription == 0)
+    {
+        client_info->pending_updates.clear();
+
+        if(subscriber_it != UpdateSubscribers.end())
+        {
+            UpdateSubscribers.erase(subscriber_it);
+        }
+    }
+    else if(subscriber_it == UpdateSubscribers.end())
+    {
+        UpdateSubscribers.push_back(client_info);
+    }
+}
+
+/*---------------------------------------------------------*\
+| Write one packet to a client.  send_mutex is only held    |
+| for the writes so replies and update notifications never  |
+| interleave on the socket.                                 |
+\*---------------------------------------------------------*/
+void NetworkServer::SendPacket(NetworkClientInfo * client_info, NetPacketHeader * header, const char * data, unsigned int data_size)
+{
+    std::lock_guard<std::mutex> send_lock(client_info->send_mutex);
+
+    if(client_info->send_failed)
+    {
+        return;
+    }
+
+    if(WriteClient(client_info, (const char *)header, sizeof(NetPacketHeader), (data_size > 0) ? MSG_MORE : 0) && (data_size > 0))
+    {
+        WriteClient(client_info, data, data_size, 0);
+    }
+}
+
+/*---------------------------------------------------------*\
+| Called with send_mutex held.  Blocking sockets are        |
+| written directly.  Non-blocking sockets are written until |
+| they would block, the rest is queued for the event loop.  |
+| A client that lets its queue grow past                    |
+| CLIENT_SEND_QUEUE_MAX is disconnected.                    |
+\*---------------------------------------------------------*/
+bool NetworkServer::WriteClient(NetworkClientInfo * client_info, const char * data, std::size_t size, int flags)
+{
+    if(!client_info->send_nonblocking)
+    {
+        while(size > 0)
+        {
+            int bytes = send(client_info->client_sock, data, (int)size, flags);
+
+            if(bytes <= 0)
+            {
+                return(false);
+            }
+
+            data += bytes;
+            size -= bytes;
+        }
+
+        return(true);
+    }
+
+#ifdef __linux__
+    bool queue_empty = (client_info->send_pos == client_info->send_buf.size());
+
+    /*---------------------------------------------------------*\
+    | Anything already queued must go out first                 |
+    \*---------------------------------------------------------*/
+    while(queue_empty && (size > 0))
+    {
+        ssize_t bytes = send(client_info->client_sock, data, size, flags | MSG_NOSIGNAL);
+
+        if(bytes < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            if((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
                 break;
+            }
+
+            client_info->send_failed = true;
+            return(false);
+        }
+
+        data += bytes;
+        size -= bytes;
+    }
+
+    if(size == 0)
+    {
+        return(true);
+    }
+
+    if((client_info->send_buf.size() - client_info->send_pos + size) > CLIENT_SEND_QUEUE_MAX)
+    {
+        LOG_WARNING("[NetworkServer] Client %s is not reading its replies, closing connection", client_info->client_ip.c_str());
+
+        /*-----------------------------------------------------*\
+        | The event loop sees the hangup and removes the client |
+        \*-----------------------------------------------------*/
+        client_info->send_failed = true;
+        shutdown(client_info->client_sock, SHUT_RDWR);
+        return(false);
+    }
+
+    client_info->send_buf.insert(client_info->send_buf.end(), data, data + size);
+
+    if(queue_empty)
+    {
+        struct epoll_event event;
+        event.events    = EPOLLIN | EPOLLRDHUP | EPOLLOUT;
+        event.data.fd   = (int)client_info->client_sock;
+
+        epoll_ctl(event_loop_fd, EPOLL_CTL_MOD, (int)client_info->client_sock, &event);
+    }
+
+    return(true);
+#else
+    return(false);
+#endif
+}
+
+void NetworkServer::SendReply_ControllerCount(NetworkClientInfo * client_info)
+{
+    NetPacketHeader reply_hdr;
+    unsigned int    reply_data;
+
+    InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_REQUEST_CONTROLLER_COUNT, sizeof(unsigned int));
+
+    reply_data = (unsigned int)controllers.size();
+
+    SendPacket(client_info, &reply_hdr, (const char *)&reply_data, sizeof(unsigned int));
+}
+
+void NetworkServer::SendReply_ControllerData(NetworkClientInfo * client_info, unsigned int dev_idx, unsigned int protocol_version)
+{
+    if(dev_idx < controllers.size())
+    {
+        /*-----------------------------------------------------*\
+        | Reuse one reply buffer per thread so a reconnecting   |
+        | client does not allocate a description per device     |
+        \*-----------------------------------------------------*/
+        static thread_local std::vector<unsigned char> reply_data;
 
-            case NET_PACKET_ID_RGBCONTROLLER_SAVEMODE:
-                if(data == NULL)
-                {
-                    break;
-                }
+        NetPacketHeader reply_hdr;
 
-                /*---------------------------------------------------------*\
-                | Verify the mode description size (first 4 bytes of data)  |
-                | matches the packet size in the header                     |
-                |                                                           |
-                | If protocol version is 4 or below and the legacy SDK      |
-                | compatibility workaround is enabled, ignore this check.   |
-                | This allows backwards compatibility with old versions of  |
-                | SDK applications that didn't properly implement the size  |
-                | field.                                                    |
-                \*---------------------------------------------------------*/
-                if((header.pkt_size == *((unsigned int*)data))
-                || ((client_info->client_protocol_version <= 4)
-                 && (legacy_workaround_enabled)))
-                {
-                    if(header.pkt_dev_idx < controllers.size())
-                    {
-                        controllers[header.pkt_dev_idx]->SetModeDescription((unsigned char *)data, client_info->client_protocol_version);
-                        controllers[header.pkt_dev_idx]->SaveMode();
-                    }
-                }
-                break;
+        if(controllers[dev_idx]->GetCachedDeviceDescription(protocol_version, reply_data))
+        {
+            description_cache_hits++;
+        }
+        else
+        {
+            description_cache_misses++;
+        }
 
-            case NET_PACKET_ID_REQUEST_PROFILE_LIST:
-                SendReply_ProfileList(client_sock);
-                break;
+        unsigned int reply_size = (unsigned int)reply_data.size();
 
-            case NET_PACKET_ID_REQUEST_SAVE_PROFILE:
-                if(data == NULL)
-                {
-                    break;
-                }
+        InitNetPacketHeader(&reply_hdr, dev_idx, NET_PACKET_ID_REQUEST_CONTROLLER_DATA, reply_size);
 
-                if(profile_manager)
-                {
-                    std::string profile_name;
-                    profile_name.assign(data, header.pkt_size);
+        SendPacket(client_info, &reply_hdr, (const char *)reply_data.data(), reply_size);
+    }
+}
 
-                    profile_manager->SaveProfile(profile_name);
-                }
+void NetworkServer::SendReply_ProtocolVersion(NetworkClientInfo * client_info)
+{
+    NetPacketHeader reply_hdr;
+    unsigned int    reply_data;
 
-                break;
+    InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_REQUEST_PROTOCOL_VERSION, sizeof(unsigned int));
 
-            case NET_PACKET_ID_REQUEST_LOAD_PROFILE:
-                if(data == NULL)
-                {
-                    break;
-                }
+    reply_data = OPENRGB_SDK_PROTOCOL_VERSION;
 
-                if(profile_manager)
-                {
-                    std::string profile_name;
-                    profile_name.assign(data, header.pkt_size);
+    SendPacket(client_info, &reply_hdr, (const char *)&reply_data, sizeof(unsigned int));
+}
 
-                    profile_manager->LoadProfile(profile_name);
-                }
+static bool IsLoopbackAddress(const std::string& ip)
+{
+    return((ip.compare(0, 4, "127.") == 0)
+        || (ip == "::1")
+        || (ip.compare(0, 11, "::ffff:127.") == 0));
+}
 
-                for(RGBController* controller : controllers)
-                {
-                    controller->UpdateLEDs();
-                }
+/*---------------------------------------------------------*\
+| Reply to a shared memory request with the name of a color |
+| ring the client can map:                                  |
+|                                                           |
+|   unsigned int    data_size                               |
+|   unsigned int    num_colors  (0 if refused)              |
+|   unsigned short  name_len                                |
+|   char            name[name_len]                          |
+|                                                           |
+| Rings are only offered to clients on the loopback         |
+| interface and live until the client disconnects.          |
+\*---------------------------------------------------------*/
+void NetworkServer::SendReply_SharedMemory(NetworkClientInfo * client_info, unsigned int dev_idx)
+{
+    NetworkSharedColorRing *    ring        = NULL;
+    unsigned int                num_colors  = 0;
 
+    if(shared_memory_enabled && IsLoopbackAddress(client_info->client_ip) && (dev_idx < controllers.size()))
+    {
+        for(std::size_t ring_idx = 0; ring_idx < client_info->shared_rings.size(); ring_idx++)
+        {
+            if(client_info->shared_ring_dev_idx[ring_idx] == dev_idx)
+            {
+                ring = client_info->shared_rings[ring_idx];
                 break;
+            }
+        }
 
-            case NET_PACKET_ID_REQUEST_DELETE_PROFILE:
-                if(data == NULL)
-                {
-                    break;
-                }
+        if(ring == NULL)
+        {
+            ring = new NetworkSharedColorRing();
 
-                if(profile_manager)
-                {
-                    std::string profile_name;
-                    profile_name.assign(data, header.pkt_size);
+            if(ring->Create((unsigned int)controllers[dev_idx]->colors.size(), shared_memory_mode))
+            {
+                client_info->shared_rings.push_back(ring);
+                client_info->shared_ring_dev_idx.push_back(dev_idx);
+                client_info->shared_ring_threads.push_back(new std::thread(&NetworkServer::SharedMemoryThreadFunction, this, client_info, ring, dev_idx));
 
-                    profile_manager->DeleteProfile(profile_name);
-                }
+                LOG_INFO("[NetworkServer] Created shared memory color ring %s for controller %d", ring->GetName().c_str(), dev_idx);
+            }
+            else
+            {
+                delete ring;
+                ring = NULL;
+            }
+        }
+    }
 
-                break;
+    std::string     ring_name;
 
-            case NET_PACKET_ID_REQUEST_PLUGIN_LIST:
-                SendReply_PluginList(client_sock);
-                break;
+    if(ring != NULL)
+    {
+        ring_name   = ring->GetName();
+        num_colors  = ring->GetNumColors();
+    }
 
-            case NET_PACKET_ID_PLUGIN_SPECIFIC:
-                {
-                    unsigned int plugin_pkt_type = *((unsigned int*)(data));
-                    unsigned int plugin_pkt_size = header.pkt_size - (sizeof(unsigned int));
-                    unsigned char* plugin_data = (unsigned char*)(data + sizeof(unsigned int));
+    NetPacketHeader reply_hdr;
+    unsigned short  name_len    = (unsigned short)ring_name.size();
+    unsigned int    data_size   = sizeof(data_size) + sizeof(num_colors) + sizeof(name_len) + name_len;
+    std::vector<char> reply_data(data_size);
 
-                    if(header.pkt_dev_idx < plugins.size())
-                    {
-                        NetworkPlugin plugin = plugins[header.pkt_dev_idx];
-                        unsigned char* output = plugin.callback(plugin.callback_arg, plugin_pkt_type, plugin_data, &plugin_pkt_size);
-                        if(output != nullptr)
-                        {
-                            SendReply_PluginSpecific(client_sock, plugin_pkt_type, output, plugin_pkt_size);
-                        }
-                    }
-                    break;
-                }
-                break;
+    memcpy(&reply_data[0], &data_size, sizeof(data_size));
+    memcpy(&reply_data[sizeof(data_size)], &num_colors, sizeof(num_colors));
+    memcpy(&reply_data[sizeof(data_size) + sizeof(num_colors)], &name_len, sizeof(name_len));
+    memcpy(&reply_data[sizeof(data_size) + sizeof(num_colors) + sizeof(name_len)], ring_name.data(), name_len);
 
-            case NET_PACKET_ID_RGBCONTROLLER_CLEARSEGMENTS:
-                if(data == NULL)
-                {
-                    break;
-                }
+    InitNetPacketHeader(&reply_hdr, dev_idx, NET_PACKET_ID_REQUEST_SHARED_MEMORY, data_size);
 
-                if((header.pkt_dev_idx < controllers.size()) && (header.pkt_size == sizeof(int)))
-                {
-                    int zone;
+    SendPacket(client_info, &reply_hdr, reply_data.data(), data_size);
+}
 
-                    memcpy(&zone, data, sizeof(int));
+void NetworkServer::SharedMemoryThreadFunction(NetworkClientInfo * client_info, NetworkSharedColorRing * ring, unsigned int dev_idx)
+{
+    std::vector<RGBColor>       frame;
+    std::vector<unsigned char>  color_description;
 
-                    controllers[header.pkt_dev_idx]->ClearSegments(zone);
-                    profile_manager->SaveProfile("sizes", true);
-                }
-                break;
+    update_source_client = client_info;
 
-            case NET_PACKET_ID_RGBCONTROLLER_ADDSEGMENT:
-                {
-                    /*---------------------------------------------------------*\
-                    | Verify the segment description size (first 4 bytes of     |
-                    | data) matches the packet size in the header               |
-                    \*---------------------------------------------------------*/
-                    if(header.pkt_size == *((unsigned int*)data))
-                    {
-                        if(header.pkt_dev_idx < controllers.size())
-                        {
-                            controllers[header.pkt_dev_idx]->SetSegmentDescription((unsigned char *)data);
-                            profile_manager->SaveProfile("sizes", true);
-                        }
-                    }
-                }
-                break;
+    while(!ring->IsStopping())
+    {
+        if(!ring->WaitFrame(frame, 100))
+        {
+            continue;
+        }
+
+        /*-----------------------------------------------------*\
+        | Skip the frame if the controller was removed or its   |
+        | number of LEDs changed since the ring was created     |
+        \*-----------------------------------------------------*/
+        if((dev_idx >= controllers.size()) || (controllers[dev_idx]->colors.size() != frame.size()))
+        {
+            continue;
         }
 
-        delete[] data;
+        unsigned int    data_size   = sizeof(unsigned int) + sizeof(unsigned short) + ((unsigned int)frame.size() * sizeof(RGBColor));
+        unsigned short  num_colors  = (unsigned short)frame.size();
+
+        color_description.resize(data_size);
+
+        memcpy(&color_description[0], &data_size, sizeof(data_size));
+        memcpy(&color_description[sizeof(data_size)], &num_colors, sizeof(num_colors));
+        memcpy(&color_description[sizeof(data_size) + sizeof(num_colors)], frame.data(), num_colors * sizeof(RGBColor));
+
+        controllers[dev_idx]->SetColorDescription(color_description.data(), data_size);
+        controllers[dev_idx]->UpdateLEDs();
     }
 
-listen_done:
+    update_source_client = nullptr;
+}
 
-    ServerClientsMutex.lock();
+void NetworkServer::RegisterControllerCallbacks()
+{
+    for(std::size_t controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
+    {
+        controllers[controller_idx]->UnregisterUpdateReasonCallback(this);
+        controllers[controller_idx]->RegisterUpdateReasonCallback(ControllerUpdateReasonCallback, this);
+    }
+}
 
-    for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
+void NetworkServer::UnregisterControllerCallbacks()
+{
+    for(std::size_t controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
     {
-        if(ServerClients[this_idx] == client_info)
-        {
-            delete client_info;
-            ServerClients.erase(ServerClients.begin() + this_idx);
-            break;
-        }
+        controllers[controller_idx]->UnregisterUpdateReasonCallback(this);
     }
+}
 
-    client_info = nullptr;
+void NetworkServer::RemoveUpdateSubscriber(NetworkClientInfo * client_info)
+{
+    std::unique_lock<std::mutex> subscribers_lock(UpdateSubscribersMutex);
 
-    ServerClientsMutex.unlock();
+    {
+        std::lock_guard<std::mutex> pending_lock(UpdatePendingMutex);
+
+        std::vector<NetworkClientInfo *>::iterator subscriber_it = std::find(UpdateSubscribers.begin(), UpdateSubscribers.end(), client_info);
+
+        if(subscriber_it != UpdateSubscribers.end())
+        {
+            UpdateSubscribers.erase(subscriber_it);
+        }
+    }
 
     /*---------------------------------------------------------*\
-    | Client info has changed, call the callbacks               |
+    | The client is about to be deleted, wait until the notify  |
+    | thread has finished sending to it                         |
     \*---------------------------------------------------------*/
-    ClientInfoChanged();
+    UpdateSubscribersCV.wait(subscribers_lock, [client_info]
+    {
+        return(client_info->notify_refs == 0);
+    });
 }
 
-void NetworkServer::ProcessRequest_ClientProtocolVersion(SOCKET client_sock, unsigned int data_size, char * data)
+/*---------------------------------------------------------*\
+| Called from the thread that updated the controller.  Only |
+| records the change; the notify thread sends it.           |
+\*---------------------------------------------------------*/
+void NetworkServer::ControllerUpdated(RGBController * controller, unsigned int update_reason)
 {
-    unsigned int protocol_version = 0;
+    std::lock_guard<std::mutex> pending_lock(UpdatePendingMutex);
 
-    if(data_size == sizeof(unsigned int) && (data != NULL))
+    if(UpdateSubscribers.empty())
     {
-        memcpy(&protocol_version, data, sizeof(unsigned int));
+        return;
     }
 
-    if(protocol_version > OPENRGB_SDK_PROTOCOL_VERSION)
-    {
-        protocol_version = OPENRGB_SDK_PROTOCOL_VERSION;
-    }
+    bool pending = false;
 
-    ServerClientsMutex.lock();
-    for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
+    for(NetworkClientInfo * subscriber : UpdateSubscribers)
     {
-        if(ServerClients[this_idx]->client_sock == client_sock)
+        if((subscriber != update_source_client) && (subscriber->update_subscription & update_reason))
         {
-            ServerClients[this_idx]->client_protocol_version = protocol_version;
-            break;
+            subscriber->pending_updates[controller] |= (subscriber->update_subscription & update_reason);
+            pending = true;
         }
     }
-    ServerClientsMutex.unlock();
 
-    /*---------------------------------------------------------*\
-    | Client info has changed, call the callbacks               |
-    \*---------------------------------------------------------*/
-    ClientInfoChanged();
+    if(pending)
+    {
+        UpdatePendingCV.notify_one();
+    }
 }
 
-void NetworkServer::ProcessRequest_ClientString(SOCKET client_sock, unsigned int data_size, char * data)
+void NetworkServer::UpdateNotifyThreadFunction()
 {
-    ServerClientsMutex.lock();
-    for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
+    typedef std::pair<NetworkClientInfo *, std::map<RGBController *, unsigned int>> ClientUpdates;
+
+    std::vector<ClientUpdates> updates;
+
+    while(update_notify_running.load())
     {
-        if(ServerClients[this_idx]->client_sock == client_sock)
         {
-            ServerClients[this_idx]->client_string.assign(data, data_size);
+            std::unique_lock<std::mutex> pending_lock(UpdatePendingMutex);
+
+            UpdatePendingCV.wait(pending_lock, [this]
+            {
+                if(!update_notify_running.load())
+                {
+                    return(true);
+                }
+
+                for(NetworkClientInfo * subscriber : UpdateSubscribers)
+                {
+                    if(!subscriber->pending_updates.empty())
+                    {
+                        return(true);
+                    }
+                }
+
+                return(false);
+            });
+        }
+
+        if(!update_notify_running.load())
+        {
             break;
         }
-    }
-    ServerClientsMutex.unlock();
 
-    /*---------------------------------------------------------*\
-    | Client info has changed, call the callbacks               |
-    \*---------------------------------------------------------*/
-    ClientInfoChanged();
+        /*-----------------------------------------------------*\
+        | Let a burst of updates (e.g. an effect updating many  |
+        | devices) accumulate so it is sent as one event per    |
+        | controller                                            |
+        \*-----------------------------------------------------*/
+        std::this_thread::sleep_for(10ms);
+
+        /*-----------------------------------------------------*\
+        | Take the pending updates under the locks, then send   |
+        | them without holding either lock                      |
+        \*-----------------------------------------------------*/
+        updates.clear();
+
+        {
+            std::lock_guard<std::mutex> subscribers_lock(UpdateSubscribersMutex);
+            std::lock_guard<std::mutex> pending_lock(UpdatePendingMutex);
+
+            for(NetworkClientInfo * subscriber : UpdateSubscribers)
+            {
+                if(!subscriber->pending_updates.empty())
+                {
+                    updates.push_back(ClientUpdates(subscriber, std::map<RGBController *, unsigned int>()));
+                    updates.back().second.swap(subscriber->pending_updates);
+                    subscriber->notify_refs++;
+                }
+            }
+        }
+
+        for(ClientUpdates& client_updates : updates)
+        {
+            for(std::map<RGBController *, unsigned int>::iterator update_it = client_updates.second.begin(); update_it != client_updates.second.end(); update_it++)
+            {
+                SendRequest_ControllerUpdated(client_updates.first, update_it->first, update_it->second);
+            }
+
+            {
+                std::lock_guard<std::mutex> subscribers_lock(UpdateSubscribersMutex);
+
+                client_updates.first->notify_refs--;
+            }
+
+            UpdateSubscribersCV.notify_all();
+        }
+    }
 }
 
-void NetworkServer::SendReply_ControllerCount(SOCKET client_sock)
+void NetworkServer::SendRequest_DeviceListChanged(NetworkClientInfo * client_info)
 {
-    NetPacketHeader reply_hdr;
-    unsigned int    reply_data;
-
-    InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_REQUEST_CONTROLLER_COUNT, sizeof(unsigned int));
+    NetPacketHeader pkt_hdr;
 
-    reply_data = (unsigned int)controllers.size();
+    InitNetPacketHeader(&pkt_hdr, 0, NET_PACKET_ID_DEVICE_LIST_UPDATED, 0);
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)&reply_data, sizeof(unsigned int), 0);
+    SendPacket(client_info, &pkt_hdr, NULL, 0);
 }
 
-void NetworkServer::SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version)
+/*---------------------------------------------------------*\
+| Controller updated event:                                 |
+|                                                           |
+|   unsigned int    data_size                               |
+|   unsigned int    update_reason                           |
+|   Mode Description    (if RGBCONTROLLER_UPDATE_REASON_    |
+|                        UPDATEMODE is set)                 |
+|   Color Description   (if RGBCONTROLLER_UPDATE_REASON_    |
+|                        UPDATELEDS is set)                 |
+|                                                           |
+| Zone and segment changes carry no data, the client should |
+| request the controller data again.                        |
+\*---------------------------------------------------------*/
+void NetworkServer::SendRequest_ControllerUpdated(NetworkClientInfo * client_info, RGBController * controller, unsigned int update_reason)
 {
-    if(dev_idx < controllers.size())
+    /*---------------------------------------------------------*\
+    | Resolve the index and read the controller under the       |
+    | controllers mutex so it cannot be removed meanwhile.  The |
+    | packet is sent after the mutex is released.               |
+    \*---------------------------------------------------------*/
+    std::unique_lock<std::mutex> controllers_lock;
+
+    if(controllers_mutex != nullptr)
     {
-        NetPacketHeader reply_hdr;
-        unsigned char *reply_data = controllers[dev_idx]->GetDeviceDescription(protocol_version);
-        unsigned int   reply_size;
+        controllers_lock = std::unique_lock<std::mutex>(*controllers_mutex);
+    }
 
-        memcpy(&reply_size, reply_data, sizeof(reply_size));
+    std::vector<RGBController *>::iterator controller_it = std::find(controllers.begin(), controllers.end(), controller);
 
-        InitNetPacketHeader(&reply_hdr, dev_idx, NET_PACKET_ID_REQUEST_CONTROLLER_DATA, reply_size);
+    if(controller_it == controllers.end())
+    {
+        return;
+    }
+
+    unsigned int    dev_idx          = (unsigned int)(controller_it - controllers.begin());
+    unsigned int    protocol_version = client_info->client_protocol_version;
+    unsigned char * mode_data        = NULL;
+    unsigned char * color_data       = NULL;
+    unsigned int    mode_size        = 0;
+    unsigned int    color_size       = 0;
 
-        send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-        send(client_sock, (const char *)reply_data, reply_size, 0);
+    if(protocol_version > OPENRGB_SDK_PROTOCOL_VERSION)
+    {
+        protocol_version = OPENRGB_SDK_PROTOCOL_VERSION;
+    }
 
-        delete[] reply_data;
+    if(update_reason & RGBCONTROLLER_UPDATE_REASON_UPDATEMODE)
+    {
+        int active_mode = controller->active_mode;
+
+        if((active_mode >= 0) && ((std::size_t)active_mode < controller->modes.size()))
+        {
+            mode_data = controller->GetModeDescription(active_mode, protocol_version);
+            memcpy(&mode_size, mode_data, sizeof(mode_size));
+        }
+        else
+        {
+            update_reason &= ~RGBCONTROLLER_UPDATE_REASON_UPDATEMODE;
+        }
     }
-}
 
-void NetworkServer::SendReply_ProtocolVersion(SOCKET client_sock)
-{
-    NetPacketHeader reply_hdr;
-    unsigned int    reply_data;
+    if(update_reason & RGBCONTROLLER_UPDATE_REASON_UPDATELEDS)
+    {
+        color_data = controller->GetColorDescription();
+        memcpy(&color_size, color_data, sizeof(color_size));
+    }
 
-    InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_REQUEST_PROTOCOL_VERSION, sizeof(unsigned int));
+    NetPacketHeader     pkt_hdr;
+    unsigned int        data_size = sizeof(data_size) + sizeof(update_reason) + mode_size + color_size;
+    std::vector<char>   pkt_buf(data_size);
+    char *              pkt_data  = pkt_buf.data();
 
-    reply_data = OPENRGB_SDK_PROTOCOL_VERSION;
+    InitNetPacketHeader(&pkt_hdr, dev_idx, NET_PACKET_ID_CONTROLLER_UPDATED, data_size);
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)&reply_data, sizeof(unsigned int), 0);
-}
+    memcpy(&pkt_data[0], &data_size, sizeof(data_size));
+    memcpy(&pkt_data[sizeof(data_size)], &update_reason, sizeof(update_reason));
 
-void NetworkServer::SendRequest_DeviceListChanged(SOCKET client_sock)
-{
-    NetPacketHeader pkt_hdr;
+    if(mode_data != NULL)
+    {
+        memcpy(&pkt_data[sizeof(data_size) + sizeof(update_reason)], mode_data, mode_size);
+        delete[] mode_data;
+    }
 
-    InitNetPacketHeader(&pkt_hdr, 0, NET_PACKET_ID_DEVICE_LIST_UPDATED, 0);
+    if(color_data != NULL)
+    {
+        memcpy(&pkt_data[sizeof(data_size) + sizeof(update_reason) + mode_size], color_data, color_size);
+        delete[] color_data;
+    }
+
+    if(controllers_lock.owns_lock())
+    {
+        controllers_lock.unlock();
+    }
 
-    send(client_sock, (char *)&pkt_hdr, sizeof(NetPacketHeader), 0);
+    SendPacket(client_info, &pkt_hdr, pkt_buf.data(), data_size);
 }
 
-void NetworkServer::SendReply_ProfileList(SOCKET client_sock)
+void NetworkServer::SendReply_ProfileList(NetworkClientInfo * client_info)
 {
     if(!profile_manager)
     {
@@ -1115,11 +2437,10 @@ void NetworkServer::SendReply_ProfileList(SOCKET client_sock)
 
     InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_REQUEST_PROFILE_LIST, reply_size);
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)reply_data, reply_size, 0);
+    SendPacket(client_info, &reply_hdr, (const char *)reply_data, reply_size);
 }
 
-void NetworkServer::SendReply_PluginList(SOCKET client_sock)
+void NetworkServer::SendReply_PluginList(NetworkClientInfo * client_info)
 {
     unsigned int data_size = 0;
     unsigned int data_ptr = 0;
@@ -1213,21 +2534,22 @@ void NetworkServer::SendReply_PluginList(SOCKET client_sock)
 
     InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_REQUEST_PLUGIN_LIST, reply_size);
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)data_buf, reply_size, 0);
+    SendPacket(client_info, &reply_hdr, (const char *)data_buf, reply_size);
 
     delete [] data_buf;
 }
 
-void NetworkServer::SendReply_PluginSpecific(SOCKET client_sock, unsigned int pkt_type, unsigned char* data, unsigned int data_size)
+void NetworkServer::SendReply_PluginSpecific(NetworkClientInfo * client_info, unsigned int pkt_type, unsigned char* data, unsigned int data_size)
 {
-    NetPacketHeader reply_hdr;
+    NetPacketHeader     reply_hdr;
+    std::vector<char>   reply_data(sizeof(pkt_type) + data_size);
 
     InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_PLUGIN_SPECIFIC, data_size + sizeof(pkt_type));
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)&pkt_type, sizeof(pkt_type), 0);
-    send(client_sock, (const char *)data, data_size, 0);
+    memcpy(&reply_data[0], &pkt_type, sizeof(pkt_type));
+    memcpy(&reply_data[sizeof(pkt_type)], data, data_size);
+
+    SendPacket(client_info, &reply_hdr, reply_data.data(), (unsigned int)reply_data.size());
     delete [] data;
 }
 
@@ -11,17 +11,26 @@
 
 #pragma once
 
+#include <map>
 #include <mutex>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
 #include "RGBController.h"
 #include "NetworkProtocol.h"
+#include "NetworkSharedMemory.h"
 #include "net_port.h"
 #include "ProfileManager.h"
 
 #define MAXSOCK 32
 #define TCP_TIMEOUT_SECONDS 5
 
+/*---------------------------------------------------------*\
+| Output the event loop queues for one client before it is  |
+| considered stuck and disconnected                         |
+\*---------------------------------------------------------*/
+#define CLIENT_SEND_QUEUE_MAX   (16 * 1024 * 1024)
+
 typedef void (*NetServerCallback)(void *);
 typedef unsigned char* (*NetPluginCallback)(void *, unsigned int, unsigned char*, unsigned int*);
 
@@ -46,6 +55,51 @@ public:
     std::string     client_string;
     unsigned int    client_protocol_version;
     std::string     client_ip;
+
+    /*---------------------------------------------------------*\
+    | Reusable receive buffer for packet data                   |
+    \*---------------------------------------------------------*/
+    std::vector<char>   recv_buf;
+    std::size_t         recv_len;
+    bool                recv_resync;
+
+    /*---------------------------------------------------------*\
+    | Output a non-blocking socket has not accepted yet, from   |
+    | send_pos onwards.  The event loop writes it out when the  |
+    | socket becomes writable.  Protected by send_mutex.        |
+    \*---------------------------------------------------------*/
+    bool                send_nonblocking;
+    bool                send_failed;
+    std::vector<char>   send_buf;
+    std::size_t         send_pos;
+
+    /*---------------------------------------------------------*\
+    | Shared memory color rings created for this client and     |
+    | the threads flushing them, indexed together               |
+    \*---------------------------------------------------------*/
+    std::vector<NetworkSharedColorRing *>   shared_rings;
+    std::vector<std::thread *>              shared_ring_threads;
+    std::vector<unsigned int>               shared_ring_dev_idx;
+
+    /*---------------------------------------------------------*\
+    | Controller update subscription.  Pending updates are      |
+    | merged per controller until the notify thread sends them. |
+    | They are keyed by controller rather than index as the     |
+    | list may change before they are sent.                     |
+    \*---------------------------------------------------------*/
+    unsigned int                            update_subscription;
+    std::map<RGBController *, unsigned int> pending_updates;
+
+    /*---------------------------------------------------------*\
+    | Notify thread sends in progress for this client,          |
+    | protected by the server's UpdateSubscribersMutex          |
+    \*---------------------------------------------------------*/
+    unsigned int                            notify_refs;
+
+    /*---------------------------------------------------------*\
+    | Serializes replies and update notifications on the socket |
+    \*---------------------------------------------------------*/
+    std::mutex                              send_mutex;
 };
 
 class NetworkServer
@@ -62,6 +116,7 @@ public:
     const char *                        GetClientString(unsigned int client_num);
     const char *                        GetClientIP(unsigned int client_num);
     unsigned int                        GetClientProtocolVersion(unsigned int client_num);
+    void                                GetDescriptionCacheStats(unsigned long long * hits, unsigned long long * misses);
 
     void                                ClientInfoChanged();
     void                                DeviceListChanged();
@@ -70,8 +125,12 @@ public:
     void                                ServerListeningChanged();
     void                                RegisterServerListeningChangeCallback(NetServerCallback, void * new_callback_arg);
 
+    void                                SetControllersMutex(std::mutex * mutex);
     void                                SetHost(std::string host);
+    void                                SetEventLoopEnable(bool enable);
     void                                SetLegacyWorkaroundEnable(bool enable);
+    void                                SetSharedMemoryEnable(bool enable);
+    void                                SetSharedMemoryMode(unsigned int mode);
     void                                SetPort(unsigned short new_port);
 
     void                                StartServer();
@@ -79,18 +138,29 @@ public:
 
     void                                ConnectionThreadFunction(int socket_idx);
     void                                ListenThreadFunction(NetworkClientInfo * client_sock);
+    void                                EventLoopThreadFunction();
+    void                                SharedMemoryThreadFunction(NetworkClientInfo * client_info, NetworkSharedColorRing * ring, unsigned int dev_idx);
+    void                                UpdateNotifyThreadFunction();
+
+    void                                ControllerUpdated(RGBController * controller, unsigned int update_reason);
+
+    bool                                ProcessPacket(NetworkClientInfo * client_info, NetPacketHeader & header, char * data);
 
     void                                ProcessRequest_ClientProtocolVersion(SOCKET client_sock, unsigned int data_size, char * data);
     void                                ProcessRequest_ClientString(SOCKET client_sock, unsigned int data_size, char * data);
+    void                                ProcessRequest_ControllerUpdates(NetworkClientInfo * client_info, unsigned int data_size, char * data);
+    bool                                ProcessRequest_RGBController_UpdateAllLEDs(unsigned int data_size, char * data);
 
-    void                                SendReply_ControllerCount(SOCKET client_sock);
-    void                                SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version);
-    void                                SendReply_ProtocolVersion(SOCKET client_sock);
+    void                                SendReply_ControllerCount(NetworkClientInfo * client_info);
+    void                                SendReply_ControllerData(NetworkClientInfo * client_info, unsigned int dev_idx, unsigned int protocol_version);
+    void                                SendReply_ProtocolVersion(NetworkClientInfo * client_info);
+    void                                SendReply_SharedMemory(NetworkClientInfo * client_info, unsigned int dev_idx);
 
-    void                                SendRequest_DeviceListChanged(SOCKET client_sock);
-    void                                SendReply_ProfileList(SOCKET client_sock);
-    void                                SendReply_PluginList(SOCKET client_sock);
-    void                                SendReply_PluginSpecific(SOCKET client_sock, unsigned int pkt_type, unsigned char* data, unsigned int data_size);
+    void                                SendRequest_DeviceListChanged(NetworkClientInfo * client_info);
+    void                                SendRequest_ControllerUpdated(NetworkClientInfo * client_info, RGBController * controller, unsigned int update_reason);
+    void                                SendReply_ProfileList(NetworkClientInfo * client_info);
+    void                                SendReply_PluginList(NetworkClientInfo * client_info);
+    void                                SendReply_PluginSpecific(NetworkClientInfo * client_info, unsigned int pkt_type, unsigned char* data, unsigned int data_size);
 
     void                                SetProfileManager(ProfileManagerInterface* profile_manager_pointer);
 
@@ -105,6 +175,11 @@ protected:
 
     std::vector<RGBController *>&       controllers;
 
+    /*---------------------------------------------------------*    | Lock held by the owner while it changes the controllers   |
+    | list, NULL if the list never changes while serving        |
+    \*---------------------------------------------------------*/
+    std::mutex *                        controllers_mutex;
+
     std::mutex                          ServerClientsMutex;
     std::vector<NetworkClientInfo *>    ServerClients;
     std::thread *                       ConnectionThread[MAXSOCK];
@@ -126,9 +201,50 @@ private:
     WSADATA     wsa;
 #endif
 
+    bool            event_loop_enabled;
     bool            legacy_workaround_enabled;
+    bool            shared_memory_enabled;
+    unsigned int    shared_memory_mode;
     int             socket_count;
     SOCKET          server_sock[MAXSOCK];
+    std::thread *   EventLoopThread;
+    std::atomic<int> event_loop_fd;
+
+    /*---------------------------------------------------------*\
+    | Controller update notifications.  UpdateSubscribersMutex  |
+    | is always taken before UpdatePendingMutex and is never    |
+    | held while sending.  The notify thread counts its sends   |
+    | in notify_refs and RemoveUpdateSubscriber waits on        |
+    | UpdateSubscribersCV until they are done.  Controller      |
+    | callbacks only take UpdatePendingMutex so a slow client   |
+    | never blocks a device update.  The controllers mutex is   |
+    | taken before UpdatePendingMutex.                          |
+    \*---------------------------------------------------------*/
+    std::mutex                          UpdateSubscribersMutex;
+    std::condition_variable             UpdateSubscribersCV;
+    std::mutex                          UpdatePendingMutex;
+    std::condition_variable             UpdatePendingCV;
+    std::vector<NetworkClientInfo *>    UpdateSubscribers;
+    std::thread *                       UpdateNotifyThread;
+    std::atomic<bool>                   update_notify_running;
+
+    /*---------------------------------------------------------*\
+    | Controller data replies served from the description cache |
+    \*---------------------------------------------------------*/
+    std::atomic<unsigned long long>     description_cache_hits;
+    std::atomic<unsigned long long>     description_cache_misses;
+
+    void            RegisterControllerCallbacks();
+    void            UnregisterControllerCallbacks();
+    void            RemoveUpdateSubscriber(NetworkClientInfo * client_info);
+
+    void            SetupClientConnection(NetworkClientInfo * client_info);
+    bool            EventLoopReceive(NetworkClientInfo * client_info);
+    bool            EventLoopFlush(NetworkClientInfo * client_info);
+    bool            DispatchPacket(NetworkClientInfo * client_info, NetPacketHeader & header, char * data);
+
+    void            SendPacket(NetworkClientInfo * client_info, NetPacketHeader * header, const char * data, unsigned int data_size);
+    bool            WriteClient(NetworkClientInfo * client_info, const char * data, std::size_t size, int flags);
 
     int             accept_select(int sockfd);
     int             recv_select(SOCKET s, char *buf, int len, int flags);
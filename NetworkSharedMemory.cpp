@@ -0,0 +1,401 @@
+/*---------------------------------------------------------*\
+| NetworkSharedMemory.cpp                                   |
+|                                                           |
+|   Shared memory color ring used as a local fast path for  |
+|   OpenRGB SDK color updates                               |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <cstring>
+#include <new>
+#include "NetworkSharedMemory.h"
+#include "LogManager.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+#define SHM_ALIGNMENT               64
+#define SHM_ALIGN(size)             (((size) + (SHM_ALIGNMENT - 1)) & ~((std::size_t)SHM_ALIGNMENT - 1))
+
+#ifdef __linux__
+/*---------------------------------------------------------*\
+| The futex word lives in memory shared between processes,  |
+| so the non-private futex operations are used              |
+\*---------------------------------------------------------*/
+static void futex_wait(std::atomic<unsigned int> * addr, unsigned int value, unsigned int timeout_ms)
+{
+    struct timespec timeout;
+
+    timeout.tv_sec  = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+
+    syscall(SYS_futex, (unsigned int *)addr, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+
+static void futex_wake(std::atomic<unsigned int> * addr)
+{
+    syscall(SYS_futex, (unsigned int *)addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+#endif
+
+NetworkSharedColorRing::NetworkSharedColorRing()
+{
+    owner           = false;
+    stopping        = false;
+    map_ptr         = NULL;
+    map_size        = 0;
+    header          = NULL;
+    last_read_seq   = 0;
+    num_colors      = 0;
+    num_slots       = 0;
+    slot_size       = 0;
+}
+
+NetworkSharedColorRing::~NetworkSharedColorRing()
+{
+    Close();
+}
+
+bool NetworkSharedColorRing::IsSupported()
+{
+#ifdef __linux__
+    return(std::atomic<unsigned int>::is_always_lock_free);
+#else
+    return(false);
+#endif
+}
+
+bool NetworkSharedColorRing::Create(unsigned int new_num_colors, unsigned int mode)
+{
+#ifdef __linux__
+    static std::atomic<unsigned int> ring_count(0);
+
+    if(map_ptr != NULL || new_num_colors == 0)
+    {
+        return(false);
+    }
+
+    char new_name[64];
+
+    snprintf(new_name, sizeof(new_name), "/openrgb-%d-%u", (int)getpid(), ring_count++);
+
+    std::size_t header_size     = SHM_ALIGN(sizeof(NetworkSharedColorRingHeader));
+    std::size_t new_slot_size   = SHM_ALIGN(sizeof(std::atomic<unsigned int>) + (new_num_colors * sizeof(RGBColor)));
+    std::size_t total_size      = header_size + (OPENRGB_SHM_NUM_SLOTS * new_slot_size);
+
+    /*-----------------------------------------------------*\
+    | The mode decides which users may map the segment, the |
+    | umask is bypassed so that the configured mode applies |
+    \*-----------------------------------------------------*/
+    int shm_fd = shm_open(new_name, O_CREAT | O_EXCL | O_RDWR, (mode_t)(mode & 0666));
+
+    if(shm_fd < 0)
+    {
+        LOG_ERROR("[NetworkSharedMemory] Failed to create %s: %s", new_name, strerror(errno));
+        return(false);
+    }
+
+    fchmod(shm_fd, (mode_t)(mode & 0666));
+
+    if(ftruncate(shm_fd, total_size) != 0)
+    {
+        LOG_ERROR("[NetworkSharedMemory] Failed to size %s: %s", new_name, strerror(errno));
+        close(shm_fd);
+        shm_unlink(new_name);
+        return(false);
+    }
+
+    void * new_map = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+
+    close(shm_fd);
+
+    if(new_map == MAP_FAILED)
+    {
+        LOG_ERROR("[NetworkSharedMemory] Failed to map %s: %s", new_name, strerror(errno));
+        shm_unlink(new_name);
+        return(false);
+    }
+
+    name        = new_name;
+    owner       = true;
+    map_ptr     = (unsigned char *)new_map;
+    map_size    = total_size;
+    header      = new(map_ptr) NetworkSharedColorRingHeader;
+    num_colors  = new_num_colors;
+    num_slots   = OPENRGB_SHM_NUM_SLOTS;
+    slot_size   = new_slot_size;
+
+    header->magic           = OPENRGB_SHM_MAGIC;
+    header->num_colors      = num_colors;
+    header->num_slots       = num_slots;
+    header->slot_size       = (unsigned int)slot_size;
+    header->write_seq       = 0;
+    header->server_waiting  = 0;
+
+    for(unsigned int slot = 0; slot < OPENRGB_SHM_NUM_SLOTS; slot++)
+    {
+        new(GetSlotSeq(slot)) std::atomic<unsigned int>(0);
+    }
+
+    last_read_seq = 0;
+
+    return(true);
+#else
+    (void)new_num_colors;
+    (void)mode;
+    return(false);
+#endif
+}
+
+bool NetworkSharedColorRing::Open(std::string new_name, unsigned int new_num_colors)
+{
+#ifdef __linux__
+    if(map_ptr != NULL)
+    {
+        return(false);
+    }
+
+    int shm_fd = shm_open(new_name.c_str(), O_RDWR, 0);
+
+    if(shm_fd < 0)
+    {
+        LOG_ERROR("[NetworkSharedMemory] Failed to open %s: %s", new_name.c_str(), strerror(errno));
+        return(false);
+    }
+
+    struct stat shm_stat;
+
+    if((fstat(shm_fd, &shm_stat) != 0) || ((std::size_t)shm_stat.st_size < sizeof(NetworkSharedColorRingHeader)))
+    {
+        close(shm_fd);
+        return(false);
+    }
+
+    std::size_t total_size = (std::size_t)shm_stat.st_size;
+
+    void * new_map = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+
+    close(shm_fd);
+
+    if(new_map == MAP_FAILED)
+    {
+        LOG_ERROR("[NetworkSharedMemory] Failed to map %s: %s", new_name.c_str(), strerror(errno));
+        return(false);
+    }
+
+    NetworkSharedColorRingHeader * new_header = (NetworkSharedColorRingHeader *)new_map;
+
+    /*-----------------------------------------------------*\
+    | Verify the segment layout fits the mapped size and    |
+    | matches the advertised number of colors               |
+    \*-----------------------------------------------------*/
+    std::size_t header_size = SHM_ALIGN(sizeof(NetworkSharedColorRingHeader));
+
+    if((new_header->magic != OPENRGB_SHM_MAGIC)
+    || (new_header->num_colors != new_num_colors)
+    || (new_header->num_slots == 0)
+    || (new_header->slot_size < (sizeof(std::atomic<unsigned int>) + (new_num_colors * sizeof(RGBColor))))
+    || ((header_size + ((std::size_t)new_header->num_slots * new_header->slot_size)) > total_size))
+    {
+        LOG_ERROR("[NetworkSharedMemory] %s has an invalid layout", new_name.c_str());
+        munmap(new_map, total_size);
+        return(false);
+    }
+
+    name        = new_name;
+    owner       = false;
+    map_ptr     = (unsigned char *)new_map;
+    map_size    = total_size;
+    header      = new_header;
+    num_colors  = new_header->num_colors;
+    num_slots   = new_header->num_slots;
+    slot_size   = new_header->slot_size;
+
+    return(true);
+#else
+    (void)new_name;
+    (void)new_num_colors;
+    return(false);
+#endif
+}
+
+void NetworkSharedColorRing::Close()
+{
+#ifdef __linux__
+    if(map_ptr == NULL)
+    {
+        return;
+    }
+
+    munmap(map_ptr, map_size);
+
+    if(owner)
+    {
+        shm_unlink(name.c_str());
+    }
+
+    map_ptr     = NULL;
+    map_size    = 0;
+    header      = NULL;
+    num_colors  = 0;
+    num_slots   = 0;
+    slot_size   = 0;
+#endif
+}
+
+std::string NetworkSharedColorRing::GetName()
+{
+    return(name);
+}
+
+unsigned int NetworkSharedColorRing::GetNumColors()
+{
+    return(num_colors);
+}
+
+void NetworkSharedColorRing::WriteFrame(const RGBColor * frame_colors, unsigned int count)
+{
+#ifdef __linux__
+    if(header == NULL || count != num_colors)
+    {
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Sequence number 0 means "no frame", skip it on wrap   |
+    \*-----------------------------------------------------*/
+    unsigned int seq = header->write_seq.load() + 1;
+
+    if(seq == 0)
+    {
+        seq = 1;
+    }
+
+    unsigned int slot = seq % num_slots;
+
+    GetSlotSeq(slot)->store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(GetSlotColors(slot), frame_colors, count * sizeof(RGBColor));
+
+    GetSlotSeq(slot)->store(seq, std::memory_order_release);
+    header->write_seq.store(seq);
+
+    if(header->server_waiting.load())
+    {
+        futex_wake(&header->write_seq);
+    }
+#else
+    (void)frame_colors;
+    (void)count;
+#endif
+}
+
+bool NetworkSharedColorRing::WaitFrame(std::vector<RGBColor>& frame, unsigned int timeout_ms)
+{
+#ifdef __linux__
+    if(header == NULL)
+    {
+        return(false);
+    }
+
+    unsigned int seq = header->write_seq.load();
+
+    if(seq == last_read_seq)
+    {
+        /*-------------------------------------------------*\
+        | Announce the wait before re-checking write_seq so |
+        | that a frame published in between either is seen  |
+        | here or makes the client issue a wake             |
+        \*-------------------------------------------------*/
+        header->server_waiting.store(1);
+
+        seq = header->write_seq.load();
+
+        if((seq == last_read_seq) && !stopping.load())
+        {
+            futex_wait(&header->write_seq, seq, timeout_ms);
+        }
+
+        header->server_waiting.store(0);
+
+        seq = header->write_seq.load();
+
+        if(seq == last_read_seq)
+        {
+            return(false);
+        }
+    }
+
+    frame.resize(num_colors);
+
+    /*-----------------------------------------------------*\
+    | Copy the newest frame.  If the client laps the ring   |
+    | while copying, retry with the newer sequence number.  |
+    \*-----------------------------------------------------*/
+    for(unsigned int attempt = 0; attempt < num_slots; attempt++)
+    {
+        unsigned int slot       = seq % num_slots;
+        unsigned int seq_before = GetSlotSeq(slot)->load(std::memory_order_acquire);
+
+        if(seq_before == seq)
+        {
+            memcpy(frame.data(), GetSlotColors(slot), num_colors * sizeof(RGBColor));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if(GetSlotSeq(slot)->load(std::memory_order_relaxed) == seq_before)
+            {
+                last_read_seq = seq;
+                return(true);
+            }
+        }
+
+        seq = header->write_seq.load();
+    }
+
+    return(false);
+#else
+    (void)frame;
+    (void)timeout_ms;
+    return(false);
+#endif
+}
+
+void NetworkSharedColorRing::Stop()
+{
+    stopping = true;
+
+#ifdef __linux__
+    if(header != NULL)
+    {
+        futex_wake(&header->write_seq);
+    }
+#endif
+}
+
+bool NetworkSharedColorRing::IsStopping()
+{
+    return(stopping.load());
+}
+
+std::atomic<unsigned int> * NetworkSharedColorRing::GetSlotSeq(unsigned int slot)
+{
+    return((std::atomic<unsigned int> *)(map_ptr + SHM_ALIGN(sizeof(NetworkSharedColorRingHeader)) + ((std::size_t)slot * slot_size)));
+}
+
+RGBColor * NetworkSharedColorRing::GetSlotColors(unsigned int slot)
+{
+    return((RGBColor *)((unsigned char *)GetSlotSeq(slot) + sizeof(std::atomic<unsigned int>)));
+}
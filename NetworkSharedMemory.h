@@ -0,0 +1,110 @@
+/*---------------------------------------------------------*\
+| NetworkSharedMemory.h                                     |
+|                                                           |
+|   Shared memory color ring used as a local fast path for  |
+|   OpenRGB SDK color updates                               |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "RGBController.h"
+
+/*---------------------------------------------------------*\
+| Shared memory magic value "ORGM"                          |
+\*---------------------------------------------------------*/
+#define OPENRGB_SHM_MAGIC           0x4D47524F
+#define OPENRGB_SHM_NUM_SLOTS       4
+#define OPENRGB_SHM_DEFAULT_MODE    0600
+
+/*---------------------------------------------------------*\
+| Layout of the shared memory segment                       |
+|                                                           |
+|   NetworkSharedColorRingHeader                            |
+|   num_slots * {                                           |
+|       std::atomic<unsigned int>   seq                     |
+|       RGBColor                    colors[num_colors]      |
+|   }                                                       |
+|                                                           |
+| The client is the only writer.  It fills the slot for     |
+| the next sequence number, publishes the sequence number   |
+| in write_seq and wakes the server through a futex on      |
+| write_seq.  The server always reads the newest frame, so  |
+| frames written faster than the device can take them are   |
+| coalesced.  Each slot's seq field works as a seqlock that |
+| lets the server detect a slot being overwritten while it  |
+| is being copied.                                          |
+|                                                           |
+| The client can write to the whole segment, including the  |
+| layout fields.  The server keeps the layout it created    |
+| and never reads num_colors, num_slots or slot_size back.  |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    unsigned int                magic;
+    unsigned int                num_colors;
+    unsigned int                num_slots;
+    unsigned int                slot_size;
+    std::atomic<unsigned int>   write_seq;
+    std::atomic<unsigned int>   server_waiting;
+} NetworkSharedColorRingHeader;
+
+class NetworkSharedColorRing
+{
+public:
+    NetworkSharedColorRing();
+    ~NetworkSharedColorRing();
+
+    static bool     IsSupported();
+
+    /*-----------------------------------------------------*\
+    | The segment is created with the given permission      |
+    | mode.  With the default of 0600 only clients running  |
+    | as the same user as the server can open it.           |
+    \*-----------------------------------------------------*/
+    bool            Create(unsigned int num_colors, unsigned int mode = OPENRGB_SHM_DEFAULT_MODE);
+    bool            Open(std::string name, unsigned int num_colors);
+    void            Close();
+
+    std::string     GetName();
+    unsigned int    GetNumColors();
+
+    /*-----------------------------------------------------*\
+    | Client side                                           |
+    \*-----------------------------------------------------*/
+    void            WriteFrame(const RGBColor * frame_colors, unsigned int count);
+
+    /*-----------------------------------------------------*\
+    | Server side                                           |
+    \*-----------------------------------------------------*/
+    bool            WaitFrame(std::vector<RGBColor>& frame, unsigned int timeout_ms);
+    void            Stop();
+    bool            IsStopping();
+
+private:
+    std::string                     name;
+    bool                            owner;
+    std::atomic<bool>               stopping;
+    unsigned char *                 map_ptr;
+    std::size_t                     map_size;
+    NetworkSharedColorRingHeader *  header;
+    unsigned int                    last_read_seq;
+
+    /*-----------------------------------------------------*\
+    | Layout of the mapped segment, kept out of the shared  |
+    | header so the other side cannot change it             |
+    \*-----------------------------------------------------*/
+    unsigned int                    num_colors;
+    unsigned int                    num_slots;
+    std::size_t                     slot_size;
+
+    std::atomic<unsigned int> *     GetSlotSeq(unsigned int slot);
+    RGBColor *                      GetSlotColors(unsigned int slot);
+};
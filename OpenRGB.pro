@@ -168,6 +168,7 @@ INCLUDEPATH +=
 HEADERS +=                                                                                      \
     $$GUI_H                                                                                     \
     $$CONTROLLER_H                                                                              \
+    Benchmark.h                                                                                 \
     Colors.h                                                                                    \
     dependencies/ColorWheel/ColorWheel.h                                                        \
     dependencies/json/nlohmann/json.hpp                                                         \
@@ -175,6 +176,7 @@ HEADERS +=
     NetworkClient.h                                                                             \
     NetworkProtocol.h                                                                           \
     NetworkServer.h                                                                             \
+    NetworkSharedMemory.h                                                                       \
     OpenRGBPluginInterface.h                                                                    \
     PluginManager.h                                                                             \
     ProfileManager.h                                                                            \
@@ -182,16 +184,22 @@ HEADERS +=
     ResourceManagerInterface.h                                                                  \
     SettingsManager.h                                                                           \
     Detector.h                                                                                  \
+    DetectionCache.h                                                                            \
     DeviceDetector.h                                                                            \
+    DeviceUpdatePool.h                                                                          \
+    HIDHotplugMonitor.h                                                                         \
     dmiinfo/dmiinfo.h                                                                           \
     filesystem.h                                                                                \
     hidapi_wrapper/hidapi_wrapper.h                                                             \
+    hidapi_wrapper/hidapi_wrapper_debug.h                                                       \
     i2c_smbus/i2c_smbus.h                                                                       \
+    i2c_smbus/i2c_smbus_debug.h                                                                 \
     i2c_tools/i2c_tools.h                                                                       \
     interop/DeviceGuard.h                                                                       \
     interop/DeviceGuardLock.h                                                                   \
     interop/DeviceGuardManager.h                                                                \
     net_port/net_port.h                                                                         \
+    net_port/smart_light_transport.h                                                            \
     pci_ids/pci_ids.h                                                                           \
     scsiapi/scsiapi.h                                                                           \
     serial_port/find_usb_serial_port.h                                                          \
@@ -241,11 +249,16 @@ SOURCES +=
     dependencies/hueplusplus-1.2.0/src/ZLLSensors.cpp                                           \
     main.cpp                                                                                    \
     cli.cpp                                                                                     \
+    Benchmark.cpp                                                                               \
+    DetectionCache.cpp                                                                          \
+    DeviceUpdatePool.cpp                                                                        \
+    HIDHotplugMonitor.cpp                                                                       \
     dmiinfo/dmiinfo.cpp                                                                         \
     LogManager.cpp                                                                              \
     NetworkClient.cpp                                                                           \
     NetworkProtocol.cpp                                                                         \
     NetworkServer.cpp                                                                           \
+    NetworkSharedMemory.cpp                                                                     \
     PluginManager.cpp                                                                           \
     ProfileManager.cpp                                                                          \
     ResourceManager.cpp                                                                         \
@@ -255,12 +268,15 @@ SOURCES +=
     SPDAccessor/SPDDetector.cpp                                                                 \
     SPDAccessor/SPDWrapper.cpp                                                                  \
     SettingsManager.cpp                                                                         \
+    hidapi_wrapper/hidapi_wrapper_debug.cpp                                                     \
     i2c_smbus/i2c_smbus.cpp                                                                     \
+    i2c_smbus/i2c_smbus_debug.cpp                                                               \
     i2c_tools/i2c_tools.cpp                                                                     \
     interop/DeviceGuard.cpp                                                                     \
     interop/DeviceGuardLock.cpp                                                                 \
     interop/DeviceGuardManager.cpp                                                              \
     net_port/net_port.cpp                                                                       \
+    net_port/smart_light_transport.cpp                                                          \
     serial_port/serial_port.cpp                                                                 \
     StringUtils.cpp                                                                             \
     super_io/super_io.cpp                                                                       \
@@ -472,6 +488,7 @@ contains(QMAKE_PLATFORM, linux) {
     -lmbedtls                                                                                   \
     -lmbedcrypto                                                                                \
     -ldl                                                                                        \
+    -lrt                                                                                        \
 
     COMPILER_VERSION = $$system($$QMAKE_CXX " -dumpversion")
     if (!versionAtLeast(COMPILER_VERSION, "9")) {
@@ -81,6 +81,8 @@ bool ProfileManager::SaveProfile(std::string profile_name, bool sizes)
         /*---------------------------------------------------------*\
         | Write controller data for each controller                 |
         \*---------------------------------------------------------*/
+        std::vector<unsigned char> controller_data;
+
         for(std::size_t controller_index = 0; controller_index < controllers.size(); controller_index++)
         {
             /*-----------------------------------------------------*\
@@ -93,14 +95,9 @@ bool ProfileManager::SaveProfile(std::string profile_name, bool sizes)
                 break;
             }
 
-            unsigned char *controller_data = controllers[controller_index]->GetDeviceDescription(profile_version);
-            unsigned int controller_size;
-
-            memcpy(&controller_size, controller_data, sizeof(controller_size));
+            controllers[controller_index]->GetCachedDeviceDescription(profile_version, controller_data);
 
-            controller_file.write((const char *)controller_data, controller_size);
-
-            delete[] controller_data;
+            controller_file.write((const char *)controller_data.data(), controller_data.size());
         }
 
         /*---------------------------------------------------------*\
@@ -317,6 +314,8 @@ bool ProfileManager::LoadDeviceFromListWithOptions
                             }
                         }
                     }
+
+                    load_controller->InvalidateDeviceDescription();
                 }
             }
 
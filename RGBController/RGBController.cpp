@@ -10,8 +10,10 @@
 |   SPDX-License-Identifier: GPL-2.0-only                   |
 \*---------------------------------------------------------*/
 
+#include <algorithm>
 #include <cstring>
 #include "RGBController.h"
+#include "NetworkProtocol.h"
 
 using namespace std::chrono_literals;
 
@@ -59,15 +61,32 @@ zone::~zone()
 RGBController::RGBController()
 {
     flags       = 0;
-    DeviceThreadRunning = true;
-    DeviceCallThread = new std::thread(&RGBController::DeviceCallThreadFunction, this);
+    CallFlag_UpdateLEDs = false;
+    CallFlag_UpdateMode = false;
+    DeviceThreadRunning = false;
+    DeviceCallThread    = NULL;
+    UpdateDispatcher    = NULL;
+    UpdateDeferred      = false;
+    PendingColorsValid  = false;
+    MaxRefreshRate      = 0;
+    FramesSubmitted     = 0;
+    FramesCoalesced     = 0;
+    FramesSent          = 0;
+    DescriptionGeneration = 0;
 }
 
 RGBController::~RGBController()
 {
-    DeviceThreadRunning = false;
-    DeviceCallThread->join();
-    delete DeviceCallThread;
+    /*-------------------------------------------------*\
+    | Stop the device call thread if one was started    |
+    | and detach from the update dispatcher             |
+    \*-------------------------------------------------*/
+    StopDeviceCallThread();
+
+    if(UpdateDispatcher != NULL)
+    {
+        UpdateDispatcher->RemoveController(this);
+    }
 
     leds.clear();
     colors.clear();
@@ -128,7 +147,98 @@ std::string RGBController::GetLEDName(unsigned int led)
     return(leds[led].name);
 }
 
+/*---------------------------------------------------------*\
+| The device description only depends on modes, zones and   |
+| segments, except for the color buffer.  Descriptions are  |
+| cached per protocol version and rebuilt when the          |
+| description generation changes.  Cache hits copy the      |
+| cached buffer and patch in the current colors.            |
+\*---------------------------------------------------------*/
 unsigned char * RGBController::GetDeviceDescription(unsigned int protocol_version)
+{
+    std::vector<unsigned char> description;
+
+    GetCachedDeviceDescription(protocol_version, description);
+
+    unsigned char *data_buf = new unsigned char[description.size()];
+
+    memcpy(data_buf, description.data(), description.size());
+
+    return(data_buf);
+}
+
+bool RGBController::GetCachedDeviceDescription(unsigned int protocol_version, std::vector<unsigned char>& data_buf)
+{
+    std::lock_guard<std::mutex> lock(DescriptionCacheMutex);
+
+    /*-----------------------------------------------------*\
+    | Versions newer than the SDK's serialize the same way  |
+    | as the SDK's own version.  Clamping keeps the cache   |
+    | to one entry per known version whatever is requested  |
+    \*-----------------------------------------------------*/
+    protocol_version = std::min(protocol_version, (unsigned int)OPENRGB_SDK_PROTOCOL_VERSION);
+
+    RGBControllerDescriptionCache& cache = DescriptionCache[protocol_version];
+
+    /*-----------------------------------------------------*\
+    | Besides the generation, check the element counts so   |
+    | that a change made without invalidating the cache     |
+    | still triggers a rebuild                              |
+    \*-----------------------------------------------------*/
+    bool cache_hit = (cache.valid)
+                  && (cache.generation  == DescriptionGeneration.load())
+                  && (cache.active_mode == active_mode)
+                  && (cache.num_modes   == modes.size())
+                  && (cache.num_zones   == zones.size())
+                  && (cache.num_leds    == leds.size())
+                  && (cache.num_colors  == colors.size());
+
+    if(!cache_hit)
+    {
+        unsigned int    colors_offset   = 0;
+        unsigned int    generation      = DescriptionGeneration.load();
+        unsigned char * description     = BuildDeviceDescription(protocol_version, &colors_offset);
+        unsigned int    description_size;
+
+        memcpy(&description_size, description, sizeof(description_size));
+
+        cache.data.assign(description, description + description_size);
+        cache.valid         = true;
+        cache.generation    = generation;
+        cache.colors_offset = colors_offset;
+        cache.active_mode   = active_mode;
+        cache.num_modes     = modes.size();
+        cache.num_zones     = zones.size();
+        cache.num_leds      = leds.size();
+        cache.num_colors    = colors.size();
+
+        delete[] description;
+    }
+    else
+    {
+        /*-------------------------------------------------*\
+        | Skip the number of colors field and copy in the   |
+        | current colors                                    |
+        \*-------------------------------------------------*/
+        memcpy(&cache.data[cache.colors_offset + sizeof(unsigned short)], colors.data(), cache.num_colors * sizeof(RGBColor));
+    }
+
+    data_buf.assign(cache.data.begin(), cache.data.end());
+
+    return(cache_hit);
+}
+
+void RGBController::InvalidateDeviceDescription()
+{
+    DescriptionGeneration++;
+}
+
+unsigned int RGBController::GetDescriptionGeneration()
+{
+    return(DescriptionGeneration.load());
+}
+
+unsigned char * RGBController::BuildDeviceDescription(unsigned int protocol_version, unsigned int* colors_offset)
 {
     unsigned int data_ptr = 0;
     unsigned int data_size = 0;
@@ -699,6 +809,8 @@ unsigned char * RGBController::GetDeviceDescription(unsigned int protocol_versio
     /*---------------------------------------------------------*\
     | Copy in number of colors (data)                           |
     \*---------------------------------------------------------*/
+    *colors_offset = data_ptr;
+
     memcpy(&data_buf[data_ptr], &num_colors, sizeof(unsigned short));
     data_ptr += sizeof(unsigned short);
 
@@ -763,6 +875,8 @@ void RGBController::ReadDeviceDescription(unsigned char* data_buf, unsigned int
 {
     unsigned int data_ptr = 0;
 
+    InvalidateDeviceDescription();
+
     data_ptr += sizeof(unsigned int);
 
     /*---------------------------------------------------------*\
@@ -1388,6 +1502,8 @@ void RGBController::SetModeDescription(unsigned char* data_buf, unsigned int pro
     int mode_idx;
     unsigned int data_ptr = sizeof(unsigned int);
 
+    InvalidateDeviceDescription();
+
     /*---------------------------------------------------------*\
     | Copy in mode index                                        |
     \*---------------------------------------------------------*/
@@ -1569,9 +1685,29 @@ unsigned char * RGBController::GetColorDescription()
 }
 
 void RGBController::SetColorDescription(unsigned char* data_buf)
+{
+    /*---------------------------------------------------------*\
+    | The buffer size is not known here, trust the number of    |
+    | colors in the description                                 |
+    \*---------------------------------------------------------*/
+    unsigned short num_colors;
+    memcpy(&num_colors, &data_buf[sizeof(unsigned int)], sizeof(unsigned short));
+
+    SetColorDescription(data_buf, sizeof(unsigned int) + sizeof(unsigned short) + (num_colors * sizeof(RGBColor)));
+}
+
+void RGBController::SetColorDescription(const unsigned char* data_buf, unsigned int data_size)
 {
     unsigned int data_ptr = sizeof(unsigned int);
 
+    /*---------------------------------------------------------*\
+    | Check that the buffer holds the number of colors          |
+    \*---------------------------------------------------------*/
+    if(data_size < (sizeof(unsigned int) + sizeof(unsigned short)))
+    {
+        return;
+    }
+
     /*---------------------------------------------------------*\
     | Copy in number of colors (data)                           |
     \*---------------------------------------------------------*/
@@ -1580,28 +1716,264 @@ void RGBController::SetColorDescription(unsigned char* data_buf)
     data_ptr += sizeof(unsigned short);
 
     /*---------------------------------------------------------*\
-    | Check if we aren't reading beyond the list of colors.     |
+    | Check if we aren't reading beyond the list of colors or   |
+    | beyond the end of the buffer                              |
     \*---------------------------------------------------------*/
-    if(((size_t)num_colors) > colors.size())
+    if((((size_t)num_colors) > colors.size())
+    || ((data_size - data_ptr) < (num_colors * sizeof(RGBColor))))
     {
         return;
     }
 
+    /*---------------------------------------------------------*\
+    | If the device is not reading the color buffer, write it   |
+    | directly.  Otherwise write into the pending frame so the  |
+    | device never sends a mix of two frames.  The pending      |
+    | frame is swapped in before the next device update.        |
+    \*---------------------------------------------------------*/
+    std::unique_lock<std::mutex> color_lock(ColorMutex, std::try_to_lock);
+    std::unique_lock<std::mutex> pending_lock;
+    RGBColor*                    target;
+
+    if(color_lock.owns_lock())
+    {
+        ApplyPendingColors();
+
+        target = colors.data();
+    }
+    else
+    {
+        pending_lock = std::unique_lock<std::mutex>(PendingColorsMutex);
+
+        if(!PendingColorsValid.load() || (PendingColors.size() != colors.size()))
+        {
+            PendingColors = colors;
+        }
+
+        target = PendingColors.data();
+    }
+
     /*---------------------------------------------------------*\
     | Copy in colors                                            |
     \*---------------------------------------------------------*/
-    for(int color_index = 0; color_index < num_colors; color_index++)
+    memcpy(target, &data_buf[data_ptr], num_colors * sizeof(RGBColor));
+
+    if(pending_lock.owns_lock())
     {
-        RGBColor new_color;
+        PendingColorsValid = true;
+    }
+}
 
-        /*---------------------------------------------------------*\
-        | Copy in color (data)                                      |
-        \*---------------------------------------------------------*/
-        memcpy(&new_color, &data_buf[data_ptr], sizeof(RGBColor));
-        data_ptr += sizeof(RGBColor);
+/*---------------------------------------------------------*\
+| The color delta description carries only the LED ranges   |
+| that differ from a reference frame:                       |
+|                                                           |
+|   unsigned int    data_size                               |
+|   unsigned short  num_colors  (size of the full buffer)   |
+|   unsigned short  num_ranges                              |
+|   num_ranges * {                                          |
+|       unsigned short  start                               |
+|       unsigned short  count                               |
+|       RGBColor        colors[count]                       |
+|   }                                                       |
+\*---------------------------------------------------------*/
+unsigned char * RGBController::GetColorDeltaDescription(const std::vector<RGBColor>& reference_colors)
+{
+    unsigned int data_ptr = 0;
+    unsigned int data_size = 0;
+
+    unsigned short num_colors = (unsigned short)colors.size();
+
+    if(reference_colors.size() != colors.size())
+    {
+        return(NULL);
+    }
+
+    /*---------------------------------------------------------*\
+    | Find the changed ranges.  A range header costs the same   |
+    | as one color, so ranges separated by a single unchanged   |
+    | LED are merged.                                           |
+    \*---------------------------------------------------------*/
+    std::vector<unsigned short> range_start;
+    std::vector<unsigned short> range_count;
+
+    for(unsigned int color_index = 0; color_index < num_colors; color_index++)
+    {
+        if(colors[color_index] == reference_colors[color_index])
+        {
+            continue;
+        }
+
+        if(!range_start.empty() && (((unsigned int)range_start.back() + range_count.back() + 1) >= color_index))
+        {
+            range_count.back() = (unsigned short)(color_index - range_start.back() + 1);
+        }
+        else
+        {
+            range_start.push_back((unsigned short)color_index);
+            range_count.push_back(1);
+        }
+    }
+
+    unsigned short num_ranges = (unsigned short)range_start.size();
+
+    /*---------------------------------------------------------*\
+    | Calculate data size                                       |
+    \*---------------------------------------------------------*/
+    data_size += sizeof(data_size);
+    data_size += sizeof(num_colors);
+    data_size += sizeof(num_ranges);
+
+    for(unsigned int range_index = 0; range_index < num_ranges; range_index++)
+    {
+        data_size += sizeof(unsigned short) * 2;
+        data_size += range_count[range_index] * sizeof(RGBColor);
+    }
+
+    /*---------------------------------------------------------*\
+    | Create data buffer                                        |
+    \*---------------------------------------------------------*/
+    unsigned char *data_buf = new unsigned char[data_size];
+
+    /*---------------------------------------------------------*\
+    | Copy in data size, number of colors and number of ranges  |
+    \*---------------------------------------------------------*/
+    memcpy(&data_buf[data_ptr], &data_size, sizeof(data_size));
+    data_ptr += sizeof(data_size);
+
+    memcpy(&data_buf[data_ptr], &num_colors, sizeof(num_colors));
+    data_ptr += sizeof(num_colors);
+
+    memcpy(&data_buf[data_ptr], &num_ranges, sizeof(num_ranges));
+    data_ptr += sizeof(num_ranges);
+
+    /*---------------------------------------------------------*\
+    | Copy in ranges                                            |
+    \*---------------------------------------------------------*/
+    for(unsigned int range_index = 0; range_index < num_ranges; range_index++)
+    {
+        memcpy(&data_buf[data_ptr], &range_start[range_index], sizeof(unsigned short));
+        data_ptr += sizeof(unsigned short);
+
+        memcpy(&data_buf[data_ptr], &range_count[range_index], sizeof(unsigned short));
+        data_ptr += sizeof(unsigned short);
+
+        memcpy(&data_buf[data_ptr], &colors[range_start[range_index]], range_count[range_index] * sizeof(RGBColor));
+        data_ptr += range_count[range_index] * sizeof(RGBColor);
+    }
+
+    return(data_buf);
+}
+
+bool RGBController::SetColorDeltaDescription(const unsigned char* data_buf, unsigned int data_size)
+{
+    const unsigned int header_size = sizeof(unsigned int) + (sizeof(unsigned short) * 2);
+
+    unsigned int data_ptr = sizeof(unsigned int);
+
+    if(data_size < header_size)
+    {
+        return(false);
+    }
+
+    unsigned short num_colors;
+    unsigned short num_ranges;
+
+    memcpy(&num_colors, &data_buf[data_ptr], sizeof(num_colors));
+    data_ptr += sizeof(num_colors);
+
+    memcpy(&num_ranges, &data_buf[data_ptr], sizeof(num_ranges));
+    data_ptr += sizeof(num_ranges);
+
+    /*---------------------------------------------------------*\
+    | The delta is only meaningful against a color buffer of    |
+    | the same size as the sender's reference frame             |
+    \*---------------------------------------------------------*/
+    if(((size_t)num_colors) != colors.size())
+    {
+        return(false);
+    }
+
+    /*---------------------------------------------------------*\
+    | Validate every range before touching the color buffer     |
+    \*---------------------------------------------------------*/
+    unsigned int ranges_ptr = data_ptr;
+
+    for(unsigned int range_index = 0; range_index < num_ranges; range_index++)
+    {
+        unsigned short start;
+        unsigned short count;
+
+        if((data_size - data_ptr) < (sizeof(unsigned short) * 2))
+        {
+            return(false);
+        }
+
+        memcpy(&start, &data_buf[data_ptr], sizeof(start));
+        memcpy(&count, &data_buf[data_ptr + sizeof(start)], sizeof(count));
+        data_ptr += sizeof(unsigned short) * 2;
+
+        if((((unsigned int)start + count) > num_colors)
+        || ((data_size - data_ptr) < (count * sizeof(RGBColor))))
+        {
+            return(false);
+        }
+
+        data_ptr += count * sizeof(RGBColor);
+    }
+
+    if(data_ptr != data_size)
+    {
+        return(false);
+    }
+
+    /*---------------------------------------------------------*\
+    | Write in place, or into the pending frame if the device   |
+    | is reading the color buffer (see SetColorDescription)     |
+    \*---------------------------------------------------------*/
+    std::unique_lock<std::mutex> color_lock(ColorMutex, std::try_to_lock);
+    std::unique_lock<std::mutex> pending_lock;
+    RGBColor*                    target;
+
+    if(color_lock.owns_lock())
+    {
+        ApplyPendingColors();
+
+        target = colors.data();
+    }
+    else
+    {
+        pending_lock = std::unique_lock<std::mutex>(PendingColorsMutex);
+
+        if(!PendingColorsValid.load() || (PendingColors.size() != colors.size()))
+        {
+            PendingColors = colors;
+        }
+
+        target = PendingColors.data();
+    }
+
+    data_ptr = ranges_ptr;
+
+    for(unsigned int range_index = 0; range_index < num_ranges; range_index++)
+    {
+        unsigned short start;
+        unsigned short count;
 
-        colors[color_index] = new_color;
+        memcpy(&start, &data_buf[data_ptr], sizeof(start));
+        memcpy(&count, &data_buf[data_ptr + sizeof(start)], sizeof(count));
+        data_ptr += sizeof(unsigned short) * 2;
+
+        memcpy(&target[start], &data_buf[data_ptr], count * sizeof(RGBColor));
+        data_ptr += count * sizeof(RGBColor);
+    }
+
+    if(pending_lock.owns_lock())
+    {
+        PendingColorsValid = true;
     }
+
+    return(true);
 }
 
 unsigned char * RGBController::GetZoneColorDescription(int zone)
@@ -1684,8 +2056,13 @@ void RGBController::SetZoneColorDescription(unsigned char* data_buf)
     data_ptr += sizeof(unsigned short);
 
     /*---------------------------------------------------------*\
-    | Copy in colors                                            |
+    | Copy in colors, waiting for the device to finish reading  |
+    | the color buffer                                          |
     \*---------------------------------------------------------*/
+    std::lock_guard<std::mutex> color_lock(ColorMutex);
+
+    ApplyPendingColors();
+
     for(int color_index = 0; color_index < num_colors; color_index++)
     {
         RGBColor new_color;
@@ -1745,8 +2122,13 @@ void RGBController::SetSingleLEDColorDescription(unsigned char* data_buf)
     }
 
     /*---------------------------------------------------------*\
-    | Copy in LED color                                         |
+    | Copy in LED color, waiting for the device to finish       |
+    | reading the color buffer                                  |
     \*---------------------------------------------------------*/
+    std::lock_guard<std::mutex> color_lock(ColorMutex);
+
+    ApplyPendingColors();
+
     memcpy(&colors[led_idx], &data_buf[sizeof(led_idx)], sizeof(RGBColor));
 }
 
@@ -2030,8 +2412,60 @@ void RGBController::UnregisterUpdateCallback(void * callback_arg)
 
 void RGBController::ClearCallbacks()
 {
+    std::lock_guard<std::mutex> lock(UpdateMutex);
+
     UpdateCallbacks.clear();
     UpdateCallbackArgs.clear();
+
+    UpdateReasonCallbacks.clear();
+    UpdateReasonCallbackArgs.clear();
+}
+
+void RGBController::RegisterUpdateReasonCallback(RGBControllerUpdateReasonCallback new_callback, void * new_callback_arg)
+{
+    std::lock_guard<std::mutex> lock(UpdateMutex);
+
+    UpdateReasonCallbacks.push_back(new_callback);
+    UpdateReasonCallbackArgs.push_back(new_callback_arg);
+}
+
+void RGBController::UnregisterUpdateReasonCallback(void * callback_arg)
+{
+    std::lock_guard<std::mutex> lock(UpdateMutex);
+
+    for(unsigned int callback_idx = 0; callback_idx < UpdateReasonCallbackArgs.size(); callback_idx++)
+    {
+        if(UpdateReasonCallbackArgs[callback_idx] == callback_arg)
+        {
+            UpdateReasonCallbackArgs.erase(UpdateReasonCallbackArgs.begin() + callback_idx);
+            UpdateReasonCallbacks.erase(UpdateReasonCallbacks.begin() + callback_idx);
+
+            break;
+        }
+    }
+}
+
+/*---------------------------------------------------------*\
+| Unlike SignalUpdate(), which only runs on UpdateLEDs(),   |
+| reason callbacks are told what changed and also run on    |
+| mode, zone and segment changes                            |
+\*---------------------------------------------------------*/
+void RGBController::SignalUpdateReason(unsigned int update_reason)
+{
+    /*-----------------------------------------------------*\
+    | Anything but a color change alters the description    |
+    \*-----------------------------------------------------*/
+    if(update_reason & ~RGBCONTROLLER_UPDATE_REASON_UPDATELEDS)
+    {
+        InvalidateDeviceDescription();
+    }
+
+    std::lock_guard<std::mutex> lock(UpdateMutex);
+
+    for(unsigned int callback_idx = 0; callback_idx < UpdateReasonCallbacks.size(); callback_idx++)
+    {
+        UpdateReasonCallbacks[callback_idx](UpdateReasonCallbackArgs[callback_idx], this, update_reason);
+    }
 }
 
 void RGBController::SignalUpdate()
@@ -2048,16 +2482,37 @@ void RGBController::SignalUpdate()
 
     UpdateMutex.unlock();
 }
+
 void RGBController::UpdateLEDs()
 {
-    CallFlag_UpdateLEDs = true;
+    FramesSubmitted++;
+
+    {
+        std::lock_guard<std::mutex> lock(DeviceCallMutex);
+
+        if(CallFlag_UpdateLEDs.exchange(true))
+        {
+            FramesCoalesced++;
+        }
+
+        DispatchUpdate();
+    }
+    DeviceCallCV.notify_one();
 
     SignalUpdate();
+    SignalUpdateReason(RGBCONTROLLER_UPDATE_REASON_UPDATELEDS);
 }
 
 void RGBController::UpdateMode()
 {
-    CallFlag_UpdateMode = true;
+    {
+        std::lock_guard<std::mutex> lock(DeviceCallMutex);
+        CallFlag_UpdateMode = true;
+        DispatchUpdate();
+    }
+    DeviceCallCV.notify_one();
+
+    SignalUpdateReason(RGBCONTROLLER_UPDATE_REASON_UPDATEMODE);
 }
 
 void RGBController::SaveMode()
@@ -2110,44 +2565,259 @@ void RGBController::DeviceUpdateMode()
 
 void RGBController::DeviceCallThreadFunction()
 {
-    CallFlag_UpdateLEDs = false;
-    CallFlag_UpdateMode = false;
-
     while(DeviceThreadRunning.load() == true)
     {
-        if(CallFlag_UpdateMode.load() == true)
+        /*-------------------------------------------------*\
+        | Sleep until an update is requested or the thread  |
+        | is stopped, idle controllers do not wake up       |
+        \*-------------------------------------------------*/
         {
-            if(flags & CONTROLLER_FLAG_RESET_BEFORE_UPDATE)
-            {
-                CallFlag_UpdateMode = false;
-                DeviceUpdateMode();
-            }
-            else
+            std::unique_lock<std::mutex> lock(DeviceCallMutex);
+
+            DeviceCallCV.wait(lock, [this]
             {
-                DeviceUpdateMode();
-                CallFlag_UpdateMode = false;
-            }
+                return(CallFlag_UpdateMode.load() || CallFlag_UpdateLEDs.load() || !DeviceThreadRunning.load());
+            });
         }
-        if(CallFlag_UpdateLEDs.load() == true)
+
+        if(DeviceThreadRunning.load() == false)
         {
-            if(flags & CONTROLLER_FLAG_RESET_BEFORE_UPDATE)
-            {
-                CallFlag_UpdateLEDs = false;
-                DeviceUpdateLEDs();
-            }
-            else
+            break;
+        }
+
+        RunPendingUpdates();
+    }
+}
+
+void RGBController::RunPendingUpdates()
+{
+    {
+        std::lock_guard<std::mutex> lock(DeviceCallMutex);
+        UpdateDeferred = false;
+    }
+
+    if(CallFlag_UpdateMode.load() == true)
+    {
+        if(flags & CONTROLLER_FLAG_RESET_BEFORE_UPDATE)
+        {
+            CallFlag_UpdateMode = false;
+            DeviceUpdateMode();
+        }
+        else
+        {
+            DeviceUpdateMode();
+            CallFlag_UpdateMode = false;
+        }
+    }
+    if(CallFlag_UpdateLEDs.load() == true)
+    {
+        /*-------------------------------------------------*\
+        | Hold back the frame until the configured refresh  |
+        | interval has passed, later UpdateLEDs() calls     |
+        | coalesce into it in the meantime.  A dispatcher   |
+        | worker must not sleep, so the frame is handed     |
+        | back to the dispatcher with its due time instead. |
+        \*-------------------------------------------------*/
+        std::chrono::steady_clock::time_point next_update;
+
+        if(!RefreshIntervalElapsed(&next_update))
+        {
+            std::unique_lock<std::mutex> lock(DeviceCallMutex);
+
+            if(UpdateDispatcher != NULL)
             {
-                DeviceUpdateLEDs();
-                CallFlag_UpdateLEDs = false;
+                UpdateDeferred = true;
+                UpdateDispatcher->ScheduleControllerAt(this, next_update);
+                return;
             }
+
+            lock.unlock();
+
+            std::this_thread::sleep_until(next_update);
+        }
+
+        std::lock_guard<std::mutex> color_lock(ColorMutex);
+
+        ApplyPendingColors();
+
+        if(flags & CONTROLLER_FLAG_RESET_BEFORE_UPDATE)
+        {
+            CallFlag_UpdateLEDs = false;
+            DeviceUpdateLEDs();
         }
         else
         {
-           std::this_thread::sleep_for(1ms);
+            DeviceUpdateLEDs();
+            CallFlag_UpdateLEDs = false;
+        }
+
+        LastLEDUpdateTime = std::chrono::steady_clock::now();
+        FramesSent++;
+
+        /*-------------------------------------------------*\
+        | A frame received while the device was busy still  |
+        | has to be sent                                    |
+        \*-------------------------------------------------*/
+        if(PendingColorsValid.load())
+        {
+            CallFlag_UpdateLEDs = true;
         }
     }
 }
 
+void RGBController::ApplyPendingColors()
+{
+    /*-------------------------------------------------*\
+    | Called with ColorMutex held.  Swap in the frame   |
+    | staged by SetColorDescription, unless the color   |
+    | buffer was resized in the meantime.  Writers call |
+    | this before writing colors directly so that a     |
+    | stale staged frame never overwrites newer data.   |
+    \*-------------------------------------------------*/
+    if(!PendingColorsValid.load())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> pending_lock(PendingColorsMutex);
+
+    if(PendingColors.size() == colors.size())
+    {
+        std::copy(PendingColors.begin(), PendingColors.end(), colors.begin());
+    }
+
+    PendingColorsValid = false;
+}
+
+bool RGBController::RefreshIntervalElapsed(std::chrono::steady_clock::time_point* next_update)
+{
+    unsigned int max_refresh_rate = MaxRefreshRate.load();
+
+    if(max_refresh_rate == 0)
+    {
+        return(true);
+    }
+
+    *next_update = LastLEDUpdateTime + std::chrono::microseconds(1000000 / max_refresh_rate);
+
+    return(std::chrono::steady_clock::now() >= *next_update);
+}
+
+void RGBController::SetMaxRefreshRate(unsigned int max_refresh_rate)
+{
+    MaxRefreshRate = max_refresh_rate;
+}
+
+unsigned int RGBController::GetMaxRefreshRate()
+{
+    return(MaxRefreshRate.load());
+}
+
+RGBControllerFrameCounters RGBController::GetFrameCounters()
+{
+    RGBControllerFrameCounters counters;
+
+    counters.submitted  = FramesSubmitted.load();
+    counters.coalesced  = FramesCoalesced.load();
+    counters.sent       = FramesSent.load();
+
+    return(counters);
+}
+
+void RGBController::SetUpdateDispatcher(RGBControllerUpdateDispatcher* dispatcher)
+{
+    /*-------------------------------------------------*\
+    | The dispatcher replaces the dedicated device call |
+    | thread, stop it if it was already started         |
+    \*-------------------------------------------------*/
+    StopDeviceCallThread();
+
+    /*-------------------------------------------------*\
+    | Detach from the previous dispatcher without       |
+    | holding the call mutex, removal waits for a       |
+    | running update which may request another one      |
+    \*-------------------------------------------------*/
+    RGBControllerUpdateDispatcher* old_dispatcher;
+
+    {
+        std::lock_guard<std::mutex> lock(DeviceCallMutex);
+
+        old_dispatcher   = UpdateDispatcher;
+        UpdateDispatcher = NULL;
+        UpdateDeferred   = false;
+    }
+
+    if(old_dispatcher != NULL)
+    {
+        old_dispatcher->RemoveController(this);
+    }
+
+    std::lock_guard<std::mutex> lock(DeviceCallMutex);
+
+    UpdateDispatcher = dispatcher;
+
+    if(UpdateDispatcher != NULL)
+    {
+        UpdateDispatcher->AddController(this);
+    }
+
+    /*-------------------------------------------------*\
+    | Hand over any update requested in the meantime    |
+    \*-------------------------------------------------*/
+    if(CallFlag_UpdateMode.load() || CallFlag_UpdateLEDs.load())
+    {
+        DispatchUpdate();
+    }
+}
+
+void RGBController::DispatchUpdate()
+{
+    /*-------------------------------------------------*\
+    | Called with DeviceCallMutex held.  Queue the      |
+    | update on the dispatcher if there is one,         |
+    | otherwise start the device call thread on first   |
+    | use so that controllers which are never updated   |
+    | do not own a thread                               |
+    \*-------------------------------------------------*/
+    if(UpdateDispatcher != NULL)
+    {
+        /*---------------------------------------------*\
+        | A deferred frame picks up newer colors when   |
+        | it is sent, only a mode change must not wait  |
+        \*---------------------------------------------*/
+        if(!UpdateDeferred || CallFlag_UpdateMode.load())
+        {
+            UpdateDispatcher->ScheduleController(this);
+        }
+    }
+    else if(DeviceCallThread == NULL)
+    {
+        DeviceThreadRunning = true;
+        DeviceCallThread    = new std::thread(&RGBController::DeviceCallThreadFunction, this);
+    }
+}
+
+void RGBController::StopDeviceCallThread()
+{
+    std::thread* thread;
+
+    {
+        std::lock_guard<std::mutex> lock(DeviceCallMutex);
+
+        thread              = DeviceCallThread;
+        DeviceCallThread    = NULL;
+        DeviceThreadRunning = false;
+    }
+
+    if(thread != NULL)
+    {
+        DeviceCallCV.notify_one();
+
+        thread->join();
+        delete thread;
+    }
+}
+
 void RGBController::DeviceSaveMode()
 {
     /*-------------------------------------------------*\
@@ -2158,11 +2828,15 @@ void RGBController::DeviceSaveMode()
 void RGBController::ClearSegments(int zone)
 {
     zones[zone].segments.clear();
+
+    SignalUpdateReason(RGBCONTROLLER_UPDATE_REASON_SEGMENTS);
 }
 
 void RGBController::AddSegment(int zone, segment new_segment)
 {
     zones[zone].segments.push_back(new_segment);
+
+    SignalUpdateReason(RGBCONTROLLER_UPDATE_REASON_SEGMENTS);
 }
 
 std::string device_type_to_str(device_type type)
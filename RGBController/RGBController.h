@@ -13,10 +13,12 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <vector>
 #include <string>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
 #include <mutex>
 
 /*------------------------------------------------------------------*\
@@ -228,13 +230,85 @@ enum
                                                     /* calling update function          */
 };
 
+/*------------------------------------------------------------------*\
+| RGBController Frame Counters                                       |
+|   submitted:  UpdateLEDs() calls                                   |
+|   coalesced:  UpdateLEDs() calls merged into an already pending    |
+|               frame before the device could send it                |
+|   sent:       DeviceUpdateLEDs() calls                             |
+\*------------------------------------------------------------------*/
+typedef struct
+{
+    unsigned long long      submitted;
+    unsigned long long      coalesced;
+    unsigned long long      sent;
+} RGBControllerFrameCounters;
+
+/*------------------------------------------------------------------*\
+| RGBController Device Description Cache                             |
+|   Serialized device description for one protocol version, along    |
+|   with the state it was built from.  colors_offset is the offset   |
+|   of the number of colors field in data.                           |
+\*------------------------------------------------------------------*/
+typedef struct
+{
+    bool                        valid = false;
+    unsigned int                generation;
+    unsigned int                colors_offset;
+    int                         active_mode;
+    std::size_t                 num_modes;
+    std::size_t                 num_zones;
+    std::size_t                 num_leds;
+    std::size_t                 num_colors;
+    std::vector<unsigned char>  data;
+} RGBControllerDescriptionCache;
+
 /*------------------------------------------------------------------*\
 | RGBController Callback Types                                       |
 \*------------------------------------------------------------------*/
 typedef void (*RGBControllerCallback)(void *);
 
+/*------------------------------------------------------------------*\
+| RGBController Update Reasons                                       |
+|   Bit flags passed to update reason callbacks so that listeners    |
+|   can tell what changed and merge several changes into one event   |
+\*------------------------------------------------------------------*/
+enum
+{
+    RGBCONTROLLER_UPDATE_REASON_UPDATELEDS      = (1 << 0), /* Colors changed               */
+    RGBCONTROLLER_UPDATE_REASON_UPDATEMODE      = (1 << 1), /* Active mode or mode changed  */
+    RGBCONTROLLER_UPDATE_REASON_RESIZEZONE      = (1 << 2), /* Zone size changed            */
+    RGBCONTROLLER_UPDATE_REASON_SEGMENTS        = (1 << 3), /* Zone segments changed        */
+};
+
+class RGBController;
+
+typedef void (*RGBControllerUpdateReasonCallback)(void *, RGBController *, unsigned int);
+
 std::string device_type_to_str(device_type type);
 
+/*------------------------------------------------------------------*\
+| RGBController Update Dispatcher                                    |
+|   Runs device updates on behalf of a controller instead of its own |
+|   device call thread.  ScheduleController is called with the       |
+|   controller's call flags set and must eventually invoke           |
+|   RunPendingUpdates() on the controller.  ScheduleControllerAt     |
+|   defers that call until due_time, it is used to hold back a frame |
+|   until the refresh interval has passed without blocking a worker. |
+|   ScheduleController on a deferred controller runs it right away.  |
+\*------------------------------------------------------------------*/
+class RGBControllerUpdateDispatcher
+{
+public:
+    virtual void            AddController(RGBController* controller)                                            = 0;
+    virtual void            RemoveController(RGBController* controller)                                         = 0;
+    virtual bool            ScheduleController(RGBController* controller)                                       = 0;
+    virtual bool            ScheduleControllerAt(RGBController* controller, std::chrono::steady_clock::time_point due_time) = 0;
+
+protected:
+    virtual                 ~RGBControllerUpdateDispatcher() {};
+};
+
 class RGBControllerInterface
 {
 public:
@@ -362,11 +436,19 @@ public:
     unsigned char *         GetDeviceDescription(unsigned int protocol_version);
     void                    ReadDeviceDescription(unsigned char* data_buf, unsigned int protocol_version);
 
+    bool                    GetCachedDeviceDescription(unsigned int protocol_version, std::vector<unsigned char>& data_buf);
+    void                    InvalidateDeviceDescription();
+    unsigned int            GetDescriptionGeneration();
+
     unsigned char *         GetModeDescription(int mode, unsigned int protocol_version);
     void                    SetModeDescription(unsigned char* data_buf, unsigned int protocol_version);
 
     unsigned char *         GetColorDescription();
     void                    SetColorDescription(unsigned char* data_buf);
+    void                    SetColorDescription(const unsigned char* data_buf, unsigned int data_size);
+
+    unsigned char *         GetColorDeltaDescription(const std::vector<RGBColor>& reference_colors);
+    bool                    SetColorDeltaDescription(const unsigned char* data_buf, unsigned int data_size);
 
     unsigned char *         GetZoneColorDescription(int zone);
     void                    SetZoneColorDescription(unsigned char* data_buf);
@@ -382,6 +464,10 @@ public:
     void                    ClearCallbacks();
     void                    SignalUpdate();
 
+    void                    RegisterUpdateReasonCallback(RGBControllerUpdateReasonCallback new_callback, void * new_callback_arg);
+    void                    UnregisterUpdateReasonCallback(void * callback_arg);
+    void                    SignalUpdateReason(unsigned int update_reason);
+
     void                    UpdateLEDs();
     //void                    UpdateZoneLEDs(int zone);
     //void                    UpdateSingleLED(int led);
@@ -391,6 +477,14 @@ public:
 
     void                    DeviceCallThreadFunction();
 
+    void                    SetUpdateDispatcher(RGBControllerUpdateDispatcher* dispatcher);
+    void                    RunPendingUpdates();
+
+    void                    SetMaxRefreshRate(unsigned int max_refresh_rate);
+    unsigned int            GetMaxRefreshRate();
+    RGBControllerFrameCounters
+                            GetFrameCounters();
+
     void                    ClearSegments(int zone);
     void                    AddSegment(int zone, segment new_segment);
 
@@ -411,10 +505,51 @@ public:
     void                    SetCustomMode();
 
 private:
+    unsigned char *         BuildDeviceDescription(unsigned int protocol_version, unsigned int* colors_offset);
+    void                    DispatchUpdate();
+    void                    StopDeviceCallThread();
+    void                    ApplyPendingColors();
+    bool                    RefreshIntervalElapsed(std::chrono::steady_clock::time_point* next_update);
+
+    RGBControllerUpdateDispatcher*  UpdateDispatcher;
     std::thread*            DeviceCallThread;
     std::atomic<bool>       CallFlag_UpdateLEDs;
     std::atomic<bool>       CallFlag_UpdateMode;
     std::atomic<bool>       DeviceThreadRunning;
+    bool                    UpdateDeferred;
+    std::mutex              DeviceCallMutex;
+    std::condition_variable DeviceCallCV;
+
+    /*---------------------------------------------------------*\
+    | Color double buffering                                    |
+    |   ColorMutex is held while the device reads colors.  Full |
+    |   color frames received while it is held are written to   |
+    |   PendingColors and swapped in before the next update.    |
+    |   Only the Set*ColorDescription paths are covered.  Code  |
+    |   writing colors[] directly may still race an update.     |
+    \*---------------------------------------------------------*/
+    std::mutex              ColorMutex;
+    std::mutex              PendingColorsMutex;
+    std::vector<RGBColor>   PendingColors;
+    std::atomic<bool>       PendingColorsValid;
+
+    /*---------------------------------------------------------*\
+    | Rate limiting and frame accounting                        |
+    \*---------------------------------------------------------*/
+    std::atomic<unsigned int>               MaxRefreshRate;
+    std::chrono::steady_clock::time_point   LastLEDUpdateTime;
+    std::atomic<unsigned long long>         FramesSubmitted;
+    std::atomic<unsigned long long>         FramesCoalesced;
+    std::atomic<unsigned long long>         FramesSent;
+
+    /*---------------------------------------------------------*\
+    | Device description cache, indexed by protocol version.    |
+    | DescriptionGeneration is bumped by any change to modes,   |
+    | zones or segments.                                        |
+    \*---------------------------------------------------------*/
+    std::mutex                                              DescriptionCacheMutex;
+    std::atomic<unsigned int>                               DescriptionGeneration;
+    std::map<unsigned int, RGBControllerDescriptionCache>   DescriptionCache;
     //bool                    CallFlag_UpdateZoneLEDs                     = false;
     //bool                    CallFlag_UpdateSingleLED                    = false;
     //bool                    CallFlag_UpdateMode                         = false;
@@ -422,4 +557,7 @@ private:
     std::mutex                          UpdateMutex;
     std::vector<RGBControllerCallback>  UpdateCallbacks;
     std::vector<void *>                 UpdateCallbackArgs;
+
+    std::vector<RGBControllerUpdateReasonCallback>  UpdateReasonCallbacks;
+    std::vector<void *>                             UpdateReasonCallbackArgs;
 };
@@ -14,10 +14,47 @@
 
 #include "RGBController_Network.h"
 
+/*---------------------------------------------------------*\
+| Send a full color frame at least this often so that the   |
+| server converges even if another client or a profile has  |
+| changed the colors underneath the delta reference         |
+\*---------------------------------------------------------*/
+#define DELTA_KEYFRAME_INTERVAL 120
+
 RGBController_Network::RGBController_Network(NetworkClient * client_ptr, unsigned int dev_idx_val)
 {
     client  = client_ptr;
     dev_idx = dev_idx_val;
+
+    frames_since_keyframe = 0;
+    shared_ring           = NULL;
+}
+
+RGBController_Network::~RGBController_Network()
+{
+    delete shared_ring;
+}
+
+unsigned int RGBController_Network::GetDeviceIndex()
+{
+    return(dev_idx);
+}
+
+void RGBController_Network::SetDeltaReference()
+{
+    std::lock_guard<std::mutex> lock(delta_mutex);
+
+    delta_reference       = colors;
+    frames_since_keyframe = 0;
+}
+
+void RGBController_Network::SetSharedColorRing(NetworkSharedColorRing * ring)
+{
+    std::lock_guard<std::mutex> lock(delta_mutex);
+
+    delete shared_ring;
+
+    shared_ring = ring;
 }
 
 void RGBController_Network::SetupZones()
@@ -58,6 +95,59 @@ void RGBController_Network::ResizeZone(int zone, int new_size)
 
 void RGBController_Network::DeviceUpdateLEDs()
 {
+    std::lock_guard<std::mutex> lock(delta_mutex);
+
+    /*---------------------------------------------------------*\
+    | Write the frame into the shared memory ring if there is   |
+    | one.  If the number of LEDs changed, drop the ring and    |
+    | fall back to the socket.                                  |
+    \*---------------------------------------------------------*/
+    if(shared_ring != NULL)
+    {
+        if(shared_ring->GetNumColors() == colors.size())
+        {
+            shared_ring->WriteFrame(colors.data(), (unsigned int)colors.size());
+            return;
+        }
+
+        delete shared_ring;
+        shared_ring = NULL;
+
+        delta_reference.clear();
+    }
+
+    /*---------------------------------------------------------*\
+    | On protocol 7 or higher, send only the LEDs that changed  |
+    | since the last frame when that is smaller than the full   |
+    | frame.  The reference is dropped whenever the number of   |
+    | LEDs changes, forcing a full frame.                       |
+    \*---------------------------------------------------------*/
+    if((client->GetProtocolVersion() >= 7) && (frames_since_keyframe < DELTA_KEYFRAME_INTERVAL))
+    {
+        unsigned char * delta_data = GetColorDeltaDescription(delta_reference);
+
+        if(delta_data != NULL)
+        {
+            unsigned int delta_size;
+            unsigned int full_size = sizeof(unsigned int) + sizeof(unsigned short) + ((unsigned int)colors.size() * sizeof(RGBColor));
+
+            memcpy(&delta_size, &delta_data[0], sizeof(unsigned int));
+
+            if(delta_size < full_size)
+            {
+                client->SendRequest_RGBController_UpdateLEDsDelta(dev_idx, delta_data, delta_size);
+
+                delete[] delta_data;
+
+                delta_reference = colors;
+                frames_since_keyframe++;
+                return;
+            }
+
+            delete[] delta_data;
+        }
+    }
+
     unsigned char * data = GetColorDescription();
     unsigned int size;
 
@@ -66,6 +156,9 @@ void RGBController_Network::DeviceUpdateLEDs()
     client->SendRequest_RGBController_UpdateLEDs(dev_idx, data, size);
 
     delete[] data;
+
+    delta_reference       = colors;
+    frames_since_keyframe = 0;
 }
 
 void RGBController_Network::UpdateZoneLEDs(int zone)
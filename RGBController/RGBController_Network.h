@@ -14,11 +14,17 @@
 
 #include "RGBController.h"
 #include "NetworkClient.h"
+#include "NetworkSharedMemory.h"
 
 class RGBController_Network : public RGBController
 {
 public:
     RGBController_Network(NetworkClient * client_ptr, unsigned int dev_idx_val);
+    ~RGBController_Network();
+
+    unsigned int GetDeviceIndex();
+    void        SetDeltaReference();
+    void        SetSharedColorRing(NetworkSharedColorRing * ring);
 
     void        SetupZones();
 
@@ -39,4 +45,17 @@ public:
 private:
     NetworkClient *     client;
     unsigned int        dev_idx;
+
+    /*-----------------------------------------------------*\
+    | Last color frame sent to the server, used as the      |
+    | reference for delta-encoded updates                   |
+    \*-----------------------------------------------------*/
+    std::mutex              delta_mutex;
+    std::vector<RGBColor>   delta_reference;
+    unsigned int            frames_since_keyframe;
+
+    /*-----------------------------------------------------*\
+    | Shared memory color ring, if the server offered one   |
+    \*-----------------------------------------------------*/
+    NetworkSharedColorRing *    shared_ring;
 };
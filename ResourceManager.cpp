@@ -16,11 +16,19 @@
 #include <locale>
 #endif
 
+#include <algorithm>
+#include <condition_variable>
+#include <map>
 #include <stdlib.h>
 #include <string>
+#include <unordered_set>
 #include <hidapi.h>
 #include "cli.h"
 #include "pci_ids/pci_ids.h"
+#include "DetectionCache.h"
+#include "DeviceUpdatePool.h"
+#include "HIDHotplugMonitor.h"
+#include "hidapi_wrapper_debug.h"
 #include "ResourceManager.h"
 #include "ProfileManager.h"
 #include "LogManager.h"
@@ -29,6 +37,7 @@
 #include "NetworkServer.h"
 #include "filesystem.h"
 #include "StringUtils.h"
+#include "dmiinfo.h"
 
 /*-------------------------------------------------------------------------*\
 | Translation Strings                                                       |
@@ -79,6 +88,39 @@ const hidapi_wrapper default_wrapper =
     (hidapi_wrapper_error)                      hid_error
 };
 
+#ifdef __linux__
+#ifdef __GLIBC__
+/*---------------------------------------------------------*\
+| Load the libhidapi-libusb library and fill in a wrapper   |
+| with its functions.  Returns false if it is not present.  |
+\*---------------------------------------------------------*/
+static bool LoadLibusbHIDWrapper(hidapi_wrapper& wrapper)
+{
+    void* dyn_handle = dlopen("libhidapi-libusb.so", RTLD_NOW | RTLD_NODELETE | RTLD_DEEPBIND);
+
+    if(dyn_handle == NULL)
+    {
+        return(false);
+    }
+
+    wrapper =
+    {
+        .dyn_handle                     = dyn_handle,
+        .hid_send_feature_report        = (hidapi_wrapper_send_feature_report)          dlsym(dyn_handle,"hid_send_feature_report"),
+        .hid_get_feature_report         = (hidapi_wrapper_get_feature_report)           dlsym(dyn_handle,"hid_get_feature_report"),
+        .hid_get_serial_number_string   = (hidapi_wrapper_get_serial_number_string)     dlsym(dyn_handle,"hid_get_serial_number_string"),
+        .hid_open_path                  = (hidapi_wrapper_open_path)                    dlsym(dyn_handle,"hid_open_path"),
+        .hid_enumerate                  = (hidapi_wrapper_enumerate)                    dlsym(dyn_handle,"hid_enumerate"),
+        .hid_free_enumeration           = (hidapi_wrapper_free_enumeration)             dlsym(dyn_handle,"hid_free_enumeration"),
+        .hid_close                      = (hidapi_wrapper_close)                        dlsym(dyn_handle,"hid_close"),
+        .hid_error                      = (hidapi_wrapper_error)                        dlsym(dyn_handle,"hid_free_enumeration")
+    };
+
+    return(true);
+}
+#endif
+#endif
+
 bool BasicHIDBlock::compare(hid_device_info* info)
 {
     return ( (vid == info->vendor_id)
@@ -97,6 +139,20 @@ bool BasicHIDBlock::compare(hid_device_info* info)
             );
 }
 
+/*---------------------------------------------------------*\
+| Key used to index HID detectors by VID:PID                |
+\*---------------------------------------------------------*/
+static uint32_t HIDDetectorKey(uint16_t vid, uint16_t pid)
+{
+    return(((uint32_t)vid << 16) | pid);
+}
+
+/*---------------------------------------------------------*\
+| Detection job run by the current thread, if any, so that  |
+| RegisterRGBController can attribute controllers to it     |
+\*---------------------------------------------------------*/
+static thread_local DetectionJob* current_detection_job = NULL;
+
 ResourceManager* ResourceManager::instance;
 
 using namespace std::chrono_literals;
@@ -123,6 +179,10 @@ ResourceManager::ResourceManager()
     dynamic_detectors_processed = false;
     init_finished               = false;
     background_thread_running    = true;
+    detection_cache             = new DetectionCache();
+    detection_phase             = DETECTION_PHASE_FULL;
+    detection_cache_checked     = false;
+    hid_hotplug_monitor         = NULL;
 
     /*-------------------------------------------------------------------------*\
     | Start the background detection thread in advance; it will be suspended    |
@@ -144,6 +204,54 @@ ResourceManager::ResourceManager()
     \*-------------------------------------------------------------------------*/
     LogManager::get()->configure(settings_manager->GetSettings("LogManager"), GetConfigurationDirectory());
 
+    /*-------------------------------------------------------------------------*\
+    | Initialize the shared device update pool                                  |
+    |   Local hardware controllers run their DeviceUpdateLEDs/DeviceUpdateMode  |
+    |   calls on this pool instead of on one thread per controller              |
+    \*-------------------------------------------------------------------------*/
+    json update_pool_settings   = settings_manager->GetSettings("DeviceUpdatePool");
+    bool update_pool_enabled    = true;
+    int  thread_count           = std::min((int)std::thread::hardware_concurrency(), 8);
+    int  network_thread_count   = 4;
+    int  queue_depth            = 1024;
+
+    if(update_pool_settings.contains("enabled"))
+    {
+        update_pool_enabled     = update_pool_settings["enabled"];
+    }
+
+    if(update_pool_settings.contains("thread_count"))
+    {
+        thread_count            = update_pool_settings["thread_count"];
+    }
+
+    if(update_pool_settings.contains("network_thread_count"))
+    {
+        network_thread_count    = update_pool_settings["network_thread_count"];
+    }
+
+    if(update_pool_settings.contains("queue_depth"))
+    {
+        queue_depth             = update_pool_settings["queue_depth"];
+    }
+
+    /*-------------------------------------------------------------------------*\
+    | Keep the settings in a sane range, negative values would otherwise turn   |
+    | into huge thread counts and queue depths                                  |
+    \*-------------------------------------------------------------------------*/
+    thread_count                = std::max(1, std::min(thread_count, 64));
+    network_thread_count        = std::max(1, std::min(network_thread_count, 64));
+    queue_depth                 = std::max(1, std::min(queue_depth, 65536));
+
+    if(update_pool_enabled)
+    {
+        update_pool             = new DeviceUpdatePool(thread_count, network_thread_count, queue_depth);
+    }
+    else
+    {
+        update_pool             = NULL;
+    }
+
     /*-------------------------------------------------------------------------*\
     | Initialize Server Instance                                                |
     |   If configured, pass through full controller list including clients      |
@@ -167,6 +275,8 @@ ResourceManager::ResourceManager()
         server              = new NetworkServer(rgb_controllers_hw);
     }
 
+    server->SetControllersMutex(&DeviceListChangeMutex);
+
     /*-------------------------------------------------------------------------*\
     | Enable legacy SDK workaround in server if configured                      |
     \*-------------------------------------------------------------------------*/
@@ -180,6 +290,41 @@ ResourceManager::ResourceManager()
         server->SetLegacyWorkaroundEnable(true);
     }
 
+    /*-------------------------------------------------------------------------*\
+    | Enable single-threaded event loop server mode if configured               |
+    \*-------------------------------------------------------------------------*/
+    if(server_settings.contains("event_loop"))
+    {
+        server->SetEventLoopEnable(server_settings["event_loop"]);
+    }
+
+    /*-------------------------------------------------------------------------*\
+    | Offer shared memory color rings to local SDK clients if configured        |
+    \*-------------------------------------------------------------------------*/
+    if(server_settings.contains("shared_memory"))
+    {
+        server->SetSharedMemoryEnable(server_settings["shared_memory"]);
+    }
+
+    /*-------------------------------------------------------------------------*\
+    | Shared memory segments are only accessible to the server's user by        |
+    | default.  A server running as root needs a wider mode, given as an octal  |
+    | string such as "0660", for clients running as other users.                |
+    \*-------------------------------------------------------------------------*/
+    if(server_settings.contains("shared_memory_mode"))
+    {
+        if(server_settings["shared_memory_mode"].is_string())
+        {
+            std::string mode_string = server_settings["shared_memory_mode"];
+
+            server->SetSharedMemoryMode((unsigned int)strtoul(mode_string.c_str(), NULL, 8));
+        }
+        else if(server_settings["shared_memory_mode"].is_number_unsigned())
+        {
+            server->SetSharedMemoryMode(server_settings["shared_memory_mode"]);
+        }
+    }
+
     /*-------------------------------------------------------------------------*\
     | Initialize Saved Client Connections                                       |
     \*-------------------------------------------------------------------------*/
@@ -201,6 +346,16 @@ ResourceManager::ResourceManager()
             client->SetName(titleString.c_str());
             client->SetPort(client_port);
 
+            if(client_settings.contains("shared_memory"))
+            {
+                client->SetSharedMemoryEnable(client_settings["shared_memory"]);
+            }
+
+            if(client_settings.contains("color_updates"))
+            {
+                client->SetColorUpdatesEnable(client_settings["color_updates"]);
+            }
+
             client->StartClient();
 
             for(int timeout = 0; timeout < 100; timeout++)
@@ -226,6 +381,12 @@ ResourceManager::ResourceManager()
 
 ResourceManager::~ResourceManager()
 {
+    /*-------------------------------------------------------------------------*\
+    | Stop handling hotplug events before the controllers are deleted           |
+    \*-------------------------------------------------------------------------*/
+    delete hid_hotplug_monitor;
+    hid_hotplug_monitor = NULL;
+
     Cleanup();
 
     // Mark the background detection thread as not running
@@ -240,6 +401,15 @@ ResourceManager::~ResourceManager()
         delete DetectDevicesThread;
         DetectDevicesThread = nullptr;
     }
+
+    /*-------------------------------------------------------------------------*\
+    | Stop the update pool after all local controllers are deleted              |
+    \*-------------------------------------------------------------------------*/
+    delete update_pool;
+    update_pool = NULL;
+
+    delete detection_cache;
+    detection_cache = NULL;
 }
 
 void ResourceManager::RegisterI2CBus(i2c_smbus_interface *bus)
@@ -255,6 +425,22 @@ std::vector<i2c_smbus_interface*> & ResourceManager::GetI2CBusses()
 
 void ResourceManager::RegisterRGBController(RGBController *rgb_controller)
 {
+    /*-------------------------------------------------*\
+    | Controllers found by a detection job running in   |
+    | parallel are registered once all jobs are done    |
+    \*-------------------------------------------------*/
+    if(current_detection_job != NULL)
+    {
+        current_detection_job->controllers_found++;
+        current_detection_job->locations.push_back(rgb_controller->location);
+
+        if(current_detection_job->defer_registration)
+        {
+            current_detection_job->controllers.push_back(rgb_controller);
+            return;
+        }
+    }
+
     /*-------------------------------------------------*\
     | Mark this controller as locally owned             |
     \*-------------------------------------------------*/
@@ -262,7 +448,38 @@ void ResourceManager::RegisterRGBController(RGBController *rgb_controller)
     rgb_controller->flags |= CONTROLLER_FLAG_LOCAL;
 
     LOG_INFO("[%s] Registering RGB controller", rgb_controller->name.c_str());
+
+    DeviceListChangeMutex.lock();
     rgb_controllers_hw.push_back(rgb_controller);
+    DeviceListChangeMutex.unlock();
+
+    /*-------------------------------------------------*\
+    | Apply the configured refresh rate limit, a per    |
+    | location entry overrides the default              |
+    \*-------------------------------------------------*/
+    json update_pool_settings   = settings_manager->GetSettings("DeviceUpdatePool");
+    unsigned int max_refresh_rate = 0;
+
+    if(update_pool_settings.contains("max_refresh_rate"))
+    {
+        max_refresh_rate        = update_pool_settings["max_refresh_rate"];
+    }
+
+    if(update_pool_settings.contains("max_refresh_rates")
+    && update_pool_settings["max_refresh_rates"].contains(rgb_controller->location))
+    {
+        max_refresh_rate        = update_pool_settings["max_refresh_rates"][rgb_controller->location];
+    }
+
+    rgb_controller->SetMaxRefreshRate(max_refresh_rate);
+
+    /*-------------------------------------------------*\
+    | Run device updates on the shared update pool      |
+    \*-------------------------------------------------*/
+    if(update_pool != NULL)
+    {
+        rgb_controller->SetUpdateDispatcher(update_pool);
+    }
 
     /*-------------------------------------------------*\
     | If the device list size has changed, call the     |
@@ -301,13 +518,29 @@ void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
     rgb_controller->ClearCallbacks();
 
     /*-------------------------------------------------------------------------*\
-    | Find the controller to remove and remove it from the hardware list        |
+    | Detach the controller from the update pool, it falls back to its own      |
+    | device call thread if it is updated after removal                         |
     \*-------------------------------------------------------------------------*/
+    rgb_controller->SetUpdateDispatcher(NULL);
+
+    /*-------------------------------------------------------------------------*\
+    | Find the controller to remove and remove it from the hardware list.  The  |
+    | lists are changed under the device list mutex, the SDK server reads them  |
+    | under it while sending controller updates                                 |
+    \*-------------------------------------------------------------------------*/
+    DeviceListChangeMutex.lock();
+
     std::vector<RGBController*>::iterator hw_it = std::find(rgb_controllers_hw.begin(), rgb_controllers_hw.end(), rgb_controller);
 
     if (hw_it != rgb_controllers_hw.end())
     {
         rgb_controllers_hw.erase(hw_it);
+
+        /*---------------------------------------------------------------------*\
+        | Keep the previous size in step so that sizes are still loaded for     |
+        | controllers registered after this one was removed                     |
+        \*---------------------------------------------------------------------*/
+        detection_prev_size = (unsigned int)rgb_controllers_hw.size();
     }
 
     /*-------------------------------------------------------------------------*\
@@ -320,6 +553,8 @@ void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
         rgb_controllers.erase(rgb_it);
     }
 
+    DeviceListChangeMutex.unlock();
+
     UpdateDeviceList();
 }
 
@@ -370,6 +605,14 @@ void ResourceManager::RegisterDeviceDetector(std::string name, DeviceDetectorFun
 {
     device_detector_strings.push_back(name);
     device_detectors.push_back(detector);
+    device_detector_network.push_back(false);
+}
+
+void ResourceManager::RegisterNetworkDeviceDetector(std::string name, DeviceDetectorFunction detector)
+{
+    device_detector_strings.push_back(name);
+    device_detectors.push_back(detector);
+    device_detector_network.push_back(true);
 }
 
 void ResourceManager::RegisterHIDDeviceDetector(std::string name,
@@ -390,6 +633,7 @@ void ResourceManager::RegisterHIDDeviceDetector(std::string name,
     block.usage_page    = usage_page;
     block.usage         = usage;
 
+    hid_device_detector_index[HIDDetectorKey(vid, pid)].push_back((unsigned int)hid_device_detectors.size());
     hid_device_detectors.push_back(block);
 }
 
@@ -411,6 +655,7 @@ void ResourceManager::RegisterHIDWrappedDeviceDetector(std::string name,
     block.usage_page    = usage_page;
     block.usage         = usage;
 
+    hid_wrapped_device_detector_index[HIDDetectorKey(vid, pid)].push_back((unsigned int)hid_wrapped_device_detectors.size());
     hid_wrapped_device_detectors.push_back(block);
 }
 
@@ -689,6 +934,11 @@ NetworkServer* ResourceManager::GetServer()
     return(server);
 }
 
+DeviceUpdatePool* ResourceManager::GetDeviceUpdatePool()
+{
+    return(update_pool);
+}
+
 static void NetworkClientInfoChangeCallback(void* this_ptr)
 {
     ResourceManager* this_obj = (ResourceManager*)this_ptr;
@@ -828,6 +1078,11 @@ unsigned int ResourceManager::GetDetectionPercent()
     return (detection_percent.load());
 }
 
+int ResourceManager::GetDetectionPhase()
+{
+    return(detection_phase.load());
+}
+
 const char *ResourceManager::GetDetectionString()
 {
     return (detection_string);
@@ -837,6 +1092,8 @@ void ResourceManager::Cleanup()
 {
     ResourceManager::get()->WaitForDeviceDetection();
 
+    DeviceListChangeMutex.lock();
+
     std::vector<RGBController *> rgb_controllers_hw_copy = rgb_controllers_hw;
 
     for(std::size_t hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw.size(); hw_controller_idx++)
@@ -858,6 +1115,8 @@ void ResourceManager::Cleanup()
     rgb_controllers_hw.clear();
     detection_prev_size = 0;
 
+    DeviceListChangeMutex.unlock();
+
     for(RGBController* rgb_controller : rgb_controllers_hw_copy)
     {
         delete rgb_controller;
@@ -937,6 +1196,13 @@ bool ResourceManager::ProcessPreDetection()
             return false;
         }
 
+        /*-------------------------------------------------*\
+        | A new detection always starts with all detectors, |
+        | this also cancels a pending cached detection      |
+        | second pass                                       |
+        \*-------------------------------------------------*/
+        detection_phase = DETECTION_PHASE_FULL;
+
         /*-------------------------------------------------*\
         | If there's anything left from the last time,      |
         | we shall remove it first                          |
@@ -1015,26 +1281,36 @@ void ResourceManager::DetectDevicesCoroutine()
 {
     DetectDeviceMutex.lock();
 
-    hid_device_info*    current_hid_device;
-    float               percent             = 0.0f;
-    float               percent_denominator = 0.0f;
-    json                detector_settings;
-    unsigned int        hid_device_count    = 0;
-    hid_device_info*    hid_devices         = NULL;
-    bool                hid_safe_mode       = false;
+    hid_device_info*                        current_hid_device;
+    json                                    detector_settings;
+    hid_device_info*                        hid_devices         = NULL;
+    bool                                    hid_safe_mode       = false;
+    bool                                    parallel_detection  = false;
+    bool                                    detection_cache_enabled = false;
+    int                                     phase               = detection_phase;
+    std::vector<DetectionJob>               jobs;
+    std::vector<std::vector<SPDWrapper>>    dimm_slots;
+    std::vector<i2c_smbus_interface*>       detection_busses;
+    std::atomic<bool>                       detection_busses_probed(false);
+    std::chrono::steady_clock::time_point   detection_start_time = std::chrono::steady_clock::now();
 
     LOG_INFO("------------------------------------------------------");
     LOG_INFO("|               Start device detection               |");
     LOG_INFO("------------------------------------------------------");
 
     /*-------------------------------------------------*\
-    | Reset the size entry used flags vector            |
+    | Reset the size entry used flags vector.  The      |
+    | second pass after a cached pass keeps the flags   |
+    | of the controllers found by the first pass.       |
     \*-------------------------------------------------*/
-    detection_size_entry_used.resize(rgb_controllers_sizes.size());
-
-    for(std::size_t size_idx = 0; size_idx < (unsigned int)detection_size_entry_used.size(); size_idx++)
+    if(phase != DETECTION_PHASE_REMAINING)
     {
-        detection_size_entry_used[size_idx] = false;
+        detection_size_entry_used.resize(rgb_controllers_sizes.size());
+
+        for(std::size_t size_idx = 0; size_idx < (unsigned int)detection_size_entry_used.size(); size_idx++)
+        {
+            detection_size_entry_used[size_idx] = false;
+        }
     }
 
     /*-------------------------------------------------*\
@@ -1052,28 +1328,32 @@ void ResourceManager::DetectDevicesCoroutine()
     }
 
     /*-------------------------------------------------*\
-    | Calculate the percentage denominator by adding    |
-    | the number of I2C and miscellaneous detectors and |
-    | the number of enumerated HID devices              |
-    |                                                   |
-    | Start by iterating through all HID devices in     |
-    | list to get a total count                         |
+    | Check parallel detection setting                  |
     \*-------------------------------------------------*/
-    if(!hid_safe_mode)
+    if(detector_settings.contains("parallel_detection"))
     {
-        hid_devices = hid_enumerate(0, 0);
+        parallel_detection = detector_settings["parallel_detection"];
     }
 
-    current_hid_device = hid_devices;
-
-    while(current_hid_device)
+    /*-------------------------------------------------*\
+    | Check detection cache setting                     |
+    \*-------------------------------------------------*/
+    if(detector_settings.contains("detection_cache"))
     {
-        hid_device_count++;
-
-        current_hid_device = current_hid_device->next;
+        detection_cache_enabled = detector_settings["detection_cache"];
     }
 
-    percent_denominator = (float)(i2c_device_detectors.size() + i2c_dimm_device_detectors.size() + i2c_pci_device_detectors.size() + device_detectors.size()) + (float)hid_device_count;
+    /*-------------------------------------------------*\
+    | Clear the HID detector enable flags cached during |
+    | the previous detection pass                       |
+    \*-------------------------------------------------*/
+    ResetHIDDetectorsEnabled();
+
+    if(phase != DETECTION_PHASE_REMAINING)
+    {
+        std::lock_guard<std::mutex> lock(DetectorTimingsMutex);
+        detector_timings.clear();
+    }
 
     /*-------------------------------------------------*\
     | Start at 0% detection progress                    |
@@ -1104,7 +1384,9 @@ void ResourceManager::DetectDevicesCoroutine()
 #endif
 
     /*-------------------------------------------------*\
-    | Detect i2c interfaces                             |
+    | Detect i2c interfaces.  The bus list is needed by |
+    | all I2C detectors, so this runs before any other  |
+    | detection.                                        |
     \*-------------------------------------------------*/
     LOG_INFO("------------------------------------------------------");
     LOG_INFO("|             Detecting I2C interfaces               |");
@@ -1112,7 +1394,11 @@ void ResourceManager::DetectDevicesCoroutine()
 
     bool i2c_interface_fail = false;
 
-    for(unsigned int i2c_bus_detector_idx = 0; i2c_bus_detector_idx < (unsigned int)i2c_bus_detectors.size() && detection_is_required.load(); i2c_bus_detector_idx++)
+    /*-------------------------------------------------*\
+    | The second pass after a cached pass reuses the    |
+    | busses detected by the first pass                 |
+    \*-------------------------------------------------*/
+    for(unsigned int i2c_bus_detector_idx = 0; i2c_bus_detector_idx < (unsigned int)i2c_bus_detectors.size() && detection_is_required.load() && phase != DETECTION_PHASE_REMAINING; i2c_bus_detector_idx++)
     {
         if(i2c_bus_detectors[i2c_bus_detector_idx]() == false)
         {
@@ -1123,539 +1409,1624 @@ void ResourceManager::DetectDevicesCoroutine()
     }
 
     /*-------------------------------------------------*\
-    | Detect i2c devices                                |
+    | Start a new address presence map on every bus.    |
+    | Whether a bus answered is tracked over both       |
+    | passes of a cached detection.                     |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|               Detecting I2C devices                |");
-    LOG_INFO("------------------------------------------------------");
-    for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
+    for(unsigned int bus = 0; bus < busses.size(); bus++)
+    {
+        busses[bus]->i2c_smbus_clear_presence();
+
+        if(phase != DETECTION_PHASE_REMAINING)
+        {
+            busses[bus]->i2c_smbus_clear_responded();
+        }
+    }
+
+    /*-------------------------------------------------*\
+    | Queue i2c device detectors.  These detectors are  |
+    | given every bus, so all I2C detection shares one  |
+    | lane.  The bus list is filled in once the         |
+    | detection phase is known, see below.              |
+    \*-------------------------------------------------*/
+    for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_device_detectors.size(); i2c_detector_idx++)
     {
-        std::size_t controller_size = rgb_controllers_hw.size();
-        detection_string = i2c_device_detector_strings[i2c_detector_idx].c_str();
+        const char* detector_name = i2c_device_detector_strings[i2c_detector_idx].c_str();
 
         /*-------------------------------------------------*\
         | Check if this detector is enabled                 |
         \*-------------------------------------------------*/
         bool this_device_enabled = true;
-        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
+        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name))
         {
-            this_device_enabled = detector_settings["detectors"][detection_string];
+            this_device_enabled = detector_settings["detectors"][detector_name];
         }
 
-        LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
-        if(this_device_enabled)
-        {
-            DetectionProgressChanged();
-
-            i2c_device_detectors[i2c_detector_idx](busses);
-        }
+        LOG_DEBUG("[%s] is %s", detector_name, ((this_device_enabled == true) ? "enabled" : "disabled"));
 
-        /*-------------------------------------------------*\
-        | If the device list size has changed, call the     |
-        | device list changed callbacks                     |
-        \*-------------------------------------------------*/
-        if(rgb_controllers_hw.size() == controller_size)
+        if(this_device_enabled)
         {
-            LOG_DEBUG("[%s] no devices found", detection_string);
-        }
+            DetectionJob job;
 
-        LOG_TRACE("[%s] detection end", detection_string);
+            job.lane        = "I2C";
+            job.category    = DETECTION_CATEGORY_I2C;
+            job.function    = [this, i2c_detector_idx, &detection_busses, &detection_busses_probed]()
+            {
+                RunDetector(i2c_device_detector_strings[i2c_detector_idx], [this, i2c_detector_idx, &detection_busses, &detection_busses_probed]()
+                {
+                    detection_busses_probed = true;
 
-        /*-------------------------------------------------*\
-        | Update detection percent                          |
-        \*-------------------------------------------------*/
-        percent = ((float)i2c_detector_idx + 1.0f) / percent_denominator;
+                    i2c_device_detectors[i2c_detector_idx](detection_busses);
+                });
+            };
 
-        detection_percent = (unsigned int)(percent * 100.0f);
+            jobs.push_back(job);
+        }
     }
 
     /*-------------------------------------------------*\
-    | Detect i2c DIMM modules                           |
+    | Queue i2c DIMM module detection.  It runs in the  |
+    | I2C lane after the i2c device detectors, as it    |
+    | did before detection was split into jobs.  The    |
+    | SPD of all slots is read once and shared by all   |
+    | DIMM detectors.  It is skipped if no DIMM         |
+    | detector runs in this detection phase, which is   |
+    | only known once the job runs.                     |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|            Detecting I2C DIMM modules              |");
-    LOG_INFO("------------------------------------------------------");
-    for(unsigned int bus = 0; bus < busses.size() && IsAnyDimmDetectorEnabled(detector_settings); bus++)
+    if(IsAnyDimmDetectorEnabled(detector_settings))
     {
-        IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
+        DetectionJob job;
+
+        job.lane        = "I2C";
+        job.category    = DETECTION_CATEGORY_I2C;
+        job.function    = [this, &dimm_slots, &detector_settings, parallel_detection]()
         {
-            std::vector<SPDWrapper> slots;
-            SPDMemoryType dimm_type = SPD_RESERVED;
+            bool any_dimm_detector_in_phase = false;
 
-            for(uint8_t spd_addr = 0x50; spd_addr < 0x58; spd_addr++)
+            for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < i2c_dimm_device_detectors.size(); i2c_detector_idx++)
             {
-                SPDDetector spd(busses[bus], spd_addr, dimm_type);
-                if(spd.is_valid())
+                if(IsDetectorInPhase(i2c_dimm_device_detectors[i2c_detector_idx].name))
                 {
-                    SPDWrapper accessor(spd);
-                    dimm_type = spd.memory_type();
-                    LOG_INFO("[ResourceManager] Detected occupied slot %d, bus %d, type %s", spd_addr - 0x50 + 1, bus, spd_memory_type_name[dimm_type]);
-                    LOG_DEBUG("[ResourceManager] Jedec ID: 0x%04x", accessor.jedec_id());
-                    slots.push_back(accessor);
+                    any_dimm_detector_in_phase = true;
+                    break;
                 }
             }
 
-            for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < i2c_dimm_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
+            if(!any_dimm_detector_in_phase)
             {
-                if(i2c_dimm_device_detectors[i2c_detector_idx].dimm_type == dimm_type &&
-                   is_jedec_in_slots(slots, i2c_dimm_device_detectors[i2c_detector_idx].jedec_id))
-                {
-                    detection_string = i2c_dimm_device_detectors[i2c_detector_idx].name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled                 |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
+                return;
+            }
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
+            dimm_slots.resize(busses.size());
 
-                        std::vector<SPDWrapper*> matching_slots = slots_with_jedec(slots, i2c_dimm_device_detectors[i2c_detector_idx].jedec_id);
-                        i2c_dimm_device_detectors[i2c_detector_idx].function(busses[bus], matching_slots);
-                    }
+            ProbeDIMMSlots(dimm_slots, parallel_detection);
 
-                    LOG_TRACE("[%s] detection end", detection_string);
+            for(unsigned int bus = 0; bus < busses.size() && detection_is_required.load(); bus++)
+            {
+                if(!dimm_slots[bus].empty())
+                {
+                    DetectDIMMBus(bus, dimm_slots[bus], detector_settings);
                 }
-
-                /*-------------------------------------------------*\
-                | Update detection percent                          |
-                \*-------------------------------------------------*/
-                percent = (i2c_device_detectors.size() + i2c_detector_idx + 1.0f) / percent_denominator;
-
-                detection_percent = (unsigned int)(percent * 100.0f);
             }
-        }
+        };
+
+        jobs.push_back(job);
     }
 
     /*-------------------------------------------------*\
-    | Detect i2c PCI devices                            |
+    | Queue i2c PCI device detectors                    |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|               Detecting I2C PCI devices            |");
-    LOG_INFO("------------------------------------------------------");
-    for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_pci_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
+    for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_pci_device_detectors.size(); i2c_detector_idx++)
     {
-        detection_string = i2c_pci_device_detectors[i2c_detector_idx].name.c_str();
+        const char* detector_name = i2c_pci_device_detectors[i2c_detector_idx].name.c_str();
 
         /*-------------------------------------------------*\
         | Check if this detector is enabled                 |
         \*-------------------------------------------------*/
         bool this_device_enabled = true;
-        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
+        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name))
         {
-            this_device_enabled = detector_settings["detectors"][detection_string];
+            this_device_enabled = detector_settings["detectors"][detector_name];
         }
 
-        LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+        LOG_DEBUG("[%s] is %s", detector_name, ((this_device_enabled == true) ? "enabled" : "disabled"));
+
         if(this_device_enabled)
         {
-            DetectionProgressChanged();
+            DetectionJob job;
 
-            for(unsigned int bus = 0; bus < busses.size(); bus++)
+            job.lane        = "I2C";
+            job.category    = DETECTION_CATEGORY_I2C;
+            job.function    = [this, i2c_detector_idx]()
             {
-                if(busses[bus]->pci_vendor           == i2c_pci_device_detectors[i2c_detector_idx].ven_id    &&
-                   busses[bus]->pci_device           == i2c_pci_device_detectors[i2c_detector_idx].dev_id    &&
-                   busses[bus]->pci_subsystem_vendor == i2c_pci_device_detectors[i2c_detector_idx].subven_id &&
-                   busses[bus]->pci_subsystem_device == i2c_pci_device_detectors[i2c_detector_idx].subdev_id)
-                {
-                    i2c_pci_device_detectors[i2c_detector_idx].function(busses[bus], i2c_pci_device_detectors[i2c_detector_idx].i2c_addr, i2c_pci_device_detectors[i2c_detector_idx].name);
-                }
-            }
-        }
-
-        LOG_TRACE("[%s] detection end", detection_string);
+                I2CPCIDeviceDetectorBlock & detector = i2c_pci_device_detectors[i2c_detector_idx];
 
-        /*-------------------------------------------------*\
-        | Update detection percent                          |
-        \*-------------------------------------------------*/
-        percent = (i2c_device_detectors.size() + i2c_dimm_device_detectors.size() + i2c_detector_idx + 1.0f) / percent_denominator;
+                RunDetector(detector.name, [this, &detector]()
+                {
+                    for(unsigned int bus = 0; bus < busses.size(); bus++)
+                    {
+                        if(busses[bus]->pci_vendor           == detector.ven_id    &&
+                           busses[bus]->pci_device           == detector.dev_id    &&
+                           busses[bus]->pci_subsystem_vendor == detector.subven_id &&
+                           busses[bus]->pci_subsystem_device == detector.subdev_id)
+                        {
+                            detector.function(busses[bus], detector.i2c_addr, detector.name);
+                        }
+                    }
+                });
+            };
 
-        detection_percent = (unsigned int)(percent * 100.0f);
+            jobs.push_back(job);
+        }
     }
 
     /*-------------------------------------------------*\
-    | Detect HID devices                                |
-    |                                                   |
-    | Reset current device pointer to first device      |
+    | Queue HID device detection.  In safe mode all HID |
+    | detectors run one at a time in a single job.      |
+    | Otherwise there is one job per enumerated device, |
+    | and devices sharing a VID:PID share a lane.       |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|               Detecting HID devices                |");
-    if (hid_safe_mode)
-    LOG_INFO("|                  with safe mode                    |");
-    LOG_INFO("------------------------------------------------------");
-    current_hid_device = hid_devices;
+    std::chrono::steady_clock::time_point hid_enumerate_start_time = std::chrono::steady_clock::now();
 
     if(hid_safe_mode)
     {
-        /*-----------------------------------------------------------------------------*\
-        | Loop through all available detectors.  If all required information matches,   |
-        | run the detector                                                              |
-        \*-----------------------------------------------------------------------------*/
-        for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
+        DetectionJob job;
+
+        job.lane        = "HID";
+        job.category    = DETECTION_CATEGORY_HID;
+        job.function    = [this, &detector_settings]()
+        {
+            DetectHIDDevicesSafeMode(detector_settings);
+        };
+
+        jobs.push_back(job);
+    }
+    else
+    {
+        hid_devices = hid_enumerate(0, 0);
+
+        for(current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
         {
-            HIDDeviceDetectorBlock & detector = hid_device_detectors[hid_detector_idx];
-            hid_devices = hid_enumerate(detector.vid, detector.pid);
+            char lane[16];
 
-            LOG_VERBOSE("[ResourceManager] Trying to run detector for [%s] (for %04x:%04x)", detector.name.c_str(), detector.vid, detector.pid);
+            snprintf(lane, sizeof(lane), "HID %04X:%04X", current_hid_device->vendor_id, current_hid_device->product_id);
 
-            current_hid_device = hid_devices;
+            DetectionJob job;
 
-            while(current_hid_device)
+            job.lane        = lane;
+            job.category    = DETECTION_CATEGORY_HID;
+            job.function    = [this, current_hid_device, &detector_settings]()
             {
+                DetectHIDDevice(default_wrapper, current_hid_device, detector_settings, false);
+            };
 
-                if(detector.compare(current_hid_device))
-                {
-                    detection_string = detector.name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
+            jobs.push_back(job);
+        }
+    }
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+#ifdef __linux__
+#ifdef __GLIBC__
+    hidapi_wrapper  wrapper;
+    hid_device_info*libusb_hid_devices  = NULL;
 
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
+    /*-------------------------------------------------*\
+    | Load the libhidapi-libusb library                 |
+    \*-------------------------------------------------*/
+    if(LoadLibusbHIDWrapper(wrapper))
+    {
+        libusb_hid_devices = wrapper.hid_enumerate(0, 0);
 
-                        detector.function(current_hid_device, hid_device_detectors[hid_detector_idx].name);
+        /*-------------------------------------------------*\
+        | Queue one job per libusb HID device, in the same  |
+        | lane as its hidraw counterpart                    |
+        \*-------------------------------------------------*/
+        for(current_hid_device = libusb_hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+        {
+            char lane[16];
 
-                        LOG_TRACE("[%s] detection end", detection_string);
-                    }
-                }
+            snprintf(lane, sizeof(lane), "HID %04X:%04X", current_hid_device->vendor_id, current_hid_device->product_id);
 
-                current_hid_device = current_hid_device->next;
-            }
+            DetectionJob job;
+
+            job.lane        = lane;
+            job.category    = DETECTION_CATEGORY_HID;
+            job.function    = [this, wrapper, current_hid_device, &detector_settings]()
+            {
+                DetectHIDDevice(wrapper, current_hid_device, detector_settings, true);
+            };
 
-            hid_free_enumeration(hid_devices);
+            jobs.push_back(job);
         }
     }
-    else
+#endif
+#endif
+
+    /*-------------------------------------------------*\
+    | Queue one job per simulated HID device listed in  |
+    | the DebugDevices settings.  They are only visible |
+    | to the detectors using the hidapi wrapper.        |
+    \*-------------------------------------------------*/
+    hid_device_info*    debug_hid_devices   = NULL;
+    json                debug_settings      = settings_manager->GetSettings("DebugDevices");
+
+    if(debug_settings.contains("hid_devices") && hidapi_wrapper_debug_load(debug_settings["hid_devices"]) > 0)
     {
-        /*-------------------------------------------------*\
-        | Iterate through all devices in list and run       |
-        | detectors                                         |
-        \*-------------------------------------------------*/
-        hid_device_count = 0;
+        debug_hid_devices = debug_wrapper.hid_enumerate(0, 0);
 
-        while(current_hid_device)
+        for(current_hid_device = debug_hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
         {
-            if(LogManager::get()->getLoglevel() >= LL_DEBUG)
+            char lane[24];
+
+            snprintf(lane, sizeof(lane), "Debug HID %04X:%04X", current_hid_device->vendor_id, current_hid_device->product_id);
+
+            DetectionJob job;
+
+            job.lane        = lane;
+            job.category    = DETECTION_CATEGORY_HID;
+            job.function    = [this, current_hid_device, &detector_settings]()
             {
-                const char* manu_name = StringUtils::wchar_to_char(current_hid_device->manufacturer_string);
-                const char* prod_name = StringUtils::wchar_to_char(current_hid_device->product_string);
-                LOG_DEBUG("[%04X:%04X U=%04X P=0x%04X I=%d] %-25s - %s", current_hid_device->vendor_id, current_hid_device->product_id, current_hid_device->usage, current_hid_device->usage_page, current_hid_device->interface_number, manu_name, prod_name);
+                DetectHIDDevice(debug_wrapper, current_hid_device, detector_settings, true);
+            };
+
+            jobs.push_back(job);
+        }
+    }
+
+    std::chrono::steady_clock::duration hid_enumerate_time = std::chrono::steady_clock::now() - hid_enumerate_start_time;
+
+    /*-------------------------------------------------*\
+    | Remember the HID paths present now, from hidraw,  |
+    | libusb and the debug wrapper.  Hotplug events are |
+    | compared against them.                            |
+    \*-------------------------------------------------*/
+    if(hid_hotplug_monitor != NULL)
+    {
+#if defined(__linux__) && defined(__GLIBC__)
+        UpdateHIDKnownPaths(hid_devices, libusb_hid_devices, debug_hid_devices);
+#else
+        UpdateHIDKnownPaths(hid_devices, NULL, debug_hid_devices);
+#endif
+    }
+
+    /*-------------------------------------------------*\
+    | Queue other detectors.  Network detectors only    |
+    | talk to devices on the network, so each one gets  |
+    | its own lane.  The rest may share serial ports or |
+    | USB devices and share one lane, which starts once |
+    | the HID lanes are done.                           |
+    \*-------------------------------------------------*/
+    for(unsigned int detector_idx = 0; detector_idx < (unsigned int)device_detectors.size(); detector_idx++)
+    {
+        const char* detector_name = device_detector_strings[detector_idx].c_str();
+
+        /*-------------------------------------------------*\
+        | Check if this detector is enabled                 |
+        \*-------------------------------------------------*/
+        bool this_device_enabled = true;
+        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name))
+        {
+            this_device_enabled = detector_settings["detectors"][detector_name];
+        }
+
+        LOG_DEBUG("[%s] is %s", detector_name, ((this_device_enabled == true) ? "enabled" : "disabled"));
+
+        if(this_device_enabled)
+        {
+            DetectionJob job;
+
+            if(device_detector_network[detector_idx])
+            {
+                job.lane        = "Network " + device_detector_strings[detector_idx];
+                job.category    = DETECTION_CATEGORY_NETWORK;
+            }
+            else
+            {
+                job.lane        = "Other";
+                job.category    = DETECTION_CATEGORY_OTHER;
+            }
+
+            job.function    = [this, detector_idx]()
+            {
+                RunDetector(device_detector_strings[detector_idx], device_detectors[detector_idx]);
+            };
+
+            jobs.push_back(job);
+        }
+    }
+
+    /*-------------------------------------------------*\
+    | On the first detection pass, check the detection  |
+    | cache.  If the hardware fingerprint matches, only |
+    | the detectors that found devices last time run    |
+    | now, and the rest run in a second pass once this  |
+    | one has been reported as complete.                |
+    \*-------------------------------------------------*/
+    if(detection_cache_enabled && phase == DETECTION_PHASE_FULL)
+    {
+        detection_fingerprint = GetDetectionFingerprint(hid_devices, detector_settings);
+
+        if(!detection_cache_checked)
+        {
+            detection_cache_checked = true;
+
+            detection_cache->Load(GetConfigurationDirectory() / "DetectionCache.json");
+
+            if(detection_cache->Matches(detection_fingerprint))
+            {
+                LOG_INFO("[ResourceManager] Detection cache matches fingerprint %s, running %u cached detectors first", detection_fingerprint.c_str(), detection_cache->GetNumDetectors());
+
+                phase = DETECTION_PHASE_CACHED;
+            }
+            else
+            {
+                LOG_INFO("[ResourceManager] Detection cache does not match fingerprint %s, running full detection", detection_fingerprint.c_str());
+            }
+        }
+    }
+
+    detection_phase = phase;
+
+    /*-------------------------------------------------*\
+    | When the detection cache matches, the cached pass |
+    | leaves out the busses that did not answer a       |
+    | single transfer in the last complete detection.   |
+    | The remaining pass probes every bus again, so the |
+    | quiet list written after it only holds busses     |
+    | that were probed and still did not answer, and a  |
+    | bus that starts answering drops out of it.        |
+    \*-------------------------------------------------*/
+    if(phase != DETECTION_PHASE_REMAINING)
+    {
+        detection_skipped_busses.clear();
+    }
+
+    for(unsigned int bus = 0; bus < busses.size(); bus++)
+    {
+        if(phase == DETECTION_PHASE_CACHED && detection_cache->IsBusQuiet(GetI2CBusDescription(busses[bus])))
+        {
+            LOG_DEBUG("[ResourceManager] Skipping quiet I2C bus %s", busses[bus]->device_name);
+            detection_skipped_busses.insert(GetI2CBusDescription(busses[bus]));
+            continue;
+        }
+
+        detection_busses.push_back(busses[bus]);
+    }
+
+    /*-------------------------------------------------*\
+    | Run all queued detection jobs                     |
+    \*-------------------------------------------------*/
+    LOG_INFO("------------------------------------------------------");
+    LOG_INFO("|                 Detecting devices                  |");
+    if (hid_safe_mode)
+    LOG_INFO("|                with HID safe mode                  |");
+    if (parallel_detection)
+    LOG_INFO("|                    in parallel                     |");
+    if (phase == DETECTION_PHASE_CACHED)
+    LOG_INFO("|              cached detectors only                 |");
+    if (phase == DETECTION_PHASE_REMAINING)
+    LOG_INFO("|             remaining detectors only               |");
+    LOG_INFO("------------------------------------------------------");
+
+    RunDetectionJobs(jobs, parallel_detection);
+
+    /*-------------------------------------------------*    | The busses skipped by the cached pass have been   |
+    | probed if an I2C detector ran in this pass        |
+    \*-------------------------------------------------*/
+    if(phase == DETECTION_PHASE_REMAINING && detection_busses_probed)
+    {
+        detection_skipped_busses.clear();
+    }
+
+    /*-------------------------------------------------*\
+    | Done using the device lists, free them            |
+    \*-------------------------------------------------*/
+    if(hid_devices != NULL)
+    {
+        hid_free_enumeration(hid_devices);
+    }
+
+#ifdef __linux__
+#ifdef __GLIBC__
+    if(libusb_hid_devices != NULL)
+    {
+        wrapper.hid_free_enumeration(libusb_hid_devices);
+    }
+#endif
+#endif
+
+    if(debug_hid_devices != NULL)
+    {
+        debug_wrapper.hid_free_enumeration(debug_hid_devices);
+    }
+
+    /*-------------------------------------------------*\
+    | Log where the detection time went                 |
+    \*-------------------------------------------------*/
+    std::chrono::steady_clock::duration detection_time = std::chrono::steady_clock::now() - detection_start_time;
+
+    LogDetectionSummary(jobs, detection_time, hid_enumerate_time);
+
+    /*-------------------------------------------------*\
+    | After a cached pass, queue the remaining          |
+    | detectors.  The background thread runs them once  |
+    | the current background function, such as the      |
+    | startup sequence, has returned.                   |
+    |                                                   |
+    | After a complete detection, record which          |
+    | detectors found devices.  An aborted detection    |
+    | leaves the cache untouched.                       |
+    \*-------------------------------------------------*/
+    if(phase == DETECTION_PHASE_CACHED)
+    {
+        LOG_INFO("[ResourceManager] Cached detectors finished in %.3f ms, last full detection took %.3f ms",
+                 std::chrono::duration<double, std::milli>(detection_time).count(), detection_cache->GetDetectionTime());
+
+        detection_cached_phase_time = detection_time;
+
+        if(detection_is_required.load())
+        {
+            detection_phase = DETECTION_PHASE_REMAINING;
+
+            ScheduledBackgroundFunction = std::bind(&ResourceManager::DetectRemainingDevicesCoroutine, this);
+        }
+        else
+        {
+            detection_phase = DETECTION_PHASE_FULL;
+        }
+    }
+    else
+    {
+        if(detection_cache_enabled && detection_is_required.load())
+        {
+            if(phase == DETECTION_PHASE_REMAINING)
+            {
+                detection_time += detection_cached_phase_time;
+
+                LOG_INFO("[ResourceManager] Remaining detectors finished, %.3f ms of detection in total",
+                         std::chrono::duration<double, std::milli>(detection_time).count());
+            }
+
+            UpdateDetectionCache(std::chrono::duration<double, std::milli>(detection_time).count());
+        }
+
+        detection_phase = DETECTION_PHASE_FULL;
+    }
+
+    /*-------------------------------------------------*\
+    | Make sure that when the detection is done,        |
+    | progress bar is set to 100%                       |
+    \*-------------------------------------------------*/
+    ProcessPostDetection();
+
+    DetectDeviceMutex.unlock();
+
+    /*-------------------------------------------------*\
+    | The dialogs below were already shown after the    |
+    | cached pass                                       |
+    \*-------------------------------------------------*/
+    if(phase == DETECTION_PHASE_REMAINING)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    /*-------------------------------------------------*\
+    | If the udev rules file is not installed, show a   |
+    | dialog                                            |
+    \*-------------------------------------------------*/
+    if(udev_not_exist)
+    {
+        LOG_DIALOG("%s", UDEV_MISSING);
+
+        udev_multiple       = false;
+        i2c_interface_fail  = false;
+    }
+
+    /*-------------------------------------------------*\
+    | If multiple udev rules files are installed, show  |
+    | a dialog                                          |
+    \*-------------------------------------------------*/
+    if(udev_multiple)
+    {
+        LOG_DIALOG("%s", UDEV_MUTLI);
+
+        i2c_interface_fail  = false;
+    }
+
+#endif
+
+    /*-------------------------------------------------*\
+    | If any i2c interfaces failed to detect due to an  |
+    | error condition, show a dialog                    |
+    \*-------------------------------------------------*/
+    if(i2c_interface_fail)
+    {
+#ifdef _WIN32
+        LOG_DIALOG("%s", I2C_ERR_WIN);
+#endif
+#ifdef __linux__
+        LOG_DIALOG("%s", I2C_ERR_LINUX);
+#endif
+    }
+}
+
+/*---------------------------------------------------------*\
+| Read the SPD of the slots on every DRAM bus.  With        |
+| parallel detection, the busses of different SMBus         |
+| controllers are probed concurrently.  Busses of the same  |
+| controller, such as the ports of an AMD FCH, share its    |
+| registers and are probed one after another.               |
+\*---------------------------------------------------------*/
+void ResourceManager::ProbeDIMMSlots(std::vector<std::vector<SPDWrapper>>& dimm_slots, bool parallel)
+{
+    std::map<uint64_t, std::vector<unsigned int>> controller_busses;
+
+    for(unsigned int bus = 0; bus < busses.size(); bus++)
+    {
+        IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
+        {
+            uint64_t controller_key = ((uint64_t)(uint16_t)busses[bus]->pci_vendor           << 48)
+                                    | ((uint64_t)(uint16_t)busses[bus]->pci_device           << 32)
+                                    | ((uint64_t)(uint16_t)busses[bus]->pci_subsystem_vendor << 16)
+                                    | ((uint64_t)(uint16_t)busses[bus]->pci_subsystem_device);
+
+            controller_busses[controller_key].push_back(bus);
+        }
+    }
+
+    std::vector<std::thread*> probe_threads;
+
+    for(std::map<uint64_t, std::vector<unsigned int>>::iterator controller_it = controller_busses.begin(); controller_it != controller_busses.end(); controller_it++)
+    {
+        std::vector<unsigned int>& controller_bus_list = controller_it->second;
+
+        std::function<void()> probe_controller = [this, &controller_bus_list, &dimm_slots]()
+        {
+            for(unsigned int bus : controller_bus_list)
+            {
+                ProbeDIMMBus(bus, dimm_slots[bus]);
+            }
+        };
+
+        if(parallel && controller_busses.size() > 1)
+        {
+            probe_threads.push_back(new std::thread(probe_controller));
+        }
+        else
+        {
+            probe_controller();
+        }
+    }
+
+    for(std::thread* probe_thread : probe_threads)
+    {
+        probe_thread->join();
+        delete probe_thread;
+    }
+}
+
+void ResourceManager::ProbeDIMMBus(unsigned int bus, std::vector<SPDWrapper>& slots)
+{
+    SPDMemoryType dimm_type = SPD_RESERVED;
+
+    for(uint8_t spd_addr = 0x50; spd_addr < 0x58 && detection_is_required.load(); spd_addr++)
+    {
+        SPDDetector spd(busses[bus], spd_addr, dimm_type);
+        if(spd.is_valid())
+        {
+            SPDWrapper accessor(spd);
+            dimm_type = spd.memory_type();
+            LOG_INFO("[ResourceManager] Detected occupied slot %d, bus %d, type %s", spd_addr - 0x50 + 1, bus, spd_memory_type_name[dimm_type]);
+            LOG_DEBUG("[ResourceManager] Jedec ID: 0x%04x", accessor.jedec_id());
+            slots.push_back(accessor);
+        }
+    }
+}
+
+void ResourceManager::DetectDIMMBus(unsigned int bus, std::vector<SPDWrapper>& slots, json &detector_settings)
+{
+    /*-------------------------------------------------*\
+    | All occupied slots of a bus have the memory type  |
+    | of the last one found                             |
+    \*-------------------------------------------------*/
+    SPDMemoryType dimm_type = slots.back().memory_type();
+
+    for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < i2c_dimm_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
+    {
+        I2CDIMMDeviceDetectorBlock & detector = i2c_dimm_device_detectors[i2c_detector_idx];
+
+        if(detector.dimm_type == dimm_type && is_jedec_in_slots(slots, detector.jedec_id))
+        {
+            const char* detector_name = detector.name.c_str();
+
+            /*-------------------------------------------------*\
+            | Check if this detector is enabled                 |
+            \*-------------------------------------------------*/
+            bool this_device_enabled = true;
+
+            {
+                std::lock_guard<std::mutex> lock(DetectorSettingsMutex);
+
+                if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name))
+                {
+                    this_device_enabled = detector_settings["detectors"][detector_name];
+                }
+            }
+
+            LOG_DEBUG("[%s] is %s", detector_name, ((this_device_enabled == true) ? "enabled" : "disabled"));
+
+            if(this_device_enabled)
+            {
+                std::vector<SPDWrapper*> matching_slots = slots_with_jedec(slots, detector.jedec_id);
+
+                RunDetector(detector.name, [this, bus, &detector, &matching_slots]()
+                {
+                    detector.function(busses[bus], matching_slots);
+                });
+            }
+        }
+    }
+}
+
+void ResourceManager::DetectHIDDevice(hidapi_wrapper wrapper, hid_device_info* current_hid_device, json &detector_settings, bool libusb)
+{
+    if(LogManager::get()->getLoglevel() >= LL_DEBUG)
+    {
+        const char* manu_name = StringUtils::wchar_to_char(current_hid_device->manufacturer_string);
+        const char* prod_name = StringUtils::wchar_to_char(current_hid_device->product_string);
+        LOG_DEBUG("[%04X:%04X U=%04X P=0x%04X I=%d] %-25s - %s", current_hid_device->vendor_id, current_hid_device->product_id, current_hid_device->usage, current_hid_device->usage_page, current_hid_device->interface_number, manu_name, prod_name);
+    }
+
+    uint32_t hid_detector_key = HIDDetectorKey(current_hid_device->vendor_id, current_hid_device->product_id);
+
+    std::unordered_map<uint32_t, std::vector<unsigned int>>::iterator hid_index_it;
+
+    /*-----------------------------------------------------------------------------*\
+    | Loop through the detectors registered for this VID:PID.  If the interface and |
+    | usage also match, run the detector.  Only wrapped detectors can use the       |
+    | libusb backend.                                                               |
+    \*-----------------------------------------------------------------------------*/
+    hid_index_it = hid_device_detector_index.find(hid_detector_key);
+
+    if(!libusb && hid_index_it != hid_device_detector_index.end())
+    {
+        for(std::size_t candidate_idx = 0; candidate_idx < hid_index_it->second.size() && detection_is_required.load(); candidate_idx++)
+        {
+            unsigned int             hid_detector_idx   = hid_index_it->second[candidate_idx];
+            HIDDeviceDetectorBlock & detector           = hid_device_detectors[hid_detector_idx];
+
+            if(detector.compare(current_hid_device))
+            {
+                bool this_device_enabled = IsHIDDetectorEnabled(detector_settings, false, hid_detector_idx);
+
+                LOG_DEBUG("[%s] is %s", detector.name.c_str(), ((this_device_enabled == true) ? "enabled" : "disabled"));
+
+                if(this_device_enabled)
+                {
+                    RunDetector(detector.name, [&detector, current_hid_device]()
+                    {
+                        detector.function(current_hid_device, detector.name);
+                    });
+                }
+            }
+        }
+    }
+
+    /*-----------------------------------------------------------------------------*\
+    | Loop through the wrapped HID detectors registered for this VID:PID.  If the   |
+    | interface and usage also match, run the detector                              |
+    \*-----------------------------------------------------------------------------*/
+    hid_index_it = hid_wrapped_device_detector_index.find(hid_detector_key);
+
+    if(hid_index_it != hid_wrapped_device_detector_index.end())
+    {
+        for(std::size_t candidate_idx = 0; candidate_idx < hid_index_it->second.size() && detection_is_required.load(); candidate_idx++)
+        {
+            unsigned int                    hid_detector_idx    = hid_index_it->second[candidate_idx];
+            HIDWrappedDeviceDetectorBlock & detector            = hid_wrapped_device_detectors[hid_detector_idx];
+
+            if(detector.compare(current_hid_device))
+            {
+                bool this_device_enabled = IsHIDDetectorEnabled(detector_settings, true, hid_detector_idx);
+
+                LOG_DEBUG("[%s] is %s", detector.name.c_str(), ((this_device_enabled == true) ? "enabled" : "disabled"));
+
+                if(this_device_enabled)
+                {
+                    RunDetector(detector.name, [&detector, wrapper, current_hid_device]()
+                    {
+                        detector.function(wrapper, current_hid_device, detector.name);
+                    });
+                }
+            }
+        }
+    }
+}
+
+void ResourceManager::DetectHIDDevicesSafeMode(json &detector_settings)
+{
+    hid_device_info* hid_devices;
+    hid_device_info* current_hid_device;
+
+    /*-----------------------------------------------------------------------------*\
+    | Enumerate all HID devices once to find out which VID:PID pairs are present.   |
+    | Detectors for devices that are not present are skipped instead of each doing  |
+    | its own enumeration.                                                          |
+    \*-----------------------------------------------------------------------------*/
+    std::unordered_set<uint32_t>    hid_present_keys;
+    unsigned int                    hid_enumerations    = 1;
+
+    hid_devices = hid_enumerate(0, 0);
+
+    for(current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        hid_present_keys.insert(HIDDetectorKey(current_hid_device->vendor_id, current_hid_device->product_id));
+    }
+
+    hid_free_enumeration(hid_devices);
+
+    /*-----------------------------------------------------------------------------*\
+    | Loop through all available detectors in order.  For each detector whose       |
+    | device is present, enumerate that VID:PID again and, if all required          |
+    | information matches, run the detector                                         |
+    \*-----------------------------------------------------------------------------*/
+    for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
+    {
+        HIDDeviceDetectorBlock & detector = hid_device_detectors[hid_detector_idx];
+
+        if(hid_present_keys.find(HIDDetectorKey(detector.vid, detector.pid)) == hid_present_keys.end())
+        {
+            continue;
+        }
+
+        hid_devices = hid_enumerate(detector.vid, detector.pid);
+        hid_enumerations++;
+
+        LOG_VERBOSE("[ResourceManager] Trying to run detector for [%s] (for %04x:%04x)", detector.name.c_str(), detector.vid, detector.pid);
+
+        current_hid_device = hid_devices;
+
+        while(current_hid_device)
+        {
+
+            if(detector.compare(current_hid_device))
+            {
+                bool this_device_enabled = IsHIDDetectorEnabled(detector_settings, false, hid_detector_idx);
+
+                LOG_DEBUG("[%s] is %s", detector.name.c_str(), ((this_device_enabled == true) ? "enabled" : "disabled"));
+
+                if(this_device_enabled)
+                {
+                    RunDetector(detector.name, [&detector, current_hid_device]()
+                    {
+                        detector.function(current_hid_device, detector.name);
+                    });
+                }
             }
-            detection_string = "";
-            DetectionProgressChanged();
-
-            /*-----------------------------------------------------------------------------*\
-            | Loop through all available detectors.  If all required information matches,   |
-            | run the detector                                                              |
-            \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
+
+            current_hid_device = current_hid_device->next;
+        }
+
+        hid_free_enumeration(hid_devices);
+    }
+
+    LOG_INFO("[ResourceManager] HID safe mode used %u enumerations for %u detectors, %u VID:PID pairs present",
+             hid_enumerations, (unsigned int)hid_device_detectors.size(), (unsigned int)hid_present_keys.size());
+}
+
+/*---------------------------------------------------------*\
+| Run one detector function, publishing its name as the     |
+| detection string and recording how long it took and how   |
+| many controllers it registered                            |
+\*---------------------------------------------------------*/
+void ResourceManager::RunDetector(const std::string& name, std::function<void()> detector)
+{
+    if(!IsDetectorInPhase(name))
+    {
+        return;
+    }
+
+    DetectionJob*   job                 = current_detection_job;
+    unsigned int    controllers_before  = (job != NULL) ? job->controllers_found : 0;
+    std::size_t     locations_before    = (job != NULL) ? job->locations.size() : 0;
+
+    detection_string = name.c_str();
+    DetectionProgressChanged();
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    detector();
+
+    std::chrono::steady_clock::duration detector_time = std::chrono::steady_clock::now() - start_time;
+
+    DetectorTiming timing;
+
+    timing.name         = name;
+    timing.time_ms      = std::chrono::duration<double, std::milli>(detector_time).count();
+    timing.controllers  = (job != NULL) ? (job->controllers_found - controllers_before) : 0;
+
+    if(job != NULL)
+    {
+        timing.locations.assign(job->locations.begin() + locations_before, job->locations.end());
+
+        job->detector_time += detector_time;
+        job->detectors_run++;
+    }
+
+    LOG_DEBUG("[%s] detection took %.3f ms, %u controllers found", name.c_str(), timing.time_ms, timing.controllers);
+
+    {
+        std::lock_guard<std::mutex> lock(DetectorTimingsMutex);
+        detector_timings.push_back(timing);
+    }
+
+    /*-----------------------------------------------------*\
+    | Let progress listeners pick up the new timing entry   |
+    \*-----------------------------------------------------*/
+    DetectionProgressChanged();
+}
+
+/*---------------------------------------------------------*\
+| Run detection jobs.  Sequentially, jobs run in order on   |
+| the calling thread and register their controllers as      |
+| they find them.  In parallel, jobs with the same lane run |
+| one after another in order on one thread, so a bus is     |
+| never probed by two detectors at once, while different    |
+| lanes run concurrently.  Controllers found in parallel    |
+| are registered in job order once every job has finished,  |
+| so the device list order does not depend on timing.       |
+\*---------------------------------------------------------*/
+void ResourceManager::RunDetectionJobs(std::vector<DetectionJob>& jobs, bool parallel)
+{
+    std::atomic<unsigned int> jobs_done(0);
+
+    std::function<void(DetectionJob&)> run_job = [this, &jobs, &jobs_done](DetectionJob& job)
+    {
+        if(detection_is_required.load())
+        {
+            std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+            current_detection_job = &job;
+            job.function();
+            current_detection_job = NULL;
+
+            job.job_time = std::chrono::steady_clock::now() - start_time;
+        }
+
+        detection_percent = (unsigned int)(((++jobs_done) * 100) / jobs.size());
+    };
+
+    if(!parallel || jobs.size() < 2)
+    {
+        for(std::size_t job_idx = 0; job_idx < jobs.size(); job_idx++)
+        {
+            run_job(jobs[job_idx]);
+        }
+
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Group jobs into lanes, keeping job order within each  |
+    | lane                                                  |
+    \*-----------------------------------------------------*/
+    std::vector<std::vector<std::size_t>>   lanes;
+    std::map<std::string, std::size_t>      lane_indices;
+
+    for(std::size_t job_idx = 0; job_idx < jobs.size(); job_idx++)
+    {
+        std::map<std::string, std::size_t>::iterator lane_it = lane_indices.find(jobs[job_idx].lane);
+
+        if(lane_it == lane_indices.end())
+        {
+            lane_it = lane_indices.insert(std::make_pair(jobs[job_idx].lane, lanes.size())).first;
+            lanes.push_back(std::vector<std::size_t>());
+        }
+
+        lanes[lane_it->second].push_back(job_idx);
+
+        jobs[job_idx].defer_registration = true;
+    }
+
+    /*-----------------------------------------------------*\
+    | Start the HID lanes after the I2C and network lanes.  |
+    | Each holds only a few short jobs, while the I2C and   |
+    | network lanes hold the slow probes.  The other lane   |
+    | goes last, its detectors may open the same HID and    |
+    | USB devices through hidapi and libusb.                |
+    \*-----------------------------------------------------*/
+    std::function<int(const std::vector<std::size_t>&)> lane_rank = [&jobs](const std::vector<std::size_t>& lane)
+    {
+        switch(jobs[lane[0]].category)
+        {
+            case DETECTION_CATEGORY_HID:
+                return(1);
+
+            case DETECTION_CATEGORY_OTHER:
+                return(2);
+
+            default:
+                return(0);
+        }
+    };
+
+    std::stable_sort(lanes.begin(), lanes.end(), [&lane_rank](const std::vector<std::size_t>& a, const std::vector<std::size_t>& b)
+    {
+        return(lane_rank(a) < lane_rank(b));
+    });
+
+    std::size_t hid_lanes_left = 0;
+
+    for(const std::vector<std::size_t>& lane : lanes)
+    {
+        if(jobs[lane[0]].category == DETECTION_CATEGORY_HID)
+        {
+            hid_lanes_left++;
+        }
+    }
+
+    unsigned int thread_count = std::thread::hardware_concurrency();
+
+    if(thread_count < DETECTION_MIN_THREADS)
+    {
+        thread_count = DETECTION_MIN_THREADS;
+    }
+
+    if(thread_count > DETECTION_MAX_THREADS)
+    {
+        thread_count = DETECTION_MAX_THREADS;
+    }
+
+    if(thread_count > lanes.size())
+    {
+        thread_count = (unsigned int)lanes.size();
+    }
+
+    LOG_INFO("[ResourceManager] Running %u detection jobs in %u lanes on %u threads", (unsigned int)jobs.size(), (unsigned int)lanes.size(), thread_count);
+
+    std::atomic<std::size_t>    next_lane(0);
+    std::vector<std::thread*>   workers;
+    std::mutex                  hid_lanes_mutex;
+    std::condition_variable     hid_lanes_cv;
+
+    for(unsigned int thread_idx = 0; thread_idx < thread_count; thread_idx++)
+    {
+        workers.push_back(new std::thread([&lanes, &jobs, &next_lane, &run_job, &hid_lanes_left, &hid_lanes_mutex, &hid_lanes_cv]()
+        {
+            for(std::size_t lane_idx = next_lane++; lane_idx < lanes.size(); lane_idx = next_lane++)
             {
-                HIDDeviceDetectorBlock & detector = hid_device_detectors[hid_detector_idx];
-                if(detector.compare(current_hid_device))
+                int category = jobs[lanes[lane_idx][0]].category;
+
+                /*-----------------------------------------*\
+                | All HID lanes sort before the other lane, |
+                | so they have already been picked up by    |
+                | running workers.  Wait for them to finish |
+                \*-----------------------------------------*/
+                if(category == DETECTION_CATEGORY_OTHER)
+                {
+                    std::unique_lock<std::mutex> lock(hid_lanes_mutex);
+                    hid_lanes_cv.wait(lock, [&hid_lanes_left]{ return(hid_lanes_left == 0); });
+                }
+
+                for(std::size_t job_idx : lanes[lane_idx])
+                {
+                    run_job(jobs[job_idx]);
+                }
+
+                if(category == DETECTION_CATEGORY_HID)
                 {
-                    detection_string = detector.name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
+                    std::lock_guard<std::mutex> lock(hid_lanes_mutex);
+
+                    if(--hid_lanes_left == 0)
                     {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
+                        hid_lanes_cv.notify_all();
                     }
+                }
+            }
+        }));
+    }
+
+    for(std::thread* worker : workers)
+    {
+        worker->join();
+        delete worker;
+    }
+
+    /*-----------------------------------------------------*\
+    | Register the controllers in job order                 |
+    \*-----------------------------------------------------*/
+    for(std::size_t job_idx = 0; job_idx < jobs.size(); job_idx++)
+    {
+        for(RGBController* controller : jobs[job_idx].controllers)
+        {
+            RegisterRGBController(controller);
+        }
+
+        jobs[job_idx].controllers.clear();
+    }
+}
+
+void ResourceManager::LogDetectionSummary(std::vector<DetectionJob>& jobs, std::chrono::steady_clock::duration detection_time, std::chrono::steady_clock::duration hid_enumerate_time)
+{
+    static const char* category_names[DETECTION_CATEGORY_COUNT] =
+    {
+        "I2C",
+        "HID",
+        "Network",
+        "Other"
+    };
+
+    std::chrono::steady_clock::duration category_job_time[DETECTION_CATEGORY_COUNT];
+    std::chrono::steady_clock::duration category_detector_time[DETECTION_CATEGORY_COUNT];
+    unsigned int                        category_detectors_run[DETECTION_CATEGORY_COUNT];
+
+    for(unsigned int category = 0; category < DETECTION_CATEGORY_COUNT; category++)
+    {
+        category_job_time[category]         = std::chrono::steady_clock::duration::zero();
+        category_detector_time[category]    = std::chrono::steady_clock::duration::zero();
+        category_detectors_run[category]    = 0;
+    }
+
+    category_job_time[DETECTION_CATEGORY_HID] = hid_enumerate_time;
+
+    for(std::size_t job_idx = 0; job_idx < jobs.size(); job_idx++)
+    {
+        category_job_time[jobs[job_idx].category]       += jobs[job_idx].job_time;
+        category_detector_time[jobs[job_idx].category]  += jobs[job_idx].detector_time;
+        category_detectors_run[jobs[job_idx].category]  += jobs[job_idx].detectors_run;
+    }
+
+    LOG_INFO("[ResourceManager] Detection took %.3f ms", std::chrono::duration<double, std::milli>(detection_time).count());
+
+    for(unsigned int category = 0; category < DETECTION_CATEGORY_COUNT; category++)
+    {
+        double job_ms       = std::chrono::duration<double, std::milli>(category_job_time[category]).count();
+        double detector_ms  = std::chrono::duration<double, std::milli>(category_detector_time[category]).count();
+
+        LOG_INFO("[ResourceManager] %s detection: %.3f ms, %.3f ms in %u detectors, %.3f ms enumerating and matching",
+                 category_names[category], job_ms, detector_ms, category_detectors_run[category], job_ms - detector_ms);
+    }
+}
+
+std::vector<DetectorTiming> ResourceManager::GetDetectorTimings()
+{
+    std::lock_guard<std::mutex> lock(DetectorTimingsMutex);
+
+    return(detector_timings);
+}
+
+/*---------------------------------------------------------*\
+| Check whether a detector runs in the current detection    |
+| phase.  The cached pass runs only the detectors listed in |
+| the detection cache, the second pass runs all others.     |
+\*---------------------------------------------------------*/
+bool ResourceManager::IsDetectorInPhase(const std::string& name)
+{
+    int phase = detection_phase;
+
+    if(phase == DETECTION_PHASE_CACHED)
+    {
+        return(detection_cache->ContainsDetector(name));
+    }
+    else if(phase == DETECTION_PHASE_REMAINING)
+    {
+        return(!detection_cache->ContainsDetector(name));
+    }
+
+    return(true);
+}
+
+/*---------------------------------------------------------*\
+| Name and PCI IDs of an I2C bus, used to recognize the bus |
+| in the detection cache                                    |
+\*---------------------------------------------------------*/
+std::string ResourceManager::GetI2CBusDescription(i2c_smbus_interface* bus)
+{
+    char description[1024];
+
+    snprintf(description, sizeof(description), "%s %04X:%04X %04X:%04X %d",
+             bus->device_name,
+             bus->pci_vendor,
+             bus->pci_device,
+             bus->pci_subsystem_vendor,
+             bus->pci_subsystem_device,
+             bus->port_id);
+
+    return(description);
+}
+
+/*---------------------------------------------------------*\
+| Build the hardware fingerprint used to validate the       |
+| detection cache.  It covers everything that decides which |
+| detectors find devices: the OpenRGB version and detector  |
+| list, the detector settings, the mainboard, the I2C       |
+| busses with their PCI IDs and all HID devices with their  |
+| paths.  Network devices are not covered, the second pass  |
+| still runs every detector that is not in the cache.       |
+\*---------------------------------------------------------*/
+std::string ResourceManager::GetDetectionFingerprint(hid_device_info* hid_devices, json &detector_settings)
+{
+    std::vector<std::string>    items;
+    char                        item[1024];
+    hid_device_info*            current_hid_device;
+    bool                        free_hid_devices    = false;
+
+    items.push_back(std::string("version ") + VERSION_STRING);
+
+    snprintf(item, sizeof(item), "detectors %u %u %u %u %u %u %u",
+             (unsigned int)device_detectors.size(),
+             (unsigned int)i2c_bus_detectors.size(),
+             (unsigned int)i2c_device_detectors.size(),
+             (unsigned int)i2c_dimm_device_detectors.size(),
+             (unsigned int)i2c_pci_device_detectors.size(),
+             (unsigned int)hid_device_detectors.size(),
+             (unsigned int)hid_wrapped_device_detectors.size());
+    items.push_back(item);
+
+    items.push_back("settings " + detector_settings.dump());
+
+    DMIInfo dmi;
+
+    items.push_back("board " + dmi.getManufacturer() + " " + dmi.getMainboard());
+
+    for(unsigned int bus = 0; bus < busses.size(); bus++)
+    {
+        items.push_back("i2c " + GetI2CBusDescription(busses[bus]));
+    }
+
+    /*-----------------------------------------------------*\
+    | In HID safe mode there is no device list yet          |
+    \*-----------------------------------------------------*/
+    if(hid_devices == NULL)
+    {
+        hid_devices         = hid_enumerate(0, 0);
+        free_hid_devices    = true;
+    }
+
+    for(current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        snprintf(item, sizeof(item), "hid %04X:%04X %d %s",
+                 current_hid_device->vendor_id,
+                 current_hid_device->product_id,
+                 current_hid_device->interface_number,
+                 current_hid_device->path);
+        items.push_back(item);
+    }
+
+    if(free_hid_devices)
+    {
+        hid_free_enumeration(hid_devices);
+    }
+
+    return(DetectionCache::ComputeFingerprint(items));
+}
+
+/*---------------------------------------------------------*\
+| Replace the detection cache with the detectors that found |
+| devices in this detection.  HID detectors run once per    |
+| matching device, so their timings are merged by name.     |
+\*---------------------------------------------------------*/
+void ResourceManager::UpdateDetectionCache(double detection_time_ms)
+{
+    std::vector<DetectionCacheEntry> entries;
+
+    {
+        std::lock_guard<std::mutex> lock(DetectorTimingsMutex);
+
+        for(std::size_t timing_idx = 0; timing_idx < detector_timings.size(); timing_idx++)
+        {
+            DetectorTiming& timing = detector_timings[timing_idx];
+
+            if(timing.controllers == 0)
+            {
+                continue;
+            }
+
+            std::size_t entry_idx = 0;
+
+            while(entry_idx < entries.size() && entries[entry_idx].name != timing.name)
+            {
+                entry_idx++;
+            }
+
+            if(entry_idx == entries.size())
+            {
+                DetectionCacheEntry new_entry;
+
+                new_entry.name          = timing.name;
+                new_entry.controllers   = 0;
+                new_entry.time_ms       = 0.0;
+
+                entries.push_back(new_entry);
+            }
+
+            entries[entry_idx].controllers += timing.controllers;
+            entries[entry_idx].time_ms     += timing.time_ms;
+            entries[entry_idx].locations.insert(entries[entry_idx].locations.end(), timing.locations.begin(), timing.locations.end());
+        }
+    }
+
+    /*-----------------------------------------------------*\
+    | Remember the busses on which no transfer succeeded,   |
+    | no detector can have found a device on them.  A bus   |
+    | that was skipped and not probed since is left out, so |
+    | it is probed again on the next start instead of       |
+    | staying quiet for good.                               |
+    \*-----------------------------------------------------*/
+    std::set<std::string> quiet_busses;
+
+    for(unsigned int bus = 0; bus < busses.size(); bus++)
+    {
+        std::string bus_description = GetI2CBusDescription(busses[bus]);
+
+        if(!busses[bus]->i2c_smbus_has_responded() && (detection_skipped_busses.count(bus_description) == 0))
+        {
+            quiet_busses.insert(bus_description);
+        }
+    }
+
+    detection_cache->SetEntries(detection_fingerprint, detection_time_ms, entries);
+    detection_cache->SetQuietBusses(quiet_busses);
+
+    if(detection_cache->Save())
+    {
+        LOG_INFO("[ResourceManager] Detection cache updated, %u detectors found devices, %u quiet I2C busses", (unsigned int)entries.size(), (unsigned int)quiet_busses.size());
+    }
+}
+
+void ResourceManager::UpdateHIDKnownPaths(hid_device_info* hid_devices, hid_device_info* libusb_hid_devices, hid_device_info* debug_hid_devices)
+{
+    hid_device_info*    current_hid_device;
+    bool                free_hid_devices    = false;
+
+    /*-----------------------------------------------------*\
+    | In HID safe mode there is no device list yet          |
+    \*-----------------------------------------------------*/
+    if(hid_devices == NULL)
+    {
+        hid_devices         = hid_enumerate(0, 0);
+        free_hid_devices    = true;
+    }
+
+    hid_known_paths.clear();
+    hid_known_libusb_paths.clear();
+    hid_known_debug_paths.clear();
+
+    for(current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        hid_known_paths.insert(current_hid_device->path);
+    }
+
+    for(current_hid_device = libusb_hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        hid_known_libusb_paths.insert(current_hid_device->path);
+    }
+
+    for(current_hid_device = debug_hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        hid_known_debug_paths.insert(current_hid_device->path);
+    }
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+    if(free_hid_devices)
+    {
+        hid_free_enumeration(hid_devices);
+    }
+}
 
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
+/*---------------------------------------------------------*\
+| Check whether a controller location refers to a HID path, |
+| making sure /dev/hidraw1 does not match /dev/hidraw10     |
+\*---------------------------------------------------------*/
+static bool LocationMatchesHIDPath(const std::string& location, const std::string& path)
+{
+    for(std::size_t path_pos = location.find(path); path_pos != std::string::npos; path_pos = location.find(path, path_pos + 1))
+    {
+        std::size_t path_end = path_pos + path.size();
 
-                        detector.function(current_hid_device, hid_device_detectors[hid_detector_idx].name);
-                    }
-                }
-            }
+        if(path_end == location.size() || !isdigit((unsigned char)location[path_end]))
+        {
+            return(true);
+        }
+    }
 
-            /*-----------------------------------------------------------------------------*\
-            | Loop through all available wrapped HID detectors.  If all required            |
-            | information matches, run the detector                                         |
-            \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_wrapped_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
-            {
-                HIDWrappedDeviceDetectorBlock & detector = hid_wrapped_device_detectors[hid_detector_idx];
-                if(detector.compare(current_hid_device))
-                {
-                    detection_string = detector.name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
+    return(false);
+}
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+/*---------------------------------------------------------*\
+| Compare one HID device list against the paths known from  |
+| the last detection or hotplug event.  Controllers on      |
+| removed or changed paths are unregistered and deleted,    |
+| and the detectors matching the added or changed devices   |
+| are run.  The known paths are replaced with the list.     |
+\*---------------------------------------------------------*/
+void ResourceManager::ProcessHIDHotplugDevices(hidapi_wrapper wrapper, bool libusb, hid_device_info* hid_devices, std::set<std::string>& known_paths, const std::set<std::string>& changed_paths, json& detector_settings, HIDHotplugCounts& counts)
+{
+    hid_device_info*        current_hid_device;
+    std::set<std::string>   current_paths;
+    std::set<std::string>   removed_paths;
 
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
+    for(current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        current_paths.insert(current_hid_device->path);
+    }
 
-                        detector.function(default_wrapper, current_hid_device, hid_wrapped_device_detectors[hid_detector_idx].name);
-                    }
-                }
+    /*-----------------------------------------------------*\
+    | A path is removed if it is gone, or if it changed     |
+    | while present, as a device unplugged and replugged    |
+    | within the settle time gets the same hidraw node      |
+    \*-----------------------------------------------------*/
+    for(const std::string& path : known_paths)
+    {
+        if(current_paths.find(path) == current_paths.end() || changed_paths.find(path) != changed_paths.end())
+        {
+            removed_paths.insert(path);
+        }
+    }
+
+    std::vector<RGBController*> removed_controllers;
+
+    for(RGBController* controller : rgb_controllers_hw)
+    {
+        for(const std::string& path : removed_paths)
+        {
+            if(LocationMatchesHIDPath(controller->GetLocation(), path))
+            {
+                removed_controllers.push_back(controller);
+                break;
             }
+        }
+    }
 
-            /*-------------------------------------------------*\
-            | Update detection percent                          |
-            \*-------------------------------------------------*/
-            hid_device_count++;
+    for(RGBController* controller : removed_controllers)
+    {
+        RemoveDetectorTimingLocation(controller->GetLocation());
+        UnregisterRGBController(controller);
+        delete controller;
+    }
 
-            percent = (i2c_device_detectors.size() + i2c_dimm_device_detectors.size() + i2c_pci_device_detectors.size() + hid_device_count) / percent_denominator;
+    /*-----------------------------------------------------*\
+    | The size profile entries of the removed controllers   |
+    | are free again for the controllers detected below     |
+    \*-----------------------------------------------------*/
+    if(!removed_controllers.empty())
+    {
+        ResetSizeEntriesUsed();
+    }
 
-            detection_percent = (unsigned int)(percent * 100.0f);
+    /*-----------------------------------------------------*\
+    | Run the HID detectors for new and changed devices     |
+    \*-----------------------------------------------------*/
+    for(current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        std::string path = current_hid_device->path;
 
-            /*-------------------------------------------------*\
-            | Move on to the next HID device                    |
-            \*-------------------------------------------------*/
-            current_hid_device = current_hid_device->next;
+        if(known_paths.find(path) == known_paths.end() || removed_paths.find(path) != removed_paths.end())
+        {
+            DetectHIDDevice(wrapper, current_hid_device, detector_settings, libusb);
+            counts.added_interfaces++;
         }
-
-        /*-------------------------------------------------*\
-        | Done using the device list, free it               |
-        \*-------------------------------------------------*/
-        hid_free_enumeration(hid_devices);
     }
 
-    /*-------------------------------------------------*\
-    | Detect HID devices                                |
-    |                                                   |
-    | Reset current device pointer to first device      |
-    \*-------------------------------------------------*/
-#ifdef __linux__
-#ifdef __GLIBC__
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|            Detecting libusb HID devices            |");
-    LOG_INFO("------------------------------------------------------");
+    counts.removed_interfaces  += (unsigned int)removed_paths.size();
+    counts.removed_controllers += (unsigned int)removed_controllers.size();
 
-    void *         dyn_handle = NULL;
-    hidapi_wrapper wrapper;
+    known_paths = current_paths;
+}
 
-    /*-------------------------------------------------*\
-    | Load the libhidapi-libusb library                 |
-    \*-------------------------------------------------*/
-#ifdef __GLIBC__
-    if((dyn_handle = dlopen("libhidapi-libusb.so", RTLD_NOW | RTLD_NODELETE | RTLD_DEEPBIND)))
-#else
-    if(dyn_handle = dlopen("libhidapi-libusb.so", RTLD_NOW | RTLD_NODELETE ))
-#endif
-    {
-        /*-------------------------------------------------*\
-        | Create a wrapper with the libusb functions        |
-        \*-------------------------------------------------*/
-        wrapper =
-        {
-            .dyn_handle                     = dyn_handle,
-            .hid_send_feature_report        = (hidapi_wrapper_send_feature_report)          dlsym(dyn_handle,"hid_send_feature_report"),
-            .hid_get_feature_report         = (hidapi_wrapper_get_feature_report)           dlsym(dyn_handle,"hid_get_feature_report"),
-            .hid_get_serial_number_string   = (hidapi_wrapper_get_serial_number_string)     dlsym(dyn_handle,"hid_get_serial_number_string"),
-            .hid_open_path                  = (hidapi_wrapper_open_path)                    dlsym(dyn_handle,"hid_open_path"),
-            .hid_enumerate                  = (hidapi_wrapper_enumerate)                    dlsym(dyn_handle,"hid_enumerate"),
-            .hid_free_enumeration           = (hidapi_wrapper_free_enumeration)             dlsym(dyn_handle,"hid_free_enumeration"),
-            .hid_close                      = (hidapi_wrapper_close)                        dlsym(dyn_handle,"hid_close"),
-            .hid_error                      = (hidapi_wrapper_error)                        dlsym(dyn_handle,"hid_free_enumeration")
-        };
+/*---------------------------------------------------------*\
+| Handle HID devices being added or removed without a full  |
+| detection.  The hidraw, libusb and debug device lists are |
+| each compared against the paths seen last time.  All      |
+| other controllers, their update threads and their place   |
+| in the device list are left untouched.  The sizes profile |
+| is applied to the new controllers and the detection cache |
+| is updated as after a full detection.                     |
+\*---------------------------------------------------------*/
+void ResourceManager::ProcessHIDHotplug(const std::set<std::string>& changed_paths)
+{
+    DetectDeviceMutex.lock();
 
-        hid_devices = wrapper.hid_enumerate(0, 0);
+    /*-----------------------------------------------------*\
+    | Leave the changes to a pending detection or second    |
+    | detection pass, it enumerates all devices anyway.     |
+    | Otherwise mark detection as running so that the HID   |
+    | detectors are not skipped.                            |
+    \*-----------------------------------------------------*/
+    bool detection_pending = false;
 
-        current_hid_device = hid_devices;
+    if(!detection_enabled
+    || detection_phase != DETECTION_PHASE_FULL
+    || !detection_is_required.compare_exchange_strong(detection_pending, true))
+    {
+        DetectDeviceMutex.unlock();
+        return;
+    }
 
-        /*-------------------------------------------------*\
-        | Iterate through all devices in list and run       |
-        | detectors                                         |
-        \*-------------------------------------------------*/
-        hid_device_count = 0;
+    json                    detector_settings   = settings_manager->GetSettings("Detectors");
+    hid_device_info*        hid_devices         = hid_enumerate(0, 0);
+    hid_device_info*        debug_hid_devices   = debug_wrapper.hid_enumerate(0, 0);
+    HIDHotplugCounts        counts              = {};
+    std::size_t             controllers_before  = rgb_controllers_hw.size();
 
-        while(current_hid_device)
-        {
-            if(LogManager::get()->getLoglevel() >= LL_DEBUG)
-            {
-                const char* manu_name = StringUtils::wchar_to_char(current_hid_device->manufacturer_string);
-                const char* prod_name = StringUtils::wchar_to_char(current_hid_device->product_string);
-                LOG_DEBUG("[%04X:%04X U=%04X P=0x%04X I=%d] %-25s - %s", current_hid_device->vendor_id, current_hid_device->product_id, current_hid_device->usage, current_hid_device->usage_page, current_hid_device->interface_number, manu_name, prod_name);
-            }
-            detection_string = "";
-            DetectionProgressChanged();
-
-            /*-----------------------------------------------------------------------------*\
-            | Loop through all available wrapped HID detectors.  If all required            |
-            | information matches, run the detector                                         |
-            \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_wrapped_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
-            {
-                HIDWrappedDeviceDetectorBlock & detector = hid_wrapped_device_detectors[hid_detector_idx];
-                if(detector.compare(current_hid_device))
-                {
-                    detection_string = detector.name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
+    /*-----------------------------------------------------*\
+    | Count the controllers found by each detector, the     |
+    | detection cache is updated from them                  |
+    \*-----------------------------------------------------*/
+    DetectionJob            hotplug_job;
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+    hotplug_job.lane        = "HID hotplug";
+    hotplug_job.category    = DETECTION_CATEGORY_HID;
 
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
+    current_detection_job   = &hotplug_job;
 
-                        detector.function(wrapper, current_hid_device, detector.name);
-                    }
-                }
-            }
+    ResetHIDDetectorsEnabled();
 
-            /*-------------------------------------------------*\
-            | Update detection percent                          |
-            \*-------------------------------------------------*/
-            hid_device_count++;
+    ProcessHIDHotplugDevices(default_wrapper, false, hid_devices, hid_known_paths, changed_paths, detector_settings, counts);
+
+#ifdef __linux__
+#ifdef __GLIBC__
+    hidapi_wrapper  wrapper;
 
-            percent = (i2c_device_detectors.size() + i2c_dimm_device_detectors.size() + i2c_pci_device_detectors.size() + hid_device_count) / percent_denominator;
+    if(LoadLibusbHIDWrapper(wrapper))
+    {
+        hid_device_info* libusb_hid_devices = wrapper.hid_enumerate(0, 0);
 
-            detection_percent = percent * 100.0f;
+        ProcessHIDHotplugDevices(wrapper, true, libusb_hid_devices, hid_known_libusb_paths, changed_paths, detector_settings, counts);
 
-            /*-------------------------------------------------*\
-            | Move on to the next HID device                    |
-            \*-------------------------------------------------*/
-            current_hid_device = current_hid_device->next;
+        if(libusb_hid_devices != NULL)
+        {
+            wrapper.hid_free_enumeration(libusb_hid_devices);
         }
-
-        /*-------------------------------------------------*\
-        | Done using the device list, free it               |
-        \*-------------------------------------------------*/
-        wrapper.hid_free_enumeration(hid_devices);
     }
 #endif
 #endif
 
-    /*-------------------------------------------------*\
-    | Detect other devices                              |
-    \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|              Detecting other devices               |");
-    LOG_INFO("------------------------------------------------------");
+    ProcessHIDHotplugDevices(debug_wrapper, true, debug_hid_devices, hid_known_debug_paths, changed_paths, detector_settings, counts);
 
-    for(unsigned int detector_idx = 0; detector_idx < (unsigned int)device_detectors.size() && detection_is_required.load(); detector_idx++)
-    {
-        detection_string = device_detector_strings[detector_idx].c_str();
+    current_detection_job   = NULL;
 
-        /*-------------------------------------------------*\
-        | Check if this detector is enabled                 |
-        \*-------------------------------------------------*/
-        bool this_device_enabled = true;
-        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-        {
-            this_device_enabled = detector_settings["detectors"][detection_string];
-        }
+    unsigned int added_controllers = (unsigned int)(rgb_controllers_hw.size() + counts.removed_controllers - controllers_before);
 
-        LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+    LOG_INFO("[ResourceManager] HID hotplug: %u interfaces removed, %u interfaces detected, %u controllers removed, %u controllers added",
+             counts.removed_interfaces, counts.added_interfaces, counts.removed_controllers, added_controllers);
 
-        if(this_device_enabled)
-        {
-            DetectionProgressChanged();
+    /*-----------------------------------------------------*\
+    | Record the new device list in the detection cache, so |
+    | that the next start does not fall back to a full      |
+    | detection because of the hotplugged device            |
+    \*-----------------------------------------------------*/
+    bool detection_cache_enabled = detector_settings.contains("detection_cache") && detector_settings["detection_cache"];
 
-            device_detectors[detector_idx]();
-        }
+    if(detection_cache_enabled && (added_controllers > 0 || counts.removed_controllers > 0))
+    {
+        detection_fingerprint = GetDetectionFingerprint(hid_devices, detector_settings);
 
-        LOG_TRACE("[%s] detection end", detection_string);
+        UpdateDetectionCache(detection_cache->GetDetectionTime());
+    }
 
-        /*-------------------------------------------------*\
-        | Update detection percent                          |
-        \*-------------------------------------------------*/
-        percent = (i2c_device_detectors.size() + hid_device_count + detector_idx + 1.0f) / percent_denominator;
+    hid_free_enumeration(hid_devices);
 
-        detection_percent = (unsigned int)(percent * 100.0f);
+    if(debug_hid_devices != NULL)
+    {
+        debug_wrapper.hid_free_enumeration(debug_hid_devices);
     }
 
-    /*-------------------------------------------------*\
-    | Make sure that when the detection is done,        |
-    | progress bar is set to 100%                       |
-    \*-------------------------------------------------*/
-    ProcessPostDetection();
+    detection_string = "";
+
+    /*-----------------------------------------------------*\
+    | Let the detection end listeners check the new         |
+    | controllers, as after a full detection                |
+    \*-----------------------------------------------------*/
+    if(added_controllers > 0)
+    {
+        ProcessPostDetection();
+    }
+    else
+    {
+        detection_is_required = false;
+
+        DetectionProgressChanged();
+    }
 
     DetectDeviceMutex.unlock();
+}
 
-#ifdef __linux__
-    /*-------------------------------------------------*\
-    | If the udev rules file is not installed, show a   |
-    | dialog                                            |
-    \*-------------------------------------------------*/
-    if(udev_not_exist)
-    {
-        LOG_DIALOG("%s", UDEV_MISSING);
+/*---------------------------------------------------------*\
+| Mark the size profile entries matching the registered     |
+| controllers as used, without applying them again          |
+\*---------------------------------------------------------*/
+void ResourceManager::ResetSizeEntriesUsed()
+{
+    detection_size_entry_used.assign(rgb_controllers_sizes.size(), false);
 
-        udev_multiple       = false;
-        i2c_interface_fail  = false;
+    for(RGBController* controller : rgb_controllers_hw)
+    {
+        profile_manager->LoadDeviceFromListWithOptions(rgb_controllers_sizes, detection_size_entry_used, controller, false, false);
     }
+}
 
-    /*-------------------------------------------------*\
-    | If multiple udev rules files are installed, show  |
-    | a dialog                                          |
-    \*-------------------------------------------------*/
-    if(udev_multiple)
+/*---------------------------------------------------------*\
+| Forget a removed controller in the detector timings, so   |
+| that the detection cache no longer counts it              |
+\*---------------------------------------------------------*/
+void ResourceManager::RemoveDetectorTimingLocation(const std::string& location)
+{
+    std::lock_guard<std::mutex> lock(DetectorTimingsMutex);
+
+    for(DetectorTiming& timing : detector_timings)
     {
-        LOG_DIALOG("%s", UDEV_MUTLI);
+        std::vector<std::string>::iterator location_it = std::find(timing.locations.begin(), timing.locations.end(), location);
 
-        i2c_interface_fail  = false;
-    }
+        if(location_it != timing.locations.end())
+        {
+            timing.locations.erase(location_it);
 
-#endif
+            if(timing.controllers > 0)
+            {
+                timing.controllers--;
+            }
 
-    /*-------------------------------------------------*\
-    | If any i2c interfaces failed to detect due to an  |
-    | error condition, show a dialog                    |
-    \*-------------------------------------------------*/
-    if(i2c_interface_fail)
+            return;
+        }
+    }
+}
+
+/*---------------------------------------------------------*\
+| Second detection pass after a cached pass.  Controllers   |
+| found by the cached pass are kept, the other detectors    |
+| add theirs to the list.                                   |
+\*---------------------------------------------------------*/
+void ResourceManager::DetectRemainingDevicesCoroutine()
+{
+    /*-----------------------------------------------------*\
+    | A rescan or abort since the cached pass resets the    |
+    | phase, there is nothing left to do then               |
+    \*-----------------------------------------------------*/
+    if(detection_phase != DETECTION_PHASE_REMAINING)
     {
-#ifdef _WIN32
-        LOG_DIALOG("%s", I2C_ERR_WIN);
-#endif
-#ifdef __linux__
-        LOG_DIALOG("%s", I2C_ERR_LINUX);
-#endif
+        return;
     }
+
+    detection_percent       = 0;
+    detection_string        = "";
+    detection_is_required   = true;
+
+    DetectionProgressChanged();
+
+    DetectDevicesCoroutine();
 }
 
 void ResourceManager::StopDeviceDetection()
 {
     LOG_INFO("[ResourceManager] Detection abort requested");
     detection_is_required = false;
+    detection_phase = DETECTION_PHASE_FULL;
     detection_percent = 100;
     detection_string = "Stopping";
 }
 
+/*---------------------------------------------------------*\
+| Make the next detection check the detection cache again,  |
+| as it does on startup.  With discard set, the cache file  |
+| is deleted first so that the next detection runs every    |
+| detector and records a new cache.                         |
+\*---------------------------------------------------------*/
+void ResourceManager::ResetDetectionCache(bool discard)
+{
+    std::lock_guard<std::mutex> lock(DetectDeviceMutex);
+
+    if(discard)
+    {
+        std::error_code ec;
+
+        filesystem::remove(GetConfigurationDirectory() / "DetectionCache.json", ec);
+
+        detection_cache->Clear();
+    }
+
+    detection_cache_checked = false;
+}
+
 void ResourceManager::Initialize(bool tryConnect, bool detectDevices, bool startServer, bool applyPostOptions)
 {
     // Cache the parameters
@@ -1696,6 +3067,31 @@ void ResourceManager::InitCoroutine()
     if(detection_enabled)
     {
         LOG_DEBUG("[ResourceManager] Running standalone");
+
+        /*-----------------------------------------------------*\
+        | Start watching for HID hotplug events before the      |
+        | first detection, events received during detection     |
+        | are handled once it has finished                      |
+        \*-----------------------------------------------------*/
+        json detector_settings  = settings_manager->GetSettings("Detectors");
+        bool hid_hotplug        = false;
+
+        if(detector_settings.contains("hid_hotplug"))
+        {
+            hid_hotplug         = detector_settings["hid_hotplug"];
+        }
+
+        if(hid_hotplug && HIDHotplugMonitor::IsSupported() && hid_hotplug_monitor == NULL)
+        {
+            hid_hotplug_monitor = new HIDHotplugMonitor(std::bind(&ResourceManager::ProcessHIDHotplug, this, std::placeholders::_1));
+
+            if(!hid_hotplug_monitor->Start())
+            {
+                delete hid_hotplug_monitor;
+                hid_hotplug_monitor = NULL;
+            }
+        }
+
         if(ProcessPreDetection())
         {
             // We are currently in a coroutine, so run detection directly with no scheduling
@@ -1796,7 +3192,11 @@ void ResourceManager::BackgroundThreadFunction()
         }
         // This line will cause the thread to suspend until the condition variable is triggered
         // NOTE: it may be subject to "spurious wakeups"
-        BackgroundFunctionStartTrigger.wait(lock);
+        // A coroutine may schedule a follow-up coroutine while it runs, don't wait then
+        if(!ScheduledBackgroundFunction)
+        {
+            BackgroundFunctionStartTrigger.wait(lock);
+        }
     }
 }
 
@@ -1804,6 +3204,7 @@ void ResourceManager::UpdateDetectorSettings()
 {
     json                detector_settings;
     bool                save_settings       = false;
+    const char*         detector_name;
 
     /*-------------------------------------------------*\
     | Open device disable list and read in disabled     |
@@ -1817,11 +3218,11 @@ void ResourceManager::UpdateDetectorSettings()
     \*-------------------------------------------------*/
     for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_device_detectors.size(); i2c_detector_idx++)
     {
-        detection_string = i2c_device_detector_strings[i2c_detector_idx].c_str();
+        detector_name = i2c_device_detector_strings[i2c_detector_idx].c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][detector_name] = true;
             save_settings = true;
         }
     }
@@ -1832,11 +3233,11 @@ void ResourceManager::UpdateDetectorSettings()
     \*-------------------------------------------------*/
     for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_dimm_device_detectors.size(); i2c_detector_idx++)
     {
-        detection_string = i2c_dimm_device_detectors[i2c_detector_idx].name.c_str();
+        detector_name = i2c_dimm_device_detectors[i2c_detector_idx].name.c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][detector_name] = true;
             save_settings = true;
         }
     }
@@ -1847,11 +3248,11 @@ void ResourceManager::UpdateDetectorSettings()
     \*-------------------------------------------------*/
     for(unsigned int i2c_pci_detector_idx = 0; i2c_pci_detector_idx < (unsigned int)i2c_pci_device_detectors.size(); i2c_pci_detector_idx++)
     {
-        detection_string = i2c_pci_device_detectors[i2c_pci_detector_idx].name.c_str();
+        detector_name = i2c_pci_device_detectors[i2c_pci_detector_idx].name.c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][detector_name] = true;
             save_settings = true;
         }
     }
@@ -1862,11 +3263,11 @@ void ResourceManager::UpdateDetectorSettings()
     \*-------------------------------------------------*/
     for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size(); hid_detector_idx++)
     {
-        detection_string = hid_device_detectors[hid_detector_idx].name.c_str();
+        detector_name = hid_device_detectors[hid_detector_idx].name.c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][detector_name] = true;
             save_settings = true;
         }
     }
@@ -1877,11 +3278,11 @@ void ResourceManager::UpdateDetectorSettings()
     \*-------------------------------------------------*/
     for(unsigned int hid_wrapped_detector_idx = 0; hid_wrapped_detector_idx < (unsigned int)hid_wrapped_device_detectors.size(); hid_wrapped_detector_idx++)
     {
-        detection_string = hid_wrapped_device_detectors[hid_wrapped_detector_idx].name.c_str();
+        detector_name = hid_wrapped_device_detectors[hid_wrapped_detector_idx].name.c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][detector_name] = true;
             save_settings = true;
         }
     }
@@ -1892,11 +3293,11 @@ void ResourceManager::UpdateDetectorSettings()
     \*-------------------------------------------------*/
     for(unsigned int detector_idx = 0; detector_idx < (unsigned int)device_detectors.size(); detector_idx++)
     {
-        detection_string = device_detector_strings[detector_idx].c_str();
+        detector_name = device_detector_strings[detector_idx].c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][detector_name] = true;
             save_settings = true;
         }
     }
@@ -1935,16 +3336,53 @@ void ResourceManager::WaitForDeviceDetection()
     DetectDeviceMutex.unlock();
 }
 
+void ResourceManager::ResetHIDDetectorsEnabled()
+{
+    hid_device_detector_resolved.assign(hid_device_detectors.size(), false);
+    hid_device_detector_enabled.assign(hid_device_detectors.size(), true);
+    hid_wrapped_device_detector_resolved.assign(hid_wrapped_device_detectors.size(), false);
+    hid_wrapped_device_detector_enabled.assign(hid_wrapped_device_detectors.size(), true);
+}
+
+/*---------------------------------------------------------*\
+| Look up whether a HID detector is enabled.  The settings  |
+| lookup is only done the first time a detector matches in  |
+| a detection pass, later matches reuse the cached flag.    |
+| HID lanes may run in parallel, so the cache and settings  |
+| are accessed under DetectorSettingsMutex.                 |
+\*---------------------------------------------------------*/
+bool ResourceManager::IsHIDDetectorEnabled(json &detector_settings, bool wrapped, unsigned int hid_detector_idx)
+{
+    std::lock_guard<std::mutex> lock(DetectorSettingsMutex);
+
+    std::vector<bool>&  resolved    = wrapped ? hid_wrapped_device_detector_resolved : hid_device_detector_resolved;
+    std::vector<bool>&  enabled     = wrapped ? hid_wrapped_device_detector_enabled  : hid_device_detector_enabled;
+
+    if(!resolved[hid_detector_idx])
+    {
+        const std::string& name = wrapped ? hid_wrapped_device_detectors[hid_detector_idx].name : hid_device_detectors[hid_detector_idx].name;
+
+        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(name))
+        {
+            enabled[hid_detector_idx] = detector_settings["detectors"][name];
+        }
+
+        resolved[hid_detector_idx] = true;
+    }
+
+    return(enabled[hid_detector_idx]);
+}
+
 bool ResourceManager::IsAnyDimmDetectorEnabled(json &detector_settings)
 {
     for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < i2c_dimm_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
     {
-        detection_string = i2c_dimm_device_detectors[i2c_detector_idx].name.c_str();
+        const char* detector_name = i2c_dimm_device_detectors[i2c_detector_idx].name.c_str();
         /*-------------------------------------------------*\
         | Check if this detector is enabled                 |
         \*-------------------------------------------------*/
-        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string) &&
-           detector_settings["detectors"][detection_string] == true)
+        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector_name) &&
+           detector_settings["detectors"][detector_name] == true)
         {
             return true;
         }
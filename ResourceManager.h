@@ -13,11 +13,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <functional>
+#include <mutex>
+#include <set>
 #include <thread>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "SPDWrapper.h"
 #include "hidapi_wrapper.h"
@@ -35,6 +40,9 @@ using json = nlohmann::json;
 #define CONTROLLER_LIST_HID 0
 
 struct hid_device_info;
+class DetectionCache;
+class DeviceUpdatePool;
+class HIDHotplugMonitor;
 class NetworkClient;
 class NetworkServer;
 class ProfileManager;
@@ -95,6 +103,71 @@ typedef struct
     uint8_t                         dimm_type;
 } I2CDIMMDeviceDetectorBlock;
 
+/*---------------------------------------------------------*\
+| Detection job categories, used to sum up detection time   |
+\*---------------------------------------------------------*/
+enum
+{
+    DETECTION_CATEGORY_I2C,
+    DETECTION_CATEGORY_HID,
+    DETECTION_CATEGORY_NETWORK,
+    DETECTION_CATEGORY_OTHER,
+    DETECTION_CATEGORY_COUNT
+};
+
+/*---------------------------------------------------------*\
+| Detection phases.  When the detection cache matches, the  |
+| detectors that found devices last time run first and the  |
+| remaining detectors run afterwards in the background.     |
+\*---------------------------------------------------------*/
+enum
+{
+    DETECTION_PHASE_FULL,
+    DETECTION_PHASE_CACHED,
+    DETECTION_PHASE_REMAINING
+};
+
+#define DETECTION_MIN_THREADS   2
+#define DETECTION_MAX_THREADS   8
+
+/*---------------------------------------------------------*\
+| A unit of detection work.  Jobs with the same lane touch  |
+| the same bus and never run at the same time.  Controllers |
+| registered by a job running in parallel are held in the   |
+| job until all jobs are done.                              |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    std::string                             lane;
+    int                                     category;
+    std::function<void()>                   function;
+    bool                                    defer_registration  = false;
+    unsigned int                            controllers_found   = 0;
+    std::vector<RGBController*>             controllers;
+    std::vector<std::string>                locations;
+    std::chrono::steady_clock::duration     job_time{};
+    std::chrono::steady_clock::duration     detector_time{};
+    unsigned int                            detectors_run       = 0;
+} DetectionJob;
+
+typedef struct
+{
+    std::string                             name;
+    double                                  time_ms;
+    unsigned int                            controllers;
+    std::vector<std::string>                locations;
+} DetectorTiming;
+
+/*---------------------------------------------------------*\
+| Interface and controller counts of one HID hotplug event  |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    unsigned int                            added_interfaces;
+    unsigned int                            removed_interfaces;
+    unsigned int                            removed_controllers;
+} HIDHotplugCounts;
+
 /*-------------------------------------------------------------------------*\
 | Define a macro for QT lupdate to parse                                    |
 \*-------------------------------------------------------------------------*/
@@ -123,6 +196,7 @@ public:
 
     void RegisterI2CBusDetector         (I2CBusDetectorFunction     detector);
     void RegisterDeviceDetector         (std::string name, DeviceDetectorFunction     detector);
+    void RegisterNetworkDeviceDetector  (std::string name, DeviceDetectorFunction     detector);
     void RegisterI2CDeviceDetector      (std::string name, I2CDeviceDetectorFunction  detector);
     void RegisterI2CDIMMDeviceDetector  (std::string name, I2CDIMMDeviceDetectorFunction detector, uint16_t jedec_id, uint8_t dimm_type);
     void RegisterI2CPCIDeviceDetector   (std::string name, I2CPCIDeviceDetectorFunction detector, uint16_t ven_id, uint16_t dev_id, uint16_t subven_id, uint16_t subdev_id, uint8_t i2c_addr);
@@ -157,8 +231,11 @@ public:
 
     bool         GetDetectionEnabled();
     unsigned int GetDetectionPercent();
+    int          GetDetectionPhase();
     const char*  GetDetectionString();
 
+    std::vector<DetectorTiming>     GetDetectorTimings();
+
     filesystem::path                GetConfigurationDirectory();
 
     void RegisterNetworkClient(NetworkClient* new_client);
@@ -167,6 +244,8 @@ public:
     std::vector<NetworkClient*>&    GetClients();
     NetworkServer*                  GetServer();
 
+    DeviceUpdatePool*               GetDeviceUpdatePool();
+
     ProfileManager*                 GetProfileManager();
     SettingsManager*                GetSettingsManager();
 
@@ -189,6 +268,8 @@ public:
 
     void StopDeviceDetection();
 
+    void ResetDetectionCache(bool discard);
+
     void WaitForInitialization();
     void WaitForDeviceDetection();
 
@@ -199,6 +280,26 @@ private:
     bool ProcessPreDetection();
     void ProcessPostDetection();
     bool IsAnyDimmDetectorEnabled(json &detector_settings);
+    void ResetHIDDetectorsEnabled();
+    bool IsHIDDetectorEnabled(json &detector_settings, bool wrapped, unsigned int hid_detector_idx);
+    void ProbeDIMMSlots(std::vector<std::vector<SPDWrapper>>& dimm_slots, bool parallel);
+    void ProbeDIMMBus(unsigned int bus, std::vector<SPDWrapper>& slots);
+    void DetectDIMMBus(unsigned int bus, std::vector<SPDWrapper>& slots, json &detector_settings);
+    void DetectHIDDevice(hidapi_wrapper wrapper, hid_device_info* current_hid_device, json &detector_settings, bool libusb);
+    void DetectHIDDevicesSafeMode(json &detector_settings);
+    void RunDetector(const std::string& name, std::function<void()> detector);
+    void RunDetectionJobs(std::vector<DetectionJob>& jobs, bool parallel);
+    bool IsDetectorInPhase(const std::string& name);
+    std::string GetI2CBusDescription(i2c_smbus_interface* bus);
+    std::string GetDetectionFingerprint(hid_device_info* hid_devices, json &detector_settings);
+    void UpdateDetectionCache(double detection_time_ms);
+    void DetectRemainingDevicesCoroutine();
+    void UpdateHIDKnownPaths(hid_device_info* hid_devices, hid_device_info* libusb_hid_devices, hid_device_info* debug_hid_devices);
+    void ProcessHIDHotplugDevices(hidapi_wrapper wrapper, bool libusb, hid_device_info* hid_devices, std::set<std::string>& known_paths, const std::set<std::string>& changed_paths, json& detector_settings, HIDHotplugCounts& counts);
+    void ProcessHIDHotplug(const std::set<std::string>& changed_paths);
+    void ResetSizeEntriesUsed();
+    void RemoveDetectorTimingLocation(const std::string& location);
+    void LogDetectionSummary(std::vector<DetectionJob>& jobs, std::chrono::steady_clock::duration detection_time, std::chrono::steady_clock::duration hid_enumerate_time);
     void RunInBackgroundThread(std::function<void()>);
     void BackgroundThreadFunction();
 
@@ -249,6 +350,11 @@ private:
     \*-------------------------------------------------------------------------------------*/
     SettingsManager*                            settings_manager;
 
+    /*-------------------------------------------------------------------------------------*\
+    | Device Update Pool                                                                    |
+    \*-------------------------------------------------------------------------------------*/
+    DeviceUpdatePool*                           update_pool;
+
     /*-------------------------------------------------------------------------------------*\
     | I2C/SMBus Interfaces                                                                  |
     \*-------------------------------------------------------------------------------------*/
@@ -276,6 +382,7 @@ private:
     \*-------------------------------------------------------------------------------------*/
     std::vector<DeviceDetectorFunction>         device_detectors;
     std::vector<std::string>                    device_detector_strings;
+    std::vector<bool>                           device_detector_network;
     std::vector<I2CBusDetectorFunction>         i2c_bus_detectors;
     std::vector<I2CDeviceDetectorFunction>      i2c_device_detectors;
     std::vector<std::string>                    i2c_device_detector_strings;
@@ -287,6 +394,22 @@ private:
     std::vector<std::string>                    dynamic_detector_strings;
     std::vector<PreDetectionHookFunction>       pre_detection_hooks;
 
+    /*-------------------------------------------------------------------------------------*\
+    | HID detector lookup                                                                   |
+    |   The index maps a VID:PID key to the detectors registered for it, in registration    |
+    |   order.  Each detector's enabled flag is read from the detector settings the first   |
+    |   time it matches in a detection pass and cached for the rest of the pass.            |
+    \*-------------------------------------------------------------------------------------*/
+    std::unordered_map<uint32_t, std::vector<unsigned int>>
+                                                hid_device_detector_index;
+    std::unordered_map<uint32_t, std::vector<unsigned int>>
+                                                hid_wrapped_device_detector_index;
+    std::vector<bool>                           hid_device_detector_resolved;
+    std::vector<bool>                           hid_device_detector_enabled;
+    std::vector<bool>                           hid_wrapped_device_detector_resolved;
+    std::vector<bool>                           hid_wrapped_device_detector_enabled;
+    std::mutex                                  DetectorSettingsMutex;
+
     bool                                        dynamic_detectors_processed;
 
     /*-------------------------------------------------------------------------------------*\
@@ -303,7 +426,33 @@ private:
     std::atomic<unsigned int>                   detection_percent;
     std::atomic<unsigned int>                   detection_prev_size;
     std::vector<bool>                           detection_size_entry_used;
-    const char*                                 detection_string;
+    std::atomic<const char*>                    detection_string;
+
+    /*-------------------------------------------------------------------------------------*\
+    | Per-detector timing of the last detection pass                                        |
+    \*-------------------------------------------------------------------------------------*/
+    std::mutex                                  DetectorTimingsMutex;
+    std::vector<DetectorTiming>                 detector_timings;
+
+    /*-------------------------------------------------------------------------------------*\
+    | Detection cache                                                                       |
+    \*-------------------------------------------------------------------------------------*/
+    DetectionCache*                             detection_cache;
+    std::atomic<int>                            detection_phase;
+    bool                                        detection_cache_checked;
+    std::string                                 detection_fingerprint;
+    std::chrono::steady_clock::duration         detection_cached_phase_time;
+    std::set<std::string>                       detection_skipped_busses;
+
+    /*-------------------------------------------------------------------------------------*\
+    | HID hotplug                                                                           |
+    |   The known paths are the hidraw, libusb and debug HID paths present at the last      |
+    |   detection or hotplug event, changes are detected against them                       |
+    \*-------------------------------------------------------------------------------------*/
+    HIDHotplugMonitor*                          hid_hotplug_monitor;
+    std::set<std::string>                       hid_known_paths;
+    std::set<std::string>                       hid_known_libusb_paths;
+    std::set<std::string>                       hid_known_debug_paths;
 
 
     /*-------------------------------------------------------------------------------------*\
@@ -8,6 +8,7 @@
 \*---------------------------------------------------------*/
 
 #include <chrono>
+#include <cstring>
 #include "DDR4DirectAccessor.h"
 
 using namespace std::chrono_literals;
@@ -53,7 +54,11 @@ bool DDR4DirectAccessor::isAvailable(i2c_smbus_interface *bus, uint8_t spd_addr)
 
 SPDAccessor *DDR4DirectAccessor::copy()
 {
-    return new DDR4DirectAccessor(bus, address);
+    DDR4DirectAccessor *access = new DDR4DirectAccessor(bus, address);
+    memcpy(access->dump, this->dump, sizeof(this->dump));
+    memcpy(access->dump_valid, this->dump_valid, sizeof(this->dump_valid));
+    access->block_read = this->block_read;
+    return access;
 }
 
 uint8_t DDR4DirectAccessor::at(uint16_t addr)
@@ -66,11 +71,60 @@ uint8_t DDR4DirectAccessor::at(uint16_t addr)
         return 0xFF;
     }
 
+    /*-----------------------------------------------------*\
+    | Read the SPD into the cache on first access           |
+    \*-----------------------------------------------------*/
+    if(!dump_valid[addr] && !read(addr))
+    {
+        return 0xFF;
+    }
+
+    /*-----------------------------------------------------*\
+    | Return value                                          |
+    \*-----------------------------------------------------*/
+    return(dump[addr]);
+}
+
+/*---------------------------------------------------------*\
+| Read the block containing addr into the cache, or only    |
+| the byte at addr once the bus rejected a block read       |
+\*---------------------------------------------------------*/
+bool DDR4DirectAccessor::read(uint16_t addr)
+{
     /*-----------------------------------------------------*\
     | Switch to the page containing address                 |
     \*-----------------------------------------------------*/
     set_page(addr >> SPD_DDR4_EEPROM_PAGE_SHIFT);
 
+    if(block_read)
+    {
+        uint16_t block_addr = addr & ~(SPD_BLOCK_READ_LENGTH - 1);
+
+        /*-------------------------------------------------*\
+        | Calculate block offset                            |
+        \*-------------------------------------------------*/
+        uint8_t offset = (uint8_t)(block_addr & SPD_DDR4_EEPROM_PAGE_MASK);
+
+        /*-------------------------------------------------*\
+        | Read block at address                             |
+        \*-------------------------------------------------*/
+        int length = bus->i2c_smbus_read_i2c_block_data(address, offset, SPD_BLOCK_READ_LENGTH, &dump[block_addr]);
+
+        std::this_thread::sleep_for(SPD_IO_DELAY);
+
+        if(length == SPD_BLOCK_READ_LENGTH)
+        {
+            for(uint16_t block_idx = 0; block_idx < SPD_BLOCK_READ_LENGTH; block_idx++)
+            {
+                dump_valid[block_addr + block_idx] = true;
+            }
+
+            return(true);
+        }
+
+        block_read = false;
+    }
+
     /*-----------------------------------------------------*\
     | Calculate offset                                      |
     \*-----------------------------------------------------*/
@@ -79,14 +133,19 @@ uint8_t DDR4DirectAccessor::at(uint16_t addr)
     /*-----------------------------------------------------*\
     | Read value at address                                 |
     \*-----------------------------------------------------*/
-    uint32_t value = bus->i2c_smbus_read_byte_data(address, offset);
+    int value = bus->i2c_smbus_read_byte_data(address, offset);
 
     std::this_thread::sleep_for(SPD_IO_DELAY);
 
-    /*-----------------------------------------------------*\
-    | Return value                                          |
-    \*-----------------------------------------------------*/
-    return((uint8_t)value);
+    if(value < 0)
+    {
+        return(false);
+    }
+
+    dump[addr]          = (uint8_t)value;
+    dump_valid[addr]    = true;
+
+    return(true);
 }
 
 void DDR4DirectAccessor::set_page(uint8_t page)
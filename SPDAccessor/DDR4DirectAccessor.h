@@ -28,5 +28,10 @@ class DDR4DirectAccessor : public DDR4Accessor
     static const uint8_t    SPD_DDR4_EEPROM_PAGE_SHIFT  = 8;
     static const uint8_t    SPD_DDR4_EEPROM_PAGE_MASK   = 0xFF;
 
+    uint8_t                 dump[SPD_DDR4_EEPROM_LENGTH];
+    bool                    dump_valid[SPD_DDR4_EEPROM_LENGTH] = {};
+    bool                    block_read                  = true;
+
     void set_page(uint8_t page);
+    bool read(uint16_t addr);
 };
@@ -29,5 +29,10 @@ class DDR5DirectAccessor : public DDR5Accessor
     static const uint8_t    SPD_DDR5_EEPROM_PAGE_MASK   = 0x7F;
     static const uint8_t    SPD_DDR5_MREG_VIRTUAL_PAGE  = 0x0B;
 
+    uint8_t                 dump[SPD_DDR5_EEPROM_LENGTH];
+    bool                    dump_valid[SPD_DDR5_EEPROM_LENGTH] = {};
+    bool                    block_read                  = true;
+
     void set_page(uint8_t page);
+    bool read(uint16_t addr);
 };
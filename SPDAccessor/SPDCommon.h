@@ -51,4 +51,10 @@ typedef enum
 
 #define SPD_IO_DELAY   1ms
 
+/*---------------------------------------------------------*\
+| Direct accessors read and cache the SPD in blocks of this |
+| many bytes if the bus supports I2C block reads            |
+\*---------------------------------------------------------*/
+#define SPD_BLOCK_READ_LENGTH   32
+
 extern const char *spd_memory_type_name[];
@@ -12,12 +12,17 @@
 #include <string>
 #include <tuple>
 #include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <thread>
 #include "AutoStart.h"
+#include "Benchmark.h"
 #include "filesystem.h"
 #include "ProfileManager.h"
 #include "ResourceManager.h"
 #include "RGBController.h"
 #include "i2c_smbus.h"
+#include "hidapi_wrapper_debug.h"
 #include "NetworkClient.h"
 #include "NetworkServer.h"
 #include "LogManager.h"
@@ -401,6 +406,16 @@ void OptionHelp()
     help_text += "--server-host                            Sets the SDK's server host. Default: 0.0.0.0 (all network interfaces)\n";
     help_text += "--server-port                            Sets the SDK's server port. Default: 6742 (1024-65535)\n";
     help_text += "-l,  --list-devices                      Lists every compatible device with their number\n";
+    help_text += "--benchmark [frames]                     Prints detection timings, then times the given number of LED updates (default 100) on every device\n";
+    help_text += "                                           Combine with the DebugDevices settings to benchmark the simulated SMBus and HID devices\n";
+    help_text += "--benchmark scenario[:frames]            Runs one of the self-contained benchmark scenarios below instead\n";
+
+    for(const BenchmarkScenario& scenario : GetBenchmarkScenarios())
+    {
+        std::string scenario_name = scenario.name;
+
+        help_text += "                                             " + scenario_name + std::string(scenario_name.size() < 20 ? 20 - scenario_name.size() : 1, ' ') + scenario.description + "\n";
+    }
     help_text += "-d,  --device [0-9 | \"name\"]             Selects device to apply colors and/or effect to, or applies to all devices if omitted\n";
     help_text += "                                           Basic string search is implemented 3 characters or more\n";
     help_text += "                                           Can be specified multiple times with different modes and colors\n";
@@ -559,6 +574,140 @@ void OptionListDevices(std::vector<RGBController *>& rgb_controllers)
     }
 }
 
+void OptionBenchmark(std::vector<RGBController *>& rgb_controllers, unsigned int frames)
+{
+    ResourceManager::get()->WaitForDeviceDetection();
+
+    /*---------------------------------------------------------*\
+    | Print the time each detector took                         |
+    \*---------------------------------------------------------*/
+    std::vector<DetectorTiming> detector_timings = ResourceManager::get()->GetDetectorTimings();
+
+    std::cout << "Detection:" << std::endl;
+
+    for(std::size_t timing_idx = 0; timing_idx < detector_timings.size(); timing_idx++)
+    {
+        std::cout << "  " << std::left << std::setw(48) << detector_timings[timing_idx].name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << detector_timings[timing_idx].time_ms << " ms  "
+                  << detector_timings[timing_idx].controllers << " controller(s)" << std::endl;
+    }
+
+    /*---------------------------------------------------------*\
+    | Remember the bus hand-offs made so far, so that only the  |
+    | ones made by the update loops are reported                |
+    \*---------------------------------------------------------*/
+    std::vector<i2c_smbus_interface*>&  busses = ResourceManager::get()->GetI2CBusses();
+    std::vector<unsigned long long>     bus_handoffs;
+
+    for(std::size_t bus_idx = 0; bus_idx < busses.size(); bus_idx++)
+    {
+        bus_handoffs.push_back(busses[bus_idx]->i2c_smbus_get_handoff_count());
+    }
+
+    unsigned long long hid_reports = hidapi_wrapper_debug_get_report_count();
+
+    /*---------------------------------------------------------*\
+    | Send a changing color to every device each frame and time |
+    | each UpdateLEDs() until the device has sent the frame.    |
+    | The update goes through the controller's update thread    |
+    | or the device update pool, so it never runs concurrently  |
+    | with another update of the same device.  The refresh rate |
+    | limit is lifted while the device is measured.             |
+    \*---------------------------------------------------------*/
+    std::cout << std::endl << "UpdateLEDs (" << frames << " frames):" << std::endl;
+
+    for(std::size_t controller_idx = 0; controller_idx < rgb_controllers.size(); controller_idx++)
+    {
+        RGBController*                          controller  = rgb_controllers[controller_idx];
+        std::chrono::steady_clock::duration     total_time{};
+        std::chrono::steady_clock::duration     max_time{};
+        unsigned int                            frames_sent = 0;
+        unsigned int                            max_refresh_rate = controller->GetMaxRefreshRate();
+
+        controller->SetMaxRefreshRate(0);
+
+        /*-----------------------------------------------------*\
+        | The first frame is not timed, it lets an update that  |
+        | was already in progress finish                        |
+        \*-----------------------------------------------------*/
+        for(unsigned int frame = 0; frame <= frames; frame++)
+        {
+            unsigned char red   = (unsigned char)(frame * 8);
+            unsigned char green = (unsigned char)(255 - red);
+            unsigned char blue  = (unsigned char)(red / 2);
+
+            controller->SetAllLEDs(ToRGBColor(red, green, blue));
+
+            unsigned long long                      sent_count  = controller->GetFrameCounters().sent;
+            std::chrono::steady_clock::time_point   start_time  = std::chrono::steady_clock::now();
+
+            controller->UpdateLEDs();
+
+            while(controller->GetFrameCounters().sent == sent_count)
+            {
+                if((std::chrono::steady_clock::now() - start_time) > std::chrono::seconds(5))
+                {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+
+            std::chrono::steady_clock::duration     frame_time  = std::chrono::steady_clock::now() - start_time;
+
+            if(frame == 0)
+            {
+                continue;
+            }
+
+            if(controller->GetFrameCounters().sent == sent_count)
+            {
+                std::cout << "  " << std::left << std::setw(4) << controller_idx << controller->name << ": frame not sent within 5 s, skipping" << std::endl;
+                break;
+            }
+
+            total_time += frame_time;
+            frames_sent++;
+
+            if(frame_time > max_time)
+            {
+                max_time = frame_time;
+            }
+        }
+
+        controller->SetMaxRefreshRate(max_refresh_rate);
+
+        if(frames_sent < frames)
+        {
+            continue;
+        }
+
+        double average_us   = (frames > 0) ? std::chrono::duration<double, std::micro>(total_time).count() / frames : 0.0;
+        double max_us       = std::chrono::duration<double, std::micro>(max_time).count();
+
+        std::cout << "  " << std::left << std::setw(4) << controller_idx << std::setw(44) << controller->name
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(12) << average_us << " us avg "
+                  << std::setw(12) << max_us << " us max" << std::endl;
+    }
+
+    /*---------------------------------------------------------*\
+    | Print the bus traffic caused by the update loops          |
+    \*---------------------------------------------------------*/
+    std::cout << std::endl << "SMBus hand-offs:" << std::endl;
+
+    for(std::size_t bus_idx = 0; bus_idx < busses.size(); bus_idx++)
+    {
+        unsigned long long handoffs = busses[bus_idx]->i2c_smbus_get_handoff_count() - bus_handoffs[bus_idx];
+
+        if(handoffs > 0)
+        {
+            std::cout << "  " << std::left << std::setw(48) << busses[bus_idx]->device_name << std::right << std::setw(12) << handoffs << std::endl;
+        }
+    }
+
+    std::cout << std::endl << "Debug HID feature reports: " << (hidapi_wrapper_debug_get_report_count() - hid_reports) << std::endl;
+}
+
 bool OptionDevice(std::vector<DeviceOptions>* current_devices, std::string argument, Options* options, std::vector<RGBController *>& rgb_controllers)
 {
     bool found = false;
@@ -934,6 +1083,62 @@ int ProcessOptions(Options* options, std::vector<RGBController *>& rgb_controlle
             exit(0);
         }
 
+        /*---------------------------------------------------------*\
+        | --benchmark [frames]                                      |
+        | --benchmark scenario[:frames]                             |
+        \*---------------------------------------------------------*/
+        else if(option == "--benchmark")
+        {
+            unsigned int    frames          = 100;
+            std::string     scenario        = "";
+            std::string     frames_argument = argument;
+
+            if(!argument.empty() && argument[0] != '-' && argument.find_first_not_of("0123456789") != std::string::npos)
+            {
+                std::size_t separator = argument.find(':');
+
+                scenario        = argument.substr(0, separator);
+                frames_argument = (separator == std::string::npos) ? "" : argument.substr(separator + 1);
+            }
+
+            if(!frames_argument.empty() && frames_argument.find_first_not_of("0123456789") == std::string::npos)
+            {
+                try
+                {
+                    unsigned long frame_count = std::stoul(frames_argument);
+
+                    if(frame_count > 1000000)
+                    {
+                        throw nullptr;
+                    }
+
+                    frames = (unsigned int)frame_count;
+                }
+                catch(...)
+                {
+                    std::cout << "Error: Invalid frame count: " + frames_argument << std::endl;
+                    return RET_FLAG_PRINT_HELP;
+                }
+            }
+            else if(!scenario.empty() && !frames_argument.empty())
+            {
+                std::cout << "Error: Invalid frame count: " + frames_argument << std::endl;
+                return RET_FLAG_PRINT_HELP;
+            }
+
+            if(scenario.empty())
+            {
+                OptionBenchmark(rgb_controllers, frames);
+            }
+            else if(!RunBenchmarkScenario(scenario, frames))
+            {
+                std::cout << "Error: Unknown benchmark scenario: " + scenario << std::endl;
+                return RET_FLAG_PRINT_HELP;
+            }
+
+            exit(0);
+        }
+
         /*---------------------------------------------------------*\
         | -d / --device                                             |
         \*---------------------------------------------------------*/
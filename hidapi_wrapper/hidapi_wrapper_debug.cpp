@@ -0,0 +1,329 @@
+/*---------------------------------------------------------*\
+| hidapi_wrapper_debug.cpp                                  |
+|                                                           |
+|   Simulated hidapi backend answering feature reports      |
+|   from scripted devices, for testing without hardware     |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hidapi_wrapper_debug.h"
+
+using json = nlohmann::json;
+
+/*---------------------------------------------------------*\
+| A simulated device.  Scripted feature reports are         |
+| returned as given, reports without a script return what   |
+| was last sent with the same report ID.                    |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    std::string                                         path;
+    unsigned short                                      vendor_id;
+    unsigned short                                      product_id;
+    int                                                 interface_number;
+    unsigned short                                      usage_page;
+    unsigned short                                      usage;
+    std::string                                         manufacturer;
+    std::string                                         product;
+    std::string                                         serial;
+    unsigned int                                        latency_us;
+    std::map<unsigned char, std::vector<unsigned char>> scripted_reports;
+    std::map<unsigned char, std::vector<unsigned char>> sent_reports;
+    std::mutex                                          mutex;
+} debug_hid_model;
+
+typedef struct
+{
+    std::shared_ptr<debug_hid_model>                    model;
+} debug_hid_handle;
+
+static std::vector<std::shared_ptr<debug_hid_model>>    debug_hid_models;
+static std::mutex                                       debug_hid_models_mutex;
+static std::atomic<unsigned long long>                  debug_hid_report_count(0);
+
+static unsigned int debug_hid_parse_number(const json& value)
+{
+    if(value.is_string())
+    {
+        return((unsigned int)strtoul(value.get<std::string>().c_str(), NULL, 0));
+    }
+
+    return(value.get<unsigned int>());
+}
+
+static wchar_t* debug_hid_wcsdup(const std::string& string)
+{
+    wchar_t* copy = (wchar_t*)calloc(string.size() + 1, sizeof(wchar_t));
+
+    for(std::size_t i = 0; i < string.size(); i++)
+    {
+        copy[i] = (wchar_t)(unsigned char)string[i];
+    }
+
+    return(copy);
+}
+
+static void debug_hid_wait(debug_hid_model* model)
+{
+    if(model->latency_us > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(model->latency_us));
+    }
+}
+
+unsigned int hidapi_wrapper_debug_load(const json& hid_devices)
+{
+    std::vector<std::shared_ptr<debug_hid_model>> models;
+
+    for(unsigned int device_idx = 0; device_idx < hid_devices.size(); device_idx++)
+    {
+        const json&                         device_settings = hid_devices[device_idx];
+        std::shared_ptr<debug_hid_model>    model           = std::make_shared<debug_hid_model>();
+
+        if(!device_settings.contains("vendor_id") || !device_settings.contains("product_id"))
+        {
+            continue;
+        }
+
+        model->path             = "debug-hid:" + std::to_string(device_idx);
+        model->vendor_id        = (unsigned short)debug_hid_parse_number(device_settings["vendor_id"]);
+        model->product_id       = (unsigned short)debug_hid_parse_number(device_settings["product_id"]);
+        model->interface_number = device_settings.contains("interface")  ? (int)debug_hid_parse_number(device_settings["interface"])             : 0;
+        model->usage_page       = device_settings.contains("usage_page") ? (unsigned short)debug_hid_parse_number(device_settings["usage_page"]) : 0;
+        model->usage            = device_settings.contains("usage")      ? (unsigned short)debug_hid_parse_number(device_settings["usage"])      : 0;
+        model->manufacturer     = device_settings.contains("manufacturer") ? device_settings["manufacturer"].get<std::string>() : "OpenRGB";
+        model->product          = device_settings.contains("product")      ? device_settings["product"].get<std::string>()      : "Debug HID Device";
+        model->serial           = device_settings.contains("serial")       ? device_settings["serial"].get<std::string>()       : "";
+        model->latency_us       = device_settings.contains("latency_us")   ? debug_hid_parse_number(device_settings["latency_us"]) : 0;
+
+        /*-------------------------------------------------*\
+        | Feature reports are keyed by report ID, the data  |
+        | starts with the report ID byte                    |
+        \*-------------------------------------------------*/
+        if(device_settings.contains("feature_reports"))
+        {
+            for(json::const_iterator it = device_settings["feature_reports"].begin(); it != device_settings["feature_reports"].end(); it++)
+            {
+                unsigned char               report_id = (unsigned char)strtoul(it.key().c_str(), NULL, 0);
+                std::vector<unsigned char>  report;
+
+                for(unsigned int byte_idx = 0; byte_idx < it.value().size(); byte_idx++)
+                {
+                    report.push_back((unsigned char)debug_hid_parse_number(it.value()[byte_idx]));
+                }
+
+                if(report.empty())
+                {
+                    report.push_back(report_id);
+                }
+
+                report[0] = report_id;
+
+                model->scripted_reports[report_id] = report;
+            }
+        }
+
+        models.push_back(model);
+    }
+
+    std::lock_guard<std::mutex> lock(debug_hid_models_mutex);
+
+    debug_hid_models        = models;
+    debug_hid_report_count  = 0;
+
+    return((unsigned int)debug_hid_models.size());
+}
+
+unsigned long long hidapi_wrapper_debug_get_report_count()
+{
+    return(debug_hid_report_count.load());
+}
+
+static int debug_hid_send_feature_report(hid_device* dev, const unsigned char* data, size_t length)
+{
+    debug_hid_model* model = ((debug_hid_handle*)dev)->model.get();
+
+    if(length == 0)
+    {
+        return(-1);
+    }
+
+    debug_hid_wait(model);
+    debug_hid_report_count++;
+
+    std::lock_guard<std::mutex> lock(model->mutex);
+
+    model->sent_reports[data[0]].assign(data, data + length);
+
+    return((int)length);
+}
+
+static int debug_hid_get_feature_report(hid_device* dev, unsigned char* data, size_t length)
+{
+    debug_hid_model* model = ((debug_hid_handle*)dev)->model.get();
+
+    if(length == 0)
+    {
+        return(-1);
+    }
+
+    debug_hid_wait(model);
+    debug_hid_report_count++;
+
+    std::lock_guard<std::mutex> lock(model->mutex);
+
+    std::map<unsigned char, std::vector<unsigned char>>::iterator it = model->scripted_reports.find(data[0]);
+
+    if(it == model->scripted_reports.end())
+    {
+        it = model->sent_reports.find(data[0]);
+
+        if(it == model->sent_reports.end())
+        {
+            return(-1);
+        }
+    }
+
+    size_t report_length = (it->second.size() < length) ? it->second.size() : length;
+
+    memcpy(data, it->second.data(), report_length);
+
+    return((int)report_length);
+}
+
+static int debug_hid_get_serial_number_string(hid_device* dev, wchar_t* string, size_t maxlen)
+{
+    debug_hid_model* model = ((debug_hid_handle*)dev)->model.get();
+
+    if(maxlen == 0)
+    {
+        return(-1);
+    }
+
+    size_t i;
+
+    for(i = 0; i < model->serial.size() && i < (maxlen - 1); i++)
+    {
+        string[i] = (wchar_t)(unsigned char)model->serial[i];
+    }
+
+    string[i] = L'\0';
+
+    return(0);
+}
+
+static hid_device* debug_hid_open_path(const char* path)
+{
+    std::lock_guard<std::mutex> lock(debug_hid_models_mutex);
+
+    for(std::size_t model_idx = 0; model_idx < debug_hid_models.size(); model_idx++)
+    {
+        if(debug_hid_models[model_idx]->path == path)
+        {
+            debug_hid_handle* handle = new debug_hid_handle;
+
+            handle->model = debug_hid_models[model_idx];
+
+            return((hid_device*)handle);
+        }
+    }
+
+    return(NULL);
+}
+
+static hid_device_info* debug_hid_enumerate(unsigned short vendor_id, unsigned short product_id)
+{
+    std::lock_guard<std::mutex> lock(debug_hid_models_mutex);
+
+    hid_device_info*    first   = NULL;
+    hid_device_info*    last    = NULL;
+
+    for(std::size_t model_idx = 0; model_idx < debug_hid_models.size(); model_idx++)
+    {
+        debug_hid_model* model = debug_hid_models[model_idx].get();
+
+        if((vendor_id != 0 && vendor_id != model->vendor_id)
+        || (product_id != 0 && product_id != model->product_id))
+        {
+            continue;
+        }
+
+        hid_device_info* info = (hid_device_info*)calloc(1, sizeof(hid_device_info));
+
+        info->path                  = strdup(model->path.c_str());
+        info->vendor_id             = model->vendor_id;
+        info->product_id            = model->product_id;
+        info->serial_number         = debug_hid_wcsdup(model->serial);
+        info->manufacturer_string   = debug_hid_wcsdup(model->manufacturer);
+        info->product_string        = debug_hid_wcsdup(model->product);
+        info->usage_page            = model->usage_page;
+        info->usage                 = model->usage;
+        info->interface_number      = model->interface_number;
+
+        if(last == NULL)
+        {
+            first = info;
+        }
+        else
+        {
+            last->next = info;
+        }
+
+        last = info;
+    }
+
+    return(first);
+}
+
+static void debug_hid_free_enumeration(hid_device_info* devs)
+{
+    while(devs != NULL)
+    {
+        hid_device_info* next = devs->next;
+
+        free(devs->path);
+        free(devs->serial_number);
+        free(devs->manufacturer_string);
+        free(devs->product_string);
+        free(devs);
+
+        devs = next;
+    }
+}
+
+static void debug_hid_close(hid_device* dev)
+{
+    delete (debug_hid_handle*)dev;
+}
+
+static const wchar_t* debug_hid_error(hid_device* /*dev*/)
+{
+    return(L"Success");
+}
+
+const hidapi_wrapper debug_wrapper =
+{
+    NULL,
+    debug_hid_send_feature_report,
+    debug_hid_get_feature_report,
+    debug_hid_get_serial_number_string,
+    debug_hid_open_path,
+    debug_hid_enumerate,
+    debug_hid_free_enumeration,
+    debug_hid_close,
+    debug_hid_error
+};
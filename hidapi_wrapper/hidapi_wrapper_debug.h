@@ -0,0 +1,31 @@
+/*---------------------------------------------------------*\
+| hidapi_wrapper_debug.h                                    |
+|                                                           |
+|   Simulated hidapi backend answering feature reports      |
+|   from scripted devices, for testing without hardware     |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include "hidapi_wrapper.h"
+
+/*---------------------------------------------------------*\
+| Load the simulated devices from the hid_devices list of   |
+| the DebugDevices settings, replacing any loaded before.   |
+| Returns the number of devices loaded.                     |
+\*---------------------------------------------------------*/
+unsigned int        hidapi_wrapper_debug_load(const nlohmann::json& hid_devices);
+
+/*---------------------------------------------------------*\
+| Number of feature reports sent to and read from the       |
+| simulated devices since they were loaded                  |
+\*---------------------------------------------------------*/
+unsigned long long  hidapi_wrapper_debug_get_report_count();
+
+extern const hidapi_wrapper debug_wrapper;
@@ -23,12 +23,16 @@ i2c_smbus_interface::i2c_smbus_interface()
 {
     i2c_smbus_start            = false;
     i2c_smbus_done             = false;
+    i2c_smbus_handoffs         = 0;
+    i2c_batch                  = NULL;
+    i2c_smbus_responded        = false;
     this->port_id              = -1;
     this->pci_device           = -1;
     this->pci_vendor           = -1;
     this->pci_subsystem_device = -1;
     this->pci_subsystem_vendor = -1;
     i2c_smbus_thread_running   = true;
+    i2c_smbus_clear_presence();
     i2c_smbus_thread           = new std::thread(&i2c_smbus_interface::i2c_smbus_thread_function, this);
 }
 
@@ -171,6 +175,8 @@ s32 i2c_smbus_interface::i2c_smbus_xfer_call(u8 addr, char read_write, u8 comman
     i2c_size_smbus  = size;
     i2c_data_smbus  = data;
     smbus_xfer      = true;
+    i2c_batch       = NULL;
+    i2c_smbus_handoffs++;
 
     std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
     i2c_smbus_start = true;
@@ -196,6 +202,8 @@ s32 i2c_smbus_interface::i2c_xfer_call(u8 addr, char read_write, int* size, u8 *
     i2c_size        = size;
     i2c_data        = data;
     smbus_xfer      = false;
+    i2c_batch       = NULL;
+    i2c_smbus_handoffs++;
 
     std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
     i2c_smbus_start = true;
@@ -212,6 +220,158 @@ s32 i2c_smbus_interface::i2c_xfer_call(u8 addr, char read_write, int* size, u8 *
     return(i2c_ret);
 }
 
+/*---------------------------------------------------------*\
+| Execute all transfers of a batch with one hand-off to the |
+| bus thread.  Returns 0 if all transfers succeeded, else   |
+| the result of the first failed transfer.                  |
+\*---------------------------------------------------------*/
+s32 i2c_smbus_interface::i2c_smbus_xfer_batch_call(i2c_smbus_batch& batch)
+{
+    if(batch.empty())
+    {
+        return(0);
+    }
+
+    i2c_smbus_xfer_mutex.lock();
+
+    i2c_batch       = &batch;
+    smbus_xfer      = true;
+    i2c_smbus_handoffs++;
+
+    std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
+    i2c_smbus_start = true;
+    i2c_smbus_start_cv.notify_all();
+    start_lock.unlock();
+
+    std::unique_lock<std::mutex> done_lock(i2c_smbus_done_mutex);
+
+    i2c_smbus_done_cv.wait(done_lock, [this]{ return i2c_smbus_done.load(); });
+    i2c_smbus_done  = false;
+
+    i2c_batch       = NULL;
+
+    i2c_smbus_xfer_mutex.unlock();
+
+    return(i2c_ret);
+}
+
+unsigned long long i2c_smbus_interface::i2c_smbus_get_handoff_count()
+{
+    return(i2c_smbus_handoffs.load());
+}
+
+/*---------------------------------------------------------*\
+| Probe an address with a quick write (I2C_SMBUS_QUICK) or  |
+| a read byte (I2C_SMBUS_BYTE).  Detectors pass the probe   |
+| they always used, since some devices only answer one of   |
+| them.  The result is remembered per probe type, so        |
+| detectors probing the same address share one transfer.    |
+| Returns 0 if the address answered, -1 if it did not.      |
+|                                                           |
+| Any write other than a quick write forgets the map, since |
+| such a write may move a device to another address, as the |
+| ENE and Crucial DRAM remapping does.                      |
+\*---------------------------------------------------------*/
+s32 i2c_smbus_interface::i2c_smbus_probe_address(u8 addr, int probe_type)
+{
+    unsigned int probe_idx = (probe_type == I2C_SMBUS_BYTE) ? 1 : 0;
+
+    addr &= 0x7F;
+
+    {
+        std::lock_guard<std::mutex> lock(i2c_smbus_presence_mutex);
+
+        if(i2c_smbus_presence[probe_idx][addr] != I2C_SMBUS_PRESENCE_UNKNOWN)
+        {
+            return(i2c_smbus_presence[probe_idx][addr]);
+        }
+    }
+
+    s32 res;
+
+    if(probe_type == I2C_SMBUS_BYTE)
+    {
+        res = i2c_smbus_read_byte(addr);
+    }
+    else
+    {
+        res = i2c_smbus_write_quick(addr, I2C_SMBUS_WRITE);
+    }
+
+    res = (res < 0) ? -1 : 0;
+
+    std::lock_guard<std::mutex> lock(i2c_smbus_presence_mutex);
+
+    i2c_smbus_presence[probe_idx][addr] = res;
+    i2c_smbus_presence_valid            = true;
+
+    return(res);
+}
+
+void i2c_smbus_interface::i2c_smbus_clear_presence()
+{
+    std::lock_guard<std::mutex> lock(i2c_smbus_presence_mutex);
+
+    for(unsigned int addr = 0; addr < 128; addr++)
+    {
+        i2c_smbus_presence[0][addr] = I2C_SMBUS_PRESENCE_UNKNOWN;
+        i2c_smbus_presence[1][addr] = I2C_SMBUS_PRESENCE_UNKNOWN;
+    }
+
+    i2c_smbus_presence_valid = false;
+}
+
+bool i2c_smbus_interface::i2c_smbus_has_responded()
+{
+    return(i2c_smbus_responded.load());
+}
+
+void i2c_smbus_interface::i2c_smbus_clear_responded()
+{
+    i2c_smbus_responded = false;
+}
+
+/*---------------------------------------------------------*\
+| Called on the bus thread after every transfer             |
+\*---------------------------------------------------------*/
+void i2c_smbus_interface::i2c_smbus_track_xfer(char read_write, int size, s32 ret)
+{
+    if(ret >= 0)
+    {
+        i2c_smbus_responded = true;
+    }
+
+    if(read_write == I2C_SMBUS_WRITE && size != I2C_SMBUS_QUICK && i2c_smbus_presence_valid.load())
+    {
+        i2c_smbus_clear_presence();
+    }
+}
+
+/*---------------------------------------------------------*\
+| Default batch implementation, runs on the bus thread and  |
+| issues the transfers one after another.  Every transfer   |
+| is attempted even if an earlier one failed, the same as   |
+| when the transfers are called individually.               |
+\*---------------------------------------------------------*/
+s32 i2c_smbus_interface::i2c_smbus_xfer_batch(i2c_smbus_batch& batch)
+{
+    s32 ret = 0;
+
+    for(std::size_t xfer_idx = 0; xfer_idx < batch.xfers.size(); xfer_idx++)
+    {
+        i2c_smbus_xfer_entry& xfer = batch.xfers[xfer_idx];
+
+        xfer.ret = i2c_smbus_xfer(xfer.addr, xfer.read_write, xfer.command, xfer.size, &xfer.data);
+
+        if(ret == 0 && xfer.ret != 0)
+        {
+            ret = xfer.ret;
+        }
+    }
+
+    return(ret);
+}
+
 s32 i2c_smbus_interface::i2c_read_block(u8 addr, int* size, u8* data)
 {
     return i2c_xfer_call(addr, I2C_SMBUS_READ, size, data);
@@ -236,13 +396,26 @@ void i2c_smbus_interface::i2c_smbus_thread_function()
             break;
         }
 
-        if(smbus_xfer)
+        if(i2c_batch != NULL)
+        {
+            i2c_ret = i2c_smbus_xfer_batch(*i2c_batch);
+
+            for(std::size_t xfer_idx = 0; xfer_idx < i2c_batch->xfers.size(); xfer_idx++)
+            {
+                i2c_smbus_track_xfer(i2c_batch->xfers[xfer_idx].read_write, i2c_batch->xfers[xfer_idx].size, i2c_batch->xfers[xfer_idx].ret);
+            }
+        }
+        else if(smbus_xfer)
         {
             i2c_ret = i2c_smbus_xfer(i2c_addr, i2c_read_write, i2c_command, i2c_size_smbus, i2c_data_smbus);
+
+            i2c_smbus_track_xfer(i2c_read_write, i2c_size_smbus, i2c_ret);
         }
         else
         {
             i2c_ret = i2c_xfer(i2c_addr, i2c_read_write, i2c_size, i2c_data);
+
+            i2c_smbus_track_xfer(i2c_read_write, I2C_SMBUS_I2C_BLOCK_DATA, i2c_ret);
         }
 
         std::unique_lock<std::mutex> done_lock(i2c_smbus_done_mutex);
@@ -251,3 +424,79 @@ void i2c_smbus_interface::i2c_smbus_thread_function()
         done_lock.unlock();
     }
 }
+
+void i2c_smbus_batch::clear()
+{
+    xfers.clear();
+}
+
+bool i2c_smbus_batch::empty()
+{
+    return(xfers.empty());
+}
+
+std::size_t i2c_smbus_batch::size()
+{
+    return(xfers.size());
+}
+
+i2c_smbus_xfer_entry& i2c_smbus_batch::add(u8 addr, char read_write, u8 command, int size)
+{
+    xfers.emplace_back();
+
+    i2c_smbus_xfer_entry& xfer = xfers.back();
+
+    xfer.addr       = addr;
+    xfer.read_write = read_write;
+    xfer.command    = command;
+    xfer.size       = size;
+    xfer.ret        = 0;
+
+    return(xfer);
+}
+
+/*---------------------------------------------------------*\
+| Returns the index of the transfer, the byte read is in    |
+| xfers[index].data.byte once the batch has been executed   |
+| and xfers[index].ret is 0                                 |
+\*---------------------------------------------------------*/
+std::size_t i2c_smbus_batch::read_byte_data(u8 addr, u8 command)
+{
+    add(addr, I2C_SMBUS_READ, command, I2C_SMBUS_BYTE_DATA);
+
+    return(xfers.size() - 1);
+}
+
+void i2c_smbus_batch::write_byte_data(u8 addr, u8 command, u8 value)
+{
+    add(addr, I2C_SMBUS_WRITE, command, I2C_SMBUS_BYTE_DATA).data.byte = value;
+}
+
+void i2c_smbus_batch::write_word_data(u8 addr, u8 command, u16 value)
+{
+    add(addr, I2C_SMBUS_WRITE, command, I2C_SMBUS_WORD_DATA).data.word = value;
+}
+
+void i2c_smbus_batch::write_block_data(u8 addr, u8 command, u8 length, const u8 *values)
+{
+    i2c_smbus_xfer_entry& xfer = add(addr, I2C_SMBUS_WRITE, command, I2C_SMBUS_BLOCK_DATA);
+
+    if (length > I2C_SMBUS_BLOCK_MAX)
+    {
+        length = I2C_SMBUS_BLOCK_MAX;
+    }
+    xfer.data.block[0] = length;
+    memcpy(&xfer.data.block[1], values, length);
+}
+
+void i2c_smbus_batch::write_i2c_block_data(u8 addr, u8 command, u8 length, const u8 *values)
+{
+    i2c_smbus_xfer_entry& xfer = add(addr, I2C_SMBUS_WRITE, command, I2C_SMBUS_I2C_BLOCK_DATA);
+
+    if (length > I2C_SMBUS_BLOCK_MAX)
+    {
+        length = I2C_SMBUS_BLOCK_MAX;
+    }
+    xfer.data.block[0] = length;
+    memcpy(&xfer.data.block[1], values, length);
+}
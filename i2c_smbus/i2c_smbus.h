@@ -17,6 +17,7 @@
 #include <thread>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
 
 typedef unsigned char   u8;
 typedef unsigned short  u16;
@@ -72,6 +73,48 @@ union i2c_smbus_data
 #define I2C_SMBUS_BLOCK_PROC_CALL   7           /* SMBus 2.0 */
 #define I2C_SMBUS_I2C_BLOCK_DATA    8
 
+// Presence map entry of an address that has not been probed yet
+#define I2C_SMBUS_PRESENCE_UNKNOWN  1
+
+/*---------------------------------------------------------*\
+| One SMBus transfer of a batch.  Read data and the result  |
+| of the transfer are returned in the entry.                |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    u8                  addr;
+    char                read_write;
+    u8                  command;
+    int                 size;
+    i2c_smbus_data      data;
+    s32                 ret;
+} i2c_smbus_xfer_entry;
+
+/*---------------------------------------------------------*\
+| A list of SMBus transfers that is executed in order by a  |
+| single hand-off to the bus thread.  Drivers that write a  |
+| whole frame of registers queue the frame here instead of  |
+| calling the i2c_smbus_write_* functions one by one.       |
+\*---------------------------------------------------------*/
+class i2c_smbus_batch
+{
+public:
+    void        clear();
+    bool        empty();
+    std::size_t size();
+
+    std::size_t read_byte_data(u8 addr, u8 command);
+    void        write_byte_data(u8 addr, u8 command, u8 value);
+    void        write_word_data(u8 addr, u8 command, u16 value);
+    void        write_block_data(u8 addr, u8 command, u8 length, const u8 *values);
+    void        write_i2c_block_data(u8 addr, u8 command, u8 length, const u8 *values);
+
+    std::vector<i2c_smbus_xfer_entry>   xfers;
+
+private:
+    i2c_smbus_xfer_entry&   add(u8 addr, char read_write, u8 command, int size);
+};
+
 
 class i2c_smbus_interface
 {
@@ -109,9 +152,23 @@ public:
     //Handle SMBus and I2C transfer calls in a single thread
     s32 i2c_smbus_xfer_call(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
     s32 i2c_xfer_call(u8 addr, char read_write, int* size, u8 *data);
+    s32 i2c_smbus_xfer_batch_call(i2c_smbus_batch& batch);
+
+    //Number of hand-offs to the bus thread since the interface was created
+    unsigned long long i2c_smbus_get_handoff_count();
+
+    //Address presence map shared by the detectors of a detection pass
+    //probe_type is I2C_SMBUS_QUICK (quick write) or I2C_SMBUS_BYTE (read byte)
+    s32  i2c_smbus_probe_address(u8 addr, int probe_type);
+    void i2c_smbus_clear_presence();
+
+    //Whether any transfer succeeded since the last clear
+    bool i2c_smbus_has_responded();
+    void i2c_smbus_clear_responded();
 
     virtual s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data) = 0;
     virtual s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data) = 0;
+    virtual s32 i2c_smbus_xfer_batch(i2c_smbus_batch& batch);
 
 private:
     std::thread *           i2c_smbus_thread;
@@ -127,6 +184,15 @@ private:
 
     std::mutex              i2c_smbus_xfer_mutex;
 
+    std::atomic<unsigned long long> i2c_smbus_handoffs;
+
+    std::mutex              i2c_smbus_presence_mutex;
+    std::atomic<bool>       i2c_smbus_presence_valid;
+    s32                     i2c_smbus_presence[2][128];
+    std::atomic<bool>       i2c_smbus_responded;
+
+    void i2c_smbus_track_xfer(char read_write, int size, s32 ret);
+
     u8                  i2c_addr;
     char                i2c_read_write;
     u8                  i2c_command;
@@ -136,6 +202,7 @@ private:
     u8*                 i2c_data;
     s32                 i2c_ret;
     bool                smbus_xfer;
+    i2c_smbus_batch*    i2c_batch;
 };
 
 #endif /* I2C_SMBUS_H */
@@ -0,0 +1,457 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_debug.cpp                                       |
+|                                                           |
+|   Simulated i2c/smbus bus answering transfers from        |
+|   scripted device models, for testing without hardware    |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "i2c_smbus_debug.h"
+#include "LogManager.h"
+#include "ResourceManager.h"
+#include "SettingsManager.h"
+
+/*---------------------------------------------------------*\
+| Page select addresses of DDR4 SPD EEPROMs                 |
+\*---------------------------------------------------------*/
+#define DEBUG_SPD_PAGE_0_ADDR       0x36
+#define DEBUG_SPD_PAGE_1_ADDR       0x37
+
+i2c_smbus_debug::i2c_smbus_debug()
+{
+    latency_us  = 0;
+    spd_page    = 0;
+    xfer_count  = 0;
+}
+
+void i2c_smbus_debug::AddDevice(u8 addr, int type, const std::map<unsigned int, u8>& registers)
+{
+    i2c_smbus_debug_device device;
+
+    device.type     = type;
+    device.pointer  = 0;
+
+    switch(type)
+    {
+        case I2C_SMBUS_DEBUG_DEVICE_ENE:
+            device.registers.resize(0x10000);
+            break;
+
+        case I2C_SMBUS_DEBUG_DEVICE_SPD_DDR4:
+            device.registers.resize(512);
+            break;
+
+        default:
+            device.registers.resize(256);
+            break;
+    }
+
+    for(std::map<unsigned int, u8>::const_iterator it = registers.begin(); it != registers.end(); it++)
+    {
+        if(it->first < device.registers.size())
+        {
+            device.registers[it->first] = it->second;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(devices_mutex);
+
+    devices[addr] = device;
+}
+
+void i2c_smbus_debug::SetLatency(unsigned int latency_us)
+{
+    this->latency_us = latency_us;
+}
+
+unsigned long long i2c_smbus_debug::i2c_smbus_debug_get_xfer_count()
+{
+    return(xfer_count.load());
+}
+
+unsigned int i2c_smbus_debug::i2c_smbus_debug_register(i2c_smbus_debug_device& device, u8 command)
+{
+    switch(device.type)
+    {
+        case I2C_SMBUS_DEBUG_DEVICE_ENE:
+            return(device.pointer);
+
+        case I2C_SMBUS_DEBUG_DEVICE_SPD_DDR4:
+            return((spd_page * 256) + command);
+
+        default:
+            return(command);
+    }
+}
+
+u8 i2c_smbus_debug::i2c_smbus_debug_read(i2c_smbus_debug_device& device, u8 command)
+{
+    if(device.type == I2C_SMBUS_DEBUG_DEVICE_ENE)
+    {
+        /*-------------------------------------------------*\
+        | ENE controllers return the 0x00-0x0F ramp on the  |
+        | direct registers 0xA0-0xAF, the indirect register |
+        | space is read through command 0x81                |
+        \*-------------------------------------------------*/
+        if(command >= 0xA0 && command < 0xB0)
+        {
+            return(command - 0xA0);
+        }
+        else if(command == 0x81)
+        {
+            return(device.registers[device.pointer]);
+        }
+
+        return(0x00);
+    }
+
+    return(device.registers[i2c_smbus_debug_register(device, command)]);
+}
+
+void i2c_smbus_debug::i2c_smbus_debug_write(i2c_smbus_debug_device& device, u8 command, u8 value)
+{
+    switch(device.type)
+    {
+        case I2C_SMBUS_DEBUG_DEVICE_ENE:
+            if(command == 0x01)
+            {
+                device.registers[device.pointer] = value;
+            }
+            break;
+
+        /*-------------------------------------------------*\
+        | SPD EEPROMs are write protected                   |
+        \*-------------------------------------------------*/
+        case I2C_SMBUS_DEBUG_DEVICE_SPD_DDR4:
+            break;
+
+        default:
+            device.registers[command] = value;
+            break;
+    }
+}
+
+void i2c_smbus_debug::i2c_smbus_debug_write_word(i2c_smbus_debug_device& device, u8 command, u16 value)
+{
+    /*-----------------------------------------------------*\
+    | ENE controllers take the byte swapped indirect        |
+    | register address as a word write to command 0x00      |
+    \*-----------------------------------------------------*/
+    if(device.type == I2C_SMBUS_DEBUG_DEVICE_ENE && command == 0x00)
+    {
+        device.pointer = ((value << 8) & 0xFF00) | ((value >> 8) & 0x00FF);
+        return;
+    }
+
+    i2c_smbus_debug_write(device, command, value & 0xFF);
+    i2c_smbus_debug_write(device, command + 1, value >> 8);
+}
+
+s32 i2c_smbus_debug::i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    xfer_count++;
+
+    if(latency_us > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(latency_us));
+    }
+
+    std::lock_guard<std::mutex> lock(devices_mutex);
+
+    /*-----------------------------------------------------*\
+    | The SPD page select addresses acknowledge whenever an |
+    | SPD EEPROM is present on the bus                      |
+    \*-----------------------------------------------------*/
+    if(addr == DEBUG_SPD_PAGE_0_ADDR || addr == DEBUG_SPD_PAGE_1_ADDR)
+    {
+        for(std::map<u8, i2c_smbus_debug_device>::iterator it = devices.begin(); it != devices.end(); it++)
+        {
+            if(it->second.type == I2C_SMBUS_DEBUG_DEVICE_SPD_DDR4)
+            {
+                if(read_write == I2C_SMBUS_WRITE && size != I2C_SMBUS_QUICK)
+                {
+                    spd_page = addr - DEBUG_SPD_PAGE_0_ADDR;
+                }
+
+                return(0);
+            }
+        }
+
+        return(-1);
+    }
+
+    std::map<u8, i2c_smbus_debug_device>::iterator it = devices.find(addr);
+
+    if(it == devices.end())
+    {
+        return(-1);
+    }
+
+    i2c_smbus_debug_device& device = it->second;
+
+    switch(size)
+    {
+        case I2C_SMBUS_QUICK:
+            return(0);
+
+        case I2C_SMBUS_BYTE:
+            if(read_write == I2C_SMBUS_READ)
+            {
+                data->byte = i2c_smbus_debug_read(device, (u8)device.pointer);
+
+                if(device.type != I2C_SMBUS_DEBUG_DEVICE_ENE)
+                {
+                    device.pointer = (device.pointer + 1) & 0xFF;
+                }
+            }
+            else if(device.type != I2C_SMBUS_DEBUG_DEVICE_ENE)
+            {
+                device.pointer = command;
+            }
+            return(0);
+
+        case I2C_SMBUS_BYTE_DATA:
+            if(read_write == I2C_SMBUS_READ)
+            {
+                data->byte = i2c_smbus_debug_read(device, command);
+            }
+            else
+            {
+                i2c_smbus_debug_write(device, command, data->byte);
+            }
+            return(0);
+
+        case I2C_SMBUS_WORD_DATA:
+            if(read_write == I2C_SMBUS_READ)
+            {
+                data->word = i2c_smbus_debug_read(device, command) | (i2c_smbus_debug_read(device, command + 1) << 8);
+            }
+            else
+            {
+                i2c_smbus_debug_write_word(device, command, data->word);
+            }
+            return(0);
+
+        case I2C_SMBUS_BLOCK_DATA:
+            if(read_write == I2C_SMBUS_READ)
+            {
+                return(-1);
+            }
+
+            /*-------------------------------------------------*\
+            | ENE controllers write block data to consecutive   |
+            | indirect registers starting at the pointer        |
+            \*-------------------------------------------------*/
+            for(unsigned int i = 0; i < data->block[0] && i < I2C_SMBUS_BLOCK_MAX; i++)
+            {
+                if(device.type == I2C_SMBUS_DEBUG_DEVICE_ENE)
+                {
+                    if(command == 0x03)
+                    {
+                        device.registers[(device.pointer + i) & 0xFFFF] = data->block[i + 1];
+                    }
+                }
+                else
+                {
+                    i2c_smbus_debug_write(device, command + i, data->block[i + 1]);
+                }
+            }
+            return(0);
+
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            if(data->block[0] > I2C_SMBUS_BLOCK_MAX)
+            {
+                data->block[0] = I2C_SMBUS_BLOCK_MAX;
+            }
+
+            for(unsigned int i = 0; i < data->block[0]; i++)
+            {
+                if(read_write == I2C_SMBUS_READ)
+                {
+                    data->block[i + 1] = i2c_smbus_debug_read(device, command + i);
+                }
+                else
+                {
+                    i2c_smbus_debug_write(device, command + i, data->block[i + 1]);
+                }
+            }
+            return(0);
+
+        default:
+            return(-1);
+    }
+}
+
+s32 i2c_smbus_debug::i2c_xfer(u8 addr, char read_write, int* size, u8* data)
+{
+    xfer_count++;
+
+    if(latency_us > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(latency_us));
+    }
+
+    std::lock_guard<std::mutex> lock(devices_mutex);
+
+    std::map<u8, i2c_smbus_debug_device>::iterator it = devices.find(addr);
+
+    if(it == devices.end() || it->second.type == I2C_SMBUS_DEBUG_DEVICE_ENE)
+    {
+        return(-1);
+    }
+
+    i2c_smbus_debug_device& device = it->second;
+
+    /*-----------------------------------------------------*\
+    | Plain I2C writes set the register pointer with their  |
+    | first byte, reads continue from the pointer           |
+    \*-----------------------------------------------------*/
+    for(int i = 0; i < *size; i++)
+    {
+        if(read_write == I2C_SMBUS_READ)
+        {
+            data[i] = i2c_smbus_debug_read(device, (u8)device.pointer);
+            device.pointer = (device.pointer + 1) & 0xFF;
+        }
+        else if(i == 0)
+        {
+            device.pointer = data[0];
+        }
+        else
+        {
+            i2c_smbus_debug_write(device, (u8)device.pointer, data[i]);
+            device.pointer = (device.pointer + 1) & 0xFF;
+        }
+    }
+
+    return(0);
+}
+
+#include "Detector.h"
+
+/*---------------------------------------------------------*\
+| Parse a register address or value given as a number or    |
+| as a string such as "0x1000"                              |
+\*---------------------------------------------------------*/
+static unsigned int i2c_smbus_debug_parse_number(const json& value)
+{
+    if(value.is_string())
+    {
+        return((unsigned int)strtoul(value.get<std::string>().c_str(), NULL, 0));
+    }
+
+    return(value.get<unsigned int>());
+}
+
+/******************************************************************************************\
+*                                                                                          *
+*   i2c_smbus_debug_detect                                                                 *
+*                                                                                          *
+*       Register simulated busses listed under smbus_busses in the DebugDevices settings.  *
+*       Each bus has a list of devices, each device an address, a model type, and the      *
+*       initial contents of its registers.  A register entry holds a single value or a     *
+*       list of values for consecutive registers.                                          *
+*                                                                                          *
+\******************************************************************************************/
+
+bool i2c_smbus_debug_detect()
+{
+    json debug_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("DebugDevices");
+
+    if(!debug_settings.contains("smbus_busses"))
+    {
+        return(false);
+    }
+
+    for(unsigned int bus_idx = 0; bus_idx < debug_settings["smbus_busses"].size(); bus_idx++)
+    {
+        json&               bus_settings    = debug_settings["smbus_busses"][bus_idx];
+        i2c_smbus_debug*    bus             = new i2c_smbus_debug();
+
+        snprintf(bus->device_name, sizeof(bus->device_name), "Debug SMBus %u", bus_idx);
+
+        if(bus_settings.contains("name"))
+        {
+            snprintf(bus->device_name, sizeof(bus->device_name), "%s", bus_settings["name"].get<std::string>().c_str());
+        }
+
+        bus->pci_vendor             = bus_settings.contains("pci_vendor")           ? i2c_smbus_debug_parse_number(bus_settings["pci_vendor"])           : 0;
+        bus->pci_device             = bus_settings.contains("pci_device")           ? i2c_smbus_debug_parse_number(bus_settings["pci_device"])           : 0;
+        bus->pci_subsystem_vendor   = bus_settings.contains("pci_subsystem_vendor") ? i2c_smbus_debug_parse_number(bus_settings["pci_subsystem_vendor"]) : 0;
+        bus->pci_subsystem_device   = bus_settings.contains("pci_subsystem_device") ? i2c_smbus_debug_parse_number(bus_settings["pci_subsystem_device"]) : 0;
+        bus->port_id                = bus_settings.contains("port_id")              ? i2c_smbus_debug_parse_number(bus_settings["port_id"])              : 0;
+
+        if(bus_settings.contains("latency_us"))
+        {
+            bus->SetLatency(i2c_smbus_debug_parse_number(bus_settings["latency_us"]));
+        }
+
+        if(bus_settings.contains("devices"))
+        {
+            for(unsigned int device_idx = 0; device_idx < bus_settings["devices"].size(); device_idx++)
+            {
+                json&                           device_settings = bus_settings["devices"][device_idx];
+                std::map<unsigned int, u8>      registers;
+                int                             type            = I2C_SMBUS_DEBUG_DEVICE_REGISTERS;
+
+                if(!device_settings.contains("address"))
+                {
+                    continue;
+                }
+
+                if(device_settings.contains("type"))
+                {
+                    std::string type_string = device_settings["type"];
+
+                    if(type_string == "ene")
+                    {
+                        type = I2C_SMBUS_DEBUG_DEVICE_ENE;
+                    }
+                    else if(type_string == "spd_ddr4")
+                    {
+                        type = I2C_SMBUS_DEBUG_DEVICE_SPD_DDR4;
+                    }
+                }
+
+                if(device_settings.contains("registers"))
+                {
+                    for(json::iterator it = device_settings["registers"].begin(); it != device_settings["registers"].end(); it++)
+                    {
+                        unsigned int reg = (unsigned int)strtoul(it.key().c_str(), NULL, 0);
+
+                        if(it.value().is_array())
+                        {
+                            for(unsigned int value_idx = 0; value_idx < it.value().size(); value_idx++)
+                            {
+                                registers[reg + value_idx] = (u8)i2c_smbus_debug_parse_number(it.value()[value_idx]);
+                            }
+                        }
+                        else
+                        {
+                            registers[reg] = (u8)i2c_smbus_debug_parse_number(it.value());
+                        }
+                    }
+                }
+
+                bus->AddDevice((u8)i2c_smbus_debug_parse_number(device_settings["address"]), type, registers);
+            }
+        }
+
+        LOG_INFO("[i2c_smbus_debug] Registering simulated bus %s", bus->device_name);
+
+        ResourceManager::get()->RegisterI2CBus(bus);
+    }
+
+    return(true);
+}
+
+REGISTER_I2C_BUS_DETECTOR(i2c_smbus_debug_detect);
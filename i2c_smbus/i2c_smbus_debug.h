@@ -0,0 +1,68 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_debug.h                                         |
+|                                                           |
+|   Simulated i2c/smbus bus answering transfers from        |
+|   scripted device models, for testing without hardware    |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "i2c_smbus.h"
+
+/*---------------------------------------------------------*\
+| Device models.  A "registers" device is a plain 8-bit     |
+| register file.  An "ene" device has the 16-bit indirect   |
+| register space of ENE SMBus controllers.  A "spd_ddr4"    |
+| device is a 512 byte DDR4 SPD EEPROM, paged through the   |
+| 0x36/0x37 page select addresses.                          |
+\*---------------------------------------------------------*/
+enum
+{
+    I2C_SMBUS_DEBUG_DEVICE_REGISTERS,
+    I2C_SMBUS_DEBUG_DEVICE_ENE,
+    I2C_SMBUS_DEBUG_DEVICE_SPD_DDR4,
+};
+
+typedef struct
+{
+    int                 type;
+    std::vector<u8>     registers;
+    u16                 pointer;
+} i2c_smbus_debug_device;
+
+class i2c_smbus_debug : public i2c_smbus_interface
+{
+public:
+    i2c_smbus_debug();
+
+    void AddDevice(u8 addr, int type, const std::map<unsigned int, u8>& registers);
+    void SetLatency(unsigned int latency_us);
+
+    //Number of transfers the simulated bus answered
+    unsigned long long i2c_smbus_debug_get_xfer_count();
+
+private:
+    std::map<u8, i2c_smbus_debug_device>    devices;
+    std::mutex                              devices_mutex;
+    unsigned int                            latency_us;
+    u8                                      spd_page;
+    std::atomic<unsigned long long>         xfer_count;
+
+    s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+    s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+
+    u8   i2c_smbus_debug_read(i2c_smbus_debug_device& device, u8 command);
+    void i2c_smbus_debug_write(i2c_smbus_debug_device& device, u8 command, u8 value);
+    void i2c_smbus_debug_write_word(i2c_smbus_debug_device& device, u8 command, u16 value);
+    unsigned int i2c_smbus_debug_register(i2c_smbus_debug_device& device, u8 command);
+};
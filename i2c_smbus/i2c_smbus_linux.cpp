@@ -14,22 +14,81 @@
 #include <sys/ioctl.h>
 #include <cstring>
 #include "LogManager.h"
+#include "ResourceManager.h"
+#include "SettingsManager.h"
 #include "i2c_smbus.h"
 #include "i2c_smbus_linux.h"
 
+#ifndef I2C_RDWR_IOCTL_MAX_MSGS
+#define I2C_RDWR_IOCTL_MAX_MSGS     42
+#endif
+
+i2c_smbus_linux::i2c_smbus_linux()
+{
+    handle          = -1;
+    slave_addr      = -1;
+    rdwr_checked    = false;
+    ioctl_count     = 0;
+
+    /*-----------------------------------------------------*\
+    | Sending batches as combined I2C_RDWR transfers is     |
+    | opt-in, the transfers of a batch then go out with     |
+    | repeated starts instead of separate transactions      |
+    \*-----------------------------------------------------*/
+    json drivers_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("Drivers");
+
+    rdwr_batch = false;
+    if(drivers_settings.contains("i2c_rdwr_batching"))
+    {
+        rdwr_batch = drivers_settings["i2c_rdwr_batching"].get<bool>();
+    }
+}
+
+unsigned long long i2c_smbus_linux::i2c_smbus_linux_get_ioctl_count()
+{
+    return(ioctl_count.load());
+}
+
+/*---------------------------------------------------------*\
+| Select the slave address for I2C_SMBUS transfers.  The    |
+| address stays selected on the handle, so the ioctl is     |
+| only needed when the address changes.  I2C_RDWR carries   |
+| the address in each message and does not change it.       |
+\*---------------------------------------------------------*/
+bool i2c_smbus_linux::i2c_smbus_linux_select_slave(u8 addr)
+{
+    if(slave_addr == addr)
+    {
+        return(true);
+    }
+
+    ioctl_count++;
+
+    if(ioctl(handle, I2C_SLAVE, addr) < 0)
+    {
+        slave_addr = -1;
+        return(false);
+    }
+
+    slave_addr = addr;
+    return(true);
+}
+
 s32 i2c_smbus_linux::i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, union i2c_smbus_data* data)
 {
 
     struct i2c_smbus_ioctl_data args;
 
     //Tell I2C host which slave address to transfer to
-    ioctl(handle, I2C_SLAVE, addr);
+    i2c_smbus_linux_select_slave(addr);
 
     args.read_write = read_write;
     args.command = command;
     args.size = size;
     args.data = data;
 
+    ioctl_count++;
+
     return ioctl(handle, I2C_SMBUS, &args);
 }
 
@@ -48,6 +107,8 @@ s32 i2c_smbus_linux::i2c_xfer(u8 addr, char read_write, int* size, u8* data)
     rdwr.msgs  = &msg;
     rdwr.nmsgs = 1;
 
+    ioctl_count++;
+
     ret_val = ioctl(handle, I2C_RDWR, &rdwr);
 
     /*-------------------------------------------------*\
@@ -64,6 +125,153 @@ s32 i2c_smbus_linux::i2c_xfer(u8 addr, char read_write, int* size, u8* data)
     return ret_val;
 }
 
+/*---------------------------------------------------------*\
+| Encode an SMBus write as a plain I2C message.  Returns    |
+| false for transfers that cannot be sent this way, which   |
+| are reads and the quick and process call types.           |
+\*---------------------------------------------------------*/
+bool i2c_smbus_linux::i2c_smbus_linux_build_msg(i2c_smbus_xfer_entry& xfer, struct i2c_msg* msg, u8* buf)
+{
+    if(xfer.read_write != I2C_SMBUS_WRITE)
+    {
+        return(false);
+    }
+
+    buf[0] = xfer.command;
+
+    switch(xfer.size)
+    {
+        case I2C_SMBUS_BYTE:
+            msg->len = 1;
+            break;
+
+        case I2C_SMBUS_BYTE_DATA:
+            buf[1]   = xfer.data.byte;
+            msg->len = 2;
+            break;
+
+        case I2C_SMBUS_WORD_DATA:
+            buf[1]   = xfer.data.word & 0xFF;
+            buf[2]   = xfer.data.word >> 8;
+            msg->len = 3;
+            break;
+
+        case I2C_SMBUS_BLOCK_DATA:
+            if(xfer.data.block[0] > I2C_SMBUS_BLOCK_MAX)
+            {
+                return(false);
+            }
+            memcpy(&buf[1], xfer.data.block, xfer.data.block[0] + 1);
+            msg->len = xfer.data.block[0] + 2;
+            break;
+
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            if(xfer.data.block[0] > I2C_SMBUS_BLOCK_MAX)
+            {
+                return(false);
+            }
+            memcpy(&buf[1], &xfer.data.block[1], xfer.data.block[0]);
+            msg->len = xfer.data.block[0] + 1;
+            break;
+
+        default:
+            return(false);
+    }
+
+    msg->addr  = xfer.addr;
+    msg->flags = 0;
+    msg->buf   = buf;
+
+    return(true);
+}
+
+/*---------------------------------------------------------*\
+| With I2C_RDWR batching enabled and an adapter that can do |
+| plain I2C, consecutive writes of a batch are sent as one  |
+| I2C_RDWR ioctl.  Other transfers, and the writes of a run |
+| that failed, go out one by one so that each entry gets    |
+| its own result.                                           |
+\*---------------------------------------------------------*/
+s32 i2c_smbus_linux::i2c_smbus_xfer_batch(i2c_smbus_batch& batch)
+{
+    if(rdwr_batch && !rdwr_checked)
+    {
+        unsigned long funcs = 0;
+
+        rdwr_checked = true;
+        ioctl_count++;
+
+        if(ioctl(handle, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C))
+        {
+            LOG_DEBUG("[i2c_smbus_linux] %s does not support I2C_RDWR, sending batches as single transfers", device_name);
+            rdwr_batch = false;
+        }
+    }
+
+    if(!rdwr_batch)
+    {
+        return(i2c_smbus_interface::i2c_smbus_xfer_batch(batch));
+    }
+
+    struct i2c_msg  msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    u8              bufs[I2C_RDWR_IOCTL_MAX_MSGS][I2C_SMBUS_BLOCK_MAX + 2];
+    std::size_t     xfer_idx    = 0;
+    s32             ret         = 0;
+
+    while(xfer_idx < batch.xfers.size())
+    {
+        std::size_t first_idx   = xfer_idx;
+        unsigned int num_msgs   = 0;
+
+        while(xfer_idx < batch.xfers.size()
+           && num_msgs < I2C_RDWR_IOCTL_MAX_MSGS
+           && i2c_smbus_linux_build_msg(batch.xfers[xfer_idx], &msgs[num_msgs], bufs[num_msgs]))
+        {
+            num_msgs++;
+            xfer_idx++;
+        }
+
+        bool run_sent = false;
+
+        if(num_msgs > 0)
+        {
+            i2c_rdwr_ioctl_data rdwr;
+
+            rdwr.msgs  = msgs;
+            rdwr.nmsgs = num_msgs;
+
+            ioctl_count++;
+
+            run_sent = (ioctl(handle, I2C_RDWR, &rdwr) >= 0);
+        }
+        else
+        {
+            xfer_idx++;
+        }
+
+        for(std::size_t run_idx = first_idx; run_idx < xfer_idx; run_idx++)
+        {
+            i2c_smbus_xfer_entry& xfer = batch.xfers[run_idx];
+
+            if(run_sent)
+            {
+                xfer.ret = 0;
+            }
+            else
+            {
+                xfer.ret = i2c_smbus_xfer(xfer.addr, xfer.read_write, xfer.command, xfer.size, &xfer.data);
+            }
+
+            if(ret == 0 && xfer.ret != 0)
+            {
+                ret = xfer.ret;
+            }
+        }
+    }
+
+    return(ret);
+}
+
 #include "Detector.h"
 #include <fcntl.h>
 #include <unistd.h>
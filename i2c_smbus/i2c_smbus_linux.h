@@ -9,6 +9,7 @@
 |   SPDX-License-Identifier: GPL-2.0-only                   |
 \*---------------------------------------------------------*/
 
+#include <atomic>
 #include "i2c_smbus.h"
 
 class i2c_smbus_linux : public i2c_smbus_interface
@@ -16,7 +17,21 @@ class i2c_smbus_linux : public i2c_smbus_interface
 public:
     int handle;
 
+    i2c_smbus_linux();
+
+    //Number of ioctls issued on the handle since the bus was created
+    unsigned long long i2c_smbus_linux_get_ioctl_count();
+
 private:
+    int                             slave_addr;
+    bool                            rdwr_batch;
+    bool                            rdwr_checked;
+    std::atomic<unsigned long long> ioctl_count;
+
     s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
     s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+    s32 i2c_smbus_xfer_batch(i2c_smbus_batch& batch);
+
+    bool i2c_smbus_linux_select_slave(u8 addr);
+    bool i2c_smbus_linux_build_msg(i2c_smbus_xfer_entry& xfer, struct i2c_msg* msg, u8* buf);
 };
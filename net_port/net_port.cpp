@@ -13,6 +13,7 @@
 
 #include "net_port.h"
 
+#include <algorithm>
 #ifndef WIN32
 #include <sys/ioctl.h>
 #include <netinet/tcp.h>
@@ -23,6 +24,10 @@
 #include <stdlib.h>
 #include <iostream>
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 #ifdef _WIN32
 #define connect_socklen_t int
 #else
@@ -115,7 +120,7 @@ int net_port::udp_listen_timeout(char * recv_data, int length, int sec, int usec
     tv.tv_sec   = sec;
     tv.tv_usec  = usec;
 
-    if(select((int)sock, &fds, NULL, NULL, &tv) <= 0)
+    if(select((int)sock + 1, &fds, NULL, NULL, &tv) <= 0)
     {
         return(0);
     }
@@ -123,11 +128,110 @@ int net_port::udp_listen_timeout(char * recv_data, int length, int sec, int usec
     return(recvfrom(sock, recv_data, length, 0, NULL, NULL));
 }
 
+//wait_readable
+//	Waits up to timeout_ms milliseconds for data to arrive on the
+//	socket.  Returns true if a read will not block.
+bool net_port::wait_readable(int timeout_ms)
+{
+    fd_set fds;
+    struct timeval tv;
+
+    FD_ZERO(&fds);
+    FD_SET(sock, &fds);
+
+    tv.tv_sec   = timeout_ms / 1000;
+    tv.tv_usec  = (timeout_ms % 1000) * 1000;
+
+    return(select((int)sock + 1, &fds, NULL, NULL, &tv) > 0);
+}
+
 int net_port::udp_write(char * buffer, int length)
 {
     return(sendto(sock, buffer, length, 0, (sockaddr *)&addrDest, sizeof(addrDest)));
 }
 
+//udp_send_multiple
+//	Sends count datagrams on sock.  If dests is not NULL each datagram
+//	goes to its own destination, otherwise all of them go to dest.  On
+//	Linux they are handed to the kernel with as few sendmmsg calls as
+//	possible, elsewhere they are sent one at a time.  Returns the number
+//	of datagrams that were sent successfully.
+static int udp_send_multiple(SOCKET sock, const sockaddr * const * dests, const sockaddr * dest, int dest_len, char ** buffers, int * lengths, int count)
+{
+    int next = 0;
+    int sent = 0;
+
+#ifdef __linux__
+    const int       batch_size = 64;
+    struct mmsghdr  msgs[batch_size];
+    struct iovec    iovs[batch_size];
+
+    while(next < count)
+    {
+        int batch_count = std::min(count - next, batch_size);
+
+        memset(msgs, 0, sizeof(struct mmsghdr) * batch_count);
+
+        for(int msg_idx = 0; msg_idx < batch_count; msg_idx++)
+        {
+            iovs[msg_idx].iov_base              = buffers[next + msg_idx];
+            iovs[msg_idx].iov_len               = lengths[next + msg_idx];
+            msgs[msg_idx].msg_hdr.msg_name      = (void *)(dests ? dests[next + msg_idx] : dest);
+            msgs[msg_idx].msg_hdr.msg_namelen   = dest_len;
+            msgs[msg_idx].msg_hdr.msg_iov       = &iovs[msg_idx];
+            msgs[msg_idx].msg_hdr.msg_iovlen    = 1;
+        }
+
+        int ret = sendmmsg(sock, msgs, batch_count, 0);
+
+        if(ret < 0 && errno == ENOSYS)
+        {
+            break;
+        }
+
+        if(ret <= 0)
+        {
+            /*---------------------------------------------*\
+            | Skip the datagram that failed and carry on,   |
+            | it is not counted as sent                     |
+            \*---------------------------------------------*/
+            next++;
+            continue;
+        }
+
+        next += ret;
+        sent += ret;
+    }
+#endif
+
+    for(; next < count; next++)
+    {
+        if(sendto(sock, buffers[next], lengths[next], 0, dests ? dests[next] : dest, dest_len) >= 0)
+        {
+            sent++;
+        }
+    }
+
+    return(sent);
+}
+
+//udp_write_multiple
+//	Sends count datagrams to the client address.  Returns the number of
+//	datagrams that were sent successfully.
+int net_port::udp_write_multiple(char ** buffers, int * lengths, int count)
+{
+    return(udp_send_multiple(sock, NULL, &addrDest, sizeof(addrDest), buffers, lengths, count));
+}
+
+//udp_write_multiple
+//	Sends count datagrams on a socket that is not owned by a net_port,
+//	each to its own destination address.  Returns the number of
+//	datagrams that were sent successfully.
+int net_port::udp_write_multiple(SOCKET send_sock, const sockaddr * const * dests, int dest_len, char ** buffers, int * lengths, int count)
+{
+    return(udp_send_multiple(send_sock, dests, NULL, dest_len, buffers, lengths, count));
+}
+
 bool net_port::tcp_client(const char * client_name, const char * port)
 {
     addrinfo    hints = {};
@@ -319,7 +423,7 @@ int net_port::tcp_listen(char * recv_data, int length)
 
 int net_port::tcp_client_write(char * buffer, int length)
 {
-    return(send(sock, buffer, length, 0));
+    return(send(sock, buffer, length, MSG_NOSIGNAL));
 }
 
 int net_port::tcp_write(char * buffer, int length)
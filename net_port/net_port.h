@@ -70,9 +70,12 @@ public:
     int udp_listen(char * recv_data, int length);
     int udp_listen_timeout(char * recv_data, int length, int sec, int usec);
     int tcp_listen(char * recv_data, int length);
+    bool wait_readable(int timeout_ms);
 
     //Function to write data to the serial port
     int udp_write(char * buffer, int length);
+    int udp_write_multiple(char ** buffers, int * lengths, int count);
+    static int udp_write_multiple(SOCKET send_sock, const sockaddr * const * dests, int dest_len, char ** buffers, int * lengths, int count);
     int tcp_write(char * buffer, int length);
     int tcp_client_write(char * buffer, int length);
 
@@ -0,0 +1,699 @@
+/*---------------------------------------------------------*\
+| smart_light_transport.cpp                                 |
+|                                                           |
+|   Shared transport for network smart lights.  Keeps one   |
+|   session per device open on top of net_port, sends       |
+|   commands without waiting for their responses and        |
+|   matches responses on a receive thread                   |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include "smart_light_transport.h"
+#include "LogManager.h"
+
+using namespace std::chrono_literals;
+
+/*---------------------------------------------------------*\
+| smart_light_template                                      |
+\*---------------------------------------------------------*/
+
+smart_light_template::smart_light_template()
+{
+    dirty = true;
+}
+
+void smart_light_template::compile(const char * format)
+{
+    literals.clear();
+    fields.clear();
+
+    /*-----------------------------------------------------*\
+    | Split the format into literal text and fields, each   |
+    | field sits between two literals                       |
+    \*-----------------------------------------------------*/
+    std::string literal;
+
+    for(const char * c = format; *c != '\0'; c++)
+    {
+        if(c[0] == '%' && (c[1] == 'u' || c[1] == 's'))
+        {
+            literals.push_back(literal);
+            fields.push_back("");
+            literal.clear();
+            c++;
+        }
+        else
+        {
+            literal += *c;
+        }
+    }
+
+    literals.push_back(literal);
+
+    dirty = true;
+}
+
+void smart_light_template::set_field(std::size_t field_idx, unsigned int value)
+{
+    char value_string[12];
+
+    snprintf(value_string, sizeof(value_string), "%u", value);
+
+    set_field(field_idx, value_string);
+}
+
+void smart_light_template::set_field(std::size_t field_idx, const char * text)
+{
+    if(field_idx >= fields.size() || fields[field_idx] == text)
+    {
+        return;
+    }
+
+    fields[field_idx].assign(text);
+
+    dirty = true;
+}
+
+const char * smart_light_template::data()
+{
+    render();
+
+    return(command.c_str());
+}
+
+int smart_light_template::length()
+{
+    render();
+
+    return((int)command.length());
+}
+
+void smart_light_template::render()
+{
+    if(!dirty)
+    {
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | The command string keeps its capacity, so rebuilding  |
+    | it does not allocate once it has grown to size        |
+    \*-----------------------------------------------------*/
+    command.clear();
+
+    for(std::size_t field_idx = 0; field_idx < fields.size(); field_idx++)
+    {
+        command.append(literals[field_idx]);
+        command.append(fields[field_idx]);
+    }
+
+    command.append(literals.back());
+
+    dirty = false;
+}
+
+/*---------------------------------------------------------*\
+| smart_light_transport                                     |
+\*---------------------------------------------------------*/
+
+smart_light_transport::smart_light_transport()
+{
+    tcp                 = false;
+    framing             = SMART_LIGHT_FRAMING_DATAGRAM;
+    session_up          = false;
+    next_seq            = 1;
+    max_in_flight       = SMART_LIGHT_DEFAULT_MAX_IN_FLIGHT;
+    timeout             = std::chrono::milliseconds(SMART_LIGHT_DEFAULT_TIMEOUT_MS);
+    unsent_valid        = false;
+    request_seq         = 0;
+    request_done        = false;
+    receive_thread      = nullptr;
+    receive_thread_run  = false;
+
+    memset(&stats, 0, sizeof(stats));
+
+    port.connected      = false;
+}
+
+smart_light_transport::~smart_light_transport()
+{
+    close();
+}
+
+bool smart_light_transport::open_udp(const char * host, const char * port_str)
+{
+    location    = std::string(host) + ":" + port_str;
+    tcp         = false;
+    framing     = SMART_LIGHT_FRAMING_DATAGRAM;
+
+    if(!port.udp_client(host, port_str))
+    {
+        return(false);
+    }
+
+    session_up  = true;
+
+    start_receive_thread();
+
+    return(true);
+}
+
+bool smart_light_transport::open_tcp(const char * host, const char * port_str, int framing_val, unsigned int connect_attempts)
+{
+    location    = std::string(host) + ":" + port_str;
+    tcp         = true;
+    framing     = framing_val;
+
+    /*-----------------------------------------------------*\
+    | net_port tokenizes the port string in place           |
+    \*-----------------------------------------------------*/
+    std::string port_copy(port_str);
+
+    if(!port.tcp_client(host, &port_copy[0]))
+    {
+        return(false);
+    }
+
+    for(unsigned int attempt = 0; attempt < connect_attempts && !session_up; attempt++)
+    {
+        session_up = connect_socket();
+    }
+
+    /*-----------------------------------------------------*\
+    | Start the receive thread even if the device did not   |
+    | answer yet, it reconnects when a command is sent      |
+    \*-----------------------------------------------------*/
+    start_receive_thread();
+
+    return(session_up);
+}
+
+void smart_light_transport::close()
+{
+    if(receive_thread != nullptr)
+    {
+        receive_thread_run = false;
+        state_cv.notify_all();
+        receive_thread->join();
+        delete receive_thread;
+        receive_thread = nullptr;
+
+        LOG_DEBUG("[Smart Light] %s: %llu sent, %llu answered, %llu lost, %llu dropped, %llu reconnects, latency avg %llu us, min %llu us, max %llu us",
+                  location.c_str(), stats.sent, stats.answered, stats.lost, stats.dropped, stats.reconnects,
+                  stats.answered ? (stats.total_us / stats.answered) : 0, stats.min_us, stats.max_us);
+    }
+
+    if(tcp && port.connected)
+    {
+        port.tcp_close();
+    }
+
+    session_up = false;
+}
+
+bool smart_light_transport::is_connected()
+{
+    std::lock_guard<std::mutex> lock(state_mutex);
+
+    return(session_up);
+}
+
+void smart_light_transport::set_response_callback(smart_light_response_callback callback)
+{
+    response_callback = callback;
+}
+
+void smart_light_transport::set_max_in_flight(unsigned int max_in_flight_val)
+{
+    std::lock_guard<std::mutex> lock(state_mutex);
+
+    max_in_flight = std::max(max_in_flight_val, 1u);
+}
+
+void smart_light_transport::set_timeout(std::chrono::milliseconds timeout_val)
+{
+    std::lock_guard<std::mutex> lock(state_mutex);
+
+    timeout = timeout_val;
+}
+
+bool smart_light_transport::send(const char * buffer, int length)
+{
+    std::unique_lock<std::mutex> lock(state_mutex);
+
+    /*-----------------------------------------------------*\
+    | If the session is down, keep only the newest command  |
+    | and let the receive thread reconnect and write it     |
+    \*-----------------------------------------------------*/
+    if(!session_up)
+    {
+        if(unsent_valid)
+        {
+            stats.dropped++;
+        }
+
+        unsent.assign(buffer, length);
+        unsent_valid = true;
+
+        lock.unlock();
+        state_cv.notify_all();
+
+        return(false);
+    }
+
+    /*-----------------------------------------------------*\
+    | Wait for a free slot so a slow device does not build  |
+    | up a backlog of stale commands                        |
+    \*-----------------------------------------------------*/
+    if(!state_cv.wait_for(lock, timeout, [this]{ return(pending.size() < max_in_flight || !session_up); }))
+    {
+        stats.lost += pending.size();
+        pending.clear();
+
+        if(tcp)
+        {
+            session_down_locked();
+        }
+    }
+
+    if(!session_up)
+    {
+        if(unsent_valid)
+        {
+            stats.dropped++;
+        }
+
+        unsent.assign(buffer, length);
+        unsent_valid = true;
+
+        lock.unlock();
+        state_cv.notify_all();
+
+        return(false);
+    }
+
+    return(write_locked(buffer, length) != 0);
+}
+
+bool smart_light_transport::request(const char * buffer, int length, std::string &response)
+{
+    std::unique_lock<std::mutex> lock(state_mutex);
+
+    if(!session_up)
+    {
+        return(false);
+    }
+
+    unsigned long long seq = write_locked(buffer, length);
+
+    if(seq == 0)
+    {
+        return(false);
+    }
+
+    request_seq     = seq;
+    request_done    = false;
+
+    /*-----------------------------------------------------*\
+    | The receive thread gives up on the command after the  |
+    | timeout, so waiting slightly longer is enough         |
+    \*-----------------------------------------------------*/
+    state_cv.wait_for(lock, timeout + 100ms, [this]{ return(request_done); });
+
+    request_seq     = 0;
+
+    if(!request_done)
+    {
+        return(false);
+    }
+
+    response.swap(request_response);
+
+    return(true);
+}
+
+smart_light_stats smart_light_transport::get_stats()
+{
+    std::lock_guard<std::mutex> lock(state_mutex);
+
+    return(stats);
+}
+
+void smart_light_transport::start_receive_thread()
+{
+    if(receive_thread == nullptr)
+    {
+        receive_thread_run  = true;
+        receive_thread      = new std::thread(&smart_light_transport::receive_thread_function, this);
+    }
+}
+
+bool smart_light_transport::connect_socket()
+{
+    if(!port.tcp_client_connect())
+    {
+        return(false);
+    }
+
+    /*-----------------------------------------------------*\
+    | Let the OS notice devices that silently went away     |
+    \*-----------------------------------------------------*/
+    const char yes = 1;
+
+    setsockopt(port.sock, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof(yes));
+
+    return(true);
+}
+
+unsigned long long smart_light_transport::write_locked(const char * buffer, int length)
+{
+    pending_command command;
+
+    command.seq         = next_seq++;
+    command.sent_time   = std::chrono::steady_clock::now();
+
+    int written;
+
+    if(tcp)
+    {
+        written = 0;
+
+        while(written < length)
+        {
+            int ret = port.tcp_client_write((char *)buffer + written, length - written);
+
+            if(ret <= 0)
+            {
+                break;
+            }
+
+            written += ret;
+        }
+    }
+    else
+    {
+        written = port.udp_write((char *)buffer, length);
+    }
+
+    if(written != length)
+    {
+        /*-------------------------------------------------*\
+        | A TCP command may have been cut short, the stream |
+        | can only be recovered by reconnecting             |
+        \*-------------------------------------------------*/
+        if(tcp)
+        {
+            session_down_locked();
+
+            unsent.assign(buffer, length);
+            unsent_valid = true;
+
+            state_cv.notify_all();
+        }
+
+        return(0);
+    }
+
+    pending.push_back(command);
+    stats.sent++;
+
+    return(command.seq);
+}
+
+void smart_light_transport::session_down_locked()
+{
+    /*-----------------------------------------------------*\
+    | Responses of a closed session will never arrive, the  |
+    | receive thread closes the socket                      |
+    \*-----------------------------------------------------*/
+    session_up  = false;
+
+    stats.lost += pending.size();
+    pending.clear();
+}
+
+void smart_light_transport::expire_pending()
+{
+    std::lock_guard<std::mutex> lock(state_mutex);
+
+    std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+    bool expired = false;
+
+    while(!pending.empty() && (now - pending.front().sent_time) > timeout)
+    {
+        pending.pop_front();
+        stats.lost++;
+        expired = true;
+    }
+
+    /*-----------------------------------------------------*\
+    | A late TCP response would be matched to the wrong     |
+    | command, so start over with a new session             |
+    \*-----------------------------------------------------*/
+    if(expired && tcp && session_up)
+    {
+        session_down_locked();
+    }
+
+    if(expired)
+    {
+        state_cv.notify_all();
+    }
+}
+
+void smart_light_transport::handle_frame(const char * data, int length)
+{
+    if(response_callback && !response_callback(data, length))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state_mutex);
+
+    /*-----------------------------------------------------*\
+    | Devices answer in order, so the response belongs to   |
+    | the oldest pending command                            |
+    \*-----------------------------------------------------*/
+    if(pending.empty())
+    {
+        return;
+    }
+
+    pending_command command = pending.front();
+    pending.pop_front();
+
+    unsigned long long latency_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - command.sent_time).count();
+
+    if(stats.answered == 0 || latency_us < stats.min_us)
+    {
+        stats.min_us = latency_us;
+    }
+
+    if(latency_us > stats.max_us)
+    {
+        stats.max_us = latency_us;
+    }
+
+    stats.answered++;
+    stats.total_us += latency_us;
+
+    if(command.seq == request_seq)
+    {
+        request_response.assign(data, length);
+        request_done = true;
+    }
+
+    state_cv.notify_all();
+}
+
+void smart_light_transport::receive_thread_function()
+{
+    std::vector<char>   receive_buffer(SMART_LIGHT_RECEIVE_BUFFER_SIZE + 1);
+    char *              buf         = receive_buffer.data();
+    int                 buf_length  = 0;
+
+    std::chrono::time_point<std::chrono::steady_clock> next_connect_time = std::chrono::steady_clock::now();
+
+    while(receive_thread_run.load())
+    {
+        /*-------------------------------------------------*\
+        | Close a broken TCP session and reopen it once     |
+        | there is a command to write                       |
+        \*-------------------------------------------------*/
+        if(tcp)
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+
+            if(!session_up)
+            {
+                if(port.connected)
+                {
+                    port.tcp_close();
+                    buf_length = 0;
+                }
+
+                if(!unsent_valid || std::chrono::steady_clock::now() < next_connect_time)
+                {
+                    state_cv.wait_for(lock, 100ms);
+                    continue;
+                }
+
+                lock.unlock();
+
+                bool connected = connect_socket();
+
+                lock.lock();
+
+                if(!connected)
+                {
+                    next_connect_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(SMART_LIGHT_RECONNECT_INTERVAL_MS);
+                    continue;
+                }
+
+                LOG_DEBUG("[Smart Light] %s: reconnected", location.c_str());
+
+                session_up = true;
+                stats.reconnects++;
+
+                if(unsent_valid)
+                {
+                    unsent_valid = false;
+                    write_locked(unsent.data(), (int)unsent.length());
+                }
+
+                continue;
+            }
+        }
+
+        expire_pending();
+
+        if(!port.wait_readable(100))
+        {
+            continue;
+        }
+
+        /*-------------------------------------------------*\
+        | Datagrams are complete responses                  |
+        \*-------------------------------------------------*/
+        if(!tcp)
+        {
+            int size = port.udp_listen(buf, SMART_LIGHT_RECEIVE_BUFFER_SIZE);
+
+            if(size > 0)
+            {
+                buf[size] = '\0';
+                handle_frame(buf, size);
+            }
+
+            continue;
+        }
+
+        int size = port.tcp_listen(buf + buf_length, SMART_LIGHT_RECEIVE_BUFFER_SIZE - buf_length);
+
+        if(size <= 0)
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+
+            session_down_locked();
+            state_cv.notify_all();
+            continue;
+        }
+
+        buf_length += size;
+
+        /*-------------------------------------------------*\
+        | Split the stream into responses                   |
+        \*-------------------------------------------------*/
+        int  consumed   = 0;
+        bool desync     = false;
+
+        while(consumed < buf_length)
+        {
+            char * frame        = buf + consumed;
+            int    available    = buf_length - consumed;
+            int    frame_length;
+            int    frame_size;
+
+            if(framing == SMART_LIGHT_FRAMING_LENGTH_PREFIX)
+            {
+                if(available < 4)
+                {
+                    break;
+                }
+
+                frame_length    = (int)(((unsigned char)frame[0] << 24) | ((unsigned char)frame[1] << 16)
+                                      | ((unsigned char)frame[2] << 8)  | ((unsigned char)frame[3]));
+
+                if(frame_length < 0 || frame_length > (SMART_LIGHT_RECEIVE_BUFFER_SIZE - 4))
+                {
+                    desync = true;
+                    break;
+                }
+
+                if(available < (4 + frame_length))
+                {
+                    break;
+                }
+
+                frame          += 4;
+                frame_size      = 4 + frame_length;
+            }
+            else
+            {
+                char * end      = (char *)memchr(frame, '\n', available);
+
+                if(end == NULL)
+                {
+                    break;
+                }
+
+                frame_length    = (int)(end - frame);
+                frame_size      = frame_length + 1;
+
+                if(frame_length > 0 && frame[frame_length - 1] == '\r')
+                {
+                    frame_length--;
+                }
+            }
+
+            /*---------------------------------------------*\
+            | Terminate the frame in place for the callback |
+            \*---------------------------------------------*/
+            char saved          = frame[frame_length];
+            frame[frame_length] = '\0';
+
+            handle_frame(frame, frame_length);
+
+            frame[frame_length] = saved;
+            consumed           += frame_size;
+        }
+
+        if(!desync && consumed == 0 && buf_length == SMART_LIGHT_RECEIVE_BUFFER_SIZE)
+        {
+            desync = true;
+        }
+
+        if(desync)
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+
+            session_down_locked();
+            state_cv.notify_all();
+            continue;
+        }
+
+        if(consumed > 0)
+        {
+            memmove(buf, buf + consumed, buf_length - consumed);
+            buf_length -= consumed;
+        }
+    }
+}
@@ -0,0 +1,174 @@
+/*---------------------------------------------------------*\
+| smart_light_transport.h                                   |
+|                                                           |
+|   Shared transport for network smart lights.  Keeps one   |
+|   session per device open on top of net_port, sends       |
+|   commands without waiting for their responses and        |
+|   matches responses on a receive thread                   |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "net_port.h"
+
+#define SMART_LIGHT_RECEIVE_BUFFER_SIZE     16384
+#define SMART_LIGHT_DEFAULT_MAX_IN_FLIGHT   4
+#define SMART_LIGHT_DEFAULT_TIMEOUT_MS      1000
+#define SMART_LIGHT_RECONNECT_INTERVAL_MS   1000
+
+/*---------------------------------------------------------*\
+| How responses are delimited on the wire                   |
+\*---------------------------------------------------------*/
+enum
+{
+    SMART_LIGHT_FRAMING_DATAGRAM        = 0,    /* UDP, one response per datagram   */
+    SMART_LIGHT_FRAMING_LINE            = 1,    /* TCP, responses end with \n       */
+    SMART_LIGHT_FRAMING_LENGTH_PREFIX   = 2,    /* TCP, 32-bit big endian length    */
+};
+
+/*---------------------------------------------------------*\
+| Per-device statistics                                     |
+|   Latency is measured from the time a command is written  |
+|   until its response arrives                              |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    unsigned long long      sent;           /* Commands written         */
+    unsigned long long      answered;       /* Responses matched        */
+    unsigned long long      lost;           /* No response in timeout   */
+    unsigned long long      dropped;        /* Replaced while offline   */
+    unsigned long long      reconnects;     /* TCP sessions reopened    */
+    unsigned long long      total_us;       /* Sum of response latencies*/
+    unsigned long long      min_us;         /* Best response latency    */
+    unsigned long long      max_us;         /* Worst response latency   */
+} smart_light_stats;
+
+/*---------------------------------------------------------*\
+| Called on the receive thread for every response frame.    |
+| The data is null-terminated.  Return false if the frame   |
+| is an unsolicited notification rather than a response.    |
+\*---------------------------------------------------------*/
+typedef std::function<bool(const char * data, int length)> smart_light_response_callback;
+
+/*---------------------------------------------------------*\
+| Command template                                          |
+|   A printf-style format with %u and %s fields is split    |
+|   into its literal parts once.  Per frame only the fields |
+|   are updated and the command is rebuilt in place.        |
+\*---------------------------------------------------------*/
+class smart_light_template
+{
+public:
+    smart_light_template();
+
+    void            compile(const char * format);
+
+    void            set_field(std::size_t field_idx, unsigned int value);
+    void            set_field(std::size_t field_idx, const char * text);
+
+    const char *    data();
+    int             length();
+
+private:
+    std::vector<std::string>    literals;
+    std::vector<std::string>    fields;
+    std::string                 command;
+    bool                        dirty;
+
+    void            render();
+};
+
+class smart_light_transport
+{
+public:
+    smart_light_transport();
+    ~smart_light_transport();
+
+    /*-----------------------------------------------------*\
+    | Open the session and start the receive thread.  TCP   |
+    | sessions try to connect up to connect_attempts times  |
+    | and reconnect on demand afterwards.                   |
+    \*-----------------------------------------------------*/
+    bool                open_udp(const char * host, const char * port);
+    bool                open_tcp(const char * host, const char * port, int framing, unsigned int connect_attempts);
+    void                close();
+
+    bool                is_connected();
+
+    void                set_response_callback(smart_light_response_callback callback);
+    void                set_max_in_flight(unsigned int max_in_flight);
+    void                set_timeout(std::chrono::milliseconds timeout);
+
+    /*-----------------------------------------------------*\
+    | Write a command and return without waiting for its    |
+    | response.  If the TCP session is down the command is  |
+    | kept, replacing any older one, and written as soon as |
+    | the session is reopened.                              |
+    \*-----------------------------------------------------*/
+    bool                send(const char * buffer, int length);
+
+    /*-----------------------------------------------------*\
+    | Write a command and wait for its response             |
+    \*-----------------------------------------------------*/
+    bool                request(const char * buffer, int length, std::string &response);
+
+    smart_light_stats   get_stats();
+
+private:
+    struct pending_command
+    {
+        unsigned long long                                  seq;
+        std::chrono::time_point<std::chrono::steady_clock>  sent_time;
+    };
+
+    net_port                        port;
+    std::string                     location;
+    bool                            tcp;
+    int                             framing;
+
+    /*-----------------------------------------------------*\
+    | Session state, pending commands and statistics, all   |
+    | protected by state_mutex.  Only the receive thread    |
+    | connects and closes the socket once it is running.    |
+    \*-----------------------------------------------------*/
+    std::mutex                      state_mutex;
+    std::condition_variable         state_cv;
+    bool                            session_up;
+    std::deque<pending_command>     pending;
+    unsigned long long              next_seq;
+    unsigned int                    max_in_flight;
+    std::chrono::milliseconds       timeout;
+    std::string                     unsent;
+    bool                            unsent_valid;
+    unsigned long long              request_seq;
+    bool                            request_done;
+    std::string                     request_response;
+    smart_light_stats               stats;
+
+    smart_light_response_callback   response_callback;
+
+    std::thread *                   receive_thread;
+    std::atomic<bool>               receive_thread_run;
+
+    void                start_receive_thread();
+    bool                connect_socket();
+    unsigned long long  write_locked(const char * buffer, int length);
+    void                session_down_locked();
+    void                expire_pending();
+    void                handle_frame(const char * data, int length);
+    void                receive_thread_function();
+};
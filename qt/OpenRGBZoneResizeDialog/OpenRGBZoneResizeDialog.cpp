@@ -184,6 +184,7 @@ int Ui::OpenRGBZoneResizeDialog::show()
     if(ret_val >= 0 && edit_dev != NULL)
     {
         edit_dev->ResizeZone(edit_zone_idx, ret_val);
+        edit_dev->SignalUpdateReason(RGBCONTROLLER_UPDATE_REASON_RESIZEZONE);
 
         edit_dev->ClearSegments(edit_zone_idx);
 
@@ -182,6 +182,7 @@ void OpenRGBZonesBulkResizer::on_save_button_clicked()
             unsigned int zone_index = std::get<1>(unconfigured_zones[i]);
 
             controller->ResizeZone(zone_index, new_size);
+            controller->SignalUpdateReason(RGBCONTROLLER_UPDATE_REASON_RESIZEZONE);
 
             has_changes = true;
         }
@@ -0,0 +1,54 @@
+/*---------------------------------------------------------*\
+| benchmark-allocation-counter.c                            |
+|                                                           |
+|   Heap allocation counter for the server-allocations      |
+|   benchmark scenario.  It is not part of the OpenRGB      |
+|   build and is only loaded with LD_PRELOAD (glibc):       |
+|                                                           |
+|   gcc -O2 -shared -fPIC -o libbenchmark-alloc.so \        |
+|       scripts/benchmark-allocation-counter.c              |
+|   LD_PRELOAD=./libbenchmark-alloc.so \                    |
+|       ./openrgb --benchmark server-allocations            |
+|                                                           |
+|   OpenRGB contributors                        17 Oct 2026 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <stddef.h>
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static unsigned long long allocation_count;
+
+/*---------------------------------------------------------*\
+| Looked up by the benchmark with dlsym()                   |
+\*---------------------------------------------------------*/
+unsigned long long openrgb_benchmark_allocation_count(void)
+{
+    return(__atomic_load_n(&allocation_count, __ATOMIC_RELAXED));
+}
+
+void* malloc(size_t size)
+{
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+
+    return(__libc_malloc(size));
+}
+
+void* calloc(size_t count, size_t size)
+{
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+
+    return(__libc_calloc(count, size));
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+
+    return(__libc_realloc(ptr, size));
+}
@@ -13,6 +13,11 @@
 
 #include "serial_port.h"
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <errno.h>
+#include <poll.h>
+#endif
+
 /*---------------------------------------------------------*\
 |  serial_port (constructor)                                |
 |    The default constructor does not initialize the serial |
@@ -607,6 +612,72 @@ int serial_port::serial_write(char * buffer, int length)
     return 0;
 }
 
+/*---------------------------------------------------------*\
+|  serial_write_nonblocking                                 |
+|    Writes up to <length> bytes to the serial port from    |
+|    <buffer> without waiting for the output to drain       |
+|    Returns the number of bytes written, 0 if the output   |
+|    buffer is full, or -1 on error                         |
+\*---------------------------------------------------------*/
+int serial_port::serial_write_nonblocking(char * buffer, int length)
+{
+    /*-----------------------------------------------------*\
+    | Windows-specific code path, the port is opened for    |
+    | blocking writes                                       |
+    \*-----------------------------------------------------*/
+#ifdef _WIN32
+    return serial_write(buffer, length);
+#endif
+
+    /*-----------------------------------------------------*\
+    | Linux and MacOS open the port with O_NDELAY, so a     |
+    | write without tcdrain does not block                  |
+    \*-----------------------------------------------------*/
+#if defined(__linux__) || defined(__APPLE__)
+    int byteswritten;
+    byteswritten = write(file_descriptor, buffer, length);
+
+    if(byteswritten < 0)
+    {
+        if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        {
+            return 0;
+        }
+
+        return -1;
+    }
+
+    return byteswritten;
+#endif
+
+    /*-----------------------------------------------------*\
+    | Return 0 on unsupported platforms                     |
+    \*-----------------------------------------------------*/
+    return 0;
+}
+
+/*---------------------------------------------------------*\
+|  serial_wait_writable                                     |
+|    Waits up to <timeout_ms> milliseconds for room in the  |
+|    output buffer                                          |
+|    Returns true if the port can be written                |
+\*---------------------------------------------------------*/
+bool serial_port::serial_wait_writable(int timeout_ms)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    struct pollfd fds;
+
+    fds.fd      = file_descriptor;
+    fds.events  = POLLOUT;
+    fds.revents = 0;
+
+    return(poll(&fds, 1, timeout_ms) > 0 && (fds.revents & POLLOUT));
+#else
+    (void)timeout_ms;
+    return true;
+#endif
+}
+
 /*---------------------------------------------------------*\
 |  serial_flush                                             |
 \*---------------------------------------------------------*/
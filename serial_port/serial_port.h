@@ -126,6 +126,8 @@ public:
     int serial_read(char * buffer, int length);
 
     int serial_write(char * buffer, int length);
+    int serial_write_nonblocking(char * buffer, int length);
+    bool serial_wait_writable(int timeout_ms);
 
     void serial_flush_rx();
     void serial_flush_tx();